@@ -1,8 +1,11 @@
 #include "AVCodecHandler.h"
 #include "FrameHandler.h"
+#include "DecoderThreadingPolicy.h"
 #include <QDebug>
+#include <algorithm>
 #include <chrono>
 #include <limits>
+#include <utility>
 
 extern "C" {
 #include <libavutil/hwcontext.h>
@@ -17,7 +20,21 @@ inline const char *safePixFmtName(AVPixelFormat fmt)
 }
 }
 
-AVCodecHandler::AVCodecHandler() = default;
+AVCodecHandler::AVCodecHandler()
+{
+    // Queue transitions resume the stage parked on them.
+    m_videoQueue.setReadyCallbacks([this] { m_demuxStage.wake(); },
+                                   [this] { m_videoDecodeStage.wake(); });
+    m_audioQueue.setReadyCallbacks([this] { m_demuxStage.wake(); },
+                                   [this] { m_audioStage.wake(); });
+    m_videoFrameQueue.setReadyCallbacks([this] { m_videoDecodeStage.wake(); },
+                                        [this] { m_videoFilterStage.wake(); });
+
+    m_presentOutput = [this](AVFrame *frame, AVRational tb) {
+        if (AVFrame *ref = av_frame_clone(frame))
+            m_presentQueue.push_back(PresentItem{ref, tb});
+    };
+}
 
 AVCodecHandler::~AVCodecHandler()
 {
@@ -51,28 +68,69 @@ bool AVCodecHandler::open()
 
     close(); // ensure clean state
 
-    // Open format context
-    AVFormatContext *rawCtx = nullptr;
+    // Clear the flag on every return path below.
+    m_opening = true;
+    struct OpeningGuard {
+        std::atomic<bool> &flag;
+        ~OpeningGuard() { flag = false; }
+    } openingGuard{m_opening};
+
+    markStartup("open-start");
+    OpenResult result = openAttempt(/*trustHeaders=*/true);
+    if (result == OpenResult::NeedsFullProbe) {
+        qDebug() << "AVCodecHandler::open() - header incomplete, probing streams";
+        close();
+        result = openAttempt(/*trustHeaders=*/false);
+    }
+    return result == OpenResult::Opened;
+}
+
+AVCodecHandler::OpenResult AVCodecHandler::openAttempt(bool trustHeaders)
+{
+    // Open format context.  The interrupt callback lets a newer open
+    // abandon this one even while FFmpeg is blocked on slow I/O.
+    AVFormatContext *rawCtx = avformat_alloc_context();
+    if (!rawCtx) {
+        qWarning() << "AVCodecHandler::open() - avformat_alloc_context failed";
+        return OpenResult::Failed;
+    }
+    rawCtx->interrupt_callback.callback = &AVCodecHandler::interruptCallback;
+    rawCtx->interrupt_callback.opaque   = this;
+
     int ret = avformat_open_input(&rawCtx, m_filePath.toUtf8().constData(),
                                    nullptr, nullptr);
     if (ret < 0 || !rawCtx) {
+        // avformat_open_input() frees rawCtx on failure
+        if (openInterrupted()) {
+            qDebug() << "AVCodecHandler::open() - cancelled:" << m_filePath;
+            return OpenResult::Failed;
+        }
         char err[AV_ERROR_MAX_STRING_SIZE]{};
         av_strerror(ret, err, sizeof(err));
         qWarning() << "avformat_open_input failed:" << err;
-        return false;
+        return OpenResult::Failed;
     }
     m_formatCtx = rawCtx;
+    markStartup("input-opened");
 
     // Limit stream analysis to reduce UI freeze on main thread
     m_formatCtx->probesize       = 1000000;   // 1 MB max probe data
     m_formatCtx->max_analyze_duration = 500000; // 0.5 s max analysis
 
-    // Read stream info
-    if (avformat_find_stream_info(m_formatCtx, nullptr) < 0) {
-        qWarning() << "avformat_find_stream_info failed";
-        close();
-        return false;
+    // Read stream info — only when the header leaves gaps.  Probing decodes
+    // frames of every stream and is most of the open time for MP4 / MKV.
+    const bool skipProbe = trustHeaders && headerParamsComplete();
+    if (!skipProbe) {
+        if (avformat_find_stream_info(m_formatCtx, nullptr) < 0 || openInterrupted()) {
+            if (openInterrupted())
+                qDebug() << "AVCodecHandler::open() - cancelled:" << m_filePath;
+            else
+                qWarning() << "avformat_find_stream_info failed";
+            close();
+            return OpenResult::Failed;
+        }
     }
+    markStartup(skipProbe ? "probe-skipped" : "probe");
 
     // Find best video & audio streams
     m_videoStreamIdx = av_find_best_stream(m_formatCtx, AVMEDIA_TYPE_VIDEO,
@@ -80,6 +138,18 @@ bool AVCodecHandler::open()
     m_audioStreamIdx = av_find_best_stream(m_formatCtx, AVMEDIA_TYPE_AUDIO,
                                             -1, -1, nullptr, 0);
 
+    // Open the audio codec on another worker while the video codec (and
+    // any hardware device) is set up here.  The Audio lane never queues
+    // behind other work, so this cannot wait on a busy pool.
+    PipelineExecutor::TaskGroup audioOpen;
+    if (m_audioStreamIdx >= 0) {
+        PipelineExecutor::instance().submit(PipelineExecutor::Lane::Audio, [this] {
+            if (!openCodec(m_audioStreamIdx, &m_audioCodecCtx)) {
+                qWarning() << "Failed to open audio codec";
+            }
+        }, &audioOpen);
+    }
+
     // Open video codec
     if (m_videoStreamIdx >= 0) {
         if (!openCodec(m_videoStreamIdx, &m_videoCodecCtx)) {
@@ -87,35 +157,189 @@ bool AVCodecHandler::open()
         }
     }
 
-    // Open audio codec
-    if (m_audioStreamIdx >= 0) {
-        if (!openCodec(m_audioStreamIdx, &m_audioCodecCtx)) {
-            qWarning() << "Failed to open audio codec";
-        }
+    audioOpen.wait();
+    markStartup("codecs-opened");
+
+    if (openInterrupted()) {
+        qDebug() << "AVCodecHandler::open() - cancelled:" << m_filePath;
+        close();
+        return OpenResult::Failed;
     }
 
     if (!m_videoCodecCtx && !m_audioCodecCtx) {
         qWarning() << "No decodable video or audio stream found";
         close();
-        return false;
+        return skipProbe ? OpenResult::NeedsFullProbe : OpenResult::Failed;
+    }
+
+    // Resume: jump to the saved position before the poster is decoded, so
+    // the poster and the primed packets already come from there.
+    if (m_startPositionUs > 0 && performSeekInternal(m_startPositionUs))
+        markStartup("start-seek");
+
+    if (m_videoCodecCtx && decodePoster())
+        markStartup("poster-decoded");
+
+    // Without a probe, the pixel / sample format comes from the decoders:
+    // the video one knows it once the poster is decoded, most audio ones
+    // right after avcodec_open2().
+    if (skipProbe) {
+        const bool videoKnown = !m_videoCodecCtx || m_videoCodecCtx->pix_fmt != AV_PIX_FMT_NONE;
+        const bool audioKnown = !m_audioCodecCtx
+                                || (m_audioCodecCtx->sample_fmt != AV_SAMPLE_FMT_NONE
+                                    && m_audioCodecCtx->sample_rate > 0
+                                    && m_audioCodecCtx->ch_layout.nb_channels > 0);
+        if (!videoKnown || !audioKnown)
+            return OpenResult::NeedsFullProbe;
     }
 
     m_seekTargetUs = -1;
     m_waitKeyFrameAfterSeek = false;
+    m_videoFilter.newStream();
+    m_atStreamStart = true;
 
-    return true;
+    return OpenResult::Opened;
 }
 
-void AVCodecHandler::close()
+bool AVCodecHandler::headerParamsComplete() const
 {
-    if (m_videoCodecCtx) {
-        avcodec_free_context(&m_videoCodecCtx);
-        m_videoCodecCtx = nullptr;
+    if (m_formatCtx->ctx_flags & AVFMTCTX_NOHEADER)
+        return false;   // streams are only discovered while reading
+    if (m_formatCtx->duration == AV_NOPTS_VALUE)
+        return false;
+
+    bool anyStream = false;
+    for (unsigned i = 0; i < m_formatCtx->nb_streams; ++i) {
+        const AVStream *st = m_formatCtx->streams[i];
+        const AVCodecParameters *par = st->codecpar;
+        if (st->disposition & AV_DISPOSITION_ATTACHED_PIC)
+            continue;
+        if (par->codec_type == AVMEDIA_TYPE_VIDEO) {
+            if (par->codec_id == AV_CODEC_ID_NONE || par->width <= 0 || par->height <= 0)
+                return false;
+            anyStream = true;
+        } else if (par->codec_type == AVMEDIA_TYPE_AUDIO) {
+            if (par->codec_id == AV_CODEC_ID_NONE || par->sample_rate <= 0
+                || par->ch_layout.nb_channels <= 0)
+                return false;
+            anyStream = true;
+        }
     }
-    if (m_audioCodecCtx) {
-        avcodec_free_context(&m_audioCodecCtx);
-        m_audioCodecCtx = nullptr;
+    return anyStream;
+}
+
+bool AVCodecHandler::decodePoster()
+{
+    // Stay well inside the queue capacities: play() hands these packets to
+    // the queues before any consumer runs.
+    constexpr size_t kMaxVideoPackets = 96;
+    constexpr size_t kMaxAudioPackets = 48;
+
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame  *frame = av_frame_alloc();
+    if (!pkt || !frame) {
+        if (pkt) av_packet_free(&pkt);
+        if (frame) av_frame_free(&frame);
+        return false;
     }
+
+    size_t videoPackets = 0;
+    size_t audioPackets = 0;
+    while (!m_posterFrame && !openInterrupted()
+           && videoPackets < kMaxVideoPackets && audioPackets < kMaxAudioPackets) {
+        if (av_read_frame(m_formatCtx, pkt) < 0) break;
+
+        const bool isVideo = pkt->stream_index == m_videoStreamIdx;
+        if (!isVideo && pkt->stream_index != m_audioStreamIdx) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        if (isVideo) {
+            ++videoPackets;
+            if (avcodec_send_packet(m_videoCodecCtx, pkt) >= 0) {
+                while (!m_posterFrame && avcodec_receive_frame(m_videoCodecCtx, frame) == 0) {
+                    if (frame->flags & AV_FRAME_FLAG_KEY) {
+                        AVFrame *poster = av_frame_alloc();
+                        if (poster && m_hwDecodeActive && frame->format == m_hwPixFmt) {
+                            if (av_hwframe_transfer_data(poster, frame, 0) < 0
+                                || av_frame_copy_props(poster, frame) < 0) {
+                                av_frame_free(&poster);
+                            }
+                        } else if (poster) {
+                            av_frame_move_ref(poster, frame);
+                        }
+                        m_posterFrame = poster;
+                    }
+                    av_frame_unref(frame);
+                }
+            }
+        } else {
+            ++audioPackets;
+        }
+
+        AVPacket *kept = av_packet_alloc();
+        if (kept) {
+            av_packet_move_ref(kept, pkt);
+            m_primedPackets.push_back(kept);
+        }
+        av_packet_unref(pkt);
+    }
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    return m_posterFrame != nullptr;
+}
+
+void AVCodecHandler::discardStartState()
+{
+    for (AVPacket *&pkt : m_primedPackets)
+        av_packet_free(&pkt);
+    m_primedPackets.clear();
+    if (m_posterFrame)
+        av_frame_free(&m_posterFrame);
+    m_atStreamStart = false;
+}
+
+void AVCodecHandler::setStartupTimeline(std::shared_ptr<StartupTimeline> timeline)
+{
+    m_startup = std::move(timeline);
+}
+
+void AVCodecHandler::setStartPosition(double seconds)
+{
+    m_startPositionUs = seconds > 0.0 ? static_cast<int64_t>(seconds * AV_TIME_BASE) : 0;
+}
+
+void AVCodecHandler::setStageTimings(std::shared_ptr<StageTimings> timings)
+{
+    m_stageTimings = std::move(timings);
+}
+
+void AVCodecHandler::setRealtimePacing(bool enabled)
+{
+    m_realtimePacing = enabled;
+}
+
+void AVCodecHandler::markStartup(const char *phase)
+{
+    if (m_startup)
+        m_startup->mark(phase);
+}
+
+void AVCodecHandler::noteFirstFrame(const char *phase)
+{
+    if (!m_startup) return;
+    const qint64 ms = m_startup->markFirstFrame(phase);
+    if (ms >= 0 && m_frameHandler)
+        m_frameHandler->stats().ttffMs.store(static_cast<uint64_t>(ms), std::memory_order_relaxed);
+}
+
+void AVCodecHandler::close()
+{
+    releaseCodec(&m_videoCodecCtx, m_videoCtxCacheable, m_videoCtxKey);
+    releaseCodec(&m_audioCodecCtx, m_audioCtxCacheable, m_audioCtxKey);
+    m_videoCtxCacheable = false;
+    m_audioCtxCacheable = false;
     if (m_formatCtx) {
         avformat_close_input(&m_formatCtx);
         m_formatCtx = nullptr;
@@ -124,6 +348,11 @@ void AVCodecHandler::close()
         av_buffer_unref(&m_hwDeviceCtx);
         m_hwDeviceCtx = nullptr;
     }
+    if (m_registeredPlayer) {
+        DecoderThreadingPolicy::unregisterPlayer();
+        m_registeredPlayer = false;
+    }
+    discardStartState();
     m_videoStreamIdx = -1;
     m_audioStreamIdx = -1;
     m_seekTargetUs = -1;
@@ -138,6 +367,24 @@ bool AVCodecHandler::isOpen() const
     return m_formatCtx != nullptr;
 }
 
+// ── Cancellation ───────────────────────────────────────────
+
+void AVCodecHandler::setInterruptCheck(InterruptCheck check)
+{
+    m_interruptCheck = std::move(check);
+}
+
+bool AVCodecHandler::openInterrupted() const
+{
+    return m_opening && m_interruptCheck && m_interruptCheck();
+}
+
+int AVCodecHandler::interruptCallback(void *opaque)
+{
+    const auto *self = static_cast<const AVCodecHandler *>(opaque);
+    return self->openInterrupted() ? 1 : 0;
+}
+
 // ── Stream metadata ────────────────────────────────────────
 
 int AVCodecHandler::videoStreamIndex() const { return m_videoStreamIdx; }
@@ -245,26 +492,45 @@ void AVCodecHandler::play()
         return;
     }
 
-    // Fresh start — join any leftover threads from a previous run (e.g. after EOF)
-    joinThreads();
+    // Fresh start — wait for leftover stages from a previous run (e.g. after EOF)
+    joinPipeline();
 
     m_abortRequested = false;
     m_paused = false;
     m_activeDecodeThreads = 0;
     m_videoQueue.restart();
     m_audioQueue.restart();
+    m_videoFrameQueue.restart();
+    m_lagController.reset();
 
     // Restart from beginning only when replaying after EOF.
     // For normal play-after-seek, keep the current demux position.
-    if (oldStatus == AVPlayerStatus::Stopped ||
-        oldStatus == AVPlayerStatus::EndOfFile ||
-        oldStatus == AVPlayerStatus::PlaybackDone) {
+    // Right after open() the demuxer is still at the start (or at the
+    // setStartPosition() keyframe): the packets the poster was decoded
+    // from are replayed instead of seeking.
+    const bool fromStart = m_atStreamStart;
+    if (!fromStart &&
+        (oldStatus == AVPlayerStatus::Stopped ||
+         oldStatus == AVPlayerStatus::EndOfFile ||
+         oldStatus == AVPlayerStatus::PlaybackDone)) {
         std::lock_guard formatLock(m_formatMutex);
         av_seek_frame(m_formatCtx, -1, 0, AVSEEK_FLAG_BACKWARD);
     }
     if (m_videoCodecCtx) avcodec_flush_buffers(m_videoCodecCtx);
     if (m_audioCodecCtx) avcodec_flush_buffers(m_audioCodecCtx);
 
+    if (fromStart) {
+        for (AVPacket *pkt : m_primedPackets) {
+            if (pkt->stream_index == m_videoStreamIdx)
+                m_videoQueue.push(pkt);
+            else
+                m_audioQueue.push(pkt);
+        }
+    }
+    AVFrame *poster = fromStart ? std::exchange(m_posterFrame, nullptr) : nullptr;
+    discardStartState();
+    m_firstFramePending = m_videoCodecCtx != nullptr;
+
     // Initialise FrameHandler contexts
     if (m_frameHandler) {
         if (m_videoCodecCtx) {
@@ -273,9 +539,21 @@ void AVCodecHandler::play()
                 renderPixFmt = m_videoCodecCtx->sw_pix_fmt;
             }
 
+            m_frameHandler->setVideoTimeBase(m_formatCtx->streams[m_videoStreamIdx]->time_base);
             m_frameHandler->initVideo(m_videoCodecCtx->width,
                                       m_videoCodecCtx->height,
-                                      renderPixFmt);
+                                      renderPixFmt,
+                                      m_videoCodecCtx->colorspace,
+                                      m_videoCodecCtx->color_range);
+            markStartup("video-init");
+
+            // Put the first keyframe on screen before the audio sink is
+            // created; the decode stage shows it again once it runs.
+            if (poster) {
+                m_frameHandler->processVideoFrame(poster);
+                if (m_firstFramePending.exchange(false))
+                    noteFirstFrame("poster-presented");
+            }
         }
         if (m_audioCodecCtx) {
             AVRational audioTb = m_formatCtx->streams[m_audioStreamIdx]->time_base;
@@ -283,11 +561,16 @@ void AVCodecHandler::play()
                                       m_audioCodecCtx->ch_layout,
                                       static_cast<AVSampleFormat>(m_audioCodecCtx->sample_fmt),
                                       audioTb);
+            markStartup("audio-init");
         }
     }
+    if (poster)
+        av_frame_free(&poster);
 
     m_status = AVPlayerStatus::Playing;
-    startThreads();
+    startPipeline();
+    if (m_startup)
+        m_startup->finish("pipeline-started");
 }
 
 void AVCodecHandler::pause()
@@ -298,10 +581,7 @@ void AVCodecHandler::pause()
         m_frameHandler->pauseAudioOutput();
     }
 
-    {
-        std::lock_guard lock(m_pauseMutex);
-        m_paused = true;
-    }
+    m_paused = true;   // each stage parks at its next step
     m_status = AVPlayerStatus::Paused;
 }
 
@@ -309,17 +589,14 @@ void AVCodecHandler::resume()
 {
     if (m_status != AVPlayerStatus::Paused) return;
 
-    {
-        std::lock_guard lock(m_pauseMutex);
-        m_paused = false;
-    }
+    m_paused = false;
 
     if (m_frameHandler) {
         m_frameHandler->resumeAudioOutput();
     }
 
-    m_pauseCond.notify_all();
     m_status = AVPlayerStatus::Playing;
+    wakeStages();
 }
 
 void AVCodecHandler::stop()
@@ -329,26 +606,24 @@ void AVCodecHandler::stop()
     qDebug() << "AVCodecHandler::stop() - begin";
     m_abortRequested = true;
 
-    // Unblock paused threads first
-    {
-        std::lock_guard lock(m_pauseMutex);
-        m_paused = false;
-    }
-    m_pauseCond.notify_all();
+    m_paused = false;
 
-    // Abort the queues so blocked push/pop return immediately
+    // Abort the queues; their callbacks wake the stages parked on them
     m_videoQueue.abort();
     m_audioQueue.abort();
+    m_videoFrameQueue.abort();
 
-    // Signal FrameHandler to bail out of any blocking write loops
-    // *before* we join, so the threads can actually exit.
+    // Drop the audio waiting for the device *before* we wait, so the
+    // audio stage does not keep retrying it.
     if (m_frameHandler)
         m_frameHandler->requestAbort();
 
-    joinThreads();
+    wakeStages();   // paused stages see the abort too
+    joinPipeline();
 
     m_videoQueue.flush();
     m_audioQueue.flush();
+    m_videoFrameQueue.flush();
 
     if (m_frameHandler)
         m_frameHandler->cleanup();
@@ -407,370 +682,586 @@ void AVCodecHandler::setAllowHwFallback(bool allow)
     m_allowHwFallback = allow;
 }
 
+void AVCodecHandler::setDecodeThreading(int threads, DecodeThreadType type)
+{
+    m_decodeThreads    = threads;
+    m_decodeThreadType = type;
+}
+
+void AVCodecHandler::setReplacesPlayer(bool replaces)
+{
+    m_replacesPlayer = replaces;
+}
+
+void AVCodecHandler::registerPlayer()
+{
+    if (m_registeredPlayer) return;
+    DecoderThreadingPolicy::registerPlayer();
+    m_registeredPlayer = true;
+}
+
+bool AVCodecHandler::isRegisteredPlayer() const
+{
+    return m_registeredPlayer;
+}
+
 QString AVCodecHandler::decodeRuntimeStatus() const
 {
     return m_decodeRuntimeStatus;
 }
 
+void AVCodecHandler::setVideoFilter(const QString &description)
+{
+    m_videoFilter.setDescription(description);
+}
+
+void AVCodecHandler::setDeinterlaceMode(DeinterlaceMode mode)
+{
+    m_videoFilter.setDeinterlaceMode(mode);
+}
+
+QVariantMap AVCodecHandler::videoFilterStats() const
+{
+    return m_videoFilter.stats();
+}
+
+void AVCodecHandler::resetVideoFilterStats()
+{
+    m_videoFilter.resetStats();
+}
+
 AVPlayerStatus AVCodecHandler::status() const
 {
     return m_status.load();
 }
 
-// ── Thread helpers ─────────────────────────────────────────
+// ── Stage helpers ──────────────────────────────────────────
 
-void AVCodecHandler::startThreads()
+void AVCodecHandler::startPipeline()
 {
-    m_demuxThread       = std::thread(&AVCodecHandler::demuxLoop, this);
-    if (m_videoCodecCtx)
-        m_videoDecodeThread = std::thread(&AVCodecHandler::videoDecodeLoop, this);
-    if (m_audioCodecCtx)
-        m_audioDecodeThread = std::thread(&AVCodecHandler::audioDecodeLoop, this);
+    // Count every decode stage before any of them runs, so a short file
+    // cannot reach PlaybackDone while another stage has not started yet.
+    m_activeDecodeThreads = (m_audioCodecCtx ? 1 : 0) + (m_videoCodecCtx ? 2 : 0);
+
+    if (m_audioCodecCtx) {
+        m_audioDecode = DecodeState{};
+        m_audioDecode.frame = av_frame_alloc();
+        m_audioStage.start([this] { return audioDecodeStep(); }, &m_pipelineTasks);
+    }
+    if (m_videoCodecCtx) {
+        m_filterResetSerial = m_videoFilterResetSerial.load();
+        m_filterInputDone   = false;
+        m_presentPaced      = false;
+        m_videoFilterStage.start([this] { return videoFilterStep(); }, &m_pipelineTasks);
+
+        m_videoDecode = DecodeState{};
+        m_videoDecode.frame = av_frame_alloc();
+        m_videoDecodeStage.start([this] { return videoDecodeStep(); }, &m_pipelineTasks);
+    }
+    m_demuxPacket = av_packet_alloc();
+    m_demuxPacketPending = false;
+    m_demuxStage.start([this] { return demuxStep(); }, &m_pipelineTasks);
 }
 
-void AVCodecHandler::joinThreads()
+void AVCodecHandler::joinPipeline()
 {
-    qDebug() << "AVCodecHandler::joinThreads - waiting...";
-    if (m_demuxThread.joinable())       m_demuxThread.join();
-    qDebug() << "AVCodecHandler::joinThreads - demux joined";
-    if (m_videoDecodeThread.joinable()) m_videoDecodeThread.join();
-    qDebug() << "AVCodecHandler::joinThreads - video joined";
-    if (m_audioDecodeThread.joinable()) m_audioDecodeThread.join();
-    qDebug() << "AVCodecHandler::joinThreads - all joined";
+    qDebug() << "AVCodecHandler::joinPipeline - waiting...";
+    m_pipelineTasks.wait();
+    qDebug() << "AVCodecHandler::joinPipeline - all stages returned";
 }
 
-void AVCodecHandler::waitIfPaused()
+void AVCodecHandler::wakeStages()
 {
-    std::unique_lock lock(m_pauseMutex);
-    m_pauseCond.wait(lock, [this] { return !m_paused || m_abortRequested; });
+    m_demuxStage.wake();
+    m_videoDecodeStage.wake();
+    m_videoFilterStage.wake();
+    m_audioStage.wake();
 }
 
-// ── Thread loops ───────────────────────────────────────────
+void AVCodecHandler::finishDecodeStage()
+{
+    if (m_activeDecodeThreads.fetch_sub(1) != 1)
+        return;
+
+    // Last decode stage to finish → signal PlaybackDone
+    AVPlayerStatus expected = AVPlayerStatus::EndOfFile;
+    if (m_status.compare_exchange_strong(expected, AVPlayerStatus::PlaybackDone)) {
+        qDebug() << "AVCodecHandler: all decode stages done → PlaybackDone";
+        if (m_playbackDoneCallback)
+            m_playbackDoneCallback();
+    }
+}
 
-void AVCodecHandler::demuxLoop()
+void AVCodecHandler::setPlaybackDoneCallback(std::function<void()> callback)
 {
-    AVPacket *pkt = av_packet_alloc();
-    if (!pkt) return;
+    m_playbackDoneCallback = std::move(callback);
+}
 
-    while (!m_abortRequested) {
-        waitIfPaused();
-        if (m_abortRequested) break;
+// ── Pipeline stages ────────────────────────────────────────
+
+PipelineStage::Step AVCodecHandler::demuxStep()
+{
+    if (m_abortRequested || !m_demuxPacket) return finishDemux();
+    if (m_paused) return PipelineStage::wait();
+
+    for (int i = 0; i < kDemuxPacketsPerStep; ++i) {
+        // A packet read last time waits for room in its queue.
+        if (m_demuxPacketPending) {
+            PacketQueue &queue = m_demuxPacket->stream_index == m_videoStreamIdx
+                                 ? m_videoQueue : m_audioQueue;
+            const PacketQueue::TryResult result = queue.tryPush(m_demuxPacket);
+            if (result == PacketQueue::TryResult::WouldBlock) return PipelineStage::wait();
+            if (result == PacketQueue::TryResult::Closed) return finishDemux();   // aborted
+            av_packet_unref(m_demuxPacket);
+            m_demuxPacketPending = false;
+        }
 
         int ret = 0;
         {
+            StageTimings::Scope timing(m_stageTimings.get(), StageTimings::Stage::Demux);
             std::lock_guard formatLock(m_formatMutex);
-            ret = av_read_frame(m_formatCtx, pkt);
+            ret = av_read_frame(m_formatCtx, m_demuxPacket);
         }
         if (ret < 0) {
             // EOF or error — signal decoders that no more packets are coming
             m_status = AVPlayerStatus::EndOfFile;
-            break;
+            return finishDemux();
         }
 
-        if (pkt->stream_index == m_videoStreamIdx) {
-            if (!m_videoQueue.push(pkt)) break;   // aborted
-        } else if (pkt->stream_index == m_audioStreamIdx) {
-            if (!m_audioQueue.push(pkt)) break;   // aborted
-        }
-        av_packet_unref(pkt);
+        if (m_demuxPacket->stream_index == m_videoStreamIdx
+            || m_demuxPacket->stream_index == m_audioStreamIdx)
+            m_demuxPacketPending = true;
+        else
+            av_packet_unref(m_demuxPacket);
     }
+    return PipelineStage::again();
+}
 
-    av_packet_free(&pkt);
+PipelineStage::Step AVCodecHandler::finishDemux()
+{
+    av_packet_free(&m_demuxPacket);
+    m_demuxPacketPending = false;
 
-    qDebug() << "AVCodecHandler::demuxLoop - exiting, signalling EOF to queues";
+    qDebug() << "AVCodecHandler::demuxStep - finished, signalling EOF to queues";
 
-    // Signal decode threads that no more packets are coming.
+    // Signal the decode stages that no more packets are coming.
     // Use signalEOF() instead of abort() so they can drain the remaining
-    // packets before exiting.
+    // packets before finishing.
     m_videoQueue.signalEOF();
     m_audioQueue.signalEOF();
+    return PipelineStage::done();
 }
 
-void AVCodecHandler::videoDecodeLoop()
+PipelineStage::Step AVCodecHandler::videoDecodeStep()
 {
-    m_activeDecodeThreads.fetch_add(1);
-    AVPacket *pkt = nullptr;
-    AVFrame  *frame = av_frame_alloc();
-    if (!frame) { m_activeDecodeThreads.fetch_sub(1); return; }
+    DecodeState &d = m_videoDecode;
+    if (m_abortRequested || !d.frame) return finishVideoDecode();
+    if (m_paused) return PipelineStage::wait();
+
+    // A frame the filter stage had no room for last time goes first.
+    if (d.pending) {
+        const FrameQueue::TryResult result = m_videoFrameQueue.tryPush(d.pending);
+        if (result == FrameQueue::TryResult::WouldBlock) return PipelineStage::wait();
+        av_frame_free(&d.pending);
+        if (result == FrameQueue::TryResult::Closed) return finishVideoDecode();   // aborted
+    }
 
-    while (!m_abortRequested) {
-        waitIfPaused();
-        if (m_abortRequested) break;
+    PlayerStats *stats = m_frameHandler ? &m_frameHandler->stats() : nullptr;
+    StageTimings *timings = d.flushing ? nullptr : m_stageTimings.get();
 
-        if (!m_videoQueue.pop(&pkt)) break;      // aborted or EOF
+    for (;;) {
+        // ── Frames of the last packet (or of the flush) ──
+        while (d.receiving) {
+            int ret = 0;
+            {
+                const int64_t t0 = timings ? StageTimings::now() : 0;
+                std::lock_guard lock(m_codecMutex);
+                ret = avcodec_receive_frame(m_videoCodecCtx, d.frame);
+                if (timings) d.decodeNs += StageTimings::now() - t0;
+            }
+            if (ret < 0) {   // EAGAIN: wants the next packet; EOF: drained
+                d.receiving = false;
+                if (d.flushing) return finishVideoDecode();
+                if (timings)
+                    timings->record(StageTimings::Stage::VideoDecode, d.decodeNs);
+                return PipelineStage::again();   // one packet per step
+            }
 
-        int ret = 0;
-        {
-            std::lock_guard lock(m_codecMutex);
-            ret = avcodec_send_packet(m_videoCodecCtx, pkt);
+            // Filtering, pacing and presentation happen on the filter stage.
+            AVFrame *out = takeVideoFrame(d.frame, !d.flushing);
+            if (!out) continue;
+            const FrameQueue::TryResult result = m_videoFrameQueue.tryPush(out);
+            if (result == FrameQueue::TryResult::WouldBlock) {
+                d.pending = out;
+                return PipelineStage::wait();
+            }
+            av_frame_free(&out);
+            if (result == FrameQueue::TryResult::Closed) return finishVideoDecode();   // aborted
         }
-        av_packet_free(&pkt);
-        if (ret < 0) continue;
 
-        while (ret >= 0 && !m_abortRequested) {
+        // ── Next packet ──
+        AVPacket *pkt = nullptr;
+        const PacketQueue::TryResult popped = m_videoQueue.tryPop(&pkt);
+        if (popped == PacketQueue::TryResult::WouldBlock) return PipelineStage::wait();
+        if (popped == PacketQueue::TryResult::Closed) {
+            if (m_abortRequested) return finishVideoDecode();
+            // End of input: drain the frames still buffered in the decoder.
             {
                 std::lock_guard lock(m_codecMutex);
-                ret = avcodec_receive_frame(m_videoCodecCtx, frame);
+                avcodec_send_packet(m_videoCodecCtx, nullptr);
             }
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
-            if (ret < 0) break;
-
-            AVFrame *renderFrame = frame;
-            AVFrame *swFrame = nullptr;
-
-            if (m_hwDecodeActive && frame->format == m_hwPixFmt) {
-                swFrame = av_frame_alloc();
-                if (!swFrame) {
-                    av_frame_unref(frame);
-                    continue;
-                }
-
-                if (av_hwframe_transfer_data(swFrame, frame, 0) < 0) {
-                    av_frame_free(&swFrame);
-                    av_frame_unref(frame);
-                    continue;
-                }
+            d.flushing  = true;
+            d.receiving = true;
+            timings     = nullptr;
+            continue;
+        }
 
-                swFrame->pts = frame->pts;
-                swFrame->pkt_dts = frame->pkt_dts;
-                swFrame->best_effort_timestamp = frame->best_effort_timestamp;
-                swFrame->flags = frame->flags;
-                renderFrame = swFrame;
+        // ── Degradation: follow the lag controller between packets ──
+        const int level = m_lagController.level();
+        if (level != d.appliedLevel) {
+            {
+                std::lock_guard lock(m_codecMutex);
+                DecodeLagController::apply(m_videoCodecCtx, level);
             }
-
-            if (m_waitKeyFrameAfterSeek.load() && !(renderFrame->flags & AV_FRAME_FLAG_KEY)) {
-                if (swFrame) {
-                    av_frame_free(&swFrame);
-                }
-                av_frame_unref(frame);
-                continue;
+            if (stats && d.appliedLevel >= 0) {
+                stats->degradeLevel.store(static_cast<uint64_t>(level), std::memory_order_relaxed);
+                PlayerStats::bump(stats->degradeChanges);
             }
+            d.appliedLevel = level;
+        }
+        if (DecodeLagController::canDropPacket(pkt, level)) {
+            av_packet_free(&pkt);
+            if (stats) PlayerStats::bump(stats->videoPacketDrops);
+            return PipelineStage::again();
+        }
+        if (stats && level > DecodeLagController::Full)
+            PlayerStats::bump(stats->videoDegradedPackets);
 
-            if (m_waitKeyFrameAfterSeek.load() && (renderFrame->flags & AV_FRAME_FLAG_KEY)) {
-                m_waitKeyFrameAfterSeek = false;
-            }
+        int ret = 0;
+        d.decodeNs = 0;   // codec calls for this packet (timings only)
+        {
+            const int64_t t0 = timings ? StageTimings::now() : 0;
+            std::lock_guard lock(m_codecMutex);
+            ret = avcodec_send_packet(m_videoCodecCtx, pkt);
+            if (timings) d.decodeNs += StageTimings::now() - t0;
+        }
+        av_packet_free(&pkt);
+        if (ret < 0) return PipelineStage::again();
+        d.receiving = true;
+    }
+}
 
-            const int64_t seekTargetUs = m_seekTargetUs.load();
-            if (seekTargetUs >= 0 && renderFrame->pts != AV_NOPTS_VALUE) {
-                AVRational tb = m_formatCtx->streams[m_videoStreamIdx]->time_base;
-                const int64_t frameUs = av_rescale_q(renderFrame->pts, tb, AVRational{1, AV_TIME_BASE});
+PipelineStage::Step AVCodecHandler::finishVideoDecode()
+{
+    DecodeState &d = m_videoDecode;
+    av_frame_free(&d.pending);
+    av_frame_free(&d.frame);
+    d = DecodeState{};
 
-                if (frameUs + 100000 < seekTargetUs) {
-                    if (swFrame) {
-                        av_frame_free(&swFrame);
-                    }
-                    av_frame_unref(frame);
-                    continue;
-                }
+    // Let the filter stage drain its graph and finish.
+    m_videoFrameQueue.signalEOF();
 
-                if (!m_audioCodecCtx) {
-                    int64_t expected = seekTargetUs;
-                    m_seekTargetUs.compare_exchange_strong(expected, -1);
-                }
-            }
+    qDebug() << "AVCodecHandler::videoDecodeStep - finished";
+    finishDecodeStage();
+    return PipelineStage::done();
+}
 
-            // ── PTS-based sync: pace video frames to audio clock ──
-            if (m_frameHandler && renderFrame->pts != AV_NOPTS_VALUE) {
-                AVRational tb = m_formatCtx->streams[m_videoStreamIdx]->time_base;
-                double videoPts = renderFrame->pts * av_q2d(tb);
-
-                // Sync to audio clock when audio stream is present
-                if (m_audioCodecCtx) {
-                    double clock = m_frameHandler->audioClock();
-                    if (clock > 0.0) {
-                        double diff = videoPts - clock;
-                        if (diff > 0.005) {
-                            // Video ahead of audio → interruptible sleep to sync
-                            auto us = static_cast<int64_t>(diff * 1e6);
-                            if (us > 0 && us < 5000000) { // safety cap 5 s
-                                std::unique_lock lock(m_pauseMutex);
-                                m_pauseCond.wait_for(lock, std::chrono::microseconds(us),
-                                    [this] { return m_abortRequested.load(); });
-                            }
-                        } else if (diff < -0.05) {
-                            // Video behind >50 ms → drop frame
-                            av_frame_unref(frame);
-                            continue;
-                        }
-                    }
-                }
+AVFrame *AVCodecHandler::takeVideoFrame(AVFrame *frame, bool gate)
+{
+    if (gate) {
+        if (m_waitKeyFrameAfterSeek.load()) {
+            if (!(frame->flags & AV_FRAME_FLAG_KEY)) {
+                av_frame_unref(frame);
+                return nullptr;
             }
+            m_waitKeyFrameAfterSeek = false;
+        }
 
-            if (m_frameHandler)
-                m_frameHandler->processVideoFrame(renderFrame);
+        const int64_t seekTargetUs = m_seekTargetUs.load();
+        if (seekTargetUs >= 0 && frame->pts != AV_NOPTS_VALUE) {
+            AVRational tb = m_formatCtx->streams[m_videoStreamIdx]->time_base;
+            const int64_t frameUs = av_rescale_q(frame->pts, tb, AVRational{1, AV_TIME_BASE});
 
-            bool expected = true;
-            if (m_logFirstFrameAfterSeek.compare_exchange_strong(expected, false)) {
-                const AVPixelFormat outFmt = static_cast<AVPixelFormat>(renderFrame->format);
-                qDebug() << "Seek first frame -> fmt:" << safePixFmtName(outFmt)
-                         << "hwActive:" << m_hwDecodeActive
-                         << "key:" << bool(renderFrame->flags & AV_FRAME_FLAG_KEY)
-                         << "pts:" << renderFrame->pts;
+            if (frameUs + 100000 < seekTargetUs) {
+                av_frame_unref(frame);
+                return nullptr;
             }
 
-            if (swFrame) {
-                av_frame_free(&swFrame);
+            if (!m_audioCodecCtx) {
+                int64_t expected = seekTargetUs;
+                m_seekTargetUs.compare_exchange_strong(expected, -1);
             }
-
-            av_frame_unref(frame);
         }
     }
 
-    // Flush decoder (drain buffered frames) — skip if abort was requested
-    if (!m_abortRequested) {
-        {
-            std::lock_guard lock(m_codecMutex);
-            avcodec_send_packet(m_videoCodecCtx, nullptr);
+    AVFrame *out = av_frame_alloc();
+    if (!out) {
+        av_frame_unref(frame);
+        return nullptr;
+    }
+
+    if (m_hwDecodeActive && frame->format == m_hwPixFmt) {
+        if (av_hwframe_transfer_data(out, frame, 0) < 0) {
+            av_frame_free(&out);
+            av_frame_unref(frame);
+            return nullptr;
         }
-        while (!m_abortRequested) {
-            int ret = 0;
-            {
-                std::lock_guard lock(m_codecMutex);
-                ret = avcodec_receive_frame(m_videoCodecCtx, frame);
-            }
-            if (ret != 0) break;
 
-            AVFrame *renderFrame = frame;
-            AVFrame *swFrame = nullptr;
+        out->pts = frame->pts;
+        out->pkt_dts = frame->pkt_dts;
+        out->best_effort_timestamp = frame->best_effort_timestamp;
+        out->flags = frame->flags;
+        av_frame_unref(frame);
+    } else {
+        av_frame_move_ref(out, frame);
+    }
+    return out;
+}
 
-            if (m_hwDecodeActive && frame->format == m_hwPixFmt) {
-                swFrame = av_frame_alloc();
-                if (!swFrame) {
-                    av_frame_unref(frame);
-                    continue;
-                }
+PipelineStage::Step AVCodecHandler::videoFilterStep()
+{
+    if (m_abortRequested) return finishVideoFilter();
+    if (m_paused) {
+        m_presentPaced = false;   // the audio clock stands still: pace again on resume
+        return PipelineStage::wait();
+    }
 
-                if (av_hwframe_transfer_data(swFrame, frame, 0) < 0) {
-                    av_frame_free(&swFrame);
-                    av_frame_unref(frame);
-                    continue;
-                }
+    // A seek happened: frames buffered inside the filters, or filtered
+    // and waiting for their time, are stale.
+    const uint32_t serial = m_videoFilterResetSerial.load();
+    if (serial != m_filterResetSerial) {
+        m_filterResetSerial = serial;
+        m_videoFilter.reset();
+        clearPresentQueue();
+    }
 
-                swFrame->pts = frame->pts;
-                swFrame->pkt_dts = frame->pkt_dts;
-                swFrame->best_effort_timestamp = frame->best_effort_timestamp;
-                swFrame->flags = frame->flags;
-                renderFrame = swFrame;
+    // ── Present the filtered frames as they fall due ──
+    while (!m_presentQueue.empty()) {
+        PresentItem &item = m_presentQueue.front();
+        const auto now = std::chrono::steady_clock::now();
+        if (!m_presentPaced) {
+            const int64_t holdUs = paceVideoFrame(item.frame, item.tb);
+            if (holdUs < 0) {
+                av_frame_free(&item.frame);
+                m_presentQueue.pop_front();
+                continue;
             }
+            m_presentDeadline = now + std::chrono::microseconds(holdUs);
+            m_presentPaced = true;
+        }
+        if (now < m_presentDeadline) {
+            // Video ahead of audio: come back when the frame is due, in
+            // slices so a pause or stop is seen promptly.
+            const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                m_presentDeadline - now);
+            return PipelineStage::again(std::min<std::chrono::microseconds>(remaining, kPacingSlice));
+        }
 
-            if (m_frameHandler)
-                m_frameHandler->processVideoFrame(renderFrame);
-
-            bool expected = true;
-            if (m_logFirstFrameAfterSeek.compare_exchange_strong(expected, false)) {
-                const AVPixelFormat outFmt = static_cast<AVPixelFormat>(renderFrame->format);
-                qDebug() << "Seek first frame -> fmt:" << safePixFmtName(outFmt)
-                         << "hwActive:" << m_hwDecodeActive
-                         << "key:" << bool(renderFrame->flags & AV_FRAME_FLAG_KEY)
-                         << "pts:" << renderFrame->pts;
-            }
+        presentVideoFrame(item.frame, item.tb);
+        av_frame_free(&item.frame);
+        m_presentQueue.pop_front();
+        m_presentPaced = false;
+    }
 
-            if (swFrame) {
-                av_frame_free(&swFrame);
-            }
-            av_frame_unref(frame);
-        }
+    if (m_filterInputDone) return finishVideoFilter();
+
+    AVFrame *frame = nullptr;
+    const FrameQueue::TryResult result = m_videoFrameQueue.tryPop(&frame);
+    if (result == FrameQueue::TryResult::WouldBlock) return PipelineStage::wait();
+    if (result == FrameQueue::TryResult::Closed) {
+        if (m_abortRequested) return finishVideoFilter();
+        // End of stream: drain the filters, then present what they held.
+        m_videoFilter.flush(m_presentOutput);
+        m_filterInputDone = true;
+        return PipelineStage::again();
     }
 
-    qDebug() << "AVCodecHandler::videoDecodeLoop - exiting";
+    const AVRational streamTb = m_formatCtx->streams[m_videoStreamIdx]->time_base;
+    m_videoFilter.filter(frame, streamTb, m_presentOutput);
     av_frame_free(&frame);
-    if (m_activeDecodeThreads.fetch_sub(1) == 1) {
-        // Last decode thread to finish → signal PlaybackDone
-        AVPlayerStatus expected = AVPlayerStatus::EndOfFile;
-        m_status.compare_exchange_strong(expected, AVPlayerStatus::PlaybackDone);
-        qDebug() << "AVCodecHandler: all decode threads done → PlaybackDone";
+    return PipelineStage::again();
+}
+
+PipelineStage::Step AVCodecHandler::finishVideoFilter()
+{
+    if (m_abortRequested)
+        m_videoFilter.reset();
+    clearPresentQueue();
+
+    qDebug() << "AVCodecHandler::videoFilterStep - finished";
+    finishDecodeStage();
+    return PipelineStage::done();
+}
+
+void AVCodecHandler::clearPresentQueue()
+{
+    for (PresentItem &item : m_presentQueue)
+        av_frame_free(&item.frame);
+    m_presentQueue.clear();
+    m_presentPaced = false;
+}
+
+int64_t AVCodecHandler::paceVideoFrame(const AVFrame *frame, AVRational tb)
+{
+    // ── PTS-based sync: pace video frames to audio clock ──
+    if (!m_realtimePacing || !m_audioCodecCtx || !m_frameHandler || frame->pts == AV_NOPTS_VALUE)
+        return 0;
+
+    const double clock = m_frameHandler->audioClock();
+    if (clock <= 0.0)
+        return 0;
+
+    const double diff = frame->pts * av_q2d(tb) - clock;
+    m_lagController.report(diff);
+    if (diff > 0.005) {
+        // Video ahead of audio → hold the frame back
+        const auto us = static_cast<int64_t>(diff * 1e6);
+        return us < 5000000 ? us : 0;   // safety cap 5 s
+    }
+    if (diff < -0.05) {
+        // Video behind >50 ms → drop frame
+        PlayerStats::bump(m_frameHandler->stats().videoLateDrops);
+        return -1;
     }
+    return 0;
 }
 
-void AVCodecHandler::audioDecodeLoop()
+void AVCodecHandler::presentVideoFrame(AVFrame *renderFrame, AVRational tb)
 {
-    m_activeDecodeThreads.fetch_add(1);
-    AVPacket *pkt = nullptr;
-    AVFrame  *frame = av_frame_alloc();
-    if (!frame) { m_activeDecodeThreads.fetch_sub(1); return; }
+    if (!m_frameHandler)
+        return;
 
-    while (!m_abortRequested) {
-        waitIfPaused();
-        if (m_abortRequested) break;
+    m_frameHandler->setVideoTimeBase(tb);
+    {
+        StageTimings::Scope timing(m_stageTimings.get(), StageTimings::Stage::VideoConvert);
+        m_frameHandler->processVideoFrame(renderFrame);
+    }
+    if (m_firstFramePending.load(std::memory_order_relaxed) && m_firstFramePending.exchange(false))
+        noteFirstFrame("first-frame");
+
+    bool expected = true;
+    if (m_logFirstFrameAfterSeek.compare_exchange_strong(expected, false)) {
+        const AVPixelFormat outFmt = static_cast<AVPixelFormat>(renderFrame->format);
+        qDebug() << "Seek first frame -> fmt:" << safePixFmtName(outFmt)
+                 << "hwActive:" << m_hwDecodeActive
+                 << "key:" << bool(renderFrame->flags & AV_FRAME_FLAG_KEY)
+                 << "pts:" << renderFrame->pts;
+    }
+}
 
-        if (!m_audioQueue.pop(&pkt)) break;      // aborted or EOF
+PipelineStage::Step AVCodecHandler::audioDecodeStep()
+{
+    DecodeState &d = m_audioDecode;
+    if (m_abortRequested || !d.frame) return finishAudioDecode();
+    if (m_paused) return PipelineStage::wait();
 
-        int ret = 0;
-        {
-            std::lock_guard lock(m_codecMutex);
-            ret = avcodec_send_packet(m_audioCodecCtx, pkt);
-        }
-        av_packet_free(&pkt);
-        if (ret < 0) continue;
+    // The device buffer had no room for all of the last frame: retry
+    // shortly instead of decoding further ahead.
+    if (m_frameHandler && !m_frameHandler->writePendingAudio())
+        return PipelineStage::again(kAudioRetry);
+    if (d.drained) return finishAudioDecode();
 
-        while (ret >= 0 && !m_abortRequested) {
+    StageTimings *timings = d.flushing ? nullptr : m_stageTimings.get();
+
+    for (;;) {
+        // ── Frames of the last packet (or of the flush) ──
+        while (d.receiving) {
+            int ret = 0;
             {
+                const int64_t t0 = timings ? StageTimings::now() : 0;
                 std::lock_guard lock(m_codecMutex);
-                ret = avcodec_receive_frame(m_audioCodecCtx, frame);
+                ret = avcodec_receive_frame(m_audioCodecCtx, d.frame);
+                if (timings) d.decodeNs += StageTimings::now() - t0;
             }
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
-            if (ret < 0) break;
-
-            if (m_waitKeyFrameAfterSeek.load()) {
-                av_frame_unref(frame);
-                continue;
+            if (ret < 0) {   // EAGAIN: wants the next packet; EOF: drained
+                d.receiving = false;
+                if (d.flushing) {
+                    d.drained = true;   // finish once the last PCM is written
+                    return PipelineStage::again();
+                }
+                if (timings)
+                    timings->record(StageTimings::Stage::AudioDecode, d.decodeNs);
+                return PipelineStage::again();   // one packet per step
             }
 
-            const int64_t seekTargetUs = m_seekTargetUs.load();
-            if (seekTargetUs >= 0 && frame->pts != AV_NOPTS_VALUE) {
-                AVRational tb = m_formatCtx->streams[m_audioStreamIdx]->time_base;
-                const int64_t frameStartUs = av_rescale_q(frame->pts, tb, AVRational{1, AV_TIME_BASE});
-                const int sampleRate = frame->sample_rate > 0 ? frame->sample_rate : m_audioCodecCtx->sample_rate;
-                const int64_t frameDurUs = sampleRate > 0
-                    ? av_rescale_q(frame->nb_samples, AVRational{1, sampleRate}, AVRational{1, AV_TIME_BASE})
-                    : 0;
-                const int64_t frameEndUs = frameStartUs + frameDurUs;
-
-                if (frameEndUs + 100000 < seekTargetUs) {
-                    av_frame_unref(frame);
+            if (!d.flushing) {
+                if (m_waitKeyFrameAfterSeek.load()) {
+                    av_frame_unref(d.frame);
                     continue;
                 }
 
-                int64_t expected = seekTargetUs;
-                m_seekTargetUs.compare_exchange_strong(expected, -1);
-            }
+                const int64_t seekTargetUs = m_seekTargetUs.load();
+                if (seekTargetUs >= 0 && d.frame->pts != AV_NOPTS_VALUE) {
+                    AVFrame *frame = d.frame;
+                    AVRational tb = m_formatCtx->streams[m_audioStreamIdx]->time_base;
+                    const int64_t frameStartUs = av_rescale_q(frame->pts, tb, AVRational{1, AV_TIME_BASE});
+                    const int sampleRate = frame->sample_rate > 0 ? frame->sample_rate : m_audioCodecCtx->sample_rate;
+                    const int64_t frameDurUs = sampleRate > 0
+                        ? av_rescale_q(frame->nb_samples, AVRational{1, sampleRate}, AVRational{1, AV_TIME_BASE})
+                        : 0;
+                    const int64_t frameEndUs = frameStartUs + frameDurUs;
+
+                    if (frameEndUs + 100000 < seekTargetUs) {
+                        av_frame_unref(frame);
+                        continue;
+                    }
 
-            if (m_frameHandler)
-                m_frameHandler->processAudioFrame(frame);
+                    int64_t expected = seekTargetUs;
+                    m_seekTargetUs.compare_exchange_strong(expected, -1);
+                }
+            }
 
-            av_frame_unref(frame);
+            // Never blocks: what the device has no room for waits in the
+            // FrameHandler for the next step.
+            if (m_frameHandler) {
+                StageTimings::Scope timing(timings, StageTimings::Stage::AudioConvert);
+                m_frameHandler->processAudioFrame(d.frame);
+            }
+            av_frame_unref(d.frame);
         }
-    }
 
-    // Flush decoder — skip if abort was requested
-    if (!m_abortRequested) {
-        {
-            std::lock_guard lock(m_codecMutex);
-            avcodec_send_packet(m_audioCodecCtx, nullptr);
-        }
-        while (!m_abortRequested) {
-            int ret = 0;
+        // ── Next packet ──
+        AVPacket *pkt = nullptr;
+        const PacketQueue::TryResult popped = m_audioQueue.tryPop(&pkt);
+        if (popped == PacketQueue::TryResult::WouldBlock) return PipelineStage::wait();
+        if (popped == PacketQueue::TryResult::Closed) {
+            if (m_abortRequested) return finishAudioDecode();
+            // End of input: drain the frames still buffered in the decoder.
             {
                 std::lock_guard lock(m_codecMutex);
-                ret = avcodec_receive_frame(m_audioCodecCtx, frame);
+                avcodec_send_packet(m_audioCodecCtx, nullptr);
             }
-            if (ret != 0) break;
-            if (m_frameHandler)
-                m_frameHandler->processAudioFrame(frame);
-            av_frame_unref(frame);
+            d.flushing  = true;
+            d.receiving = true;
+            timings     = nullptr;
+            continue;
         }
-    }
 
-    qDebug() << "AVCodecHandler::audioDecodeLoop - exiting";
-    av_frame_free(&frame);
-    if (m_activeDecodeThreads.fetch_sub(1) == 1) {
-        // Last decode thread to finish → signal PlaybackDone
-        AVPlayerStatus expected = AVPlayerStatus::EndOfFile;
-        m_status.compare_exchange_strong(expected, AVPlayerStatus::PlaybackDone);
-        qDebug() << "AVCodecHandler: all decode threads done → PlaybackDone";
+        int ret = 0;
+        d.decodeNs = 0;   // codec calls for this packet (timings only)
+        {
+            const int64_t t0 = timings ? StageTimings::now() : 0;
+            std::lock_guard lock(m_codecMutex);
+            ret = avcodec_send_packet(m_audioCodecCtx, pkt);
+            if (timings) d.decodeNs += StageTimings::now() - t0;
+        }
+        av_packet_free(&pkt);
+        if (ret < 0) return PipelineStage::again();
+        d.receiving = true;
     }
 }
 
+PipelineStage::Step AVCodecHandler::finishAudioDecode()
+{
+    DecodeState &d = m_audioDecode;
+    av_frame_free(&d.frame);
+    d = DecodeState{};
+
+    qDebug() << "AVCodecHandler::audioDecodeStep - finished";
+    finishDecodeStage();
+    return PipelineStage::done();
+}
+
 // ── Frame handler ──────────────────────────────────────────
 
 void AVCodecHandler::setFrameHandler(FrameHandler *handler)
@@ -806,8 +1297,12 @@ bool AVCodecHandler::performSeekInternal(int64_t targetTs)
         return false;
     }
 
+    discardStartState();   // primed packets / poster are from the old position
     m_videoQueue.flush();
     m_audioQueue.flush();
+    m_videoFrameQueue.flush();
+    m_videoFilterResetSerial.fetch_add(1);
+    m_lagController.reset();
 
     {
         std::lock_guard lock(m_codecMutex);
@@ -903,8 +1398,11 @@ bool AVCodecHandler::decodePreviewFrameFromCurrentPos()
 
             m_waitKeyFrameAfterSeek = false;
 
-            if (m_frameHandler)
+            // Shown unfiltered: the filter graph belongs to the filter stage.
+            if (m_frameHandler) {
+                m_frameHandler->setVideoTimeBase(m_formatCtx->streams[m_videoStreamIdx]->time_base);
                 m_frameHandler->processVideoFrame(renderFrame);
+            }
 
             if (swFrame) {
                 av_frame_free(&swFrame);
@@ -927,12 +1425,42 @@ bool AVCodecHandler::decodePreviewFrameFromCurrentPos()
 
 bool AVCodecHandler::openCodec(int streamIndex, AVCodecContext **outCtx)
 {
-    AVCodecParameters *par = m_formatCtx->streams[streamIndex]->codecpar;
+    const AVStream *stream = m_formatCtx->streams[streamIndex];
+    AVCodecParameters *par = stream->codecpar;
     const AVCodec *codec = avcodec_find_decoder(par->codec_id);
     if (!codec) {
         return false;
     }
 
+    const bool isVideo = streamIndex == m_videoStreamIdx;
+    CodecContextCache::Key &key = isVideo ? m_videoCtxKey : m_audioCtxKey;
+    bool &cacheable = isVideo ? m_videoCtxCacheable : m_audioCtxCacheable;
+    cacheable = false;
+
+    // Software decoders with the same parameters as a recently closed one
+    // (same camera, same settings) take over its opened context.
+    if (!isVideo || m_decodeBackend == VideoDecodeBackend::Software) {
+        key = CodecContextCache::Key::fromParameters(par);
+        if (isVideo) {
+            m_hwDecodeActive = false;
+            m_hwPixFmt = AV_PIX_FMT_NONE;
+            const DecoderThreadingPolicy::Choice threading = DecoderThreadingPolicy::choose(
+                codec, par->width, par->height, false, m_decodeThreads, m_decodeThreadType,
+                sharingPlayers());
+            key.threadCount = threading.threadCount;
+            key.threadType  = threading.threadType;
+        }
+        cacheable = true;
+
+        if (AVCodecContext *warm = CodecContextCache::instance().acquire(key)) {
+            warm->pkt_timebase = stream->time_base;
+            qDebug() << "AVCodecHandler::openCodec - reusing"
+                     << (isVideo ? "video" : "audio") << "decoder" << codec->name;
+            *outCtx = warm;
+            return true;
+        }
+    }
+
     AVCodecContext *ctx = avcodec_alloc_context3(codec);
     if (!ctx) {
         return false;
@@ -942,8 +1470,9 @@ bool AVCodecHandler::openCodec(int streamIndex, AVCodecContext **outCtx)
         avcodec_free_context(&ctx);
         return false;
     }
+    ctx->pkt_timebase = stream->time_base;
 
-    if (streamIndex == m_videoStreamIdx) {
+    if (isVideo) {
         m_hwDecodeActive = false;
         m_hwPixFmt = AV_PIX_FMT_NONE;
 
@@ -959,6 +1488,11 @@ bool AVCodecHandler::openCodec(int streamIndex, AVCodecContext **outCtx)
                 m_decodeRuntimeStatus = "Software(Fallback)";
             }
         }
+
+        const DecoderThreadingPolicy::Choice threading = DecoderThreadingPolicy::choose(
+            codec, ctx->width, ctx->height, m_hwDecodeActive, m_decodeThreads, m_decodeThreadType,
+            sharingPlayers());
+        DecoderThreadingPolicy::apply(ctx, threading);
     }
 
     if (avcodec_open2(ctx, codec, nullptr) < 0) {
@@ -966,10 +1500,35 @@ bool AVCodecHandler::openCodec(int streamIndex, AVCodecContext **outCtx)
         return false;
     }
 
+    if (isVideo) {
+        // thread_count is resolved by avcodec_open2() when it was 0 (auto).
+        qDebug() << "Video decode threading:" << ctx->thread_count
+                 << DecoderThreadingPolicy::threadTypeName(ctx->active_thread_type)
+                 << "codec:" << codec->name << ctx->width << "x" << ctx->height
+                 << "players:" << sharingPlayers();
+    }
+
     *outCtx = ctx;
     return true;
 }
 
+int AVCodecHandler::sharingPlayers() const
+{
+    const bool counted = m_registeredPlayer || m_replacesPlayer;
+    return std::max(1, DecoderThreadingPolicy::activePlayers() + (counted ? 0 : 1));
+}
+
+void AVCodecHandler::releaseCodec(AVCodecContext **ctx, bool cacheable, const CodecContextCache::Key &key)
+{
+    if (!*ctx) return;
+    if (cacheable) {
+        CodecContextCache::instance().release(key, *ctx);
+        *ctx = nullptr;
+    } else {
+        avcodec_free_context(ctx);
+    }
+}
+
 bool AVCodecHandler::trySetupHardwareDecode(const AVCodec *codec, AVCodecContext *ctx)
 {
     if (!codec || !ctx) return false;
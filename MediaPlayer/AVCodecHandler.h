@@ -3,13 +3,25 @@
 #include <QObject>
 #include <QString>
 #include <QSize>
-#include <thread>
+#include <QVariantMap>
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <mutex>
-#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include "AVPlayerStatus.h"
 #include "PacketQueue.h"
+#include "FrameQueue.h"
+#include "VideoFilterGraph.h"
+#include "DecodeLagController.h"
+#include "PipelineExecutor.h"
+#include "PipelineStage.h"
+#include "StartupTimeline.h"
+#include "StageTimings.h"
+#include "CodecContextCache.h"
 
 class FrameHandler;
 
@@ -21,8 +33,8 @@ extern "C" {
 #include <libavutil/hwcontext.h>
 }
 
-/// @brief Manages FFmpeg demuxing + codec context + decode threads for a single
-///        media file.  NOT a QML_ELEMENT — used internally by PlayerWindowManager.
+/// @brief Manages FFmpeg demuxing + codec context + decode stages for a single
+///        media file.  The stages run on the shared PipelineExecutor.  NOT a QML_ELEMENT — used internally by PlayerWindowManager.
 class AVCodecHandler
 {
 public:
@@ -47,17 +59,45 @@ public:
 
     bool isOpen() const;
 
+    // ── Cancellation ──
+    /// Polled while open() runs, both between its steps and from FFmpeg's
+    /// AVIOInterruptCB during blocking I/O; returning true abandons the
+    /// open.  Must be set before open() is called.
+    using InterruptCheck = std::function<bool()>;
+    void setInterruptCheck(InterruptCheck check);
+
+    // ── Startup timing ──
+    /// Timeline the open / first play() phases are marked on; the first
+    /// picture also lands in PlayerStats::ttffMs.  Set before open().
+    void setStartupTimeline(std::shared_ptr<StartupTimeline> timeline);
+
+    /// Position (seconds) open() seeks to before decoding the poster, so
+    /// play() starts there without another seek.  0 = the beginning.  Set
+    /// before open(); lands on the keyframe at or before it.
+    void setStartPosition(double seconds);
+
+    // ── Benchmarking ──
+    /// Per-stage latency samples (see StageTimings), nullptr = off.  Set
+    /// while no playback is running.
+    void setStageTimings(std::shared_ptr<StageTimings> timings);
+
+    /// With pacing off, video frames are handed over as soon as they are
+    /// decoded instead of being held back (or dropped) against the audio
+    /// clock, so the pipeline runs as fast as it can.  On by default; set
+    /// while no playback is running.
+    void setRealtimePacing(bool enabled);
+
     // ── Playback control ──
-    /// Allocate queues / threads and begin playback.
+    /// Reset the queues, submit the pipeline stages and begin playback.
     void play();
 
-    /// Pause playback (threads stay alive but block on a condition variable).
+    /// Pause playback (the stages park until resume()).
     void pause();
 
     /// Resume from paused state.
     void resume();
 
-    /// Stop playback: abort queues, join threads, flush state.
+    /// Stop playback: abort queues, wait for the stages, flush state.
     void stop();
 
     /// Seek to the given timestamp (seconds).
@@ -67,10 +107,36 @@ public:
     // ── Decode backend options ──
     void setDecodeBackend(VideoDecodeBackend backend);
     void setAllowHwFallback(bool allow);
+    /// Decoder threading override; @p threads 0 = DecoderThreadingPolicy
+    /// table.  Applied on the next open().
+    void setDecodeThreading(int threads, DecodeThreadType type);
+    /// The next open() takes the place of a handler that is already counted
+    /// in DecoderThreadingPolicy (re-open, next playlist item), so the
+    /// decoder is sized for the players there are, not one more.
+    void setReplacesPlayer(bool replaces);
+    /// Count this handler as a playing decoder.  Called by the owner once
+    /// the handler is swapped in; close() undoes it.
+    void registerPlayer();
+    bool isRegisteredPlayer() const;
     QString decodeRuntimeStatus() const;
 
+    // ── Video post-processing ──
+    /// libavfilter description (ffmpeg -vf syntax), empty = none.
+    /// Thread-safe; applied on the next frame.
+    void setVideoFilter(const QString &description);
+    /// Deinterlacing policy.  Thread-safe; applied on the next frame.
+    void setDeinterlaceMode(DeinterlaceMode mode);
+    /// Per-filter timing, see VideoFilterGraph::stats().
+    QVariantMap videoFilterStats() const;
+    void resetVideoFilterStats();
+
     AVPlayerStatus status() const;
 
+    /// Called on the last decode stage once the whole file has been handed
+    /// to the FrameHandler (status becomes PlaybackDone).  Runs on an
+    /// executor worker; set while no playback is running.
+    void setPlaybackDoneCallback(std::function<void()> callback);
+
     // ── Stream metadata (valid after open()) ──
     int videoStreamIndex() const;
     int audioStreamIndex() const;
@@ -110,24 +176,86 @@ public:
     AVCodecContext  *audioCodecContext() const;
 
 private:
+    enum class OpenResult { Failed, Opened, NeedsFullProbe };
+
+    /// One open pass.  With @p trustHeaders the stream parameters from the
+    /// container header are used as-is when they look complete, skipping
+    /// avformat_find_stream_info(); NeedsFullProbe asks for a second pass
+    /// when the decoders could not fill in what the header left out.
+    OpenResult openAttempt(bool trustHeaders);
+    /// True when the header already gave every audio / video stream its
+    /// codec, size / sample rate and the file a duration.
+    bool headerParamsComplete() const;
+    /// Decode the first video keyframe into m_posterFrame.  Every packet
+    /// read on the way is kept in m_primedPackets for play().
+    bool decodePoster();
+    void discardStartState();
+    void markStartup(const char *phase);
+    void noteFirstFrame(const char *phase);
+
     bool openCodec(int streamIndex, AVCodecContext **outCtx);
+    /// Decoders the one being opened shares the machine with, itself included.
+    int  sharingPlayers() const;
+    void releaseCodec(AVCodecContext **ctx, bool cacheable, const CodecContextCache::Key &key);
     bool performSeekInternal(int64_t targetTs);
     bool decodePreviewFrameFromCurrentPos();
     bool trySetupHardwareDecode(const AVCodec *codec, AVCodecContext *ctx);
     static enum AVPixelFormat getHardwareFormat(AVCodecContext *ctx, const enum AVPixelFormat *pix_fmts);
-
-    // ── Thread entry points (run on worker threads) ──
-    void demuxLoop();        ///< Read packets from container → push into queues
-    void videoDecodeLoop();  ///< Pop video packets → decode → produce AVFrame
-    void audioDecodeLoop();  ///< Pop audio packets → decode → produce PCM
-
-    // ── Thread helpers ──
-    void startThreads();
-    void joinThreads();
-
-    // ── Pause support ──
-    /// Call in each loop iteration; blocks while m_paused is true.
-    void waitIfPaused();
+    /// AVIOInterruptCB entry point; @p opaque is the AVCodecHandler.
+    static int interruptCallback(void *opaque);
+    bool openInterrupted() const;
+
+    // ── Pipeline stages (PipelineStage steps on the shared executor) ──
+    /// Each step does a bounded amount of work and returns; a stage whose
+    /// queue is empty or full, or that is paused, parks until woken.
+    PipelineStage::Step demuxStep();        ///< Read packets from container → push into queues
+    PipelineStage::Step videoDecodeStep();  ///< Pop video packets → decode → queue AVFrame
+    PipelineStage::Step videoFilterStep();  ///< Pop video frames → filter → pace → present
+    PipelineStage::Step audioDecodeStep();  ///< Pop audio packets → decode → produce PCM
+
+    PipelineStage::Step finishDemux();
+    PipelineStage::Step finishVideoDecode();
+    PipelineStage::Step finishVideoFilter();
+    PipelineStage::Step finishAudioDecode();
+
+    /// Decoder state a decode stage keeps between its steps.
+    struct DecodeState {
+        AVFrame *frame        = nullptr;   ///< avcodec_receive_frame() target
+        AVFrame *pending      = nullptr;   ///< decoded, waiting for room downstream
+        bool     receiving    = false;     ///< a packet was sent, frames may follow
+        bool     flushing     = false;     ///< end of input: null packet sent
+        bool     drained      = false;     ///< the flush returned every frame
+        int64_t  decodeNs     = 0;         ///< codec time for the current packet
+        int      appliedLevel = -1;        ///< lag controller level on the codec
+    };
+
+    /// Hardware transfer plus, with @p gate, the seek keyframe / target
+    /// checks for a frame just received into @p frame.  Returns a frame the
+    /// caller owns, or nullptr when it is not shown; @p frame is unref'd.
+    AVFrame *takeVideoFrame(AVFrame *frame, bool gate);
+
+    /// A/V sync for @p frame (pts in @p tb): 0 = present now, -1 = drop it
+    /// (late), otherwise microseconds to hold it back.  Reports the lag.
+    int64_t paceVideoFrame(const AVFrame *frame, AVRational tb);
+
+    /// Hand @p frame (pts in @p tb) to the FrameHandler.  Runs on the video
+    /// filter stage once paceVideoFrame() let it through.
+    void presentVideoFrame(AVFrame *frame, AVRational tb);
+    void clearPresentQueue();
+
+    // ── Stage helpers ──
+    /// Start the stages for the open streams on the shared executor.
+    void startPipeline();
+    /// Block until every stage of the current run has returned.
+    void joinPipeline();
+    /// Resume every parked stage (pause / abort changed).
+    void wakeStages();
+    /// End of a decode stage: the last one out moves EndOfFile → PlaybackDone.
+    void finishDecodeStage();
+
+    static constexpr int kDemuxPacketsPerStep = 16;
+    static constexpr std::chrono::milliseconds kAudioRetry{5};     ///< device buffer full
+    static constexpr std::chrono::milliseconds kPacingSlice{10};   ///< longest pacing delay per step
 
     // ── Members: file / codec ──
     QString m_filePath;
@@ -137,26 +265,85 @@ private:
     int m_videoStreamIdx = -1;
     int m_audioStreamIdx = -1;
 
+    // ── Members: decoder reuse ──
+    /// Keys the contexts above go back to CodecContextCache under on
+    /// close(); a context without a key (hardware decode) is freed.
+    CodecContextCache::Key m_videoCtxKey;
+    CodecContextCache::Key m_audioCtxKey;
+    bool m_videoCtxCacheable = false;
+    bool m_audioCtxCacheable = false;
+
+    // ── Members: pipeline stages ──
+    // Declared before the queues, whose ready callbacks wake them.
+    PipelineStage m_demuxStage{PipelineExecutor::Lane::Demux};
+    PipelineStage m_videoDecodeStage{PipelineExecutor::Lane::Video};
+    PipelineStage m_videoFilterStage{PipelineExecutor::Lane::Video};
+    PipelineStage m_audioStage{PipelineExecutor::Lane::Audio};
+
     // ── Members: packet queues ──
     PacketQueue m_videoQueue{128};
     PacketQueue m_audioQueue{64};
-
-    // ── Members: threads ──
-    std::thread m_demuxThread;
-    std::thread m_videoDecodeThread;
-    std::thread m_audioDecodeThread;
+    FrameQueue  m_videoFrameQueue{4};   ///< decoded frames → filter stage
+
+    // ── Members: stage state (touched only by the stage's steps) ──
+    AVPacket   *m_demuxPacket        = nullptr;
+    bool        m_demuxPacketPending = false;   ///< read, waiting for room in its queue
+    DecodeState m_videoDecode;
+    DecodeState m_audioDecode;
+
+    struct PresentItem {
+        AVFrame   *frame = nullptr;
+        AVRational tb{0, 1};
+    };
+    std::deque<PresentItem> m_presentQueue;      ///< filter output waiting for its time
+    std::chrono::steady_clock::time_point m_presentDeadline;
+    bool        m_presentPaced      = false;     ///< m_presentDeadline is for the head frame
+    bool        m_filterInputDone   = false;     ///< frame queue drained, filters flushed
+    uint32_t    m_filterResetSerial = 0;
+    VideoFilterGraph::Output m_presentOutput;    ///< queues filter output on m_presentQueue
+
+    // ── Members: pipeline ──
+    PipelineExecutor::TaskGroup m_pipelineTasks;   ///< stages of the current run
+    std::function<void()>       m_playbackDoneCallback;
 
     // ── Members: state ──
     std::atomic<AVPlayerStatus> m_status{AVPlayerStatus::Stopped};
     std::atomic<bool> m_abortRequested{false};
-    std::atomic<int>  m_activeDecodeThreads{0}; ///< counts running decode threads
+    std::atomic<int>  m_activeDecodeThreads{0}; ///< counts running decode stages
     std::atomic<int64_t> m_seekTargetUs{-1};    ///< pending seek target (microseconds), -1 when inactive
     std::atomic<bool> m_waitKeyFrameAfterSeek{false};
     std::atomic<bool> m_logFirstFrameAfterSeek{false};
 
+    // ── Members: open cancellation ──
+    InterruptCheck    m_interruptCheck;
+    std::atomic<bool> m_opening{false};   ///< interrupt check only applies inside open()
+
+    // ── Members: startup ──
+    std::shared_ptr<StartupTimeline> m_startup;
+    std::atomic<bool>      m_firstFramePending{false};
+    AVFrame               *m_posterFrame = nullptr;   ///< first keyframe, shown by play()
+    std::vector<AVPacket*> m_primedPackets;           ///< packets read by decodePoster()
+    bool                   m_atStreamStart = false;   ///< demuxer at the open position, bar primed packets
+    int64_t                m_startPositionUs = 0;     ///< setStartPosition(), AV_TIME_BASE units
+
+    // ── Members: benchmarking ──
+    std::shared_ptr<StageTimings> m_stageTimings;
+    bool                   m_realtimePacing = true;
+
+    // ── Video post-processing ──
+    VideoFilterGraph      m_videoFilter;
+    std::atomic<uint32_t> m_videoFilterResetSerial{0};   ///< bumped by seeks
+
+    // ── Graceful degradation when video lags the audio clock ──
+    DecodeLagController   m_lagController;
+
     // ── Decode backend options ──
     VideoDecodeBackend m_decodeBackend = VideoDecodeBackend::Software;
     bool               m_allowHwFallback = true;
+    int                m_decodeThreads = 0;
+    DecodeThreadType   m_decodeThreadType = DecodeThreadType::Auto;
+    bool               m_registeredPlayer = false;   ///< counted in DecoderThreadingPolicy
+    bool               m_replacesPlayer = false;     ///< see setReplacesPlayer()
 
     // ── Hardware decode state ──
     AVBufferRef       *m_hwDeviceCtx = nullptr;
@@ -171,8 +358,6 @@ private:
     std::mutex              m_codecMutex;       ///< guards avcodec send/receive/flush operations
     std::mutex              m_formatMutex;      ///< guards avformat read/seek operations
 
-    // ── Members: pause mechanism ──
-    std::mutex              m_pauseMutex;
-    std::condition_variable m_pauseCond;
-    bool                    m_paused = false;
+    // ── Members: pause ──
+    std::atomic<bool>       m_paused{false};   ///< stages park while set
 };
@@ -36,3 +36,24 @@ enum class SwsFilterMode : uint8_t {
     Bicubic,        ///< Bicubic – sharper, moderate cost
     Lanczos,        ///< Lanczos – highest quality, highest cost
 };
+
+/// @brief HDR (PQ / HLG) → SDR tone-mapping curve.
+enum class ToneMapper : uint8_t {
+    Off,            ///< Show the HDR signal as-is – washed out on SDR displays
+    Hable,          ///< Hable filmic curve – punchy, compresses highlights early
+    Bt2390,         ///< ITU-R BT.2390 EETF – preserves mid-tones, default
+};
+
+/// @brief Deinterlacing policy (bwdif, one output frame per field).
+enum class DeinterlaceMode : uint8_t {
+    Off,            ///< Present frames as decoded
+    Auto,           ///< Deinterlace once the stream flags an interlaced frame – default
+    Force,          ///< Deinterlace every frame (streams with missing field flags)
+};
+
+/// @brief Decoder threading model override (see DecoderThreadingPolicy).
+enum class DecodeThreadType : uint8_t {
+    Auto,           ///< Per-codec tuning table – default
+    Frame,          ///< Frame threading – best throughput, adds thread_count frames of latency
+    Slice,          ///< Slice threading – no extra latency, scales with slices per frame
+};
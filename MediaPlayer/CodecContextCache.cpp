@@ -0,0 +1,121 @@
+#include "CodecContextCache.h"
+
+CodecContextCache::Key CodecContextCache::Key::fromParameters(const AVCodecParameters *par)
+{
+    Key key;
+    key.type           = par->codec_type;
+    key.codecId        = par->codec_id;
+    key.profile        = par->profile;
+    key.level          = par->level;
+    key.format         = par->format;
+    key.width          = par->width;
+    key.height         = par->height;
+    key.sampleAspect   = par->sample_aspect_ratio;
+    key.fieldOrder     = par->field_order;
+    key.colorSpace     = par->color_space;
+    key.colorRange     = par->color_range;
+    key.colorPrimaries = par->color_primaries;
+    key.colorTrc       = par->color_trc;
+    key.sampleRate     = par->sample_rate;
+    key.channels       = par->ch_layout.nb_channels;
+    if (par->ch_layout.order == AV_CHANNEL_ORDER_NATIVE)
+        key.channelMask = par->ch_layout.u.mask;
+    if (par->extradata && par->extradata_size > 0)
+        key.extradata.assign(par->extradata, par->extradata + par->extradata_size);
+    return key;
+}
+
+bool CodecContextCache::Key::operator==(const Key &other) const
+{
+    return type           == other.type
+        && codecId        == other.codecId
+        && profile        == other.profile
+        && level          == other.level
+        && format         == other.format
+        && width          == other.width
+        && height         == other.height
+        && av_cmp_q(sampleAspect, other.sampleAspect) == 0
+        && fieldOrder     == other.fieldOrder
+        && colorSpace     == other.colorSpace
+        && colorRange     == other.colorRange
+        && colorPrimaries == other.colorPrimaries
+        && colorTrc       == other.colorTrc
+        && sampleRate     == other.sampleRate
+        && channels       == other.channels
+        && channelMask    == other.channelMask
+        && threadCount    == other.threadCount
+        && threadType     == other.threadType
+        && extradata      == other.extradata;
+}
+
+CodecContextCache &CodecContextCache::instance()
+{
+    static CodecContextCache cache;
+    return cache;
+}
+
+CodecContextCache::~CodecContextCache()
+{
+    clear();
+}
+
+AVCodecContext *CodecContextCache::acquire(const Key &key)
+{
+    std::lock_guard lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            AVCodecContext *ctx = it->ctx;
+            m_entries.erase(it);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return ctx;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void CodecContextCache::release(const Key &key, AVCodecContext *ctx)
+{
+    if (!ctx) return;
+
+    // Back to the state of a freshly opened decoder: no buffered frames or
+    // references, no frame skipping left over from DecodeLagController.
+    avcodec_flush_buffers(ctx);
+    ctx->skip_frame       = AVDISCARD_DEFAULT;
+    ctx->skip_idct        = AVDISCARD_DEFAULT;
+    ctx->skip_loop_filter = AVDISCARD_DEFAULT;
+
+    std::vector<AVCodecContext *> evicted;
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->key.type == key.type) {
+                evicted.push_back(it->ctx);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_entries.push_front(Entry{key, ctx});
+    }
+    // Freeing joins the decoder's threads; keep that outside the lock.
+    for (AVCodecContext *old : evicted)
+        avcodec_free_context(&old);
+}
+
+void CodecContextCache::clear()
+{
+    std::list<Entry> entries;
+    {
+        std::lock_guard lock(m_mutex);
+        entries.swap(m_entries);
+    }
+    for (Entry &e : entries)
+        avcodec_free_context(&e.ctx);
+}
+
+size_t CodecContextCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <vector>
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/// @brief Process-wide cache of opened, idle decoder contexts keyed by the
+///        stream's codec parameters.
+///
+/// Playlists of clips from one camera share codec, size, format and
+/// extradata, yet every open() used to pay avcodec_alloc_context3() +
+/// avcodec_open2() (and the decoder's thread pool spin-up) again.
+/// AVCodecHandler hands its contexts back here on close(); the cache
+/// flushes them and gives them out again to the next stream with an equal
+/// key.  Contexts out of the cache are owned by the caller until released.
+///
+/// A decoder context holds its thread pool and reference frames, so only
+/// the last released context of each media type is kept: enough to carry
+/// it from one playlist item to the one after the next (the next is
+/// pre-opened while the current still decodes).  PlayerWindowManager
+/// clears the cache when the media is closed.
+///
+/// Only software decoders are cached: a hardware context carries the
+/// owning handler in ctx->opaque and its hw device reference.
+/// Thread-safe.
+class CodecContextCache
+{
+public:
+    struct Key {
+        AVMediaType     type      = AVMEDIA_TYPE_UNKNOWN;
+        AVCodecID       codecId   = AV_CODEC_ID_NONE;
+        int             profile   = 0;
+        int             level     = 0;
+        int             format    = -1;
+        int             width     = 0;
+        int             height    = 0;
+        AVRational      sampleAspect{0, 1};
+        AVFieldOrder    fieldOrder = AV_FIELD_UNKNOWN;
+        AVColorSpace    colorSpace = AVCOL_SPC_UNSPECIFIED;
+        AVColorRange    colorRange = AVCOL_RANGE_UNSPECIFIED;
+        AVColorPrimaries colorPrimaries = AVCOL_PRI_UNSPECIFIED;
+        AVColorTransferCharacteristic colorTrc = AVCOL_TRC_UNSPECIFIED;
+        int             sampleRate = 0;
+        int             channels   = 0;
+        uint64_t        channelMask = 0;   ///< native-order layouts only
+        /// Requested, before avcodec_open2().  Depends on the number of
+        /// players; an open that replaces a playing handler sizes itself for
+        /// the same count, so consecutive playlist items agree.
+        int             threadCount = 0;
+        int             threadType  = 0;
+        std::vector<uint8_t> extradata;
+
+        static Key fromParameters(const AVCodecParameters *par);
+
+        bool operator==(const Key &other) const;
+    };
+
+    static CodecContextCache &instance();
+
+    ~CodecContextCache();
+
+    CodecContextCache(const CodecContextCache &) = delete;
+    CodecContextCache &operator=(const CodecContextCache &) = delete;
+
+    /// Take an idle context opened for @p key, or nullptr on a miss.
+    AVCodecContext *acquire(const Key &key);
+
+    /// Flush @p ctx and keep it for the next acquire() with @p key.  An
+    /// idle context of the same media type already held is freed.
+    void release(const Key &key, AVCodecContext *ctx);
+
+    void clear();
+
+    size_t   size() const;
+    uint64_t hits() const   { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    CodecContextCache() = default;
+
+    struct Entry {
+        Key             key;
+        AVCodecContext *ctx = nullptr;
+    };
+
+    mutable std::mutex m_mutex;
+    std::list<Entry>  m_entries;   ///< front = most recently released
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
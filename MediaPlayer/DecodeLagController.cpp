@@ -0,0 +1,76 @@
+#include "DecodeLagController.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+int64_t steadyNowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+}
+
+void DecodeLagController::report(double lagSeconds)
+{
+    const int64_t now = steadyNowMs();
+    if (m_resetPending.exchange(false, std::memory_order_relaxed)) {
+        m_lagEma       = 0.0;
+        m_lastChangeMs = now;
+    }
+
+    // Only lateness matters; early frames are simply waited for.
+    const double behind = std::max(0.0, -lagSeconds);
+    m_lagEma += kSmoothing * (behind - m_lagEma);
+
+    const int cur = level();
+    const int64_t held = now - m_lastChangeMs;
+    int next = cur;
+    if (m_lagEma > kEscalateSec && held >= kEscalateHoldMs && cur < DropNonRefPackets)
+        next = cur + 1;
+    else if (m_lagEma < kRelaxSec && held >= kRelaxHoldMs && cur > Full)
+        next = cur - 1;
+
+    if (next != cur) {
+        m_level.store(next, std::memory_order_relaxed);
+        m_lastChangeMs = now;
+        qDebug() << "DecodeLagController:" << levelName(cur) << "->" << levelName(next)
+                 << "lag" << static_cast<int>(m_lagEma * 1000.0) << "ms";
+    }
+}
+
+void DecodeLagController::reset()
+{
+    m_level.store(Full, std::memory_order_relaxed);
+    m_resetPending.store(true, std::memory_order_relaxed);
+}
+
+void DecodeLagController::apply(AVCodecContext *ctx, int level)
+{
+    if (!ctx) return;
+    ctx->skip_loop_filter = level >= SkipLoopFilter   ? AVDISCARD_ALL    : AVDISCARD_DEFAULT;
+    ctx->skip_idct        = level >= SkipIdct         ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+    ctx->skip_frame       = level >= SkipNonRefFrames ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+}
+
+bool DecodeLagController::canDropPacket(const AVPacket *pkt, int level)
+{
+    // Disposable = nothing else references it (set by demuxers / parsers
+    // that know, e.g. MP4 sdtp).  Keyframes are never dropped.
+    return level >= DropNonRefPackets
+           && (pkt->flags & AV_PKT_FLAG_DISPOSABLE)
+           && !(pkt->flags & AV_PKT_FLAG_KEY);
+}
+
+const char *DecodeLagController::levelName(int level)
+{
+    switch (level) {
+    case Full:              return "full";
+    case SkipLoopFilter:    return "skip-loop-filter";
+    case SkipIdct:          return "skip-idct";
+    case SkipNonRefFrames:  return "skip-nonref-frames";
+    case DropNonRefPackets: return "drop-nonref-packets";
+    default:                return "?";
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/// @brief Trades video decode quality for speed while video lags the audio
+///        clock, and gives it back once playback has caught up.
+///
+/// Dropping a late frame at presentation wastes the whole decode, and on a
+/// slow CPU the backlog keeps growing.  The controller smooths the lateness
+/// reported for every frame and escalates one level at a time:
+///
+///   1. skip_loop_filter = AVDISCARD_ALL     (no deblocking)
+///   2. + skip_idct      = AVDISCARD_NONREF  (cheap reconstruction of B-frames)
+///   3. + skip_frame     = AVDISCARD_NONREF  (B-frames are not decoded at all)
+///   4. + non-reference packets are dropped before avcodec_send_packet()
+///
+/// Escalation needs the smoothed lag above kEscalateSec and at least
+/// kEscalateHoldMs since the last change.  De-escalation needs it below
+/// kRelaxSec for kRelaxHoldMs, so the level does not oscillate.
+///
+/// report() runs on the thread that paces video; level() / apply() on the
+/// decode thread; reset() from any thread.
+class DecodeLagController
+{
+public:
+    enum Level : int {
+        Full = 0,
+        SkipLoopFilter,
+        SkipIdct,
+        SkipNonRefFrames,
+        DropNonRefPackets,
+    };
+
+    /// Feed the lateness of one frame: video pts − audio clock in seconds
+    /// (negative = video behind).
+    void report(double lagSeconds);
+
+    /// Back to full quality (seek, new file).  Takes effect immediately.
+    void reset();
+
+    int level() const { return m_level.load(std::memory_order_relaxed); }
+
+    /// Configure @p ctx for @p level.  Call between packets, under the codec lock.
+    static void apply(AVCodecContext *ctx, int level);
+
+    /// True if @p pkt may be skipped at @p level without breaking references.
+    static bool canDropPacket(const AVPacket *pkt, int level);
+
+    static const char *levelName(int level);
+
+private:
+    static constexpr double  kEscalateSec    = 0.050;
+    static constexpr double  kRelaxSec       = 0.015;
+    static constexpr int64_t kEscalateHoldMs = 500;
+    static constexpr int64_t kRelaxHoldMs    = 2000;
+    static constexpr double  kSmoothing      = 0.1;   ///< EMA weight of a new sample
+
+    std::atomic<int>  m_level{Full};
+    std::atomic<bool> m_resetPending{false};
+
+    // report() thread only
+    double  m_lagEma       = 0.0;
+    int64_t m_lastChangeMs = 0;
+};
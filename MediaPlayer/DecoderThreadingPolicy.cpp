@@ -0,0 +1,171 @@
+#include "DecoderThreadingPolicy.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+/// One row of the tuning table.  Rows for a codec are ordered from the
+/// largest resolution down; the first row whose pixel count the stream
+/// reaches wins.
+struct TuningRow {
+    AVCodecID codec;
+    int       minPixels;
+    int       threadType;
+    int       threads;
+};
+
+constexpr int k2160p = 3840 * 2160;
+constexpr int k1080p = 1920 * 1080;
+constexpr int k720p  = 1280 * 720;
+
+// Starting points, not measurements: counts grow with resolution and stop
+// at 12, past which frame threads mostly add latency and memory.  Tune
+// them with zqt_bench --threads.  H.264 / HEVC / VP9 / AV1
+// scale with frame threads (slices are rarely used by encoders); MPEG-2
+// always has one slice per macroblock row so slice threading scales
+// without frame latency.
+constexpr TuningRow kTuningTable[] = {
+    { AV_CODEC_ID_H264,       k2160p, FF_THREAD_FRAME, 12 },
+    { AV_CODEC_ID_H264,       k1080p, FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_H264,       k720p,  FF_THREAD_FRAME,  6 },
+    { AV_CODEC_ID_H264,       0,      FF_THREAD_FRAME,  4 },
+
+    { AV_CODEC_ID_HEVC,       k2160p, FF_THREAD_FRAME, 12 },
+    { AV_CODEC_ID_HEVC,       k1080p, FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_HEVC,       0,      FF_THREAD_FRAME,  4 },
+
+    { AV_CODEC_ID_VP9,        k2160p, FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_VP9,        k1080p, FF_THREAD_FRAME,  6 },
+    { AV_CODEC_ID_VP9,        0,      FF_THREAD_FRAME,  4 },
+
+    { AV_CODEC_ID_AV1,        k2160p, FF_THREAD_FRAME, 12 },
+    { AV_CODEC_ID_AV1,        k1080p, FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_AV1,        0,      FF_THREAD_FRAME,  4 },
+
+    { AV_CODEC_ID_MPEG2VIDEO, k1080p, FF_THREAD_SLICE,  8 },
+    { AV_CODEC_ID_MPEG2VIDEO, 0,      FF_THREAD_SLICE,  4 },
+
+    { AV_CODEC_ID_MPEG4,      0,      FF_THREAD_FRAME,  4 },
+
+    // Intra-only: every frame is independent, frame threads are free.
+    { AV_CODEC_ID_PRORES,     k1080p, FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_PRORES,     0,      FF_THREAD_FRAME,  4 },
+    { AV_CODEC_ID_DNXHD,      0,      FF_THREAD_FRAME,  8 },
+    { AV_CODEC_ID_MJPEG,      0,      FF_THREAD_FRAME,  4 },
+};
+}
+
+std::atomic<int> DecoderThreadingPolicy::s_activePlayers{0};
+std::atomic<int> DecoderThreadingPolicy::s_playingPlayers{0};
+
+DecoderThreadingPolicy::Choice DecoderThreadingPolicy::choose(const AVCodec *codec, int width, int height,
+                                                              bool hwAccel, int overrideThreads,
+                                                              DecodeThreadType overrideType,
+                                                              int players)
+{
+    Choice choice;
+    if (!codec)
+        return choice;
+
+    // ── Table ──
+    const int pixels = width * height;
+    for (const TuningRow &row : kTuningTable) {
+        if (row.codec == codec->id && pixels >= row.minPixels) {
+            choice.threadCount = row.threads;
+            choice.threadType  = row.threadType;
+            choice.source      = "table";
+            break;
+        }
+    }
+
+    // The GPU decodes; extra frame threads only hold more surfaces.
+    if (hwAccel) {
+        choice.threadCount = 1;
+        choice.threadType  = FF_THREAD_FRAME;
+        choice.source      = "hwaccel";
+    }
+
+    // ── Overrides ──
+    if (overrideThreads > 0) {
+        choice.threadCount = overrideThreads;
+        choice.source      = "override";
+    }
+    if (overrideType == DecodeThreadType::Frame) {
+        choice.threadType = FF_THREAD_FRAME;
+        choice.source     = "override";
+    } else if (overrideType == DecodeThreadType::Slice) {
+        choice.threadType = FF_THREAD_SLICE;
+        choice.source     = "override";
+    }
+
+    // ── Share the machine between concurrent players ──
+    // An explicit thread count is taken as-is.  0 (codecs without a table
+    // row) would let FFmpeg size the decoder for every core, so it is
+    // resolved to the core count and capped like the rest.
+    if (overrideThreads <= 0 && choice.threadCount != 1) {
+        const int cores   = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        const int wanted  = choice.threadCount > 0 ? choice.threadCount : cores;
+        choice.threadCount = std::min(wanted, coresPerPlayer(players));
+    }
+
+    // ── What the decoder can actually do ──
+    const bool canFrame = codec->capabilities & AV_CODEC_CAP_FRAME_THREADS;
+    const bool canSlice = codec->capabilities & AV_CODEC_CAP_SLICE_THREADS;
+    if (choice.threadType == FF_THREAD_FRAME && !canFrame && canSlice)
+        choice.threadType = FF_THREAD_SLICE;
+    else if (choice.threadType == FF_THREAD_SLICE && !canSlice && canFrame)
+        choice.threadType = FF_THREAD_FRAME;
+
+    return choice;
+}
+
+int DecoderThreadingPolicy::coresPerPlayer(int players)
+{
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    return std::max(2, cores / std::max(1, players));
+}
+
+void DecoderThreadingPolicy::apply(AVCodecContext *ctx, const Choice &choice)
+{
+    if (!ctx) return;
+    ctx->thread_count = choice.threadCount;
+    ctx->thread_type  = choice.threadType;
+}
+
+void DecoderThreadingPolicy::registerPlayer()
+{
+    s_activePlayers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DecoderThreadingPolicy::unregisterPlayer()
+{
+    s_activePlayers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int DecoderThreadingPolicy::activePlayers()
+{
+    return s_activePlayers.load(std::memory_order_relaxed);
+}
+
+void DecoderThreadingPolicy::playbackStarted()
+{
+    s_playingPlayers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DecoderThreadingPolicy::playbackStopped()
+{
+    s_playingPlayers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int DecoderThreadingPolicy::playingPlayers()
+{
+    return s_playingPlayers.load(std::memory_order_relaxed);
+}
+
+const char *DecoderThreadingPolicy::threadTypeName(int threadType)
+{
+    if (threadType == (FF_THREAD_FRAME | FF_THREAD_SLICE)) return "frame+slice";
+    if (threadType == FF_THREAD_FRAME) return "frame";
+    if (threadType == FF_THREAD_SLICE) return "slice";
+    return "none";
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+
+#include "AVPlayerStatus.h"
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/// @brief Chooses thread_count / thread_type for a video decoder.
+///
+/// FFmpeg's default (auto threads, frame + slice) ignores the codec and the
+/// resolution, and each player on a shared box sizes itself for the whole
+/// machine.  The policy starts from a built-in table of per-codec,
+/// per-resolution thread counts (past a point, extra frame threads only add
+/// memory and latency).  It then splits the machine's cores evenly between
+/// the players currently decoding and falls back to what the decoder
+/// actually supports.  Explicit overrides from PlayerConfig win over the
+/// table.
+class DecoderThreadingPolicy
+{
+public:
+    struct Choice {
+        int         threadCount = 0;   ///< 0 = FFmpeg auto (only for a null codec)
+        int         threadType  = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        const char *source      = "default";   ///< "table", "override", "hwaccel", …
+    };
+
+    /// @param overrideThreads  0 = use the table
+    /// @param players          decoders sharing the machine, the caller included
+    static Choice choose(const AVCodec *codec, int width, int height, bool hwAccel,
+                         int overrideThreads, DecodeThreadType overrideType, int players);
+
+    /// Apply @p choice to @p ctx (before avcodec_open2()).
+    static void apply(AVCodecContext *ctx, const Choice &choice);
+
+    /// Players with an active video decoder, process-wide.  A handler is
+    /// registered by its owner once it becomes the one that plays
+    /// (AVCodecHandler::registerPlayer()) and unregisters in close(), so a
+    /// re-open or a standby pre-roll does not count twice.
+    static void registerPlayer();
+    static void unregisterPlayer();
+    static int  activePlayers();
+
+    /// Players actually playing (not paused, stopped or finished),
+    /// process-wide, as reported by PlayerWindowManager.  A stopped
+    /// handler stays registered above, so background work that only has
+    /// to yield to playback (ThumbnailCache) throttles on this instead.
+    static void playbackStarted();
+    static void playbackStopped();
+    static int  playingPlayers();
+
+    /// Cores one of @p players may use for its decoder and per-frame work
+    /// (at least 2), so concurrent players do not oversubscribe the CPU.
+    static int coresPerPlayer(int players);
+
+    static const char *threadTypeName(int threadType);
+
+private:
+    static std::atomic<int> s_activePlayers;
+    static std::atomic<int> s_playingPlayers;
+};
@@ -0,0 +1,237 @@
+#include "FrameBufferPool.h"
+#include "PlayerStats.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+#include <QAbstractVideoBuffer>
+#endif
+#include <new>
+
+namespace {
+constexpr size_t kBlockAlignment = 64;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+
+/// Plane geometry of a pooled video frame.
+struct PlaneLayout {
+    int planeCount = 0;
+    int bytesPerLine[4] = {};
+    int height[4] = {};
+
+    size_t totalBytes() const
+    {
+        size_t total = 0;
+        for (int i = 0; i < planeCount; ++i)
+            total += static_cast<size_t>(bytesPerLine[i]) * height[i];
+        return total;
+    }
+};
+
+bool layoutFor(const QVideoFrameFormat &format, PlaneLayout &out)
+{
+    const int w  = format.frameWidth();
+    const int h  = format.frameHeight();
+    const int cw = (w + 1) / 2;
+    const int ch = (h + 1) / 2;
+    if (w <= 0 || h <= 0) return false;
+
+    switch (format.pixelFormat()) {
+    case QVideoFrameFormat::Format_YUV420P:
+        out.planeCount = 3;
+        out.bytesPerLine[0] = FrameBufferPool::alignedStride(w);
+        out.bytesPerLine[1] = FrameBufferPool::alignedStride(cw);
+        out.bytesPerLine[2] = out.bytesPerLine[1];
+        out.height[0] = h;
+        out.height[1] = ch;
+        out.height[2] = ch;
+        return true;
+    case QVideoFrameFormat::Format_P010:
+        out.planeCount = 2;
+        out.bytesPerLine[0] = FrameBufferPool::alignedStride(w * 2);
+        out.bytesPerLine[1] = FrameBufferPool::alignedStride(cw * 4);
+        out.height[0] = h;
+        out.height[1] = ch;
+        return true;
+    case QVideoFrameFormat::Format_RGBA8888:
+    case QVideoFrameFormat::Format_RGBX8888:
+    case QVideoFrameFormat::Format_BGRA8888:
+        out.planeCount = 1;
+        out.bytesPerLine[0] = FrameBufferPool::alignedStride(w * 4);
+        out.height[0] = h;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// QAbstractVideoBuffer over a pooled allocation.  The buffer goes back to
+/// the pool when the last QVideoFrame copy releases this object.
+class PooledVideoBuffer : public QAbstractVideoBuffer
+{
+public:
+    PooledVideoBuffer(FrameBufferPool::Buffer buffer,
+                      const QVideoFrameFormat &format,
+                      const PlaneLayout &layout)
+        : m_buffer(std::move(buffer)), m_format(format), m_layout(layout) {}
+
+    MapData map(QVideoFrame::MapMode mode) override
+    {
+        Q_UNUSED(mode);
+        MapData data;
+        data.planeCount = m_layout.planeCount;
+        uint8_t *p = m_buffer.get();
+        for (int i = 0; i < m_layout.planeCount; ++i) {
+            data.bytesPerLine[i] = m_layout.bytesPerLine[i];
+            data.data[i]         = p;
+            data.dataSize[i]     = m_layout.bytesPerLine[i] * m_layout.height[i];
+            p += data.dataSize[i];
+        }
+        return data;
+    }
+
+    QVideoFrameFormat format() const override
+    {
+        return m_format;
+    }
+
+private:
+    FrameBufferPool::Buffer m_buffer;
+    QVideoFrameFormat       m_format;
+    PlaneLayout             m_layout;
+};
+#endif // Qt 6.8
+
+void releaseImageBuffer(void *info)
+{
+    delete static_cast<FrameBufferPool::Buffer *>(info);
+}
+}
+
+std::shared_ptr<FrameBufferPool> FrameBufferPool::create(PlayerStats *stats, size_t maxFreeBytes)
+{
+    return std::shared_ptr<FrameBufferPool>(new FrameBufferPool(stats, maxFreeBytes));
+}
+
+FrameBufferPool::FrameBufferPool(PlayerStats *stats, size_t maxFreeBytes)
+    : m_maxFreeBytes(maxFreeBytes), m_stats(stats) {}
+
+FrameBufferPool::~FrameBufferPool()
+{
+    trim();
+}
+
+FrameBufferPool::Buffer FrameBufferPool::acquire(size_t bytes)
+{
+    uint8_t *block = nullptr;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_free.find(bytes);
+        if (it != m_free.end() && !it->second.empty()) {
+            block = it->second.back();
+            it->second.pop_back();
+            m_freeBytes -= bytes;
+        }
+    }
+
+    if (block) {
+        if (m_stats) PlayerStats::bump(m_stats->poolReuses);
+    } else {
+        block = allocateBlock(bytes);
+        if (!block) return {};
+        if (m_stats) {
+            PlayerStats::bump(m_stats->poolAllocations);
+            PlayerStats::bump(m_stats->poolAllocatedBytes, bytes);
+        }
+    }
+
+    std::weak_ptr<FrameBufferPool> weakPool = weak_from_this();
+    return Buffer(block, [weakPool, bytes](uint8_t *p) {
+        if (auto pool = weakPool.lock())
+            pool->recycle(p, bytes);
+        else
+            freeBlock(p);
+    });
+}
+
+QVideoFrame FrameBufferPool::acquireVideoFrame(const QVideoFrameFormat &format)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    PlaneLayout layout;
+    if (!layoutFor(format, layout)) return {};
+
+    Buffer buffer = acquire(layout.totalBytes());
+    if (!buffer) return {};
+
+    return QVideoFrame(std::make_unique<PooledVideoBuffer>(std::move(buffer), format, layout));
+#else
+    // Custom QAbstractVideoBuffer backends are public API only from Qt 6.8;
+    // before that QVideoFrame allocates its own memory per frame.
+    return QVideoFrame(format);
+#endif
+}
+
+QImage FrameBufferPool::acquireImage(int width, int height, QImage::Format format)
+{
+    if (width <= 0 || height <= 0) return {};
+
+    const int stride = alignedStride(width * 4);
+    Buffer buffer = acquire(static_cast<size_t>(stride) * height);
+    if (!buffer) return {};
+
+    uint8_t *data = buffer.get();
+    return QImage(data, width, height, stride, format,
+                  &releaseImageBuffer, new Buffer(std::move(buffer)));
+}
+
+void FrameBufferPool::trim()
+{
+    std::lock_guard lock(m_mutex);
+    for (auto &entry : m_free) {
+        for (uint8_t *block : entry.second)
+            freeBlock(block);
+    }
+    m_free.clear();
+    m_freeBytes = 0;
+}
+
+int FrameBufferPool::alignedStride(int bytes)
+{
+    const int a = static_cast<int>(kBlockAlignment);
+    return (bytes + a - 1) / a * a;
+}
+
+uint8_t *FrameBufferPool::allocateBlock(size_t bytes)
+{
+    return static_cast<uint8_t *>(
+        ::operator new(bytes, std::align_val_t(kBlockAlignment), std::nothrow));
+}
+
+void FrameBufferPool::freeBlock(uint8_t *block)
+{
+    ::operator delete(block, std::align_val_t(kBlockAlignment));
+}
+
+void FrameBufferPool::recycle(uint8_t *block, size_t bytes)
+{
+    std::lock_guard lock(m_mutex);
+
+    // Over budget (e.g. after a resolution switch): drop idle blocks of
+    // other sizes first, then give up and free this one.
+    if (m_freeBytes + bytes > m_maxFreeBytes) {
+        for (auto it = m_free.begin(); it != m_free.end() && m_freeBytes + bytes > m_maxFreeBytes;) {
+            if (it->first == bytes) { ++it; continue; }
+            for (uint8_t *b : it->second) {
+                freeBlock(b);
+                m_freeBytes -= it->first;
+            }
+            it = m_free.erase(it);
+        }
+        if (m_freeBytes + bytes > m_maxFreeBytes) {
+            freeBlock(block);
+            return;
+        }
+    }
+
+    m_free[bytes].push_back(block);
+    m_freeBytes += bytes;
+}
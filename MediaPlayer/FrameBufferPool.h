@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QImage>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+struct PlayerStats;
+
+/// @brief Recycling pool of 64-byte aligned pixel buffers.
+///
+/// processVideoFrame() used to construct a fresh QVideoFrame / QImage per
+/// frame — at 4K that is ~33 MB allocated and page-faulted 60 times a
+/// second.  Buffers handed out here are returned to the pool automatically
+/// when the last QVideoFrame / QImage referencing them is destroyed (i.e.
+/// when QVideoSink or OpenGLVideoItem drops the frame), so steady-state
+/// playback allocates nothing.
+///
+/// Always create through create(): returned buffers keep a weak reference
+/// to the pool and free themselves if the pool is already gone.
+class FrameBufferPool : public std::enable_shared_from_this<FrameBufferPool>
+{
+public:
+    using Buffer = std::shared_ptr<uint8_t>;
+
+    static std::shared_ptr<FrameBufferPool> create(PlayerStats *stats = nullptr,
+                                                   size_t maxFreeBytes = 256u << 20);
+    ~FrameBufferPool();
+
+    // Non-copyable
+    FrameBufferPool(const FrameBufferPool &) = delete;
+    FrameBufferPool &operator=(const FrameBufferPool &) = delete;
+
+    /// Get a buffer of exactly @p bytes (contents undefined). Thread-safe.
+    Buffer acquire(size_t bytes);
+
+    /// QVideoFrame backed by a pooled buffer.  Supports the formats the
+    /// player produces: YUV420P, P010, RGBA8888 / RGBX8888 / BGRA8888.
+    /// Returns an invalid frame for anything else.  Before Qt 6.8 (no
+    /// public QAbstractVideoBuffer) this is a plain, unpooled QVideoFrame.
+    QVideoFrame acquireVideoFrame(const QVideoFrameFormat &format);
+
+    /// QImage backed by a pooled buffer (32-bit formats only).
+    QImage acquireImage(int width, int height, QImage::Format format);
+
+    /// Release all idle buffers (e.g. on stop).
+    void trim();
+
+    /// Row pitch used for pooled planes: rounded up to 64 bytes.
+    static int alignedStride(int bytes);
+
+private:
+    FrameBufferPool(PlayerStats *stats, size_t maxFreeBytes);
+
+    static uint8_t *allocateBlock(size_t bytes);
+    static void     freeBlock(uint8_t *block);
+    void recycle(uint8_t *block, size_t bytes);
+
+    mutable std::mutex                                  m_mutex;
+    std::unordered_map<size_t, std::vector<uint8_t *>>  m_free;   ///< size → idle blocks
+    size_t                                              m_freeBytes = 0;
+    size_t                                              m_maxFreeBytes;
+    PlayerStats                                        *m_stats = nullptr;   // non-owning
+};
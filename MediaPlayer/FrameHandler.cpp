@@ -12,8 +12,10 @@
 #include <QMetaObject>
 #include <QElapsedTimer>
 #include <cmath>
+#include <algorithm>
 
 #include "rtx/RtxVsrClient.h"
+#include "vsr/CpuVsrBackend.h"
 
 extern "C" {
 #include <libavutil/imgutils.h>
@@ -26,12 +28,15 @@ extern "C" {
 
 FrameHandler::FrameHandler(QObject *parent)
     : QObject(parent)
+    , m_bufferPool(FrameBufferPool::create(&m_stats))
 {
 }
 
 FrameHandler::~FrameHandler()
 {
     cleanup();
+    releaseAudioOutput();
+    m_swsCache.clear();
 }
 
 // ════════════════════════════════════════════════════════════
@@ -58,14 +63,28 @@ SwsFilterMode FrameHandler::swsFilter() const
     return m_swsFilter;
 }
 
-bool FrameHandler::initVideo(int srcWidth, int srcHeight, AVPixelFormat srcFmt)
+void FrameHandler::setToneMapper(ToneMapper mapper)
+{
+    m_toneMapper.store(mapper, std::memory_order_relaxed);
+}
+
+ToneMapper FrameHandler::toneMapper() const
+{
+    return m_toneMapper.load(std::memory_order_relaxed);
+}
+
+bool FrameHandler::initVideo(int srcWidth, int srcHeight, AVPixelFormat srcFmt,
+                             AVColorSpace colorSpace, AVColorRange colorRange)
 {
     cleanupVideo();
 
     m_srcWidth  = srcWidth;
     m_srcHeight = srcHeight;
     m_srcPixFmt = srcFmt;
+    m_srcColorSpace = colorSpace;
+    m_srcColorRange = colorRange;
     m_is10bit   = is10BitFormat(srcFmt);
+    m_peakDetector.reset();
 
     if (m_is10bit) {
         qDebug() << "FrameHandler::initVideo - detected 10-bit source:"
@@ -86,30 +105,34 @@ bool FrameHandler::initVideo(int srcWidth, int srcHeight, AVPixelFormat srcFmt)
             dstFmt = AV_PIX_FMT_P010LE;           // preserve 10-bit
         }
 
-        m_swsCtx = sws_getContext(
-            srcWidth, srcHeight, srcFmt,
-            srcWidth, srcHeight, dstFmt,
-            toSwsFlags(m_swsFilter), nullptr, nullptr, nullptr);
+        m_swsCtx = acquireSwsContext(dstFmt);
 
         if (!m_swsCtx) {
-            qWarning() << "FrameHandler::initVideo - sws_getContext failed";
+            qWarning() << "FrameHandler::initVideo - failed to acquire sws context";
             return false;
         }
     }
-    // OpenGLTexture path: no sws needed – raw YUV planes are uploaded directly.
+    // OpenGLTexture path: planar YUV is uploaded as-is; other formats get an
+    // RGBA context lazily in processVideoFrame.
 
     return true;
 }
 
+void FrameHandler::setVideoTimeBase(AVRational tb)
+{
+    m_videoTimeBase.store(tb, std::memory_order_relaxed);
+}
+
 void FrameHandler::cleanupVideo()
 {
-    if (m_swsCtx) {
-        sws_freeContext(m_swsCtx);
-        m_swsCtx = nullptr;
-    }
+    // The context stays alive in m_swsCache so that switching back to a
+    // previously seen format does not pay another sws init.
+    m_swsCtx    = nullptr;
     m_srcWidth  = 0;
     m_srcHeight = 0;
     m_srcPixFmt = AV_PIX_FMT_NONE;
+    m_srcColorSpace = AVCOL_SPC_UNSPECIFIED;
+    m_srcColorRange = AVCOL_RANGE_UNSPECIFIED;
     resetVsrState();
 }
 
@@ -121,32 +144,38 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
     }
 
     const AVPixelFormat frameFmt = static_cast<AVPixelFormat>(frame->format);
-    if (frame->width != m_srcWidth || frame->height != m_srcHeight || frameFmt != m_srcPixFmt) {
+    if (frame->width != m_srcWidth || frame->height != m_srcHeight || frameFmt != m_srcPixFmt
+        || frame->colorspace != m_srcColorSpace || frame->color_range != m_srcColorRange) {
         resetVsrState();
-        if (!initVideo(frame->width, frame->height, frameFmt)) {
+        if (!initVideo(frame->width, frame->height, frameFmt,
+                       frame->colorspace, frame->color_range)) {
             return;
         }
     }
 
-    // ── RTX VSR path ──
-    if (m_vsrEnabled && !m_vsrInitFailed
-        && RtxVsrClient::supportsInputFormat(frameFmt)) {
-        if (tryProcessVsr(frame))
-            return;
-        // VSR failed this frame — fall through to legacy path
-        qDebug() << "FrameHandler: VSR frame failed, falling back to legacy";
-    } else if (m_vsrEnabled && !m_vsrInitFailed
-               && !RtxVsrClient::supportsInputFormat(frameFmt)) {
-        static bool sWarnedFmt = false;
-        if (!sWarnedFmt) {
-            qDebug() << "FrameHandler: VSR skipped – unsupported pixel format:"
-                     << av_get_pix_fmt_name(frameFmt);
-            sWarnedFmt = true;
+    // ── VSR path ──
+    if (m_vsrEnabled && !m_vsrInitFailed && ensureVsrBackend()) {
+        if (m_vsrBackend->supportsInputFormat(frameFmt)) {
+            if (tryProcessVsr(frame))
+                return;
+            // VSR failed this frame — fall through to legacy path
+            qDebug() << "FrameHandler: VSR frame failed, falling back to legacy";
+        } else {
+            static bool sWarnedFmt = false;
+            if (!sWarnedFmt) {
+                qDebug() << "FrameHandler: VSR skipped – unsupported pixel format:"
+                         << av_get_pix_fmt_name(frameFmt);
+                sWarnedFmt = true;
+            }
         }
     }
 
     // ── Legacy path (no VSR) ──
 
+    // An upscale queued before VSR failed or was switched off must reach
+    // the sink before this newer frame does.  Returns at once when idle.
+    m_vsrWorker.drain();
+
     if (m_renderMode == VideoRenderMode::QVideoSink) {
         // ── Software path: deliver to QVideoSink ──
 
@@ -154,8 +183,8 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
         if (m_srcPixFmt == AV_PIX_FMT_YUV420P && !m_swsCtx) {
             QVideoFrameFormat fmt(QSize(m_srcWidth, m_srcHeight),
                                   QVideoFrameFormat::Format_YUV420P);
-            QVideoFrame videoFrame(fmt);
-            if (!videoFrame.map(QVideoFrame::WriteOnly)) return;
+            QVideoFrame videoFrame = m_bufferPool->acquireVideoFrame(fmt);
+            if (!videoFrame.isValid() || !videoFrame.map(QVideoFrame::WriteOnly)) return;
 
             // Copy Y, U, V planes
             const int ySize  = m_srcWidth * m_srcHeight;
@@ -187,8 +216,25 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
             // 10-bit path: sws converts to P010LE → QVideoFrame Format_P010
             QVideoFrameFormat fmt(QSize(m_srcWidth, m_srcHeight),
                                   QVideoFrameFormat::Format_P010);
-            QVideoFrame videoFrame(fmt);
-            if (!videoFrame.map(QVideoFrame::WriteOnly)) return;
+
+            // PQ / HLG: tag transfer, gamut and source peak so Qt's video
+            // shaders tone map to the SDR surface on the GPU (Qt uses its
+            // own curve; the Hable / BT.2390 choice applies to the OpenGL
+            // path).  Untagged, the signal would be shown as SDR.
+            if (m_toneMapper.load(std::memory_order_relaxed) != ToneMapper::Off
+                && HdrPeakDetector::isHdrTransfer(frame->color_trc)) {
+                fmt.setColorTransfer(frame->color_trc == AVCOL_TRC_SMPTE2084
+                                         ? QVideoFrameFormat::ColorTransfer_ST2084
+                                         : QVideoFrameFormat::ColorTransfer_STD_B67);
+                fmt.setColorSpace(QVideoFrameFormat::ColorSpace_BT2020);
+                fmt.setColorRange(frame->color_range == AVCOL_RANGE_JPEG
+                                      ? QVideoFrameFormat::ColorRange_Full
+                                      : QVideoFrameFormat::ColorRange_Video);
+                fmt.setMaxLuminance(m_peakDetector.update(frame));
+            }
+
+            QVideoFrame videoFrame = m_bufferPool->acquireVideoFrame(fmt);
+            if (!videoFrame.isValid() || !videoFrame.map(QVideoFrame::WriteOnly)) return;
 
             // P010 has 2 planes: Y (16-bit per pixel), UV interleaved (16-bit)
             uint8_t *dstData[4]     = { videoFrame.bits(0), videoFrame.bits(1),
@@ -210,8 +256,8 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
             // 8-bit non-YUV420P path: sws converts to RGBA
             QVideoFrameFormat fmt(QSize(m_srcWidth, m_srcHeight),
                                   QVideoFrameFormat::Format_RGBA8888);
-            QVideoFrame videoFrame(fmt);
-            if (!videoFrame.map(QVideoFrame::WriteOnly)) return;
+            QVideoFrame videoFrame = m_bufferPool->acquireVideoFrame(fmt);
+            if (!videoFrame.isValid() || !videoFrame.map(QVideoFrame::WriteOnly)) return;
 
             uint8_t *dstData[4]     = { videoFrame.bits(0), nullptr, nullptr, nullptr };
             int      dstLinesize[4] = { videoFrame.bytesPerLine(0), 0, 0, 0 };
@@ -229,17 +275,30 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
         }
 
     } else {
-        // ── OpenGL path: emit raw frame as QImage ──
+        // ── OpenGL path ──
+
+        // Planar YUV the shader understands: hand over a reference to the
+        // decoder's frame, planes are uploaded and converted on the GPU.
+        if (GLVideoFrame::layoutFor(m_srcPixFmt) != GLVideoFrame::Layout::None) {
+            GLVideoFrame glFrame = GLVideoFrame::fromAVFrame(frame);
+            if (glFrame.isValid()) {
+                // HDR is tone mapped in the fragment shader; the source
+                // peak it maps from is measured here on the decode thread.
+                if (glFrame.isHdr() && m_toneMapper.load(std::memory_order_relaxed) != ToneMapper::Off)
+                    glFrame.peakNits = m_peakDetector.update(frame);
+                deliverGLFrame(std::move(glFrame), frame);
+                return;
+            }
+        }
 
+        // Anything else goes through sws to RGBA first
         if (!m_swsCtx) {
-            m_swsCtx = sws_getContext(
-                m_srcWidth, m_srcHeight, m_srcPixFmt,
-                m_srcWidth, m_srcHeight, AV_PIX_FMT_RGBA,
-                toSwsFlags(m_swsFilter), nullptr, nullptr, nullptr);
+            m_swsCtx = acquireSwsContext(AV_PIX_FMT_RGBA);
         }
         if (!m_swsCtx) return;
 
-        QImage img(m_srcWidth, m_srcHeight, QImage::Format_RGBA8888);
+        QImage img = m_bufferPool->acquireImage(m_srcWidth, m_srcHeight, QImage::Format_RGBA8888);
+        if (img.isNull()) return;
         uint8_t *dstData[4]     = { img.bits(), nullptr, nullptr, nullptr };
         int      dstLinesize[4] = { static_cast<int>(img.bytesPerLine()), 0, 0, 0 };
 
@@ -248,12 +307,30 @@ void FrameHandler::processVideoFrame(AVFrame *frame)
                   0, m_srcHeight,
                   dstData, dstLinesize);
 
-        emit videoFrameReady(img);
+        deliverGLFrame(GLVideoFrame::fromImage(img), frame);
     }
 }
 
+void FrameHandler::deliverGLFrame(GLVideoFrame glFrame, const AVFrame *src)
+{
+    glFrame.presentAtUs = GLVideoFrame::steadyNowUs();
+    const AVRational tb = m_videoTimeBase.load(std::memory_order_relaxed);
+    if (src && src->pts != AV_NOPTS_VALUE && tb.den > 0) {
+        glFrame.pts = src->pts * av_q2d(tb);
+
+        // The decode thread paces us to within a few ms of the audio clock;
+        // carry the remainder so the item can target the right vsync.
+        const double clock = m_audioClock.load();
+        if (clock > 0.0) {
+            const double ahead = std::clamp(glFrame.pts - clock, 0.0, 0.1);
+            glFrame.presentAtUs += static_cast<int64_t>(ahead * 1e6);
+        }
+    }
+    emit videoFrameReady(glFrame);
+}
+
 // ════════════════════════════════════════════════════════════
-//  RTX VSR
+//  VSR (RTX, CPU fallback)
 // ════════════════════════════════════════════════════════════
 
 void FrameHandler::setVsrEnabled(bool enabled)
@@ -284,45 +361,45 @@ void FrameHandler::setDisplaySize(const QSize &size)
 
 void FrameHandler::preloadVsr()
 {
-#ifdef Q_OS_WIN
-    if (!m_vsrClient) {
-        m_vsrClient = std::make_unique<RtxVsrClient>();
-    }
-    if (!m_vsrClient->isLoaded()) {
-        if (m_vsrClient->load()) {
-            qDebug() << "FrameHandler: VSR bridge DLL pre-loaded successfully";
-        } else {
-            qDebug() << "FrameHandler: VSR bridge DLL pre-load failed:"
-                     << m_vsrClient->lastError();
-        }
+    ensureVsrBackend();
+}
+
+bool FrameHandler::ensureVsrBackend()
+{
+    if (m_vsrBackend)
+        return true;
+
+    // The bridge is Windows-only, except for the mock built with
+    // ZQT_BUILD_RTX_MOCK_BRIDGE, which is picked up the same way.
+    auto rtx = std::make_unique<RtxVsrClient>();
+    if (rtx->load()) {
+        qDebug() << "FrameHandler: VSR bridge DLL pre-loaded successfully";
+        m_vsrBackend = std::move(rtx);
+    } else {
+        qDebug() << "FrameHandler: VSR bridge DLL pre-load failed:"
+                 << rtx->lastError() << "- using the CPU upscaler";
+        m_vsrBackend = std::make_unique<CpuVsrBackend>();
     }
-#endif
+    m_stats.vsrBackend.store(m_vsrBackend->name(), std::memory_order_relaxed);
+    return true;
 }
 
 void FrameHandler::warmUpVsr()
 {
-#ifdef Q_OS_WIN
-    // If a previous warm-up thread is still running, skip.
-    if (m_vsrWarmupThread && m_vsrWarmupThread->isRunning())
+    // If a previous warm-up is still running, skip.
+    if (m_vsrWarmup.busy())
         return;
-    // Clean up finished thread
-    if (m_vsrWarmupThread) {
-        delete m_vsrWarmupThread;
-        m_vsrWarmupThread = nullptr;
-    }
 
-    if (!m_vsrClient)
-        preloadVsr();
-    if (!m_vsrClient || !m_vsrClient->isLoaded())
+    if (!ensureVsrBackend() || !m_vsrBackend->needsWarmUp())
         return;
-    if (m_vsrClient->isInitialized())
+    if (m_vsrBackend->isInitialized())
         return;   // already warm
 
-    // Run the heavy D3D11 + NGX initialisation on a background thread
-    // so the GUI stays responsive.  RtxVsrClient::initialize() is
-    // mutex-protected, so concurrent calls from the decode thread are safe.
-    RtxVsrClient *client = m_vsrClient.get();
-    m_vsrWarmupThread = QThread::create([client]() {
+    // Run the heavy D3D11 + NGX initialisation on a background worker
+    // so the GUI stays responsive.  VsrBackend::initialize() is
+    // mutex-protected, so concurrent calls from the decode stage are safe.
+    VsrBackend *client = m_vsrBackend.get();
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background, [client]() {
         qDebug() << "FrameHandler: warming up VSR (background)...";
         QElapsedTimer t;
         t.start();
@@ -333,24 +410,14 @@ void FrameHandler::warmUpVsr()
         } else {
             qDebug() << "FrameHandler: VSR warm-up failed:" << client->lastError();
         }
-    });
-    m_vsrWarmupThread->start();
-#endif
+    }, &m_vsrWarmup);
 }
 
 bool FrameHandler::tryProcessVsr(AVFrame *frame)
 {
-    QElapsedTimer totalTimer;
-    totalTimer.start();
-
-    if (!m_vsrClient) {
-        m_vsrClient = std::make_unique<RtxVsrClient>();
-        if (!m_vsrClient->load()) {
-            qWarning() << "FrameHandler: VSR bridge DLL load failed:"
-                       << m_vsrClient->lastError();
-            m_vsrInitFailed = true;
-            return false;
-        }
+    if (!ensureVsrBackend()) {
+        m_vsrInitFailed = true;
+        return false;
     }
 
     // ── Compute desired output dimensions ──
@@ -387,16 +454,19 @@ bool FrameHandler::tryProcessVsr(AVFrame *frame)
     }
 
     // ── (Re-)initialize if dimensions changed or not yet initialised ──
-    const bool needInit = !m_vsrClient->isInitialized()
-                          || m_vsrClient->inWidth()  != frame->width
-                          || m_vsrClient->inHeight() != frame->height
-                          || m_vsrClient->outWidth()  != outW
-                          || m_vsrClient->outHeight() != outH;
+    const bool needInit = !m_vsrBackend->isInitialized()
+                          || m_vsrBackend->inWidth()  != frame->width
+                          || m_vsrBackend->inHeight() != frame->height
+                          || m_vsrBackend->outWidth()  != outW
+                          || m_vsrBackend->outHeight() != outH;
 
     if (needInit) {
+        // The worker may still be upscaling a frame at the old size.
+        m_vsrWorker.drain();
+
         const AVPixelFormat ffFmt = static_cast<AVPixelFormat>(frame->format);
         const int bridgePixFmt = (ffFmt == AV_PIX_FMT_P010LE) ? 1 /*P010*/ : 0 /*NV12*/;
-        const bool isReset = m_vsrClient->isInitialized();
+        const bool isReset = m_vsrBackend->isInitialized();
 
         qDebug() << "FrameHandler: VSR" << (isReset ? "reset" : "init")
                  << frame->width << "x" << frame->height
@@ -405,13 +475,13 @@ bool FrameHandler::tryProcessVsr(AVFrame *frame)
 
         QElapsedTimer initTimer;
         initTimer.start();
-        if (!m_vsrClient->initialize(frame->width, frame->height,
+        if (!m_vsrBackend->initialize(frame->width, frame->height,
                                      outW, outH,
                                      /*quality=*/1,
                                      /*pixelFormat=*/bridgePixFmt)) {
             qWarning() << "FrameHandler: VSR init failed ("
                        << initTimer.elapsed() << "ms):"
-                       << m_vsrClient->lastError();
+                       << m_vsrBackend->lastError();
             m_vsrInitFailed = true;
             return false;
         }
@@ -424,86 +494,113 @@ bool FrameHandler::tryProcessVsr(AVFrame *frame)
         m_vsrFrameCount = 0;
     }
 
-    // ── Process frame ──
-    // Use the dimensions the client was actually initialised with.
-    outW = m_vsrClient->outWidth();
-    outH = m_vsrClient->outHeight();
-    const int outStride = outW * 4;
-    const size_t bufSize = static_cast<size_t>(outStride) * outH;
-
-    if (m_vsrOutBuffer.size() != bufSize)
-        m_vsrOutBuffer.resize(bufSize);
+    // ── Hand off to the worker ──
+    // Use the dimensions the backend was actually initialised with.  The
+    // worker holds a reference to the decoder's frame (no pixel copy) and
+    // upscales it while this thread goes on to decode the next one.
+    outW = m_vsrBackend->outWidth();
+    outH = m_vsrBackend->outHeight();
 
-    QElapsedTimer procTimer;
-    procTimer.start();
-    if (!m_vsrClient->processFrameToBgra(frame, m_vsrOutBuffer.data(),
-                                         outStride, outW, outH)) {
-        if (m_vsrFirstFrame) {
-            qWarning() << "FrameHandler: VSR process failed:"
-                       << m_vsrClient->lastError();
-        }
+    AVFrame *ref = av_frame_clone(frame);
+    if (!ref)
         return false;
-    }
-    const qint64 procMs = procTimer.elapsed();
+    std::shared_ptr<AVFrame> src(ref, [](AVFrame *f) { av_frame_free(&f); });
 
-    if (m_vsrFirstFrame) {
-        qDebug() << "VSR-TIMING: first processFrameToBgra():" << procMs << "ms"
-                 << "total tryProcessVsr():" << totalTimer.elapsed() << "ms";
-
-        if (bufSize >= 16) {
-            const uint8_t *p = m_vsrOutBuffer.data();
-            qDebug().nospace()
-                << "VSR-DIAG: first 4 output pixels (byte order): "
-                << "px0=[" << p[0] << "," << p[1] << "," << p[2] << "," << p[3] << "] "
-                << "px1=[" << p[4] << "," << p[5] << "," << p[6] << "," << p[7] << "] "
-                << "px2=[" << p[8] << "," << p[9] << "," << p[10] << "," << p[11] << "] "
-                << "px3=[" << p[12] << "," << p[13] << "," << p[14] << "," << p[15] << "]";
-            qDebug() << "VSR-DIAG: if BGRA order -> pixel0 RGB ="
-                     << p[2] << p[1] << p[0]
-                     << "| if RGBA order -> pixel0 RGB ="
-                     << p[0] << p[1] << p[2];
-        }
+    m_vsrWorker.submit([this, src, outW, outH]() {
+        processVsrJob(src.get(), outW, outH);
+    });
+    return true;
+}
 
-        m_vsrFirstFrame = false;
-    } else if (procMs > 50) {
-        qDebug() << "VSR-TIMING: processFrameToBgra():" << procMs << "ms (slow)";
-    }
+void FrameHandler::processVsrJob(const AVFrame *frame, int outW, int outH)
+{
+    if (m_audioAbort)
+        return;
 
-    // ── Deliver ──
-    QElapsedTimer deliverTimer;
-    deliverTimer.start();
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    // The backend writes straight into the pooled output buffer.
+    qint64 procNs = 0;
+    bool ok = false;
+    auto upscale = [&](uint8_t *dst, int dstStride) {
+        QElapsedTimer procTimer;
+        procTimer.start();
+        ok = m_vsrBackend->processFrameToBgra(frame, dst, dstStride, outW, outH);
+        procNs = procTimer.nsecsElapsed();
+        if (ok && m_vsrFirstFrame)
+            logVsrFirstFrame(dst);
+    };
 
     if (m_renderMode == VideoRenderMode::QVideoSink) {
         QVideoFrameFormat fmt(QSize(outW, outH),
                               QVideoFrameFormat::Format_RGBA8888);
-        QVideoFrame videoFrame(fmt);
-        if (!videoFrame.map(QVideoFrame::WriteOnly))
-            return false;
+        QVideoFrame videoFrame = m_bufferPool->acquireVideoFrame(fmt);
+        if (videoFrame.isValid() && videoFrame.map(QVideoFrame::WriteOnly)) {
+            upscale(videoFrame.bits(0), videoFrame.bytesPerLine(0));
+            videoFrame.unmap();
+            if (ok) {
+                std::lock_guard<std::mutex> lock(m_videoSinkMutex);
+                if (m_videoSink)
+                    m_videoSink->setVideoFrame(videoFrame);
+            }
+        }
+    } else {
+        QImage img = m_bufferPool->acquireImage(outW, outH, QImage::Format_RGBA8888);
+        if (!img.isNull()) {
+            upscale(img.bits(), static_cast<int>(img.bytesPerLine()));
+            if (ok)
+                deliverGLFrame(GLVideoFrame::fromImage(img), frame);
+        }
+    }
 
-        const int dstStride = videoFrame.bytesPerLine(0);
-        for (int y = 0; y < outH; ++y) {
-            memcpy(videoFrame.bits(0) + y * dstStride,
-                   m_vsrOutBuffer.data() + y * outStride,
-                   static_cast<size_t>(outW) * 4);
+    if (!ok) {
+        // The frame is already gone from the decode thread; after a few
+        // failures in a row hand the stream back to the legacy path.
+        if (m_vsrFirstFrame || m_vsrFailures == 0) {
+            qWarning() << "FrameHandler: VSR process failed:"
+                       << m_vsrBackend->lastError();
         }
-        videoFrame.unmap();
+        if (++m_vsrFailures >= kMaxVsrFailures) {
+            qWarning() << "FrameHandler: VSR failed" << m_vsrFailures
+                       << "frames in a row, falling back to legacy";
+            m_vsrInitFailed = true;
+        }
+        return;
+    }
+    m_vsrFailures = 0;
 
-        std::lock_guard<std::mutex> lock(m_videoSinkMutex);
-        if (m_videoSink)
-            m_videoSink->setVideoFrame(videoFrame);
-    } else {
-        QImage img(m_vsrOutBuffer.data(), outW, outH, outStride,
-                   QImage::Format_RGBA8888);
-        emit videoFrameReady(img.copy());
+    PlayerStats::bump(m_stats.vsrFrames);
+    PlayerStats::bump(m_stats.vsrFrameNs, static_cast<uint64_t>(procNs));
+    PlayerStats::raise(m_stats.vsrFrameMaxNs, static_cast<uint64_t>(procNs));
+
+    const qint64 procMs = procNs / 1000000;
+    if (m_vsrFirstFrame) {
+        qDebug() << "VSR-TIMING: first processFrameToBgra():" << procMs << "ms"
+                 << "total frame:" << totalTimer.elapsed() << "ms";
+        m_vsrFirstFrame = false;
+    } else if (procMs > 50) {
+        qDebug() << "VSR-TIMING: processFrameToBgra():" << procMs << "ms (slow)";
     }
 
     if (m_vsrFrameCount < 3) {
-        qDebug() << "VSR-TIMING: deliver:" << deliverTimer.elapsed() << "ms"
-                 << "| total frame:" << totalTimer.elapsed() << "ms";
+        qDebug() << "VSR-TIMING: total frame:" << totalTimer.elapsed() << "ms";
         ++m_vsrFrameCount;
     }
+}
 
-    return true;
+void FrameHandler::logVsrFirstFrame(const uint8_t *p)
+{
+    qDebug().nospace()
+        << "VSR-DIAG: first 4 output pixels (byte order): "
+        << "px0=[" << p[0] << "," << p[1] << "," << p[2] << "," << p[3] << "] "
+        << "px1=[" << p[4] << "," << p[5] << "," << p[6] << "," << p[7] << "] "
+        << "px2=[" << p[8] << "," << p[9] << "," << p[10] << "," << p[11] << "] "
+        << "px3=[" << p[12] << "," << p[13] << "," << p[14] << "," << p[15] << "]";
+    qDebug() << "VSR-DIAG: if BGRA order -> pixel0 RGB ="
+             << p[2] << p[1] << p[0]
+             << "| if RGBA order -> pixel0 RGB ="
+             << p[0] << p[1] << p[2];
 }
 
 void FrameHandler::resetVsrState()
@@ -511,22 +608,20 @@ void FrameHandler::resetVsrState()
     // Only clear per-session tracking state.
     // The VSR GPU handle is kept alive — the next tryProcessVsr() call
     // will re-configure it via the fast m_fnReset path if needed.
+    m_vsrWorker.drain();
     m_vsrInitFailed = false;
     m_vsrFirstFrame = true;
     m_vsrFrameCount = 0;
-    m_vsrOutBuffer.clear();
+    m_vsrFailures   = 0;
 }
 
 void FrameHandler::shutdownVsr()
 {
     // Wait for any background warm-up to finish first.
-    if (m_vsrWarmupThread) {
-        m_vsrWarmupThread->wait();
-        delete m_vsrWarmupThread;
-        m_vsrWarmupThread = nullptr;
-    }
-    if (m_vsrClient)
-        m_vsrClient->shutdown();
+    m_vsrWarmup.wait();
+    m_vsrWorker.stop();
+    if (m_vsrBackend)
+        m_vsrBackend->shutdown();
     resetVsrState();
 }
 
@@ -571,37 +666,59 @@ bool FrameHandler::initAudio(int srcSampleRate,
                               AVSampleFormat srcSampleFmt,
                               AVRational audioTimeBase)
 {
-    cleanupAudio();
-    m_srcSampleRate = srcSampleRate;
     m_audioTimeBase = audioTimeBase;
 
-    // Target layout: stereo
-    AVChannelLayout outLayout;
-    av_channel_layout_default(&outLayout, kOutChannels);
-
-    // Allocate SwrContext
-    int ret = swr_alloc_set_opts2(
-        &m_swrCtx,
-        &outLayout,      AV_SAMPLE_FMT_S16, kOutSampleRate,  // dst
-        &srcChLayout,    srcSampleFmt,       srcSampleRate,   // src
-        0, nullptr);
-
-    if (ret < 0 || !m_swrCtx) {
-        char err[AV_ERROR_MAX_STRING_SIZE]{};
-        av_strerror(ret, err, sizeof(err));
-        qWarning() << "FrameHandler::initAudio – swr_alloc_set_opts2 failed:" << err;
-        return false;
-    }
+    // Only the resampler depends on the source; the sink stays up.  Files
+    // from the same source keep the resampler as well — whatever it still
+    // holds from the previous file is a few samples of filter delay.
+    const bool sameSource = m_swrCtx
+                            && srcSampleRate == m_srcSampleRate
+                            && srcSampleFmt == m_srcSampleFmt
+                            && av_channel_layout_compare(&srcChLayout, &m_srcChLayout) == 0;
+    if (sameSource) {
+        qDebug() << "FrameHandler::initAudio – reusing resampler";
+    } else {
+        if (m_swrCtx) {
+            swr_free(&m_swrCtx);
+            m_swrCtx = nullptr;
+        }
 
-    if (swr_init(m_swrCtx) < 0) {
-        qWarning() << "FrameHandler::initAudio – swr_init failed";
-        swr_free(&m_swrCtx);
-        return false;
+        // Target layout: stereo
+        AVChannelLayout outLayout;
+        av_channel_layout_default(&outLayout, kOutChannels);
+
+        // Allocate SwrContext
+        int ret = swr_alloc_set_opts2(
+            &m_swrCtx,
+            &outLayout,      AV_SAMPLE_FMT_S16, kOutSampleRate,  // dst
+            &srcChLayout,    srcSampleFmt,       srcSampleRate,   // src
+            0, nullptr);
+
+        if (ret < 0 || !m_swrCtx) {
+            char err[AV_ERROR_MAX_STRING_SIZE]{};
+            av_strerror(ret, err, sizeof(err));
+            qWarning() << "FrameHandler::initAudio – swr_alloc_set_opts2 failed:" << err;
+            return false;
+        }
+
+        if (swr_init(m_swrCtx) < 0) {
+            qWarning() << "FrameHandler::initAudio – swr_init failed";
+            swr_free(&m_swrCtx);
+            return false;
+        }
+
+        m_srcSampleRate = srcSampleRate;
+        m_srcSampleFmt  = srcSampleFmt;
+        av_channel_layout_uninit(&m_srcChLayout);
+        av_channel_layout_copy(&m_srcChLayout, &srcChLayout);
     }
 
     m_audioClock = 0.0;
     m_audioAbort = false;
 
+    if (m_nullAudioOutput)
+        return true;
+
     // Create the audio output device eagerly on the main thread so that
     // processAudioFrame (called from the decode thread) never needs a
     // BlockingQueuedConnection back to the main thread — avoiding deadlock.
@@ -612,16 +729,37 @@ bool FrameHandler::initAudio(int srcSampleRate,
     return true;
 }
 
+void FrameHandler::setNullAudioOutput(bool enabled)
+{
+    m_nullAudioOutput = enabled;
+}
+
 void FrameHandler::cleanupAudio()
 {
     qDebug() << "FrameHandler::cleanupAudio – thread:" << QThread::currentThread()
              << "owner:" << this->thread();
 
-    // Signal the write loop in processAudioFrame() to exit immediately
+    // Stop writePendingAudio() from feeding the sink
     m_audioAbort = true;
 
-    // Destroy QAudioSink.  Always called from the main thread (after worker
-    // threads have been joined), so no cross-thread bounce is needed.
+    // Drop the queued audio but keep the QAudioSink: the next file
+    // restarts it in createAudioSinkImpl() instead of opening the device
+    // again.  Always called from the main thread (after the pipeline has
+    // been joined), so no cross-thread bounce is needed.
+    {
+        std::lock_guard<std::mutex> lock(m_audioMutex);
+        if (m_audioSink) {
+            m_audioSink->reset();
+            m_audioIO = nullptr;
+        }
+        m_pendingAudio.clear();
+        m_lastWriteNs = -1;   // a restarted sink has nothing queued to bridge
+    }
+    m_audioClock = 0.0;
+}
+
+void FrameHandler::releaseAudioOutput()
+{
     {
         std::lock_guard<std::mutex> lock(m_audioMutex);
         if (m_audioSink) {
@@ -634,7 +772,9 @@ void FrameHandler::cleanupAudio()
         swr_free(&m_swrCtx);
         m_swrCtx = nullptr;
     }
-    m_audioClock = 0.0;
+    av_channel_layout_uninit(&m_srcChLayout);
+    m_srcSampleRate = 0;
+    m_srcSampleFmt  = AV_SAMPLE_FMT_NONE;
 }
 
 void FrameHandler::processAudioFrame(AVFrame *frame)
@@ -647,7 +787,7 @@ void FrameHandler::processAudioFrame(AVFrame *frame)
 
     // Audio sink is created eagerly in initAudio() on the main thread.
     // If it doesn't exist here, we simply cannot output audio.
-    {
+    if (!m_nullAudioOutput) {
         std::lock_guard<std::mutex> lock(m_audioMutex);
         if (!m_audioSink || !m_audioIO) return;
     }
@@ -667,53 +807,100 @@ void FrameHandler::processAudioFrame(AVFrame *frame)
                                 frame->nb_samples);
     if (converted <= 0) return;
 
-    int totalBytes = converted * bytesPerSample;
+    buffer.truncate(converted * bytesPerSample);
+    const double duration = static_cast<double>(converted) / kOutSampleRate;
+
+    // ── Audio clock at the end of this frame ──
+    // Use the frame PTS directly.  The clock only moves once the frame is
+    // in the device buffer, so with back-pressure it advances at ≈1×
+    // real time; at EOF it equals the true media duration.
+    if (m_nullAudioOutput) {
+        const double clock = frame->pts != AV_NOPTS_VALUE
+            ? static_cast<double>(frame->pts) * av_q2d(m_audioTimeBase) + duration
+            : m_audioClock.load() + duration;
+        m_audioClock = clock;
+        emit audioClockUpdated(clock);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_audioMutex);
+        if (!(m_audioIO && m_audioSink)) return;
+
+        if (m_transitionPending.exchange(false) && m_lastWriteNs >= 0) {
+            // Silence = time since the old item's last write beyond what
+            // the sink still had queued at that point.
+            const qint64 sinceUs = (m_audioWriteClock.nsecsElapsed() - m_lastWriteNs) / 1000;
+            const qint64 gapUs   = std::max<qint64>(0, sinceUs - m_lastBufferedUs);
+            m_stats.transitionGapUs.store(gapUs, std::memory_order_relaxed);
+            qDebug() << "FrameHandler: playlist transition gap" << gapUs / 1000.0 << "ms";
+        }
 
-    // ── Back-pressure write: pace the decode thread to real-time ──
+        const double queuedClock = m_pendingAudio.empty() ? m_audioClock.load()
+                                                          : m_pendingAudio.back().clock;
+        const double clock = frame->pts != AV_NOPTS_VALUE
+            ? static_cast<double>(frame->pts) * av_q2d(m_audioTimeBase) + duration
+            : queuedClock + duration;
+        m_pendingAudio.push_back(PendingAudio{std::move(buffer), 0, clock});
+    }
+    writePendingAudio();
+}
+
+bool FrameHandler::writePendingAudio()
+{
+    // ── Back-pressure write ──
     // QAudioSink in push mode does not block on write(); it simply buffers
     // the data.  Without back-pressure the entire file would be decoded and
     // buffered in milliseconds, making audioClock jump to the end instantly.
-    // We check bytesFree() and sleep when the device buffer is full, so
-    // the decode thread naturally runs at ≈1× playback speed.
+    // Only what bytesFree() allows is written; the decode stage comes back
+    // for the rest, so it runs at ≈1× playback speed without a thread
+    // sleeping on the device.
+    bool advanced = false;
+    double clock  = 0.0;
+    bool drained  = false;
     {
         std::lock_guard<std::mutex> lock(m_audioMutex);
-        if (!(m_audioIO && m_audioSink)) return;
+        if (m_pendingAudio.empty()) return true;
+        if (m_audioAbort || !(m_audioIO && m_audioSink)
+            || m_audioSink->state() == QAudio::StoppedState) {
+            m_pendingAudio.clear();   // nothing will ever play it
+            return true;
+        }
 
-        const char *src = buffer.constData();
-        int remaining = totalBytes;
-        while (remaining > 0 && !m_audioAbort) {
-            int freeBytes = m_audioSink->bytesFree();
-            if (freeBytes <= 0) {
-                // During pause, the sink is suspended and bytesFree may remain 0.
-                // Break so decode thread can reach waitIfPaused() promptly.
-                if (m_audioSink->state() != QAudio::ActiveState) {
-                    break;
-                }
-                // Buffer full — wait ~5 ms for the device to drain some data
-                QThread::usleep(5000);
-                continue;
-            }
-            int toWrite = std::min(remaining, freeBytes);
-            qint64 written = m_audioIO->write(src, toWrite);
+        bool wrote = false;
+        while (!m_pendingAudio.empty()) {
+            PendingAudio &chunk = m_pendingAudio.front();
+            // A suspended (paused) sink may report no room until resumed.
+            const int freeBytes = m_audioSink->bytesFree();
+            if (freeBytes <= 0) break;
+            const int toWrite = std::min(static_cast<int>(chunk.data.size()) - chunk.offset, freeBytes);
+            const qint64 written = m_audioIO->write(chunk.data.constData() + chunk.offset, toWrite);
             if (written <= 0) break;
-            src       += written;
-            remaining -= static_cast<int>(written);
+            wrote = true;
+            chunk.offset += static_cast<int>(written);
+            if (chunk.offset >= chunk.data.size()) {
+                advanced = true;
+                clock    = chunk.clock;
+                m_pendingAudio.pop_front();
+            }
         }
-    }
 
-    // ── Update audio clock ──
-    // Use the frame PTS directly. With back-pressure the decode thread
-    // is paced to ≈1× real-time, so PTS advances smoothly.
-    // At EOF the PTS equals the true media duration — no buffer-lag error.
-    if (frame->pts != AV_NOPTS_VALUE) {
-        double pts = static_cast<double>(frame->pts) * av_q2d(m_audioTimeBase);
-        m_audioClock = pts + static_cast<double>(converted) / kOutSampleRate;
-    } else {
-        m_audioClock = m_audioClock.load()
-                       + static_cast<double>(converted) / kOutSampleRate;
+        if (wrote) {
+            if (!m_audioWriteClock.isValid())
+                m_audioWriteClock.start();
+            m_lastWriteNs = m_audioWriteClock.nsecsElapsed();
+            const qint64 queuedBytes = m_audioSink->bufferSize() - m_audioSink->bytesFree();
+            m_lastBufferedUs = std::max<qint64>(0, queuedBytes) * 1000000
+                               / (kOutSampleRate * kOutChannels * 2);
+        }
+        drained = m_pendingAudio.empty();
     }
 
-    emit audioClockUpdated(m_audioClock.load());
+    if (advanced) {
+        m_audioClock = clock;
+        emit audioClockUpdated(clock);
+    }
+    return drained;
 }
 
 double FrameHandler::audioClock() const
@@ -753,6 +940,11 @@ void FrameHandler::resumeAudioOutput()
     }
 }
 
+void FrameHandler::beginAudioTransition()
+{
+    m_transitionPending = true;
+}
+
 // ════════════════════════════════════════════════════════════
 //  Lifecycle
 // ════════════════════════════════════════════════════════════
@@ -766,16 +958,27 @@ void FrameHandler::cleanup()
 {
     cleanupAudio();
     cleanupVideo();
+    m_bufferPool->trim();
     shutdownVsr();   // full GPU teardown on app exit
 }
 
+PlayerStats &FrameHandler::stats()
+{
+    return m_stats;
+}
+
+const PlayerStats &FrameHandler::stats() const
+{
+    return m_stats;
+}
+
 // ════════════════════════════════════════════════════════════
 //  Private
 // ════════════════════════════════════════════════════════════
 
 bool FrameHandler::ensureAudioSink()
 {
-    if (m_audioSink) return true;
+    if (m_audioSink && m_audioIO) return true;
 
     // QAudioSink must be created on a thread that owns this QObject
     // (normally the main / GUI thread).  If we are on a different thread,
@@ -796,7 +999,15 @@ bool FrameHandler::createAudioSinkImpl()
 {
     {
         std::lock_guard<std::mutex> lock(m_audioMutex);
-        if (m_audioSink) return true;
+        if (m_audioSink && m_audioIO) return true;
+
+        // Kept from the previous file by cleanupAudio(): just restart it.
+        if (m_audioSink) {
+            m_audioIO = m_audioSink->start();
+            if (m_audioIO) return true;
+            qWarning() << "FrameHandler::createAudioSinkImpl – restarting the sink failed, recreating";
+            m_audioSink.reset();
+        }
     }
 
     QAudioFormat format;
@@ -827,6 +1038,30 @@ bool FrameHandler::createAudioSinkImpl()
     return true;
 }
 
+SwsContext *FrameHandler::acquireSwsContext(AVPixelFormat dstFmt)
+{
+    SwsContextCache::Key key;
+    key.srcWidth   = m_srcWidth;
+    key.srcHeight  = m_srcHeight;
+    key.srcFormat  = m_srcPixFmt;
+    key.dstWidth   = m_srcWidth;
+    key.dstHeight  = m_srcHeight;
+    key.dstFormat  = dstFmt;
+    // In OpenGLTexture mode sws only converts the pixel format at source
+    // size; scaling (and the configured filter) is done by the shader.
+    key.flags      = m_renderMode == VideoRenderMode::OpenGLTexture
+                         ? SWS_BILINEAR
+                         : toSwsFlags(m_swsFilter);
+    key.colorSpace = m_srcColorSpace;
+    key.colorRange = m_srcColorRange;
+
+    bool hit = false;
+    SwsContext *ctx = m_swsCache.acquire(key, &hit);
+    if (ctx)
+        PlayerStats::bump(hit ? m_stats.swsCacheHits : m_stats.swsCacheMisses);
+    return ctx;
+}
+
 int FrameHandler::toSwsFlags(SwsFilterMode mode)
 {
     switch (mode) {
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSize>
 #include <QImage>
 #include <memory>
 #include <atomic>
+#include <deque>
 #include <mutex>
 #include <vector>
 
 #include "AVPlayerStatus.h"
+#include "PlayerStats.h"
+#include "SwsContextCache.h"
+#include "FrameBufferPool.h"
+#include "GLVideoFrame.h"
+#include "HdrPeakDetector.h"
+#include "VsrWorker.h"
 
 // FFmpeg (C library)
 extern "C" {
@@ -59,9 +68,22 @@ public:
     void setSwsFilter(SwsFilterMode filter);
     SwsFilterMode swsFilter() const;
 
+    /// HDR → SDR curve for PQ / HLG sources.  Thread-safe; takes effect on
+    /// the next frame.
+    void setToneMapper(ToneMapper mapper);
+    ToneMapper toneMapper() const;
+
     /// Initialise the sws scaler for the given source format.
-    /// Call once after the video codec is opened.
-    bool initVideo(int srcWidth, int srcHeight, AVPixelFormat srcFmt);
+    /// Call once after the video codec is opened; mid-stream parameter
+    /// changes are picked up automatically by processVideoFrame().
+    bool initVideo(int srcWidth, int srcHeight, AVPixelFormat srcFmt,
+                   AVColorSpace colorSpace = AVCOL_SPC_UNSPECIFIED,
+                   AVColorRange colorRange = AVCOL_RANGE_UNSPECIFIED);
+
+    /// Time base of the video frames' pts (the stream's, or the filter
+    /// graph's output), used to stamp OpenGL frames with their presentation
+    /// time.  Thread-safe.
+    void setVideoTimeBase(AVRational tb);
 
     /// Release sws resources.
     void cleanupVideo();
@@ -74,10 +96,11 @@ public:
     void setVideoSink(QVideoSink *sink);
 
     // ────────────────────────────────────────────────────────────
-    //  RTX VSR
+    //  Video super resolution (RTX, CPU fallback)
     // ────────────────────────────────────────────────────────────
 
-    /// Enable / disable RTX VSR processing at runtime.
+    /// Enable / disable VSR processing at runtime.  Uses RTX VSR when the
+    /// bridge DLL loads, the portable CPU upscaler otherwise.
     void setVsrEnabled(bool enabled);
     bool vsrEnabled() const;
 
@@ -85,8 +108,9 @@ public:
     /// output dimensions. Thread-safe — called from the GUI thread.
     void setDisplaySize(const QSize &size);
 
-    /// Pre-load the VSR bridge DLL (symbol resolution only, no GPU init).
-    /// Called once at startup to reduce first-frame latency.
+    /// Pick the VSR backend and pre-load the RTX bridge DLL if present
+    /// (symbol resolution only, no GPU init).  Called once at startup to
+    /// reduce first-frame latency.
     void preloadVsr();
 
     /// Pre-initialize the VSR GPU context on a background thread.
@@ -106,7 +130,10 @@ public:
     // ────────────────────────────────────────────────────────
 
     /// Initialise the swr resampler for the given source format.
-    /// Call once after the audio codec is opened.
+    /// Call once after the audio codec is opened.  An existing audio sink
+    /// is kept (its output format never changes), so audio still buffered
+    /// from the previous item plays on.  The resampler is kept too when the
+    /// source rate, layout and sample format match the previous file.
     /// @param srcSampleRate  e.g. 48000
     /// @param srcChLayout    source channel layout (from AVCodecContext)
     /// @param srcSampleFmt   source sample format (from AVCodecContext)
@@ -114,13 +141,26 @@ public:
     bool initAudio(int srcSampleRate, const AVChannelLayout &srcChLayout,
                    AVSampleFormat srcSampleFmt, AVRational audioTimeBase);
 
-    /// Release swr + audio output resources.
+    /// Resample as usual but discard the PCM instead of writing it to an
+    /// audio device; the audio clock still follows the frame pts.  Nothing
+    /// then holds the audio stage back to real time (headless benchmark).
+    /// Must be called before initAudio().
+    void setNullAudioOutput(bool enabled);
+
+    /// Stop audio output and drop what is still queued.  The sink and the
+    /// resampler stay allocated for the next file; the destructor frees them.
     void cleanupAudio();
 
-    /// Resample a decoded audio AVFrame and write PCM to the audio device.
-    /// Called from the audio decode thread.
+    /// Resample a decoded audio AVFrame and write as much of the PCM to the
+    /// audio device as it has room for; the rest waits for
+    /// writePendingAudio().  Never blocks.  Called from the audio decode stage.
     void processAudioFrame(AVFrame *frame);
 
+    /// Write PCM held back by processAudioFrame() while the device buffer
+    /// was full.  Returns true once nothing is left; the audio decode stage
+    /// retries a moment later otherwise, which paces it to real time.
+    bool writePendingAudio();
+
     /// Current audio playback position in seconds (used as the master clock).
     double audioClock() const;
 
@@ -130,6 +170,11 @@ public:
     /// Resume audio device output (used when playback resumes).
     void resumeAudioOutput();
 
+    /// The next processAudioFrame() starts a new playlist item on the
+    /// running sink: measure the silence between the last buffered sample
+    /// of the old item and the first of the new one (transitionGapUs).
+    void beginAudioTransition();
+
     // ────────────────────────────────────────────────────────
     //  Lifecycle helpers
     // ────────────────────────────────────────────────────────
@@ -141,10 +186,17 @@ public:
     /// Release all resources (video + audio).
     void cleanup();
 
+    /// Pipeline performance counters (thread-safe, lock-free).
+    PlayerStats &stats();
+    const PlayerStats &stats() const;
+
+    /// sws_scale() flags for @p mode.
+    static int toSwsFlags(SwsFilterMode mode);
+
 signals:
-    /// Emitted (on decode thread) whenever a new QImage is ready.
-    /// Connect with Qt::QueuedConnection to receive on the GUI thread.
-    void videoFrameReady(const QImage &image);
+    /// Emitted (on decode thread) in OpenGLTexture mode whenever a new frame
+    /// is ready.  Connect with Qt::QueuedConnection to receive on the GUI thread.
+    void videoFrameReady(const GLVideoFrame &frame);
 
     /// Emitted when the audio clock is updated (for A/V sync UI).
     void audioClockUpdated(double seconds);
@@ -153,22 +205,38 @@ private:
     // ── Video ──
     VideoRenderMode     m_renderMode  = VideoRenderMode::QVideoSink;
     SwsFilterMode       m_swsFilter   = SwsFilterMode::Bilinear;
-    SwsContext         *m_swsCtx      = nullptr;
+    SwsContext         *m_swsCtx      = nullptr;   ///< borrowed from m_swsCache
+    SwsContextCache     m_swsCache;
     int                 m_srcWidth    = 0;
     int                 m_srcHeight   = 0;
     AVPixelFormat       m_srcPixFmt   = AV_PIX_FMT_NONE;
+    AVColorSpace        m_srcColorSpace = AVCOL_SPC_UNSPECIFIED;
+    AVColorRange        m_srcColorRange = AVCOL_RANGE_UNSPECIFIED;
     bool                m_is10bit     = false;   ///< true when source is >8-bit
+    std::atomic<AVRational> m_videoTimeBase{AVRational{0, 1}};   ///< set per frame by the filter thread
+
+    // HDR tone mapping (curve applied by the renderer)
+    std::atomic<ToneMapper> m_toneMapper{ToneMapper::Bt2390};
+    HdrPeakDetector     m_peakDetector;
 
     // QVideoSink path
     QVideoSink         *m_videoSink  = nullptr;
     std::mutex          m_videoSinkMutex;   ///< guards m_videoSink across threads
 
+    // Performance counters
+    PlayerStats         m_stats;
+
+    // Recycled output buffers for QVideoFrame / QImage delivery
+    std::shared_ptr<FrameBufferPool> m_bufferPool;
+
     // Volume (0.0 – 1.0 linear gain, applied to QAudioSink)
     std::atomic<qreal>  m_volume{0.8};
 
     // ── Audio ──
     SwrContext         *m_swrCtx     = nullptr;
-    int                 m_srcSampleRate = 0;
+    int                 m_srcSampleRate = 0;           ///< source m_swrCtx was built for
+    AVSampleFormat      m_srcSampleFmt  = AV_SAMPLE_FMT_NONE;
+    AVChannelLayout     m_srcChLayout{};
     AVRational          m_audioTimeBase{0, 1};  ///< stream time_base for PTS
 
     // Audio output (created on first processAudioFrame call)
@@ -176,17 +244,34 @@ private:
     QIODevice          *m_audioIO    = nullptr;   // non-owning, from QAudioSink::start()
     std::mutex          m_audioMutex;             // guards m_audioSink/m_audioIO operations
 
+    /// PCM of one frame waiting for room in the device buffer.
+    struct PendingAudio {
+        QByteArray data;
+        int        offset = 0;     ///< bytes already written
+        double     clock  = 0.0;   ///< audio clock once fully written
+    };
+    std::deque<PendingAudio> m_pendingAudio;   ///< under m_audioMutex
+
     // Audio clock
     std::atomic<double> m_audioClock{0.0};
-    std::atomic<bool>   m_audioAbort{false};      ///< set by cleanupAudio() to unblock write loop
+    std::atomic<bool>   m_audioAbort{false};      ///< set by cleanupAudio() to drop pending PCM
+    bool                m_nullAudioOutput = false;   ///< setNullAudioOutput()
 
-    // ── RTX VSR ──
-    std::unique_ptr<class RtxVsrClient> m_vsrClient;
+    // Playlist transition gap (audio decode thread, under m_audioMutex)
+    QElapsedTimer       m_audioWriteClock;
+    qint64              m_lastWriteNs       = -1;  ///< m_audioWriteClock at the last write
+    qint64              m_lastBufferedUs    = 0;   ///< audio queued in the sink after it
+    std::atomic<bool>   m_transitionPending{false};
+
+    // ── VSR ──
+    std::unique_ptr<class VsrBackend> m_vsrBackend;
+    VsrWorker         m_vsrWorker;      ///< upscales off the decode thread
     std::atomic<bool> m_vsrEnabled{false};
-    bool              m_vsrInitFailed  = false;
-    bool              m_vsrFirstFrame  = true;
-    int               m_vsrFrameCount  = 0;
-    std::vector<uint8_t> m_vsrOutBuffer;
+    std::atomic<bool> m_vsrInitFailed{false};
+    bool              m_vsrFirstFrame  = true;   ///< worker thread
+    int               m_vsrFrameCount  = 0;      ///< worker thread
+    int               m_vsrFailures    = 0;      ///< worker thread, consecutive
+    static constexpr int kMaxVsrFailures = 3;
     std::atomic<int>  m_displayWidth{0};
     std::atomic<int>  m_displayHeight{0};
 
@@ -197,13 +282,23 @@ private:
     // ── Helpers ──
     bool ensureAudioSink();
     bool createAudioSinkImpl();   ///< Must run on the main (GUI) thread
-    static int  toSwsFlags(SwsFilterMode mode);
+    void releaseAudioOutput();    ///< free the sink and the resampler
+    SwsContext *acquireSwsContext(AVPixelFormat dstFmt);
     static bool is10BitFormat(AVPixelFormat fmt);
 
+    /// Stamp pts / presentation time and emit videoFrameReady.
+    void deliverGLFrame(GLVideoFrame glFrame, const AVFrame *src);
+
     // ── VSR ──
+    bool ensureVsrBackend();
+    /// Initialise the backend if needed and queue @p frame on m_vsrWorker.
+    /// Returns false if the frame must take the legacy path instead.
     bool tryProcessVsr(AVFrame *frame);
+    /// Runs on m_vsrWorker: upscale into a pooled frame and deliver it.
+    void processVsrJob(const AVFrame *frame, int outW, int outH);
+    static void logVsrFirstFrame(const uint8_t *pixels);
     void resetVsrState();
     void shutdownVsr();        ///< full GPU teardown (disable / app exit)
 
-    QThread *m_vsrWarmupThread = nullptr;
+    PipelineExecutor::TaskGroup m_vsrWarmup;   ///< background backend warm-up
 };
@@ -0,0 +1,132 @@
+#include "FrameQueue.h"
+
+FrameQueue::FrameQueue(size_t maxSize)
+    : m_maxSize(maxSize) {}
+
+FrameQueue::~FrameQueue()
+{
+    m_canPush = nullptr;   // the stages they wake may already be gone
+    m_canPop  = nullptr;
+    flush();
+}
+
+bool FrameQueue::push(const AVFrame *frame)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_condPush.wait(lock, [this] { return m_aborted || m_queue.size() < m_maxSize; });
+        if (m_aborted) return false;
+
+        AVFrame *ref = av_frame_clone(frame);
+        if (!ref) return false;
+        m_queue.push(ref);
+        m_condPop.notify_one();
+    }
+    notifyCanPop();
+    return true;
+}
+
+bool FrameQueue::pop(AVFrame **out)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_condPop.wait(lock, [this] { return m_aborted || !m_queue.empty() || m_eof; });
+        if (m_aborted || m_queue.empty()) return false;
+
+        *out = m_queue.front();
+        m_queue.pop();
+        m_condPush.notify_one();
+    }
+    notifyCanPush();
+    return true;
+}
+
+FrameQueue::TryResult FrameQueue::tryPush(const AVFrame *frame)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_aborted) return TryResult::Closed;
+        if (m_queue.size() >= m_maxSize) return TryResult::WouldBlock;
+
+        AVFrame *ref = av_frame_clone(frame);
+        if (!ref) return TryResult::Done;   // out of memory: the frame is dropped
+        m_queue.push(ref);
+        m_condPop.notify_one();
+    }
+    notifyCanPop();
+    return TryResult::Done;
+}
+
+FrameQueue::TryResult FrameQueue::tryPop(AVFrame **out)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_aborted) return TryResult::Closed;
+        if (m_queue.empty()) return m_eof ? TryResult::Closed : TryResult::WouldBlock;
+
+        *out = m_queue.front();
+        m_queue.pop();
+        m_condPush.notify_one();
+    }
+    notifyCanPush();
+    return TryResult::Done;
+}
+
+void FrameQueue::setReadyCallbacks(std::function<void()> canPush, std::function<void()> canPop)
+{
+    std::lock_guard lock(m_mutex);
+    m_canPush = std::move(canPush);
+    m_canPop  = std::move(canPop);
+}
+
+void FrameQueue::flush()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        while (!m_queue.empty()) {
+            AVFrame *frame = m_queue.front();
+            m_queue.pop();
+            av_frame_free(&frame);
+        }
+        m_condPush.notify_all();
+    }
+    notifyCanPush();
+}
+
+void FrameQueue::abort()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_aborted = true;
+        m_condPush.notify_all();
+        m_condPop.notify_all();
+    }
+    notifyCanPush();
+    notifyCanPop();
+}
+
+void FrameQueue::signalEOF()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_eof = true;
+        m_condPop.notify_all();
+    }
+    notifyCanPop();
+}
+
+void FrameQueue::restart()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_aborted = false;
+        m_eof     = false;
+    }
+    notifyCanPush();
+}
+
+size_t FrameQueue::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_queue.size();
+}
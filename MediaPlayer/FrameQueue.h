@@ -0,0 +1,75 @@
+#pragma once
+
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+/// @brief Thread-safe bounded blocking queue for decoded AVFrame pointers.
+///
+/// Sits between the video decode stage (pushes frames) and the video
+/// filter stage (pops, filters and presents them).  Frames are queued by
+/// reference, so a push never copies pixel data.  Keep the capacity small:
+/// every queued frame pins a full decoded picture.
+class FrameQueue
+{
+public:
+    /// See PacketQueue::TryResult.
+    enum class TryResult { Done, WouldBlock, Closed };
+
+    explicit FrameQueue(size_t maxSize = 4);
+    ~FrameQueue();
+
+    // Non-copyable, non-movable
+    FrameQueue(const FrameQueue &) = delete;
+    FrameQueue &operator=(const FrameQueue &) = delete;
+
+    /// Enqueue a frame (blocks if full, returns false if aborted).
+    /// The queue takes a new reference — caller still owns @p frame.
+    bool push(const AVFrame *frame);
+
+    /// Dequeue a frame (blocks if empty, returns false if aborted or
+    /// EOF-drained).  On success the caller must av_frame_free(*out).
+    bool pop(AVFrame **out);
+
+    /// push() without blocking: WouldBlock when full.
+    TryResult tryPush(const AVFrame *frame);
+
+    /// pop() without blocking: Closed when aborted or EOF-drained.
+    TryResult tryPop(AVFrame **out);
+
+    /// See PacketQueue::setReadyCallbacks().
+    void setReadyCallbacks(std::function<void()> canPush, std::function<void()> canPop);
+
+    /// Drop all buffered frames.
+    void flush();
+
+    /// Wake all blocked threads so they can exit.
+    void abort();
+
+    /// Signal that no more frames will be pushed (see PacketQueue::signalEOF).
+    void signalEOF();
+
+    /// Reset the aborted/EOF flags so the queue can be reused.
+    void restart();
+
+    size_t size() const;
+
+private:
+    mutable std::mutex        m_mutex;
+    std::condition_variable   m_condPush;
+    std::condition_variable   m_condPop;
+    std::queue<AVFrame *>     m_queue;
+    size_t                    m_maxSize;
+    bool                      m_aborted = false;
+    bool                      m_eof     = false;
+    std::function<void()>     m_canPush;
+    std::function<void()>     m_canPop;
+
+    void notifyCanPush() const { if (m_canPush) m_canPush(); }
+    void notifyCanPop()  const { if (m_canPop)  m_canPop(); }
+};
@@ -0,0 +1,147 @@
+#include "HdrPeakDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include <libavutil/mastering_display_metadata.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace {
+
+constexpr float kDefaultPeakNits = 1000.0f;   ///< untagged PQ, nominal HLG display
+
+/// SMPTE ST 2084 EOTF: normalised signal → nits
+float pqToNits(float e)
+{
+    constexpr float m1 = 0.1593017578125f, m2 = 78.84375f;
+    constexpr float c1 = 0.8359375f, c2 = 18.8515625f, c3 = 18.6875f;
+    const float p = std::pow(std::max(e, 0.0f), 1.0f / m2);
+    return 10000.0f * std::pow(std::max(p - c1, 0.0f) / (c2 - c3 * p), 1.0f / m1);
+}
+
+/// ARIB STD-B67 inverse OETF followed by the BT.2100 OOTF for a 1000-nit
+/// display (system gamma 1.2), applied to luma.
+float hlgToNits(float e)
+{
+    constexpr float a = 0.17883277f, b = 0.28466892f, c = 0.55991073f;
+    e = std::clamp(e, 0.0f, 1.0f);
+    const float scene = e <= 0.5f ? e * e / 3.0f : (std::exp((e - c) / a) + b) / 12.0f;
+    return kDefaultPeakNits * std::pow(scene, 1.2f);
+}
+
+} // namespace
+
+bool HdrPeakDetector::isHdrTransfer(AVColorTransferCharacteristic trc)
+{
+    return trc == AVCOL_TRC_SMPTE2084 || trc == AVCOL_TRC_ARIB_STD_B67;
+}
+
+float HdrPeakDetector::metadataPeakNits(const AVFrame *frame)
+{
+    if (!frame) return 0.0f;
+
+    if (const AVFrameSideData *sd = av_frame_get_side_data(frame, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL)) {
+        const auto *cll = reinterpret_cast<const AVContentLightMetadata *>(sd->data);
+        if (cll->MaxCLL > 0)
+            return static_cast<float>(cll->MaxCLL);
+    }
+    if (const AVFrameSideData *sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA)) {
+        const auto *mdm = reinterpret_cast<const AVMasteringDisplayMetadata *>(sd->data);
+        if (mdm->has_luminance && mdm->max_luminance.den > 0)
+            return static_cast<float>(av_q2d(mdm->max_luminance));
+    }
+    return 0.0f;
+}
+
+float HdrPeakDetector::update(const AVFrame *frame)
+{
+    if (!frame || !isHdrTransfer(frame->color_trc))
+        return 0.0f;
+
+    // Side data is usually only attached to keyframes — keep the last one.
+    const float metadata = metadataPeakNits(frame);
+    if (metadata > 0.0f)
+        m_staticPeak = metadata;
+
+    const float ceiling = m_staticPeak > 0.0f ? m_staticPeak
+                        : frame->color_trc == AVCOL_TRC_ARIB_STD_B67 ? kDefaultPeakNits
+                        : 10000.0f;
+
+    const float measured = measureFramePeak(frame);
+    if (measured <= 0.0f)
+        return std::max(m_staticPeak > 0.0f ? m_staticPeak : kDefaultPeakNits, kSdrWhiteNits);
+
+    if (m_smoothedPeak <= 0.0f) {
+        m_smoothedPeak = measured;
+    } else {
+        // Brighten within a few frames, darken over ~2 s at 24 fps so the
+        // curve does not visibly breathe between shots.
+        const float k = measured > m_smoothedPeak ? 0.25f : 0.02f;
+        m_smoothedPeak += (measured - m_smoothedPeak) * k;
+    }
+    return std::clamp(m_smoothedPeak, kSdrWhiteNits, std::max(ceiling, kSdrWhiteNits));
+}
+
+void HdrPeakDetector::reset()
+{
+    m_staticPeak   = 0.0f;
+    m_smoothedPeak = 0.0f;
+}
+
+float HdrPeakDetector::measureFramePeak(const AVFrame *frame)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_RGB
+                                 | AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_FLOAT)))
+        return 0.0f;
+
+    const AVComponentDescriptor &luma = desc->comp[0];
+    if (luma.plane != 0 || luma.depth < 8 || luma.depth > 16 || !frame->data[0])
+        return 0.0f;
+
+    const int depth = luma.depth;
+    const uint32_t mask = (1u << depth) - 1u;
+    const int width  = frame->width;
+    const int height = frame->height;
+
+    m_histogram.fill(0);
+    uint32_t samples = 0;
+
+    for (int y = kSampleStep / 2; y < height; y += kSampleStep) {
+        const uint8_t *row = frame->data[0] + static_cast<ptrdiff_t>(y) * frame->linesize[0] + luma.offset;
+        if (depth == 8) {
+            for (int x = kSampleStep / 2; x < width; x += kSampleStep)
+                ++m_histogram[(row[static_cast<ptrdiff_t>(x) * luma.step] * kBins) >> 8];
+        } else {
+            for (int x = kSampleStep / 2; x < width; x += kSampleStep) {
+                uint16_t v;
+                std::memcpy(&v, row + static_cast<ptrdiff_t>(x) * luma.step, sizeof(v));
+                const uint32_t code = (static_cast<uint32_t>(v) >> luma.shift) & mask;
+                ++m_histogram[(code * kBins) >> depth];
+            }
+        }
+        samples += static_cast<uint32_t>((width - kSampleStep / 2 + kSampleStep - 1) / kSampleStep);
+    }
+    if (samples == 0)
+        return 0.0f;
+
+    // 99.9th percentile: ignore the brightest 0.1 % (specular highlights,
+    // noise) so single pixels do not drive the whole frame's curve.
+    const uint32_t skip = samples / 1000;
+    uint32_t above = 0;
+    int bin = kBins - 1;
+    for (; bin > 0; --bin) {
+        above += m_histogram[bin];
+        if (above > skip) break;
+    }
+
+    float signal = (static_cast<float>(bin) + 1.0f) / kBins;   // upper edge of the bin
+    if (frame->color_range != AVCOL_RANGE_JPEG)
+        signal = (signal - 16.0f / 255.0f) * (255.0f / 219.0f);
+    signal = std::clamp(signal, 0.0f, 1.0f);
+
+    return frame->color_trc == AVCOL_TRC_ARIB_STD_B67 ? hlgToNits(signal) : pqToNits(signal);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+/// @brief Source peak luminance for HDR → SDR tone mapping.
+///
+/// Static metadata (MaxCLL, mastering display luminance) describes the whole
+/// title and is often missing or far above what a given scene uses, which
+/// makes tone-mapped output needlessly dim.  The detector therefore also
+/// measures each frame on a subsampled luma plane (1 in 8 rows × 1 in 8
+/// pixels — ~130k samples at 4K), takes a high percentile of the histogram
+/// so isolated specular pixels do not pump the curve, and smooths it over
+/// time (fast attack, slow release).  The metadata peak, when present,
+/// caps the measurement.
+///
+/// Not thread-safe: used from the video decode thread only.
+class HdrPeakDetector
+{
+public:
+    /// Reference white of SDR content in an HDR signal (ITU-R BT.2408).
+    static constexpr float kSdrWhiteNits = 203.0f;
+
+    /// True for the PQ (SMPTE ST 2084) and HLG (ARIB STD-B67) transfers.
+    static bool isHdrTransfer(AVColorTransferCharacteristic trc);
+
+    /// Peak from the frame's side data: MaxCLL if present, otherwise the
+    /// mastering display's max luminance.  0 when neither is attached.
+    static float metadataPeakNits(const AVFrame *frame);
+
+    /// Feed a decoded frame; returns the peak (nits) to tone map from, or 0
+    /// for SDR frames.
+    float update(const AVFrame *frame);
+
+    /// Forget the temporal state (new stream, seek).
+    void reset();
+
+private:
+    /// 99.9th percentile of the subsampled luma plane, in nits; 0 if the
+    /// pixel format cannot be read.
+    float measureFramePeak(const AVFrame *frame);
+
+    static constexpr int kSampleStep = 8;
+    static constexpr int kBins       = 256;
+
+    std::array<uint32_t, kBins> m_histogram{};
+    float m_staticPeak   = 0.0f;   ///< last seen side-data peak
+    float m_smoothedPeak = 0.0f;
+};
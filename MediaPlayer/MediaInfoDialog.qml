@@ -69,6 +69,20 @@ Dialog {
 
             Label { text: qsTr("Channels") }
             Label { text: root.manager.hasMedia ? root.manager.audioChannels.toString() : "-" }
+
+            // ── Performance ──
+            Label { text: qsTr("Performance"); font.bold: true; Layout.columnSpan: 2; Layout.topMargin: 8 }
+
+            Repeater {
+                model: root.manager.hasMedia ? Object.keys(root.manager.stats) : []
+
+                Label {
+                    required property string modelData
+                    text: modelData + ": " + root.manager.stats[modelData]
+                    opacity: 0.8
+                    Layout.columnSpan: 2
+                }
+            }
         }
     }
 }
@@ -5,75 +5,135 @@ PacketQueue::PacketQueue(size_t maxSize)
 
 PacketQueue::~PacketQueue()
 {
+    m_canPush = nullptr;   // the stages they wake may already be gone
+    m_canPop  = nullptr;
     flush();
 }
 
 bool PacketQueue::push(AVPacket *pkt)
 {
-    std::unique_lock lock(m_mutex);
-    // Block until there is room or we are told to abort
-    m_condPush.wait(lock, [this] { return m_aborted || m_queue.size() < m_maxSize; });
-    if (m_aborted) return false;
-
-    AVPacket *clone = av_packet_clone(pkt);
-    m_queue.push(clone);
-    m_condPop.notify_one();          // wake one waiting consumer
+    {
+        std::unique_lock lock(m_mutex);
+        // Block until there is room or we are told to abort
+        m_condPush.wait(lock, [this] { return m_aborted || m_queue.size() < m_maxSize; });
+        if (m_aborted) return false;
+
+        AVPacket *clone = av_packet_clone(pkt);
+        m_queue.push(clone);
+        m_condPop.notify_one();          // wake one waiting consumer
+    }
+    notifyCanPop();
     return true;
 }
 
 bool PacketQueue::pop(AVPacket **out)
 {
-    std::unique_lock lock(m_mutex);
-    // Block until a packet is available, aborted, or EOF with empty queue
-    m_condPop.wait(lock, [this] { return m_aborted || !m_queue.empty() || m_eof; });
-    if (m_queue.empty()) return false;   // aborted or EOF-drained
-
-    *out = m_queue.front();
-    m_queue.pop();
-    m_condPush.notify_one();         // wake one waiting producer
+    {
+        std::unique_lock lock(m_mutex);
+        // Block until a packet is available, aborted, or EOF with empty queue
+        m_condPop.wait(lock, [this] { return m_aborted || !m_queue.empty() || m_eof; });
+        if (m_queue.empty()) return false;   // aborted or EOF-drained
+
+        *out = m_queue.front();
+        m_queue.pop();
+        m_condPush.notify_one();         // wake one waiting producer
+    }
+    notifyCanPush();
     return true;
 }
 
-void PacketQueue::flush()
+PacketQueue::TryResult PacketQueue::tryPush(AVPacket *pkt)
 {
-    std::lock_guard lock(m_mutex);
-    while (!m_queue.empty()) {
-        AVPacket *pkt = m_queue.front();
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_aborted) return TryResult::Closed;
+        if (m_queue.size() >= m_maxSize) return TryResult::WouldBlock;
+
+        m_queue.push(av_packet_clone(pkt));
+        m_condPop.notify_one();
+    }
+    notifyCanPop();
+    return TryResult::Done;
+}
+
+PacketQueue::TryResult PacketQueue::tryPop(AVPacket **out)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.empty())
+            return (m_aborted || m_eof) ? TryResult::Closed : TryResult::WouldBlock;
+
+        *out = m_queue.front();
         m_queue.pop();
-        av_packet_free(&pkt);
+        m_condPush.notify_one();
     }
-    // After flush the queue is empty — wake any blocked producer
-    m_condPush.notify_all();
+    notifyCanPush();
+    return TryResult::Done;
 }
 
-void PacketQueue::abort()
+void PacketQueue::setReadyCallbacks(std::function<void()> canPush, std::function<void()> canPop)
 {
     std::lock_guard lock(m_mutex);
-    m_aborted = true;
-    m_condPush.notify_all();
-    m_condPop.notify_all();
+    m_canPush = std::move(canPush);
+    m_canPop  = std::move(canPop);
+}
+
+void PacketQueue::flush()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        while (!m_queue.empty()) {
+            AVPacket *pkt = m_queue.front();
+            m_queue.pop();
+            av_packet_free(&pkt);
+        }
+        // After flush the queue is empty — wake any blocked producer
+        m_condPush.notify_all();
+    }
+    notifyCanPush();
+}
+
+void PacketQueue::abort()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_aborted = true;
+        m_condPush.notify_all();
+        m_condPop.notify_all();
+    }
+    notifyCanPush();
+    notifyCanPop();
 }
 
 void PacketQueue::signalEOF()
 {
-    std::lock_guard lock(m_mutex);
-    m_eof = true;
-    m_condPop.notify_all();   // wake consumers so they see EOF once drained
+    {
+        std::lock_guard lock(m_mutex);
+        m_eof = true;
+        m_condPop.notify_all();   // wake consumers so they see EOF once drained
+    }
+    notifyCanPop();
 }
 
 void PacketQueue::restart()
 {
-    std::lock_guard lock(m_mutex);
-    m_aborted = false;
-    m_eof     = false;
+    {
+        std::lock_guard lock(m_mutex);
+        m_aborted = false;
+        m_eof     = false;
+    }
+    notifyCanPush();
 }
 
 void PacketQueue::setMaxSize(size_t maxSize)
 {
-    std::lock_guard lock(m_mutex);
-    m_maxSize = maxSize;
-    // If capacity increased, wake producers that may have been blocked
-    m_condPush.notify_all();
+    {
+        std::lock_guard lock(m_mutex);
+        m_maxSize = maxSize;
+        // If capacity increased, wake producers that may have been blocked
+        m_condPush.notify_all();
+    }
+    notifyCanPush();
 }
 
 size_t PacketQueue::size() const
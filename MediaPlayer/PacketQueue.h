@@ -3,6 +3,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -10,11 +11,19 @@ extern "C" {
 
 /// @brief Thread-safe bounded blocking queue for AVPacket pointers.
 ///
-/// Designed for the producer-consumer pattern between the demux thread
-/// (pushes packets) and the decode thread (pops packets).
+/// Designed for the producer-consumer pattern between the demux stage
+/// (pushes packets) and a decode stage (pops packets).  The stages use the
+/// non-blocking tryPush() / tryPop() and are woken by the ready callbacks;
+/// push() / pop() block the calling thread.
 class PacketQueue
 {
 public:
+    enum class TryResult {
+        Done,
+        WouldBlock,   ///< full (tryPush) or empty (tryPop): wait for a ready callback
+        Closed,       ///< aborted, or drained after signalEOF()
+    };
+
     explicit PacketQueue(size_t maxSize = 128);
     ~PacketQueue();
 
@@ -30,6 +39,17 @@ public:
     /// On success *out is a newly allocated AVPacket; caller must av_packet_free().
     bool pop(AVPacket **out);
 
+    /// push() without blocking: WouldBlock when full.
+    TryResult tryPush(AVPacket *pkt);
+
+    /// pop() without blocking: WouldBlock when empty and more may come.
+    TryResult tryPop(AVPacket **out);
+
+    /// @p canPush runs whenever room may have been made, @p canPop whenever
+    /// a packet, EOF or abort arrives; both outside the lock.  Set before
+    /// the queue is shared.
+    void setReadyCallbacks(std::function<void()> canPush, std::function<void()> canPop);
+
     /// Drop all buffered packets, freeing their memory.
     void flush();
 
@@ -58,4 +78,9 @@ private:
     size_t                    m_maxSize;
     bool                      m_aborted = false;
     bool                      m_eof     = false;   ///< no more pushes coming
+    std::function<void()>     m_canPush;
+    std::function<void()>     m_canPop;
+
+    void notifyCanPush() const { if (m_canPush) m_canPush(); }
+    void notifyCanPop()  const { if (m_canPop)  m_canPop(); }
 };
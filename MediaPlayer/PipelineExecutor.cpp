@@ -0,0 +1,267 @@
+#include "PipelineExecutor.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Identifies the pool worker running on this thread (-1 = not a worker).
+thread_local int t_workerIndex = -1;
+
+// Orders PipelineExecutor::m_timed as a min-heap on the deadline.
+constexpr auto laterDue = [](const auto &a, const auto &b) { return a.due > b.due; };
+}
+
+// ── TaskGroup ──────────────────────────────────────────────
+
+void PipelineExecutor::TaskGroup::add()
+{
+    std::lock_guard lock(m_mutex);
+    ++m_pending;
+}
+
+void PipelineExecutor::TaskGroup::done()
+{
+    std::lock_guard lock(m_mutex);
+    if (--m_pending == 0)
+        m_cv.notify_all();
+}
+
+void PipelineExecutor::TaskGroup::wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+}
+
+bool PipelineExecutor::TaskGroup::busy() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_pending > 0;
+}
+
+// ── Executor ───────────────────────────────────────────────
+
+PipelineExecutor &PipelineExecutor::instance()
+{
+    static PipelineExecutor executor;
+    return executor;
+}
+
+PipelineExecutor::PipelineExecutor()
+    : m_cpuBudget(std::max(2, static_cast<int>(std::thread::hardware_concurrency())))
+{
+}
+
+PipelineExecutor::~PipelineExecutor()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+
+    const int count = m_workerCount.load();
+    for (int i = 0; i < count; ++i) {
+        if (m_workers[i]->thread.joinable())
+            m_workers[i]->thread.join();
+    }
+}
+
+void PipelineExecutor::submit(Lane lane, Task task, TaskGroup *group)
+{
+    if (!task) return;
+    if (group) group->add();
+    enqueue(static_cast<int>(lane), Job{std::move(task), group, isStageLane(lane)});
+}
+
+void PipelineExecutor::submitAfter(Lane lane, std::chrono::microseconds delay, Task task,
+                                   TaskGroup *group)
+{
+    if (delay.count() <= 0) {
+        submit(lane, std::move(task), group);
+        return;
+    }
+    if (!task) return;
+    if (group) group->add();
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_timed.push_back(TimedJob{Clock::now() + delay, static_cast<int>(lane),
+                                   Job{std::move(task), group, isStageLane(lane)}});
+        std::push_heap(m_timed.begin(), m_timed.end(), laterDue);
+        if (m_workerCount.load() == 0)
+            spawnWorkerLocked();
+    }
+    m_cv.notify_one();   // an idle worker re-arms its timeout
+}
+
+void PipelineExecutor::enqueue(int laneIdx, Job job)
+{
+    const bool stage = job.stage;
+    if (t_workerIndex >= 0) {
+        Worker &self = *m_workers[t_workerIndex];
+        std::lock_guard lock(self.mutex);
+        self.lanes[laneIdx].push_back(std::move(job));
+    } else {
+        std::lock_guard lock(m_injectMutex);
+        m_inject[laneIdx].push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_queued;
+        // Stage steps and other tasks each grow the pool up to one busy
+        // worker per core: stages never wait behind a long open or scan,
+        // and neither kind oversubscribes the CPU on its own.
+        const int busy       = m_workerCount.load() - m_idle;
+        const int busyOfKind = stage ? m_stagesRunning : busy - m_stagesRunning;
+        if (m_queued > m_idle && busyOfKind < m_cpuBudget)
+            spawnWorkerLocked();
+    }
+    m_cv.notify_one();
+}
+
+QVariantMap PipelineExecutor::stats() const
+{
+    int busy = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        busy = m_workerCount.load() - m_idle;
+    }
+    QVariantMap map;
+    map.insert("executorWorkers", m_workerCount.load());
+    map.insert("executorBusy",    busy);
+    map.insert("executorTasks",   static_cast<qulonglong>(m_tasksRun.load()));
+    map.insert("executorSteals",  static_cast<qulonglong>(m_steals.load()));
+    return map;
+}
+
+const char *PipelineExecutor::laneName(Lane lane)
+{
+    switch (lane) {
+    case Lane::Audio:      return "audio";
+    case Lane::Video:      return "video";
+    case Lane::Demux:      return "demux";
+    case Lane::Io:         return "io";
+    case Lane::Background: return "background";
+    }
+    return "unknown";
+}
+
+bool PipelineExecutor::isStageLane(Lane lane)
+{
+    return lane == Lane::Audio || lane == Lane::Video || lane == Lane::Demux;
+}
+
+void PipelineExecutor::spawnWorkerLocked()
+{
+    const int index = m_workerCount.load();
+    if (index >= kMaxWorkers) {
+        qWarning() << "PipelineExecutor::submit - worker limit reached, task queued";
+        return;
+    }
+    m_workers[index] = std::make_unique<Worker>();
+    ++m_idle;
+    m_workers[index]->thread = std::thread(&PipelineExecutor::run, this, index);
+    m_workerCount.store(index + 1);   // publish after the slot is filled
+}
+
+int PipelineExecutor::promoteDueLocked()
+{
+    int promoted = 0;
+    const Clock::time_point now = Clock::now();
+    while (!m_timed.empty() && m_timed.front().due <= now) {
+        std::pop_heap(m_timed.begin(), m_timed.end(), laterDue);
+        TimedJob timed = std::move(m_timed.back());
+        m_timed.pop_back();
+        {
+            std::lock_guard lock(m_injectMutex);
+            m_inject[timed.lane].push_back(std::move(timed.job));
+        }
+        ++m_queued;
+        ++promoted;
+    }
+    return promoted;
+}
+
+bool PipelineExecutor::popLane(std::deque<Job> &queue, bool back, Job &job)
+{
+    if (queue.empty()) return false;
+    if (back) {
+        job = std::move(queue.back());
+        queue.pop_back();
+    } else {
+        job = std::move(queue.front());
+        queue.pop_front();
+    }
+    return true;
+}
+
+bool PipelineExecutor::takeJob(int self, Job &job)
+{
+    const int count = m_workerCount.load();
+
+    // Lane by lane so a queued Audio task always beats a Background one,
+    // wherever it sits.
+    for (int lane = 0; lane < kLaneCount; ++lane) {
+        {
+            Worker &own = *m_workers[self];
+            std::lock_guard lock(own.mutex);
+            if (popLane(own.lanes[lane], true, job)) return true;
+        }
+        {
+            std::lock_guard lock(m_injectMutex);
+            if (popLane(m_inject[lane], false, job)) return true;
+        }
+        for (int i = 1; i < count; ++i) {
+            Worker &victim = *m_workers[(self + i) % count];
+            std::lock_guard lock(victim.mutex);
+            if (popLane(victim.lanes[lane], false, job)) {
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PipelineExecutor::run(int index)
+{
+    t_workerIndex = index;
+
+    for (;;) {
+        int promoted = 0;
+        {
+            std::lock_guard lock(m_mutex);
+            promoted = promoteDueLocked();
+        }
+        if (promoted > 1) m_cv.notify_all();
+
+        Job job;
+        if (takeJob(index, job)) {
+            {
+                std::lock_guard lock(m_mutex);
+                --m_queued;
+                --m_idle;
+                if (job.stage) ++m_stagesRunning;
+            }
+            job.task();
+            job.task = nullptr;   // release captures before signalling
+            m_tasksRun.fetch_add(1, std::memory_order_relaxed);
+            if (job.group) job.group->done();
+            {
+                std::lock_guard lock(m_mutex);
+                ++m_idle;
+                if (job.stage) --m_stagesRunning;
+            }
+            continue;
+        }
+
+        std::unique_lock lock(m_mutex);
+        if (m_stopping && m_queued <= 0) return;
+        const auto ready = [this] { return m_stopping || m_queued > 0; };
+        if (m_timed.empty())
+            m_cv.wait(lock, ready);
+        else
+            m_cv.wait_until(lock, m_timed.front().due, ready);   // then promote it
+        if (m_stopping && m_queued <= 0) return;
+    }
+}
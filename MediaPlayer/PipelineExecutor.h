@@ -0,0 +1,157 @@
+#pragma once
+
+#include <QVariantMap>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Process-wide pool of worker threads shared by every player.
+///
+/// Pipeline stages (demux, video decode, video filter, audio decode) and
+/// one-off jobs (opening a file) are submitted as tasks instead of getting
+/// a thread of their own.  Workers are created on demand and parked when
+/// idle, so once the pool has warmed up play / stop / seek / open never
+/// create or join a thread.
+///
+/// Every task belongs to a lane.  A free worker always takes the highest
+/// lane available: Audio > Video > Demux > Io > Background.  Tasks submitted from
+/// a worker go to that worker's own deque (LIFO, cache-warm); tasks from
+/// other threads go to a shared injection queue; idle workers steal from
+/// the front of the other workers' deques.
+///
+/// Pipeline stages are PipelineStage steps: short tasks that return to the
+/// executor when their queue is empty or full, or the player is paused,
+/// and are resubmitted on wakeup, so a stage holds a worker only while it
+/// has work.  The pool grows on demand to one worker per core for the
+/// stage lanes and one per core for Io / Background, and no further: many
+/// players share the same workers, and a long open or library scan can
+/// never take the workers the stages need.  Timed tasks (submitAfter())
+/// serve A/V pacing without parking a worker in a sleep.
+/// Decoder-internal threads are budgeted separately by
+/// DecoderThreadingPolicy.
+class PipelineExecutor
+{
+public:
+    enum class Lane : uint8_t {
+        Audio = 0,
+        Video,
+        Demux,        ///< a stage lane, like Audio / Video
+        Io,
+        Background,
+    };
+    static constexpr int kLaneCount = 5;
+
+    using Task = std::function<void()>;
+
+    /// Counts the outstanding tasks submitted with it; wait() replaces
+    /// joining the threads that used to run them.
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /// Block until every task submitted with this group has returned.
+        void wait();
+
+        /// True while at least one task of the group is queued or running.
+        bool busy() const;
+
+    private:
+        friend class PipelineExecutor;
+        friend class PipelineStage;   // counts a stage until it finishes
+        void add();
+        void done();
+
+        mutable std::mutex      m_mutex;
+        std::condition_variable m_cv;
+        int                     m_pending = 0;
+    };
+
+    static PipelineExecutor &instance();
+
+    ~PipelineExecutor();
+
+    PipelineExecutor(const PipelineExecutor &) = delete;
+    PipelineExecutor &operator=(const PipelineExecutor &) = delete;
+
+    /// Queue @p task on @p lane.  With a @p group, group->wait() returns
+    /// only after the task has finished.
+    void submit(Lane lane, Task task, TaskGroup *group = nullptr);
+
+    /// Queue @p task on @p lane once @p delay has passed.  No worker is
+    /// held meanwhile; the task runs as soon as a worker is free after
+    /// the deadline.
+    void submitAfter(Lane lane, std::chrono::microseconds delay, Task task,
+                     TaskGroup *group = nullptr);
+
+    /// "executorWorkers", "executorBusy", "executorTasks", "executorSteals".
+    QVariantMap stats() const;
+
+    static const char *laneName(Lane lane);
+
+private:
+    PipelineExecutor();
+
+    struct Job {
+        Task       task;
+        TaskGroup *group = nullptr;
+        bool       stage = false;   ///< submitted on a stage lane
+    };
+
+    /// Audio, Video and Demux: pipeline stage steps.
+    static bool isStageLane(Lane lane);
+
+    using Clock = std::chrono::steady_clock;
+    struct TimedJob {
+        Clock::time_point due;
+        int               lane = 0;
+        Job               job;
+    };
+
+    struct Worker {
+        std::mutex                         mutex;
+        std::array<std::deque<Job>, kLaneCount> lanes;
+        std::thread                        thread;
+    };
+
+    static constexpr int kMaxWorkers = 256;
+
+    void run(int index);
+    bool takeJob(int self, Job &job);
+    bool popLane(std::deque<Job> &queue, bool back, Job &job);
+    void spawnWorkerLocked();
+    /// Move the timed jobs that are due to the injection queue; returns
+    /// how many.
+    int  promoteDueLocked();
+    void enqueue(int lane, Job job);
+
+    std::array<std::unique_ptr<Worker>, kMaxWorkers> m_workers;
+    std::atomic<int> m_workerCount{0};
+    const int        m_cpuBudget;   ///< busy workers per kind (stage / other) the pool grows to
+
+    // Shared injection queue for submits from non-worker threads
+    std::mutex                               m_injectMutex;
+    std::array<std::deque<Job>, kLaneCount>  m_inject;
+
+    // Sleep / accounting state
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_cv;
+    int                     m_idle     = 0;   ///< workers waiting for a job
+    int                     m_queued   = 0;   ///< jobs not yet taken
+    int                     m_stagesRunning = 0;   ///< workers inside a stage-lane task
+    std::vector<TimedJob>   m_timed;               ///< min-heap on due
+    bool                    m_stopping = false;
+
+    std::atomic<uint64_t> m_tasksRun{0};
+    std::atomic<uint64_t> m_steals{0};
+};
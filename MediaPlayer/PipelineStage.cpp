@@ -0,0 +1,66 @@
+#include "PipelineStage.h"
+
+PipelineStage::PipelineStage(PipelineExecutor::Lane lane)
+    : m_lane(lane) {}
+
+void PipelineStage::start(StepFunction step, PipelineExecutor::TaskGroup *group)
+{
+    if (group) group->add();
+    m_step  = std::move(step);
+    m_group = group;
+    m_state.store(Scheduled);
+    schedule({});
+}
+
+void PipelineStage::wake()
+{
+    int state = m_state.load();
+    for (;;) {
+        if (state == Parked) {
+            if (m_state.compare_exchange_weak(state, Scheduled)) {
+                schedule({});
+                return;
+            }
+        } else if (state == Running) {
+            if (m_state.compare_exchange_weak(state, RunningWoken))
+                return;
+        } else {
+            return;   // idle, or a step is already due
+        }
+    }
+}
+
+void PipelineStage::schedule(std::chrono::microseconds delay)
+{
+    PipelineExecutor::instance().submitAfter(m_lane, delay, [this] { runStep(); });
+}
+
+void PipelineStage::runStep()
+{
+    m_state.store(Running);
+    const Step step = m_step();
+
+    switch (step.next) {
+    case Next::Again:
+        m_state.store(Scheduled);
+        schedule(step.delay);
+        return;
+    case Next::Wait: {
+        int expected = Running;
+        if (m_state.compare_exchange_strong(expected, Parked))
+            return;
+        // Woken while the step ran: what it waited for may already be there.
+        m_state.store(Scheduled);
+        schedule({});
+        return;
+    }
+    case Next::Done: {
+        PipelineExecutor::TaskGroup *group = m_group;
+        m_step  = nullptr;
+        m_group = nullptr;
+        m_state.store(Idle);
+        if (group) group->done();   // last: the owner may start the stage again
+        return;
+    }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "PipelineExecutor.h"
+
+/// @brief A pipeline stage run as a series of short PipelineExecutor tasks.
+///
+/// The step function does a bounded amount of work and says what comes
+/// next: run again (after a delay, for A/V pacing), wait for wake() — its
+/// input queue is empty, its output queue full or the player paused — or
+/// stop.  Between steps the stage holds no worker.  wake() may be called
+/// from any thread at any time; one that lands while a step runs makes the
+/// stage run again instead of parking, so no wakeup is lost.
+class PipelineStage
+{
+public:
+    enum class Next { Again, Wait, Done };
+
+    struct Step {
+        Next                      next = Next::Again;
+        std::chrono::microseconds delay{0};   ///< Again only
+    };
+
+    static Step again(std::chrono::microseconds delay = {}) { return {Next::Again, delay}; }
+    static Step wait() { return {Next::Wait, {}}; }
+    static Step done() { return {Next::Done, {}}; }
+
+    using StepFunction = std::function<Step()>;
+
+    explicit PipelineStage(PipelineExecutor::Lane lane);
+
+    PipelineStage(const PipelineStage &) = delete;
+    PipelineStage &operator=(const PipelineStage &) = delete;
+
+    /// Run @p step until it returns done().  @p group counts the stage as
+    /// one task for that whole time.  The stage must be idle.
+    void start(StepFunction step, PipelineExecutor::TaskGroup *group);
+
+    /// Schedule a waiting stage; a no-op when it is idle or already due.
+    void wake();
+
+private:
+    enum State : int {
+        Idle,
+        Parked,         ///< returned wait()
+        Scheduled,      ///< a step is queued on the executor
+        Running,
+        RunningWoken,   ///< wake() arrived while the step ran
+    };
+
+    void schedule(std::chrono::microseconds delay);
+    void runStep();
+
+    const PipelineExecutor::Lane m_lane;
+    StepFunction                 m_step;
+    PipelineExecutor::TaskGroup *m_group = nullptr;
+    std::atomic<int>             m_state{Idle};
+};
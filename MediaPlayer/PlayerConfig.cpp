@@ -1,11 +1,11 @@
 #include "PlayerConfig.h"
 #include <algorithm>
-#include <QSettings>
+#include "SettingsStore.h"
 
 PlayerConfig::PlayerConfig(QObject *parent)
     : QObject(parent)
 {
-    QSettings settings;
+    const SettingsStore &settings = SettingsStore::instance();
     m_volume = settings.value("player/volume", m_volume).toInt();
     m_volume = std::clamp(m_volume, 0, 100);
     m_muted = settings.value("player/muted", m_muted).toBool();
@@ -13,11 +13,23 @@ PlayerConfig::PlayerConfig(QObject *parent)
         settings.value("player/renderMode", static_cast<int>(m_renderMode)).toInt());
     m_swsFilter = static_cast<SwsFilterMode>(
         settings.value("player/swsFilter", static_cast<int>(m_swsFilter)).toInt());
+    m_toneMapper = static_cast<ToneMapper>(std::clamp(
+        settings.value("player/toneMapper", static_cast<int>(m_toneMapper)).toInt(),
+        0, static_cast<int>(ToneMapper::Bt2390)));
+    m_videoFilter = settings.value("player/videoFilter", m_videoFilter).toString().trimmed();
+    m_deinterlaceMode = static_cast<DeinterlaceMode>(std::clamp(
+        settings.value("player/deinterlaceMode", static_cast<int>(m_deinterlaceMode)).toInt(),
+        0, static_cast<int>(DeinterlaceMode::Force)));
     m_realtimeSeekPreview = settings.value("player/realtimeSeekPreview", m_realtimeSeekPreview).toBool();
     m_decodeBackend = static_cast<VideoDecodeBackend>(
         settings.value("player/decodeBackend", static_cast<int>(m_decodeBackend)).toInt());
+    m_decodeThreads = std::clamp(settings.value("player/decodeThreads", m_decodeThreads).toInt(),
+                                 0, kMaxDecodeThreads);
+    m_decodeThreadType = static_cast<DecodeThreadType>(std::clamp(
+        settings.value("player/decodeThreadType", static_cast<int>(m_decodeThreadType)).toInt(),
+        0, static_cast<int>(DecodeThreadType::Slice)));
     m_preferZeroCopy = true;
-    settings.setValue("player/preferZeroCopy", true);
+    SettingsStore::instance().setValue("player/preferZeroCopy", true);
     m_allowHwFallback = settings.value("player/allowHwFallback", m_allowHwFallback).toBool();
     m_vsrEnabled = settings.value("player/vsrEnabled", m_vsrEnabled).toBool();
     m_videoFlipX = settings.value("player/videoFlipX", m_videoFlipX).toBool();
@@ -37,7 +49,7 @@ void PlayerConfig::setVolume(int vol)
     vol = std::clamp(vol, 0, 100);
     if (m_volume == vol) return;
     m_volume = vol;
-    QSettings().setValue("player/volume", m_volume);
+    SettingsStore::instance().setValue("player/volume", m_volume);
     emit volumeChanged();
 }
 
@@ -50,7 +62,7 @@ void PlayerConfig::setMuted(bool muted)
 {
     if (m_muted == muted) return;
     m_muted = muted;
-    QSettings().setValue("player/muted", m_muted);
+    SettingsStore::instance().setValue("player/muted", m_muted);
     emit mutedChanged();
 }
 
@@ -71,7 +83,7 @@ void PlayerConfig::setRenderMode(VideoRenderMode mode)
 {
     if (m_renderMode == mode) return;
     m_renderMode = mode;
-    QSettings().setValue("player/renderMode", static_cast<int>(m_renderMode));
+    SettingsStore::instance().setValue("player/renderMode", static_cast<int>(m_renderMode));
     emit renderModeChanged();
 }
 
@@ -96,7 +108,7 @@ void PlayerConfig::setSwsFilter(SwsFilterMode filter)
 {
     if (m_swsFilter == filter) return;
     m_swsFilter = filter;
-    QSettings().setValue("player/swsFilter", static_cast<int>(m_swsFilter));
+    SettingsStore::instance().setValue("player/swsFilter", static_cast<int>(m_swsFilter));
     emit swsFilterChanged();
 }
 
@@ -110,6 +122,71 @@ void PlayerConfig::setSwsFilterInt(int filter)
     setSwsFilter(static_cast<SwsFilterMode>(filter));
 }
 
+// ── HDR tone mapping ───────────────────────────────────────
+
+ToneMapper PlayerConfig::toneMapper() const
+{
+    return m_toneMapper;
+}
+
+void PlayerConfig::setToneMapper(ToneMapper mapper)
+{
+    if (m_toneMapper == mapper) return;
+    m_toneMapper = mapper;
+    SettingsStore::instance().setValue("player/toneMapper", static_cast<int>(m_toneMapper));
+    emit toneMapperChanged();
+}
+
+int PlayerConfig::toneMapperInt() const
+{
+    return static_cast<int>(m_toneMapper);
+}
+
+void PlayerConfig::setToneMapperInt(int mapper)
+{
+    setToneMapper(static_cast<ToneMapper>(std::clamp(mapper, 0, static_cast<int>(ToneMapper::Bt2390))));
+}
+
+// ── Video post-processing ──────────────────────────────────
+
+QString PlayerConfig::videoFilter() const
+{
+    return m_videoFilter;
+}
+
+void PlayerConfig::setVideoFilter(const QString &description)
+{
+    const QString trimmed = description.trimmed();
+    if (m_videoFilter == trimmed) return;
+    m_videoFilter = trimmed;
+    SettingsStore::instance().setValue("player/videoFilter", m_videoFilter);
+    emit videoFilterChanged();
+}
+
+DeinterlaceMode PlayerConfig::deinterlaceMode() const
+{
+    return m_deinterlaceMode;
+}
+
+void PlayerConfig::setDeinterlaceMode(DeinterlaceMode mode)
+{
+    if (m_deinterlaceMode == mode) return;
+    m_deinterlaceMode = mode;
+    SettingsStore::instance().setValue("player/deinterlaceMode", static_cast<int>(m_deinterlaceMode));
+    emit deinterlaceModeChanged();
+}
+
+int PlayerConfig::deinterlaceModeInt() const
+{
+    return static_cast<int>(m_deinterlaceMode);
+}
+
+void PlayerConfig::setDeinterlaceModeInt(int mode)
+{
+    setDeinterlaceMode(static_cast<DeinterlaceMode>(
+        std::clamp(mode, 0, static_cast<int>(DeinterlaceMode::Force))));
+}
+
 bool PlayerConfig::realtimeSeekPreview() const
 {
     return m_realtimeSeekPreview;
@@ -119,7 +196,7 @@ void PlayerConfig::setRealtimeSeekPreview(bool enabled)
 {
     if (m_realtimeSeekPreview == enabled) return;
     m_realtimeSeekPreview = enabled;
-    QSettings().setValue("player/realtimeSeekPreview", m_realtimeSeekPreview);
+    SettingsStore::instance().setValue("player/realtimeSeekPreview", m_realtimeSeekPreview);
     emit realtimeSeekPreviewChanged();
 }
 
@@ -132,7 +209,7 @@ void PlayerConfig::setDecodeBackend(VideoDecodeBackend backend)
 {
     if (m_decodeBackend == backend) return;
     m_decodeBackend = backend;
-    QSettings().setValue("player/decodeBackend", static_cast<int>(m_decodeBackend));
+    SettingsStore::instance().setValue("player/decodeBackend", static_cast<int>(m_decodeBackend));
     emit decodeBackendChanged();
 }
 
@@ -146,6 +223,46 @@ void PlayerConfig::setDecodeBackendInt(int backend)
     setDecodeBackend(static_cast<VideoDecodeBackend>(backend));
 }
 
+// ── Decoder threading ──────────────────────────────────────
+
+int PlayerConfig::decodeThreads() const
+{
+    return m_decodeThreads;
+}
+
+void PlayerConfig::setDecodeThreads(int threads)
+{
+    threads = std::clamp(threads, 0, kMaxDecodeThreads);
+    if (m_decodeThreads == threads) return;
+    m_decodeThreads = threads;
+    SettingsStore::instance().setValue("player/decodeThreads", m_decodeThreads);
+    emit decodeThreadsChanged();
+}
+
+DecodeThreadType PlayerConfig::decodeThreadType() const
+{
+    return m_decodeThreadType;
+}
+
+void PlayerConfig::setDecodeThreadType(DecodeThreadType type)
+{
+    if (m_decodeThreadType == type) return;
+    m_decodeThreadType = type;
+    SettingsStore::instance().setValue("player/decodeThreadType", static_cast<int>(m_decodeThreadType));
+    emit decodeThreadTypeChanged();
+}
+
+int PlayerConfig::decodeThreadTypeInt() const
+{
+    return static_cast<int>(m_decodeThreadType);
+}
+
+void PlayerConfig::setDecodeThreadTypeInt(int type)
+{
+    setDecodeThreadType(static_cast<DecodeThreadType>(
+        std::clamp(type, 0, static_cast<int>(DecodeThreadType::Slice))));
+}
+
 bool PlayerConfig::preferZeroCopy() const
 {
     return m_preferZeroCopy;
@@ -156,7 +273,7 @@ void PlayerConfig::setPreferZeroCopy(bool enabled)
     Q_UNUSED(enabled);
     if (m_preferZeroCopy) return;
     m_preferZeroCopy = true;
-    QSettings().setValue("player/preferZeroCopy", true);
+    SettingsStore::instance().setValue("player/preferZeroCopy", true);
     emit preferZeroCopyChanged();
 }
 
@@ -169,7 +286,7 @@ void PlayerConfig::setAllowHwFallback(bool enabled)
 {
     if (m_allowHwFallback == enabled) return;
     m_allowHwFallback = enabled;
-    QSettings().setValue("player/allowHwFallback", m_allowHwFallback);
+    SettingsStore::instance().setValue("player/allowHwFallback", m_allowHwFallback);
     emit allowHwFallbackChanged();
 }
 
@@ -182,7 +299,7 @@ void PlayerConfig::setVideoFlipX(bool enabled)
 {
     if (m_videoFlipX == enabled) return;
     m_videoFlipX = enabled;
-    QSettings().setValue("player/videoFlipX", m_videoFlipX);
+    SettingsStore::instance().setValue("player/videoFlipX", m_videoFlipX);
     emit videoFlipXChanged();
 }
 
@@ -195,7 +312,7 @@ void PlayerConfig::setVideoFlipY(bool enabled)
 {
     if (m_videoFlipY == enabled) return;
     m_videoFlipY = enabled;
-    QSettings().setValue("player/videoFlipY", m_videoFlipY);
+    SettingsStore::instance().setValue("player/videoFlipY", m_videoFlipY);
     emit videoFlipYChanged();
 }
 
@@ -208,7 +325,7 @@ void PlayerConfig::setLockAspectRatio(bool enabled)
 {
     if (m_lockAspectRatio == enabled) return;
     m_lockAspectRatio = enabled;
-    QSettings().setValue("player/lockAspectRatio", m_lockAspectRatio);
+    SettingsStore::instance().setValue("player/lockAspectRatio", m_lockAspectRatio);
     emit lockAspectRatioChanged();
 }
 
@@ -223,6 +340,6 @@ void PlayerConfig::setVsrEnabled(bool enabled)
 {
     if (m_vsrEnabled == enabled) return;
     m_vsrEnabled = enabled;
-    QSettings().setValue("player/vsrEnabled", m_vsrEnabled);
+    SettingsStore::instance().setValue("player/vsrEnabled", m_vsrEnabled);
     emit vsrEnabledChanged();
 }
@@ -25,6 +25,16 @@ class PlayerConfig : public QObject
     // ── Scaling filter ──
     Q_PROPERTY(int swsFilter READ swsFilterInt WRITE setSwsFilterInt NOTIFY swsFilterChanged)
 
+    // ── HDR tone mapping ──
+    Q_PROPERTY(int toneMapper READ toneMapperInt WRITE setToneMapperInt NOTIFY toneMapperChanged)
+
+    // ── Video post-processing ──
+    /// libavfilter description in ffmpeg -vf syntax ("" = no filters).
+    Q_PROPERTY(QString videoFilter READ videoFilter WRITE setVideoFilter NOTIFY videoFilterChanged)
+
+    /// DeinterlaceMode as int: 0 = off, 1 = auto, 2 = force.
+    Q_PROPERTY(int deinterlaceMode READ deinterlaceModeInt WRITE setDeinterlaceModeInt NOTIFY deinterlaceModeChanged)
+
     // ── Seek preview ──
     /// Enable throttled real-time seek while dragging the progress slider.
     Q_PROPERTY(bool realtimeSeekPreview READ realtimeSeekPreview WRITE setRealtimeSeekPreview NOTIFY realtimeSeekPreviewChanged)
@@ -32,6 +42,12 @@ class PlayerConfig : public QObject
     // ── Decode backend (future HW decode) ──
     Q_PROPERTY(int decodeBackend READ decodeBackendInt WRITE setDecodeBackendInt NOTIFY decodeBackendChanged)
 
+    // ── Decoder threading (applied on the next open) ──
+    /// Video decoder threads, 0 = tuning table (DecoderThreadingPolicy).
+    Q_PROPERTY(int decodeThreads READ decodeThreads WRITE setDecodeThreads NOTIFY decodeThreadsChanged)
+    /// DecodeThreadType as int: 0 = auto, 1 = frame, 2 = slice.
+    Q_PROPERTY(int decodeThreadType READ decodeThreadTypeInt WRITE setDecodeThreadTypeInt NOTIFY decodeThreadTypeChanged)
+
     // ── Hardware decode options (future use) ──
     Q_PROPERTY(bool preferZeroCopy READ preferZeroCopy WRITE setPreferZeroCopy NOTIFY preferZeroCopyChanged)
     Q_PROPERTY(bool allowHwFallback READ allowHwFallback WRITE setAllowHwFallback NOTIFY allowHwFallbackChanged)
@@ -73,6 +89,23 @@ public:
     int  swsFilterInt() const;
     void setSwsFilterInt(int filter);
 
+    // ── HDR tone mapping ──
+    ToneMapper toneMapper() const;
+    void setToneMapper(ToneMapper mapper);
+
+    int  toneMapperInt() const;
+    void setToneMapperInt(int mapper);
+
+    // ── Video post-processing ──
+    QString videoFilter() const;
+    void setVideoFilter(const QString &description);
+
+    DeinterlaceMode deinterlaceMode() const;
+    void setDeinterlaceMode(DeinterlaceMode mode);
+
+    int  deinterlaceModeInt() const;
+    void setDeinterlaceModeInt(int mode);
+
     // ── Seek preview ──
     bool realtimeSeekPreview() const;
     void setRealtimeSeekPreview(bool enabled);
@@ -83,6 +116,15 @@ public:
     int  decodeBackendInt() const;
     void setDecodeBackendInt(int backend);
 
+    // ── Decoder threading ──
+    int  decodeThreads() const;
+    void setDecodeThreads(int threads);
+
+    DecodeThreadType decodeThreadType() const;
+    void setDecodeThreadType(DecodeThreadType type);
+    int  decodeThreadTypeInt() const;
+    void setDecodeThreadTypeInt(int type);
+
     // ── Hardware decode options ──
     bool preferZeroCopy() const;
     void setPreferZeroCopy(bool enabled);
@@ -108,8 +150,13 @@ signals:
     void mutedChanged();
     void renderModeChanged();
     void swsFilterChanged();
+    void toneMapperChanged();
+    void videoFilterChanged();
+    void deinterlaceModeChanged();
     void realtimeSeekPreviewChanged();
     void decodeBackendChanged();
+    void decodeThreadsChanged();
+    void decodeThreadTypeChanged();
     void preferZeroCopyChanged();
     void allowHwFallbackChanged();
     void videoFlipXChanged();
@@ -122,12 +169,19 @@ private:
     bool             m_muted      = false;
     VideoRenderMode  m_renderMode = VideoRenderMode::QVideoSink;
     SwsFilterMode    m_swsFilter  = SwsFilterMode::Bilinear;
+    ToneMapper       m_toneMapper = ToneMapper::Bt2390;
+    QString          m_videoFilter;
+    DeinterlaceMode  m_deinterlaceMode = DeinterlaceMode::Auto;
     bool             m_realtimeSeekPreview = true;
     VideoDecodeBackend m_decodeBackend = VideoDecodeBackend::Software;
+    int              m_decodeThreads = 0;
+    DecodeThreadType m_decodeThreadType = DecodeThreadType::Auto;
     bool             m_preferZeroCopy = true;
     bool             m_allowHwFallback = true;
     bool             m_vsrEnabled = false;
     bool             m_videoFlipX = false;
     bool             m_videoFlipY = false;
     bool             m_lockAspectRatio = true;
+
+    static constexpr int kMaxDecodeThreads = 64;
 };
@@ -0,0 +1,125 @@
+#include "PlayerStats.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+int64_t steadyNowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+QVariant counter(const std::atomic<uint64_t> &c)
+{
+    return QVariant::fromValue<qulonglong>(c.load(std::memory_order_relaxed));
+}
+}
+
+void PlayerStats::reset()
+{
+    swsCacheHits.store(0, std::memory_order_relaxed);
+    swsCacheMisses.store(0, std::memory_order_relaxed);
+    poolAllocations.store(0, std::memory_order_relaxed);
+    poolAllocatedBytes.store(0, std::memory_order_relaxed);
+    poolReuses.store(0, std::memory_order_relaxed);
+    videoLateDrops.store(0, std::memory_order_relaxed);
+    videoPacketDrops.store(0, std::memory_order_relaxed);
+    videoDegradedPackets.store(0, std::memory_order_relaxed);
+    degradeChanges.store(0, std::memory_order_relaxed);
+    degradeLevel.store(0, std::memory_order_relaxed);
+    startupOpenMs.store(0, std::memory_order_relaxed);
+    ttffMs.store(0, std::memory_order_relaxed);
+    transitionGapUs.store(-1, std::memory_order_relaxed);
+    vsrFrames.store(0, std::memory_order_relaxed);
+    vsrFrameNs.store(0, std::memory_order_relaxed);
+    vsrFrameMaxNs.store(0, std::memory_order_relaxed);
+    m_pageFaultBase.store(processPageFaults(), std::memory_order_relaxed);
+    m_resetMs.store(steadyNowMs(), std::memory_order_relaxed);
+}
+
+QVariantMap PlayerStats::snapshot() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("swsCacheHits"), counter(swsCacheHits));
+    map.insert(QStringLiteral("swsCacheMisses"), counter(swsCacheMisses));
+
+    const uint64_t allocs = poolAllocations.load(std::memory_order_relaxed);
+    const int64_t  elapsedMs = steadyNowMs() - m_resetMs.load(std::memory_order_relaxed);
+    map.insert(QStringLiteral("poolAllocations"), QVariant::fromValue<qulonglong>(allocs));
+    map.insert(QStringLiteral("poolAllocatedMB"),
+               static_cast<double>(poolAllocatedBytes.load(std::memory_order_relaxed)) / (1024.0 * 1024.0));
+    map.insert(QStringLiteral("poolReuses"), counter(poolReuses));
+    map.insert(QStringLiteral("poolAllocsPerSec"),
+               elapsedMs > 0 ? static_cast<double>(allocs) * 1000.0 / elapsedMs : 0.0);
+
+    map.insert(QStringLiteral("videoLateDrops"), counter(videoLateDrops));
+    map.insert(QStringLiteral("videoPacketDrops"), counter(videoPacketDrops));
+    map.insert(QStringLiteral("videoDegradedPackets"), counter(videoDegradedPackets));
+    map.insert(QStringLiteral("decodeDegradeLevel"), counter(degradeLevel));
+    map.insert(QStringLiteral("decodeDegradeChanges"), counter(degradeChanges));
+
+    if (const uint64_t ttff = ttffMs.load(std::memory_order_relaxed)) {
+        map.insert(QStringLiteral("startupOpenMs"), counter(startupOpenMs));
+        map.insert(QStringLiteral("ttffMs"), QVariant::fromValue<qulonglong>(ttff));
+    }
+    if (const int64_t gapUs = transitionGapUs.load(std::memory_order_relaxed); gapUs >= 0)
+        map.insert(QStringLiteral("transitionGapMs"), static_cast<double>(gapUs) / 1000.0);
+
+    const uint64_t vsr = vsrFrames.load(std::memory_order_relaxed);
+    if (vsr > 0) {
+        if (const char *backend = vsrBackend.load(std::memory_order_relaxed))
+            map.insert(QStringLiteral("vsrBackend"), QString::fromLatin1(backend));
+        map.insert(QStringLiteral("vsrFrames"), QVariant::fromValue<qulonglong>(vsr));
+        map.insert(QStringLiteral("vsrMsAvg"),
+                   static_cast<double>(vsrFrameNs.load(std::memory_order_relaxed)) / 1e6 / static_cast<double>(vsr));
+        map.insert(QStringLiteral("vsrMsMax"),
+                   static_cast<double>(vsrFrameMaxNs.load(std::memory_order_relaxed)) / 1e6);
+    }
+
+    const uint64_t faults = processPageFaults();
+    const uint64_t base   = m_pageFaultBase.load(std::memory_order_relaxed);
+    map.insert(QStringLiteral("pageFaults"),
+               QVariant::fromValue<qulonglong>(faults >= base ? faults - base : 0));
+    return map;
+}
+
+uint64_t PlayerStats::processPageFaults()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PageFaultCount;
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt);
+    return 0;
+#endif
+}
+
+uint64_t PlayerStats::processPeakRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize;
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // KiB
+#endif
+#endif
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QVariantMap>
+#include <atomic>
+#include <cstdint>
+
+/// @brief Lock-free performance counters for one playback pipeline.
+///
+/// Written from the decode / render threads with relaxed atomics, read on
+/// the GUI thread through snapshot() (exposed as PlayerWindowManager::stats
+/// and shown in the media info dialog).
+struct PlayerStats
+{
+    // ── Scaler (SwsContextCache) ──
+    std::atomic<uint64_t> swsCacheHits{0};
+    std::atomic<uint64_t> swsCacheMisses{0};
+
+    // ── Frame buffers (FrameBufferPool) ──
+    std::atomic<uint64_t> poolAllocations{0};     ///< fresh heap allocations
+    std::atomic<uint64_t> poolAllocatedBytes{0};
+    std::atomic<uint64_t> poolReuses{0};          ///< buffers served from the pool
+
+    // ── Video decode degradation (AVCodecHandler / DecodeLagController) ──
+    std::atomic<uint64_t> videoLateDrops{0};       ///< frames dropped at presentation (>50 ms late)
+    std::atomic<uint64_t> videoPacketDrops{0};     ///< non-reference packets skipped before decode
+    std::atomic<uint64_t> videoDegradedPackets{0}; ///< packets decoded at reduced quality
+    std::atomic<uint64_t> degradeChanges{0};       ///< level escalations + relaxations
+    std::atomic<uint64_t> degradeLevel{0};         ///< current DecodeLagController::Level
+
+    // ── Startup (StartupTimeline) ──
+    std::atomic<uint64_t> startupOpenMs{0};        ///< open request → media opened
+    std::atomic<uint64_t> ttffMs{0};               ///< open request → first picture, 0 until shown
+    std::atomic<int64_t>  transitionGapUs{-1};     ///< audio silence entering this playlist item, -1 = none
+
+    // ── Video super resolution (VsrBackend) ──
+    std::atomic<const char *> vsrBackend{nullptr}; ///< backend name literal, null until chosen
+    std::atomic<uint64_t> vsrFrames{0};
+    std::atomic<uint64_t> vsrFrameNs{0};          ///< total processFrameToBgra() time
+    std::atomic<uint64_t> vsrFrameMaxNs{0};
+
+    /// Zero all counters (called when a new file starts playing).
+    void reset();
+
+    /// Copy the current counter values into a QML-friendly map.
+    QVariantMap snapshot() const;
+
+    /// Relaxed increment helper for the hot paths.
+    static void bump(std::atomic<uint64_t> &counter, uint64_t n = 1)
+    {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// Relaxed running maximum.
+    static void raise(std::atomic<uint64_t> &counter, uint64_t value)
+    {
+        uint64_t cur = counter.load(std::memory_order_relaxed);
+        while (value > cur && !counter.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+    /// Process-wide page fault count (minor + major on POSIX, all faults on
+    /// Windows).  Returns 0 where unsupported.
+    static uint64_t processPageFaults();
+
+    /// Peak resident set size of the process in bytes (peak working set on
+    /// Windows).  Returns 0 where unsupported.
+    static uint64_t processPeakRssBytes();
+
+private:
+    std::atomic<uint64_t> m_pageFaultBase{0};   ///< processPageFaults() at reset()
+    std::atomic<int64_t>  m_resetMs{0};         ///< steady clock at reset()
+};
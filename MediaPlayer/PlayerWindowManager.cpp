@@ -1,5 +1,10 @@
 #include "PlayerWindowManager.h"
 #include "FrameHandler.h"
+#include "PipelineExecutor.h"
+#include "StartupTimeline.h"
+#include "CodecContextCache.h"
+#include "DecoderThreadingPolicy.h"
+#include "ResumeStore.h"
 #include <QFileInfo>
 #include <QUrl>
 #include <QDebug>
@@ -16,15 +21,19 @@ bool isTerminalPlaybackState(AVPlayerStatus st)
 
 PlayerWindowManager::PlayerWindowManager(QObject *parent)
     : QObject(parent)
+    , m_openGeneration(std::make_shared<std::atomic<quint64>>(0))
+    , m_standbyGeneration(std::make_shared<std::atomic<quint64>>(0))
     , m_frameHandler(new FrameHandler(this))   // owned as child QObject
     , m_config(new PlayerConfig(this))         // owned as child QObject
 {
-    m_codec.setFrameHandler(m_frameHandler);
-    m_codec.setDecodeBackend(m_config->decodeBackend());
-    m_codec.setAllowHwFallback(m_config->allowHwFallback());
+    qRegisterMetaType<GLVideoFrame>();
+
+    m_codec = createCodecHandler();
+    m_codec->setFrameHandler(m_frameHandler);
 
     m_frameHandler->setVideoRenderMode(m_config->renderMode());
     m_frameHandler->setSwsFilter(m_config->swsFilter());
+    m_frameHandler->setToneMapper(m_config->toneMapper());
     m_frameHandler->setVsrEnabled(m_config->vsrEnabled());
 
     // Pre-load the VSR bridge DLL so that the symbol resolution cost
@@ -56,30 +65,55 @@ PlayerWindowManager::PlayerWindowManager(QObject *parent)
         m_frameHandler->setSwsFilter(m_config->swsFilter());
     });
 
+    connect(m_config, &PlayerConfig::toneMapperChanged, this, [this]() {
+        m_frameHandler->setToneMapper(m_config->toneMapper());
+    });
+
+    connect(m_config, &PlayerConfig::videoFilterChanged, this, [this]() {
+        m_codec->setVideoFilter(m_config->videoFilter());
+    });
+
+    connect(m_config, &PlayerConfig::deinterlaceModeChanged, this, [this]() {
+        m_codec->setDeinterlaceMode(m_config->deinterlaceMode());
+    });
+
     connect(m_config, &PlayerConfig::decodeBackendChanged, this, [this]() {
-        m_codec.setDecodeBackend(m_config->decodeBackend());
+        m_codec->setDecodeBackend(m_config->decodeBackend());
+    });
+
+    connect(m_config, &PlayerConfig::decodeThreadsChanged, this, [this]() {
+        m_codec->setDecodeThreading(m_config->decodeThreads(), m_config->decodeThreadType());
+    });
+
+    connect(m_config, &PlayerConfig::decodeThreadTypeChanged, this, [this]() {
+        m_codec->setDecodeThreading(m_config->decodeThreads(), m_config->decodeThreadType());
     });
 
     connect(m_config, &PlayerConfig::allowHwFallbackChanged, this, [this]() {
-        m_codec.setAllowHwFallback(m_config->allowHwFallback());
+        m_codec->setAllowHwFallback(m_config->allowHwFallback());
     });
 
     connect(m_config, &PlayerConfig::vsrEnabledChanged, this, [this]() {
         m_frameHandler->setVsrEnabled(m_config->vsrEnabled());
     });
 
-    connect(m_frameHandler, &FrameHandler::videoFrameReady, this, [this](const QImage &image) {
+    connect(this, &PlayerWindowManager::playingChanged, this, &PlayerWindowManager::syncPlayingState);
+
+    connect(m_frameHandler, &FrameHandler::videoFrameReady, this, [this](const GLVideoFrame &frame) {
         if (m_glFrameSink) {
-            QMetaObject::invokeMethod(m_glFrameSink, "setFrame", Qt::QueuedConnection,
-                                      Q_ARG(QImage, image));
+            QMetaObject::invokeMethod(m_glFrameSink, "setVideoFrame", Qt::QueuedConnection,
+                                      Q_ARG(GLVideoFrame, frame));
         }
-        emit videoFrameReady(image);
     }, Qt::QueuedConnection);
 }
 
 PlayerWindowManager::~PlayerWindowManager()
 {
+    ++*m_openGeneration;   // in-flight opens give up and free their handler
+    ++*m_standbyGeneration;
     stop();
+    if (m_countedPlaying)
+        DecoderThreadingPolicy::playbackStopped();
 }
 
 // ── Drop enabled ───────────────────────────────────────────
@@ -100,83 +134,369 @@ void PlayerWindowManager::setDropEnabled(bool enabled)
 
 void PlayerWindowManager::openMedia(const QString &path)
 {
-    // Normalise: QML's drop gives "file:///..." – use QUrl for cross-platform conversion
-    QString localPath = QUrl(path).toLocalFile();
-    if (localPath.isEmpty()) {
-        localPath = path;  // fallback: already a plain path
-    }
+    openPlaylist(QVariantList{path}, 0);
+}
+
+void PlayerWindowManager::openPlaylist(const QVariantList &items, int startIndex)
+{
+    auto timeline = std::make_shared<StartupTimeline>();
+    timeline->mark("request");
 
-    QFileInfo fi(localPath);
-    if (!fi.exists() || !fi.isFile()) {
-        qWarning() << "File does not exist:" << localPath;
-        emit mediaOpenFailed(localPath);
+    QStringList paths;
+    QString     startPath;
+    for (int i = 0; i < items.size(); ++i) {
+        const QString localPath = toLocalMediaPath(items.at(i).toString());
+        QFileInfo fi(localPath);
+        if (!fi.exists() || !fi.isFile()) {
+            qWarning() << "File does not exist:" << localPath;
+            continue;
+        }
+        if (i == startIndex || startPath.isEmpty())
+            startPath = localPath;
+        paths.append(localPath);
+    }
+    if (paths.isEmpty()) {
+        emit mediaOpenFailed(items.isEmpty() ? QString() : toLocalMediaPath(items.first().toString()));
         return;
     }
 
+    discardStandby();
+    m_playlist      = paths;
+    m_playlistIndex = static_cast<int>(paths.indexOf(startPath));
+    emit playlistChanged();
+
+    openPlaylistItem(std::move(timeline));
+}
+
+void PlayerWindowManager::openPlaylistItem(std::shared_ptr<StartupTimeline> timeline)
+{
+    if (!timeline) {
+        timeline = std::make_shared<StartupTimeline>();
+        timeline->mark("request");
+    }
+
     // Stop any previous playback
     stop();
 
     // Run the heavy FFmpeg open on a background thread so the UI
     // (page transition animation, etc.) stays responsive.
-    openMediaAsync(localPath);
+    openMediaAsync(m_playlist.at(m_playlistIndex), std::move(timeline));
 }
 
-void PlayerWindowManager::openMediaAsync(const QString &localPath)
+QString PlayerWindowManager::toLocalMediaPath(const QString &path)
 {
-    QPointer<PlayerWindowManager> self(this);
+    // Normalise: QML's drop gives "file:///..." – use QUrl for cross-platform conversion
+    const QString localPath = QUrl(path).toLocalFile();
+    return localPath.isEmpty() ? path : localPath;   // fallback: already a plain path
+}
+
+std::unique_ptr<AVCodecHandler> PlayerWindowManager::createCodecHandler() const
+{
+    auto codec = std::make_unique<AVCodecHandler>();
+    applyCodecConfig(*codec);
+    return codec;
+}
 
-    // Capture path by value; the lambda runs on a throwaway QThread.
-    QThread *worker = QThread::create([self, localPath]() {
-        if (!self) return;
+void PlayerWindowManager::applyCodecConfig(AVCodecHandler &codec) const
+{
+    codec.setDecodeBackend(m_config->decodeBackend());
+    codec.setAllowHwFallback(m_config->allowHwFallback());
+    codec.setVideoFilter(m_config->videoFilter());
+    codec.setDeinterlaceMode(m_config->deinterlaceMode());
+    codec.setDecodeThreading(m_config->decodeThreads(), m_config->decodeThreadType());
+}
 
-        self->m_codec.setFilePath(localPath);
-        bool ok = self->m_codec.open();
+void PlayerWindowManager::submitOpen(const QString &localPath,
+                                     const std::shared_ptr<std::atomic<quint64>> &counter,
+                                     std::shared_ptr<StartupTimeline> timeline,
+                                     bool resume,
+                                     OpenDone done)
+{
+    QPointer<PlayerWindowManager> self(this);
 
-        if (!self) return;
+    // Every request gets a generation; starting a newer one on the same
+    // counter makes older opens stale, and the interrupt check aborts
+    // their blocking FFmpeg I/O.
+    const quint64 generation = ++*counter;
+    std::shared_ptr<std::atomic<quint64>> current = counter;
+    auto stale = [current, generation] { return current->load() != generation; };
+
+    // The open builds into a fresh handler that only this request touches.
+    // Whichever side drops the last reference frees a handler that is
+    // never handed to @p done.
+    auto pending = std::make_shared<std::unique_ptr<AVCodecHandler>>(createCodecHandler());
+    (*pending)->setInterruptCheck(stale);
+    (*pending)->setFilePath(localPath);
+    (*pending)->setStartupTimeline(std::move(timeline));
+    // Every open here ends up replacing m_codec, so it inherits its slot.
+    (*pending)->setReplacesPlayer(m_codec && m_codec->isRegisteredPlayer());
+
+    // Capture by value; the lambda runs on a shared executor worker.
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Io,
+                                        [self, localPath, pending, stale, resume, done = std::move(done)]() {
+        if (stale()) return;
+
+        // Also teaches ResumeStore the file's fingerprint for record().
+        const double resumeAt = ResumeStore::instance().resumePosition(localPath);
+        if (resume && resumeAt > 0.0) {
+            qDebug() << "Resuming" << localPath << "at" << resumeAt << "s";
+            (*pending)->setStartPosition(resumeAt);
+        }
 
-        // Bounce back to the main / GUI thread for UI updates + play()
-        QMetaObject::invokeMethod(self, [self, ok, localPath]() {
-            if (!self) return;
+        const bool ok = (*pending)->open();
+        if (stale()) {
+            qDebug() << "Open superseded:" << localPath;
+            return;
+        }
 
-            if (!ok) {
-                qWarning() << "Failed to open media:" << localPath;
-                emit self->mediaOpenFailed(localPath);
-                return;
-            }
+        // Bounce back to the main / GUI thread
+        QMetaObject::invokeMethod(self, [self, ok, pending, stale, done]() {
+            if (!self || stale()) return;
+            std::unique_ptr<AVCodecHandler> handler = std::move(*pending);
+            handler->setInterruptCheck({});
+            done(std::move(handler), ok);
+        }, Qt::QueuedConnection);
+    });
+}
 
-            qDebug() << "Opened media:" << localPath
-                     << "resolution:" << self->m_codec.videoResolution()
-                     << "duration:" << self->m_codec.durationSeconds() << "s"
-                     << "video:" << self->m_codec.videoCodecName()
-                     << "audio:" << self->m_codec.audioCodecName()
-                     << "decodePath:" << self->m_codec.decodeRuntimeStatus();
+void PlayerWindowManager::openMediaAsync(const QString &localPath,
+                                         std::shared_ptr<StartupTimeline> timeline)
+{
+    submitOpen(localPath, m_openGeneration, timeline, /*resume=*/true,
+               [this, localPath, timeline](std::unique_ptr<AVCodecHandler> handler, bool ok) {
+        if (!ok) {
+            qWarning() << "Failed to open media:" << localPath;
+            emit mediaOpenFailed(localPath);
+            return;
+        }
+        timeline->mark("swapped-in");
+        adoptHandler(std::move(handler), /*gapless=*/false);
+        m_frameHandler->stats().startupOpenMs.store(
+            static_cast<uint64_t>(timeline->elapsedMs()), std::memory_order_relaxed);
+    });
+}
 
-            emit self->mediaChanged();
+void PlayerWindowManager::adoptHandler(std::unique_ptr<AVCodecHandler> fresh, bool gapless)
+{
+    // A gapless switch keeps the FrameHandler running: the finished item's
+    // stages have all returned, so it is simply detached and its buffered
+    // audio plays out while the new item starts.  Otherwise the previous
+    // media is stopped first (openMedia() / playNext() normally did).
+    std::unique_ptr<AVCodecHandler> previous = std::move(m_codec);
+    if (gapless)
+        previous->setFrameHandler(nullptr);
+    else
+        previous->stop();
 
-            // Auto-play after successful open
-            self->play();
+    fresh->setFrameHandler(m_frameHandler);
+    applyCodecConfig(*fresh);   // settings changed while opening
+    fresh->registerPlayer();
+    QPointer<PlayerWindowManager> self(this);
+    AVCodecHandler *codec = fresh.get();
+    fresh->setPlaybackDoneCallback([self, codec]() {
+        QMetaObject::invokeMethod(self, [self, codec]() {
+            if (self && self->m_codec.get() == codec)
+                self->onPlaybackDone();
         }, Qt::QueuedConnection);
     });
+    m_codec = std::move(fresh);
+
+    qDebug() << "Opened media:" << m_codec->filePath()
+             << "resolution:" << m_codec->videoResolution()
+             << "duration:" << m_codec->durationSeconds() << "s"
+             << "video:" << m_codec->videoCodecName()
+             << "audio:" << m_codec->audioCodecName()
+             << "decodePath:" << m_codec->decodeRuntimeStatus()
+             << (gapless ? "(gapless)" : "");
+
+    m_frameHandler->stats().reset();
+    m_codec->resetVideoFilterStats();
+    if (gapless)
+        m_frameHandler->beginAudioTransition();
+    m_position = 0.0;
+    m_lastResumeSave = 0.0;
+    emit mediaChanged();
+    emit positionChanged();
+    emit statsChanged();
+
+    // Auto-play after successful open
+    startPlayback();
 
-    // Auto-delete the QThread when it finishes
-    connect(worker, &QThread::finished, worker, &QObject::deleteLater);
-    worker->start();
+    // Released only once the new item runs; nothing of it is on the
+    // FrameHandler any more.
+    previous.reset();
 }
 
 void PlayerWindowManager::closeMedia()
 {
+    ++*m_openGeneration;   // abandon any open still in flight
+    discardStandby();
     stop();
-    m_codec.close();
+    m_codec->close();
+    // Warm decoders only pay off between items.  While another window
+    // plays, its next item may still pick one up.
+    if (DecoderThreadingPolicy::activePlayers() == 0)
+        CodecContextCache::instance().clear();
+    m_playlist.clear();
+    m_playlistIndex = -1;
+    emit playlistChanged();
     emit mediaChanged();
 }
 
+// ── Playlist ─────────────────────────────────────────────────────────
+
+QStringList PlayerWindowManager::playlist() const
+{
+    return m_playlist;
+}
+
+int PlayerWindowManager::playlistIndex() const
+{
+    return m_playlistIndex;
+}
+
+bool PlayerWindowManager::hasNext() const
+{
+    return m_playlistIndex >= 0 && m_playlistIndex + 1 < m_playlist.size();
+}
+
+bool PlayerWindowManager::hasPrevious() const
+{
+    return m_playlistIndex > 0;
+}
+
+bool PlayerWindowManager::playNext()
+{
+    if (!hasNext()) return false;
+    ++m_playlistIndex;
+    emit playlistChanged();
+
+    if (m_standby && m_standbyIndex == m_playlistIndex) {
+        discardStandbyRequest();
+        adoptHandler(std::move(m_standby), /*gapless=*/false);
+        m_standbyIndex = -1;
+        return true;
+    }
+    discardStandby();
+    openPlaylistItem();
+    return true;
+}
+
+bool PlayerWindowManager::playPrevious()
+{
+    if (!hasPrevious()) return false;
+    --m_playlistIndex;
+    emit playlistChanged();
+    discardStandby();
+    openPlaylistItem();
+    return true;
+}
+
+void PlayerWindowManager::prerollNext()
+{
+    if (!hasNext() || m_standbyRequested) return;
+    m_standbyRequested = true;
+    m_standbyPending   = true;
+
+    const int index = m_playlistIndex + 1;
+    const QString path = m_playlist.at(index);
+    qDebug() << "PlayerWindowManager: pre-opening next item" << path;
+
+    // No resume: the item follows the current one back to back.
+    submitOpen(path, m_standbyGeneration, nullptr, /*resume=*/false,
+               [this, index, path](std::unique_ptr<AVCodecHandler> handler, bool ok) {
+        m_standbyPending = false;
+        if (!ok) {
+            qWarning() << "Failed to pre-open next item:" << path;
+        } else {
+            m_standby      = std::move(handler);
+            m_standbyIndex = index;
+        }
+        if (m_switchWhenReady) {
+            // The current item already finished while this was opening.
+            m_switchWhenReady = false;
+            advanceAfterEnd();
+        }
+    });
+}
+
+void PlayerWindowManager::discardStandbyRequest()
+{
+    ++*m_standbyGeneration;
+    m_standbyRequested = false;
+    m_standbyPending   = false;
+    m_switchWhenReady  = false;
+}
+
+void PlayerWindowManager::saveResumePosition(bool finished)
+{
+    const AVPlayerStatus st = m_codec->status();
+    if (!finished && st != AVPlayerStatus::Playing && st != AVPlayerStatus::Paused)
+        return;   // nothing playing, m_position means nothing
+
+    const double duration = m_codec->durationSeconds();
+    ResumeStore::instance().record(m_codec->filePath(), finished ? duration : m_position,
+                                   duration, finished);
+    m_lastResumeSave = m_position;
+}
+
+void PlayerWindowManager::discardStandby()
+{
+    discardStandbyRequest();
+    m_standby.reset();
+    m_standbyIndex = -1;
+}
+
+void PlayerWindowManager::onPlaybackDone()
+{
+    if (m_codec->status() != AVPlayerStatus::PlaybackDone || m_switchWhenReady)
+        return;
+
+    saveResumePosition(/*finished=*/true);
+
+    if (hasNext()) {
+        if (m_standbyPending) {
+            m_switchWhenReady = true;   // prerollNext() finishes the switch
+            return;
+        }
+        advanceAfterEnd();
+        return;
+    }
+
+    qDebug() << "PlayerWindowManager: playback done, stopping";
+    m_positionTimer.stop();
+    m_codec->stop();
+    m_position = 0.0;
+    emit positionChanged();
+    emit playingChanged();
+    emit playbackFinished();
+}
+
+void PlayerWindowManager::advanceAfterEnd()
+{
+    ++m_playlistIndex;
+    emit playlistChanged();
+
+    if (m_standby && m_standbyIndex == m_playlistIndex) {
+        std::unique_ptr<AVCodecHandler> next = std::move(m_standby);
+        m_standbyIndex = -1;
+        m_standbyRequested = false;
+        adoptHandler(std::move(next), m_codec->status() == AVPlayerStatus::PlaybackDone);
+        return;
+    }
+
+    // Not pre-opened (or the pre-open failed): regular open.
+    discardStandby();
+    openPlaylistItem();
+}
+
 // ── Playback control ─────────────────────────────────────────────────
 
 void PlayerWindowManager::play()
 {
-    if (!m_codec.isOpen()) return;
+    if (!m_codec->isOpen()) return;
 
-    const AVPlayerStatus st = m_codec.status();
+    const AVPlayerStatus st = m_codec->status();
     if (isTerminalPlaybackState(st)) {
         return;
     }
@@ -189,6 +509,11 @@ void PlayerWindowManager::play()
         }
     }
 
+    startPlayback();
+}
+
+void PlayerWindowManager::startPlayback()
+{
     // Ensure the video sink is wired before starting threads
     if (m_videoSink)
         m_frameHandler->setVideoSink(m_videoSink);
@@ -196,14 +521,14 @@ void PlayerWindowManager::play()
     // Apply current volume setting
     m_frameHandler->setVolume(m_config->effectiveVolume());
 
-    m_codec.play();
+    m_codec->play();
     m_positionTimer.start();
     emit playingChanged();
 }
 
 void PlayerWindowManager::pause()
 {
-    const AVPlayerStatus st = m_codec.status();
+    const AVPlayerStatus st = m_codec->status();
     if (isTerminalPlaybackState(st)) {
         return;
     }
@@ -216,14 +541,16 @@ void PlayerWindowManager::pause()
         }
     }
 
-    m_codec.pause();
+    m_codec->pause();
     m_positionTimer.stop();
     emit playingChanged();
 }
 
 void PlayerWindowManager::stop()
 {
-    m_codec.stop();
+    saveResumePosition(/*finished=*/false);
+    ResumeStore::instance().flushAsync();
+    m_codec->stop();
     m_positionTimer.stop();
     m_position = 0.0;
     emit positionChanged();
@@ -232,7 +559,7 @@ void PlayerWindowManager::stop()
 
 void PlayerWindowManager::togglePlayPause()
 {
-    const AVPlayerStatus st = m_codec.status();
+    const AVPlayerStatus st = m_codec->status();
     if (isTerminalPlaybackState(st)) {
         return;
     }
@@ -254,16 +581,16 @@ void PlayerWindowManager::togglePlayPause()
 
 bool PlayerWindowManager::seek(double seconds)
 {
-    if (!m_codec.isOpen()) return false;
+    if (!m_codec->isOpen()) return false;
 
-    const double dur = m_codec.durationSeconds();
+    const double dur = m_codec->durationSeconds();
     if (dur > 0.0) {
         seconds = qBound(0.0, seconds, dur);
     } else {
         seconds = qMax(0.0, seconds);
     }
 
-    const bool ok = m_codec.seek(seconds);
+    const bool ok = m_codec->seek(seconds);
     if (!ok) return false;
 
     m_seekUiHold = true;
@@ -319,7 +646,18 @@ void PlayerWindowManager::setGlFrameSink(QObject *sink)
 
 bool PlayerWindowManager::isPlaying() const
 {
-    return m_codec.status() == AVPlayerStatus::Playing;
+    return m_codec->status() == AVPlayerStatus::Playing;
+}
+
+void PlayerWindowManager::syncPlayingState()
+{
+    const bool playing = isPlaying();
+    if (playing == m_countedPlaying) return;
+    m_countedPlaying = playing;
+    if (playing)
+        DecoderThreadingPolicy::playbackStarted();
+    else
+        DecoderThreadingPolicy::playbackStopped();
 }
 
 // ── Position ─────────────────────────────────────────────────────
@@ -362,85 +700,91 @@ void PlayerWindowManager::onPositionTimer()
         emit positionChanged();
     }
 
-    // Detect playback end: all decode threads have finished draining
-    AVPlayerStatus st = m_codec.status();
-    if (st == AVPlayerStatus::PlaybackDone) {
-        qDebug() << "PlayerWindowManager: playback done, stopping";
-        m_positionTimer.stop();
-        m_codec.stop();
-        m_position = 0.0;
-        emit positionChanged();
-        emit playingChanged();
-        emit playbackFinished();
+    if (std::abs(m_position - m_lastResumeSave) >= kResumeSaveSeconds)
+        saveResumePosition(/*finished=*/false);
+
+    emit statsChanged();
+
+    // Pre-open the next playlist item during the last seconds of this one
+    const AVPlayerStatus st = m_codec->status();
+    if (hasNext() && !m_standbyRequested) {
+        const double dur = m_codec->durationSeconds();
+        if (st == AVPlayerStatus::EndOfFile || (dur > 0.0 && dur - pos <= kPrerollSeconds))
+            prerollNext();
     }
+
+    // Detect playback end: all decode stages have finished draining.
+    // Normally the PlaybackDone callback got here first.
+    if (st == AVPlayerStatus::PlaybackDone)
+        onPlaybackDone();
 }
 
 // ── Property getters ───────────────────────────────────────
 
 bool PlayerWindowManager::hasMedia() const
 {
-    return m_codec.isOpen();
+    return m_codec->isOpen();
 }
 
 QString PlayerWindowManager::filePath() const
 {
-    return m_codec.filePath();
+    return m_codec->filePath();
 }
 
 int PlayerWindowManager::videoWidth() const
 {
-    return m_codec.videoResolution().width();
+    return m_codec->videoResolution().width();
 }
 
 int PlayerWindowManager::videoHeight() const
 {
-    return m_codec.videoResolution().height();
+    return m_codec->videoResolution().height();
 }
 
 double PlayerWindowManager::duration() const
 {
-    return m_codec.durationSeconds();
+    return m_codec->durationSeconds();
 }
 
 double PlayerWindowManager::bitRate() const
 {
-    return m_codec.bitRateKbps();
+    return m_codec->bitRateKbps();
 }
 
 QString PlayerWindowManager::videoCodec() const
 {
-    return m_codec.videoCodecName();
+    return m_codec->videoCodecName();
 }
 
 QString PlayerWindowManager::audioCodec() const
 {
-    return m_codec.audioCodecName();
+    return m_codec->audioCodecName();
 }
 
 QString PlayerWindowManager::decodePath() const
 {
-    const QString status = m_codec.decodeRuntimeStatus();
+    const QString status = m_codec->decodeRuntimeStatus();
     return status.isEmpty() ? QStringLiteral("-") : status;
 }
 
 double PlayerWindowManager::frameRate() const
 {
-    return m_codec.videoFrameRate();
+    return m_codec->videoFrameRate();
 }
 
 int PlayerWindowManager::sampleRate() const
 {
-    return m_codec.audioSampleRate();
+    return m_codec->audioSampleRate();
 }
 
 int PlayerWindowManager::audioChannels() const
 {
-    return m_codec.audioChannels();
+    return m_codec->audioChannels();
 }
 
 QString PlayerWindowManager::durationText() const
 {
-    double secs = m_codec.durationSeconds();
+    double secs = m_codec->durationSeconds();
     int h = static_cast<int>(secs) / 3600;
     int m = (static_cast<int>(secs) % 3600) / 60;
     int s = static_cast<int>(secs) % 60;
@@ -452,11 +796,28 @@ QString PlayerWindowManager::durationText() const
 
 QString PlayerWindowManager::resolutionText() const
 {
-    QSize res = m_codec.videoResolution();
+    QSize res = m_codec->videoResolution();
     if (res.isEmpty()) return "-";
     return QString("%1×%2").arg(res.width()).arg(res.height());
 }
 
+QVariantMap PlayerWindowManager::stats() const
+{
+    QVariantMap map = m_frameHandler->stats().snapshot();
+    map.insert(m_codec->videoFilterStats());
+    map.insert(PipelineExecutor::instance().stats());
+    const CodecContextCache &codecCache = CodecContextCache::instance();
+    map.insert("codecCacheHits",   static_cast<qulonglong>(codecCache.hits()));
+    map.insert("codecCacheMisses", static_cast<qulonglong>(codecCache.misses()));
+    map.insert("codecCacheSize",   static_cast<qulonglong>(codecCache.size()));
+    if (m_glFrameSink) {
+        const QVariantMap gl = m_glFrameSink->property("renderStats").toMap();
+        for (auto it = gl.cbegin(); it != gl.cend(); ++it)
+            map.insert(it.key(), it.value());
+    }
+    return map;
+}
+
 PlayerConfig *PlayerWindowManager::config() const
 {
     return m_config;
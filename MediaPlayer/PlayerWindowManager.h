@@ -10,6 +10,10 @@
 #include <QtQml/qqml.h>
 #include <QVideoSink>
 #include <QImage>
+#include <QVariantMap>
+#include <QStringList>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include "AVCodecHandler.h"
 #include "PlayerConfig.h"
@@ -51,6 +55,16 @@ class PlayerWindowManager : public QObject
     Q_PROPERTY(double position     READ position     NOTIFY positionChanged)
     Q_PROPERTY(QString positionText READ positionText NOTIFY positionChanged)
 
+    // ── Playlist ──
+    Q_PROPERTY(QStringList playlist READ playlist NOTIFY playlistChanged)
+    Q_PROPERTY(int  playlistIndex READ playlistIndex NOTIFY playlistChanged)
+    Q_PROPERTY(bool hasNext       READ hasNext       NOTIFY playlistChanged)
+    Q_PROPERTY(bool hasPrevious   READ hasPrevious   NOTIFY playlistChanged)
+
+    // ── Diagnostics ──
+    /// Pipeline performance counters, refreshed with the position timer.
+    Q_PROPERTY(QVariantMap stats READ stats NOTIFY statsChanged)
+
     // ── Config ──
     Q_PROPERTY(PlayerConfig* config READ config CONSTANT)
     Q_PROPERTY(QSize displaySize READ displaySize WRITE setDisplaySize NOTIFY displaySizeChanged)
@@ -66,8 +80,15 @@ public:
     // ── Open / close media ──
     /// Called from QML when a file is dropped or chosen.
     /// Opens asynchronously; emits mediaChanged() + auto-plays on success.
+    /// Same as a one-item openPlaylist().
     Q_INVOKABLE void openMedia(const QString &path);
 
+    /// Replace the playlist with @p items (paths or file URLs) and open the
+    /// one at @p startIndex.  Items play back to back: the next one is
+    /// opened on a standby handler during the last seconds of the current
+    /// one and takes over at EOF without stopping the audio output.
+    Q_INVOKABLE void openPlaylist(const QVariantList &items, int startIndex = 0);
+
     /// Close current media and clear metadata.
     Q_INVOKABLE void closeMedia();
 
@@ -77,6 +98,8 @@ public:
     Q_INVOKABLE void stop();
     Q_INVOKABLE void togglePlayPause();
     Q_INVOKABLE bool seek(double seconds);
+    Q_INVOKABLE bool playNext();
+    Q_INVOKABLE bool playPrevious();
 
     // ── Video sink ──
     QVideoSink *videoSink() const;
@@ -91,6 +114,15 @@ public:
     double  position() const;
     QString positionText() const;
 
+    // ── Playlist ──
+    QStringList playlist() const;
+    int  playlistIndex() const;
+    bool hasNext() const;
+    bool hasPrevious() const;
+
+    // ── Diagnostics ──
+    QVariantMap stats() const;
+
     // ── Config ──
     PlayerConfig *config() const;
 
@@ -124,18 +156,31 @@ signals:
     void mediaOpenFailed(const QString &path);
     void videoSinkChanged();
     void glFrameSinkChanged();
-    void videoFrameReady(const QImage &image);
     void playingChanged();
     void positionChanged();
     void playbackFinished();
     void displaySizeChanged();
+    void statsChanged();
+    void playlistChanged();
 
 private slots:
     void onPositionTimer();
 
 private:
     bool m_dropEnabled = true;
-    AVCodecHandler m_codec;
+    std::unique_ptr<AVCodecHandler> m_codec;   // replaced by each successful open
+    std::shared_ptr<std::atomic<quint64>> m_openGeneration;   // shared with in-flight opens
+
+    // Playlist + standby handler for the next item
+    static constexpr double kPrerollSeconds = 5.0;   // pre-open the next item this close to the end
+    QStringList    m_playlist;
+    int            m_playlistIndex = -1;
+    std::unique_ptr<AVCodecHandler> m_standby;       // opened, not yet playing
+    int            m_standbyIndex = -1;
+    bool           m_standbyRequested = false;       // pre-open started for m_playlistIndex + 1
+    bool           m_standbyPending   = false;       // ... and still opening
+    bool           m_switchWhenReady  = false;       // current item ended before the pre-open
+    std::shared_ptr<std::atomic<quint64>> m_standbyGeneration;
     FrameHandler  *m_frameHandler = nullptr;   // owned, child QObject
     QVideoSink    *m_videoSink    = nullptr;   // non-owning, from QML VideoOutput
     QPointer<QObject> m_glFrameSink;           // guarded, from QML OpenGLVideoItem
@@ -146,8 +191,45 @@ private:
     double         m_seekUiTarget = 0.0;
     qint64         m_seekUiExpireMs = 0;
     bool           m_tailToggleGuard = true;
+    bool           m_countedPlaying  = false;   // reported to DecoderThreadingPolicy::playbackStarted()
     QSize          m_displaySize;
 
-    /// Async helper: runs AVCodecHandler::open() off the main thread
-    void openMediaAsync(const QString &localPath);
+    // Resume positions (ResumeStore)
+    static constexpr double kResumeSaveSeconds = 5.0;   // record every this much playback
+    double         m_lastResumeSave = 0.0;
+
+    /// Async helper: opens @p localPath into a fresh AVCodecHandler off the
+    /// main thread and swaps it in; a newer request cancels it.
+    void openMediaAsync(const QString &localPath, std::shared_ptr<StartupTimeline> timeline);
+
+    /// Receives the opened handler (ok) or the failed one on the GUI thread.
+    using OpenDone = std::function<void(std::unique_ptr<AVCodecHandler>, bool ok)>;
+    /// Open @p localPath into a fresh handler on the executor.  Bumping
+    /// @p counter cancels it; @p done only runs for the latest request.
+    /// With @p resume the handler starts at the ResumeStore position.
+    void submitOpen(const QString &localPath,
+                    const std::shared_ptr<std::atomic<quint64>> &counter,
+                    std::shared_ptr<StartupTimeline> timeline, bool resume, OpenDone done);
+    /// Make @p fresh the current handler and start it.  @p gapless keeps
+    /// the audio output of the finished previous item running.
+    void adoptHandler(std::unique_ptr<AVCodecHandler> fresh, bool gapless);
+    /// Wire the sinks and start m_codec (no end-of-file guard).
+    void startPlayback();
+    /// Report isPlaying() changes to DecoderThreadingPolicy.
+    void syncPlayingState();
+
+    void openPlaylistItem(std::shared_ptr<StartupTimeline> timeline = nullptr);
+    void prerollNext();
+    void advanceAfterEnd();
+    void onPlaybackDone();
+    void discardStandbyRequest();
+    void discardStandby();
+    /// Record the current position (or, with @p finished, the end) of the
+    /// playing item in ResumeStore.
+    void saveResumePosition(bool finished);
+    static QString toLocalMediaPath(const QString &path);
+
+    /// New handler carrying the current PlayerConfig decode settings.
+    std::unique_ptr<AVCodecHandler> createCodecHandler() const;
+    void applyCodecConfig(AVCodecHandler &codec) const;
 };
@@ -0,0 +1,256 @@
+#include "ResumeStore.h"
+#include "FileFingerprint.h"
+#include "PipelineExecutor.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+QDataStream &operator<<(QDataStream &out, const ResumeStore::Entry &entry)
+{
+    out << entry.path << entry.position << entry.duration << entry.lastPlayedMs << entry.finished;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, ResumeStore::Entry &entry)
+{
+    in >> entry.path >> entry.position >> entry.duration >> entry.lastPlayedMs >> entry.finished;
+    return in;
+}
+
+ResumeStore &ResumeStore::instance()
+{
+    static ResumeStore store;
+    return store;
+}
+
+ResumeStore::ResumeStore()
+    : m_snapshotPath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                     + QStringLiteral("/resume.db"))
+    , m_journalPath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                    + QStringLiteral("/resume.journal"))
+{
+    // Construct the executor first so it outlives this store at exit.
+    PipelineExecutor::instance();
+}
+
+ResumeStore::~ResumeStore()
+{
+    // Never wait for a queued task here: at exit the pool may be busy
+    // with stages.  Only a flush that is already running is waited for.
+    {
+        std::lock_guard gate(m_gate->mutex);
+        m_gate->closed = true;
+    }
+    flush();   // everything not written by a task yet
+}
+
+// ── Queries / updates ──────────────────────────────────────
+
+double ResumeStore::resumePosition(const QString &path)
+{
+    const QString identity = FileFingerprint::of(path);
+    if (identity.isEmpty()) return 0.0;
+    ensureLoaded();
+
+    std::lock_guard lock(m_mutex);
+    m_identities.insert(path, identity);
+
+    const auto it = m_entries.constFind(identity);
+    if (it == m_entries.cend()) return 0.0;
+    const Entry &e = it.value();
+    if (e.finished || e.position < kMinResumeSeconds)
+        return 0.0;
+    if (e.duration > 0.0 && e.position > e.duration - kEndMarginSeconds)
+        return 0.0;
+    return e.position;
+}
+
+void ResumeStore::record(const QString &path, double position, double duration, bool finished)
+{
+    if (path.isEmpty()) return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    std::lock_guard lock(m_mutex);
+
+    Change change;
+    change.identity = m_identities.value(path);
+    change.entry    = Entry{path, position, duration, now, finished};
+    if (m_loaded && !change.identity.isEmpty())
+        m_entries.insert(change.identity, change.entry);
+    m_pending.push_back(std::move(change));
+
+    if (now - m_lastFlushMs >= kFlushIntervalMs)
+        scheduleFlushLocked();
+}
+
+void ResumeStore::flushAsync()
+{
+    std::lock_guard lock(m_mutex);
+    if (!m_pending.empty())
+        scheduleFlushLocked();
+}
+
+void ResumeStore::scheduleFlushLocked()
+{
+    if (m_flushScheduled) return;
+    m_flushScheduled = true;
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background,
+                                        [this, gate = m_gate] {
+        std::lock_guard lock(gate->mutex);
+        if (!gate->closed)
+            flush();
+    });
+}
+
+// ── Persistence (Background lane) ──────────────────────────
+
+void ResumeStore::ensureLoaded()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_loaded) return;
+    }
+    std::lock_guard io(m_ioMutex);
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_loaded) return;
+    }
+
+    // Read without holding m_mutex so record() never waits on the disk.
+    QHash<QString, Entry> entries;
+    int journalRecords = 0;
+
+    QFile snapshot(m_snapshotPath);
+    if (snapshot.open(QIODevice::ReadOnly)) {
+        QDataStream in(&snapshot);
+        in.setVersion(QDataStream::Qt_6_6);
+        quint32 magic = 0, version = 0;
+        qint32 count = 0;
+        in >> magic >> version >> count;
+        if (magic == kMagic && version == kVersion) {
+            for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                QString identity;
+                Entry entry;
+                in >> identity >> entry;
+                if (in.status() == QDataStream::Ok)
+                    entries.insert(identity, entry);
+            }
+        } else {
+            qWarning() << "ResumeStore - unsupported snapshot, ignored:" << m_snapshotPath;
+        }
+    }
+
+    QFile journal(m_journalPath);
+    if (journal.open(QIODevice::ReadOnly)) {
+        QDataStream in(&journal);
+        in.setVersion(QDataStream::Qt_6_6);
+        while (!in.atEnd()) {
+            QString identity;
+            Entry entry;
+            in >> identity >> entry;
+            if (in.status() != QDataStream::Ok) break;   // torn last batch
+            entries.insert(identity, entry);
+            ++journalRecords;
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    // Entries recorded while loading are newer than the disk.
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        if (!m_entries.contains(it.key()))
+            m_entries.insert(it.key(), it.value());
+    }
+    m_journalRecords = journalRecords;
+    m_loaded = true;
+}
+
+void ResumeStore::flush()
+{
+    ensureLoaded();
+    std::lock_guard io(m_ioMutex);
+
+    std::vector<Change> batch;
+    {
+        std::lock_guard lock(m_mutex);
+        batch.swap(m_pending);
+        m_flushScheduled = false;
+        m_lastFlushMs = QDateTime::currentMSecsSinceEpoch();
+    }
+    if (batch.empty()) return;
+
+    // Latest change per file; fingerprints not known yet are read here.
+    QHash<QString, Entry> latest;
+    for (Change &change : batch) {
+        if (change.identity.isEmpty())
+            change.identity = FileFingerprint::of(change.entry.path);
+        if (!change.identity.isEmpty())
+            latest.insert(change.identity, change.entry);
+    }
+    if (latest.isEmpty()) return;
+
+    QDir().mkpath(QFileInfo(m_journalPath).absolutePath());
+    QFile journal(m_journalPath);
+    if (journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        QDataStream out(&journal);
+        out.setVersion(QDataStream::Qt_6_6);
+        for (auto it = latest.cbegin(); it != latest.cend(); ++it)
+            out << it.key() << it.value();
+    } else {
+        qWarning() << "ResumeStore::flush - cannot open" << m_journalPath << journal.errorString();
+    }
+
+    QHash<QString, Entry> snapshot;
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto it = latest.cbegin(); it != latest.cend(); ++it) {
+            m_entries.insert(it.key(), it.value());
+            m_identities.insert(it.value().path, it.key());
+        }
+        m_journalRecords += static_cast<int>(latest.size());
+        if (m_journalRecords < kCompactAfter) return;
+
+        // Keep the most recently played files.
+        if (m_entries.size() > kMaxEntries) {
+            std::vector<std::pair<qint64, QString>> byAge;
+            byAge.reserve(m_entries.size());
+            for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+                byAge.emplace_back(it.value().lastPlayedMs, it.key());
+            std::sort(byAge.begin(), byAge.end());
+            for (size_t i = 0; i + kMaxEntries < byAge.size(); ++i)
+                m_entries.remove(byAge[i].second);
+        }
+        snapshot = m_entries;
+        m_journalRecords = 0;
+    }
+    compact(snapshot);
+}
+
+void ResumeStore::compact(const QHash<QString, Entry> &entries)
+{
+    QSaveFile file(m_snapshotPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ResumeStore::compact - cannot open" << m_snapshotPath << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_6);
+    out << kMagic << kVersion << qint32(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it)
+        out << it.key() << it.value();
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "ResumeStore::compact - write failed:" << m_snapshotPath;
+        return;
+    }
+
+    // Everything in the journal is in the snapshot now.
+    QFile journal(m_journalPath);
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        qWarning() << "ResumeStore::compact - cannot truncate" << m_journalPath;
+}
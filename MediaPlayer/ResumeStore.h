@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// @brief Per-file resume positions and watch history, keyed by
+///        FileFingerprint so a moved or renamed file still resumes.
+///
+/// record() only updates memory and queues the change; a Background task
+/// appends queued changes to a journal in batches, at most every
+/// kFlushIntervalMs or when flushAsync() asks for it (closing media).
+/// Once the journal has grown past kCompactAfter records it is folded
+/// into the snapshot file.  Loading replays snapshot + journal, so a crash
+/// loses at most the last unflushed batch.  No file I/O happens on the
+/// calling thread except resumePosition(), which reads the file's
+/// fingerprint and is meant for the open task.  The destructor writes what
+/// is left itself instead of waiting for a queued flush task.
+class ResumeStore
+{
+public:
+    struct Entry {
+        QString path;               ///< last path the file was played from
+        double  position     = 0.0; ///< seconds
+        double  duration     = 0.0; ///< seconds
+        qint64  lastPlayedMs = 0;   ///< ms since epoch
+        bool    finished     = false;
+    };
+
+    static ResumeStore &instance();
+
+    ~ResumeStore();
+
+    ResumeStore(const ResumeStore &) = delete;
+    ResumeStore &operator=(const ResumeStore &) = delete;
+
+    /// Where playback of @p path should start, in seconds (0 = beginning:
+    /// unknown, finished, or too close to either end).  Any thread but the
+    /// GUI thread.
+    double resumePosition(const QString &path);
+
+    /// Remember that @p path is at @p position.  No I/O; the GUI thread
+    /// calls this from the position timer.
+    void record(const QString &path, double position, double duration, bool finished = false);
+
+    /// Write the queued changes now, from a Background task.
+    void flushAsync();
+
+private:
+    ResumeStore();
+
+    struct Change {
+        QString identity;   ///< empty: resolved by the flush task
+        Entry   entry;
+    };
+
+    void ensureLoaded();    ///< reads the files once, outside m_mutex
+    void scheduleFlushLocked();
+    void flush();           ///< Background task body
+    void compact(const QHash<QString, Entry> &entries);
+
+    static constexpr qint64 kFlushIntervalMs = 15000;
+    static constexpr int    kCompactAfter    = 512;    ///< journal records
+    static constexpr int    kMaxEntries      = 5000;   ///< oldest dropped on compaction
+    static constexpr double kMinResumeSeconds = 10.0;
+    static constexpr double kEndMarginSeconds = 15.0;
+    static constexpr quint32 kMagic   = 0x5A515253;    // "ZQRS"
+    static constexpr quint32 kVersion = 1;
+
+    const QString m_snapshotPath;
+    const QString m_journalPath;
+
+    std::mutex              m_mutex;           ///< guards everything below
+    bool                    m_loaded = false;
+    QHash<QString, Entry>   m_entries;         ///< by fingerprint
+    QHash<QString, QString> m_identities;      ///< path → fingerprint, this session
+    std::vector<Change>     m_pending;
+    bool                    m_flushScheduled = false;
+    qint64                  m_lastFlushMs = 0;
+    int                     m_journalRecords = 0;
+
+    std::mutex              m_ioMutex;         ///< serialises flush() / compact()
+
+    /// Shared with the flush tasks: one that only runs after the store is
+    /// gone finds the gate closed and returns without touching it.
+    struct FlushGate {
+        std::mutex mutex;     ///< held while a task flushes
+        bool       closed = false;
+    };
+    std::shared_ptr<FlushGate> m_gate = std::make_shared<FlushGate>();
+};
+
+QDataStream &operator<<(QDataStream &out, const ResumeStore::Entry &entry);
+QDataStream &operator>>(QDataStream &in, ResumeStore::Entry &entry);
@@ -0,0 +1,73 @@
+#include "StageTimings.h"
+
+#include <algorithm>
+
+void StageTimings::record(Stage stage, int64_t ns)
+{
+    Samples &s = m_samples[static_cast<int>(stage)];
+    std::lock_guard lock(s.mutex);
+    s.ns.push_back(ns);
+}
+
+StageTimings::Summary StageTimings::summary(Stage stage) const
+{
+    std::vector<int64_t> ns;
+    {
+        const Samples &s = m_samples[static_cast<int>(stage)];
+        std::lock_guard lock(s.mutex);
+        ns = s.ns;
+    }
+
+    Summary sum;
+    if (ns.empty()) return sum;
+    std::sort(ns.begin(), ns.end());
+
+    // Nearest-rank percentile
+    auto rank = [&ns](int percent) {
+        const size_t n = ns.size();
+        const size_t idx = (n * static_cast<size_t>(percent) + 99) / 100;
+        return ns[std::clamp<size_t>(idx, 1, n) - 1];
+    };
+
+    sum.count = ns.size();
+    for (int64_t v : ns) sum.totalNs += v;
+    sum.p50Ns = rank(50);
+    sum.p90Ns = rank(90);
+    sum.p99Ns = rank(99);
+    sum.maxNs = ns.back();
+    return sum;
+}
+
+void StageTimings::reserve(size_t items)
+{
+    for (Samples &s : m_samples) {
+        std::lock_guard lock(s.mutex);
+        s.ns.reserve(s.ns.size() + items);
+    }
+}
+
+void StageTimings::reset()
+{
+    for (Samples &s : m_samples) {
+        std::lock_guard lock(s.mutex);
+        s.ns.clear();
+    }
+}
+
+const char *StageTimings::stageName(Stage stage)
+{
+    switch (stage) {
+    case Stage::Demux:        return "demux";
+    case Stage::VideoDecode:  return "video-decode";
+    case Stage::VideoConvert: return "video-convert";
+    case Stage::AudioDecode:  return "audio-decode";
+    case Stage::AudioConvert: return "audio-convert";
+    }
+    return "unknown";
+}
+
+int64_t StageTimings::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// @brief Per-item latency samples for each pipeline stage.
+///
+/// Handed to an AVCodecHandler with setStageTimings() by the headless
+/// benchmark; the player itself never sets one, so the stages only pay a
+/// null check.  Every demuxed packet, decode call and converted frame adds
+/// one sample, and summary() turns them into a count and percentiles.
+/// Thread-safe; each stage has its own lock.
+class StageTimings
+{
+public:
+    enum class Stage : uint8_t {
+        Demux = 0,      ///< av_read_frame(), per packet
+        VideoDecode,    ///< send + receive calls, per video packet
+        VideoConvert,   ///< FrameHandler::processVideoFrame(), per frame
+        AudioDecode,    ///< send + receive calls, per audio packet
+        AudioConvert,   ///< FrameHandler::processAudioFrame(), per frame
+    };
+    static constexpr int kStageCount = 5;
+
+    struct Summary {
+        uint64_t count   = 0;
+        int64_t  totalNs = 0;
+        int64_t  p50Ns   = 0;
+        int64_t  p90Ns   = 0;
+        int64_t  p99Ns   = 0;
+        int64_t  maxNs   = 0;
+    };
+
+    /// Times one item of @p stage from construction to destruction; does
+    /// nothing without @p timings.
+    class Scope
+    {
+    public:
+        Scope(StageTimings *timings, Stage stage)
+            : m_timings(timings), m_stage(stage), m_startNs(timings ? now() : 0) {}
+        ~Scope() { if (m_timings) m_timings->record(m_stage, now() - m_startNs); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        StageTimings *m_timings;
+        Stage         m_stage;
+        int64_t       m_startNs;
+    };
+
+    void record(Stage stage, int64_t ns);
+    Summary summary(Stage stage) const;
+
+    /// Make room for @p items more samples in every stage, so record()
+    /// does not allocate while the benchmark counts allocations.
+    void reserve(size_t items);
+
+    /// Drop every sample (between benchmark runs).
+    void reset();
+
+    static const char *stageName(Stage stage);
+    static int64_t now();   ///< steady clock, ns
+
+private:
+    struct Samples {
+        mutable std::mutex   mutex;
+        std::vector<int64_t> ns;
+    };
+    std::array<Samples, kStageCount> m_samples;
+};
@@ -0,0 +1,45 @@
+#include "StartupTimeline.h"
+#include <QDebug>
+
+StartupTimeline::StartupTimeline()
+{
+    m_clock.start();
+}
+
+void StartupTimeline::mark(const char *phase)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_done) return;
+    logLocked(phase, m_clock.elapsed());
+}
+
+void StartupTimeline::finish(const char *phase)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_done) return;
+    logLocked(phase, m_clock.elapsed());
+    m_done = true;
+}
+
+qint64 StartupTimeline::markFirstFrame(const char *phase)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_firstFrameMarked) return -1;
+    const qint64 now = m_clock.elapsed();
+    logLocked(phase, now);
+    m_firstFrameMarked = true;
+    return now;
+}
+
+qint64 StartupTimeline::elapsedMs() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_clock.elapsed();
+}
+
+void StartupTimeline::logLocked(const char *phase, qint64 nowMs)
+{
+    qDebug().nospace() << "STARTUP-TIMING " << phase << " +" << nowMs
+                       << " ms (" << (nowMs - m_lastMs) << " ms)";
+    m_lastMs = nowMs;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <mutex>
+
+/// @brief Timing marks for one open request, from the file drop to the
+///        first picture on screen.
+///
+/// Created by PlayerWindowManager when a file is requested and handed to
+/// the AVCodecHandler that opens it.  Each phase calls mark(), which logs
+///
+///   STARTUP-TIMING <phase> +<ms since request> (<ms since previous mark>)
+///
+/// finish() closes the timeline once the pipeline runs: later marks are
+/// ignored, so the log shows exactly one startup sequence per file.  The
+/// first frame is marked on its own and may land on either side of
+/// finish(): with a poster it comes before audio init, without one the
+/// video stage shows it after the pipeline started.  Thread-safe; the
+/// phases run on the open worker, the GUI thread and the video stage.
+class StartupTimeline
+{
+public:
+    StartupTimeline();
+
+    /// Log @p phase unless the timeline was finished.
+    void mark(const char *phase);
+
+    /// Log @p phase as the last startup phase and close the timeline.
+    void finish(const char *phase);
+
+    /// Log @p phase as the first picture and return the time-to-first-frame
+    /// in ms.  Returns -1 when the first frame had already been marked.
+    qint64 markFirstFrame(const char *phase);
+
+    /// Milliseconds since the request.
+    qint64 elapsedMs() const;
+
+private:
+    void logLocked(const char *phase, qint64 nowMs);
+
+    mutable std::mutex m_mutex;
+    QElapsedTimer      m_clock;
+    qint64             m_lastMs = 0;
+    bool               m_done   = false;   ///< finish() was called
+    bool               m_firstFrameMarked = false;
+};
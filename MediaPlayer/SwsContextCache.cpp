@@ -0,0 +1,100 @@
+#include "SwsContextCache.h"
+
+#include <QDebug>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+
+bool SwsContextCache::Key::operator==(const Key &other) const
+{
+    return srcWidth   == other.srcWidth
+        && srcHeight  == other.srcHeight
+        && srcFormat  == other.srcFormat
+        && dstWidth   == other.dstWidth
+        && dstHeight  == other.dstHeight
+        && dstFormat  == other.dstFormat
+        && flags      == other.flags
+        && colorSpace == other.colorSpace
+        && colorRange == other.colorRange;
+}
+
+SwsContextCache::SwsContextCache(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1) {}
+
+SwsContextCache::~SwsContextCache()
+{
+    clear();
+}
+
+SwsContext *SwsContextCache::acquire(const Key &key, bool *hit)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            // Move to front (most recently used)
+            if (it != m_entries.begin())
+                m_entries.splice(m_entries.begin(), m_entries, it);
+            if (hit) *hit = true;
+            return m_entries.front().ctx;
+        }
+    }
+
+    if (hit) *hit = false;
+
+    SwsContext *ctx = create(key);
+    if (!ctx) return nullptr;
+
+    // Evict least recently used entries to make room
+    while (m_entries.size() >= m_capacity) {
+        sws_freeContext(m_entries.back().ctx);
+        m_entries.pop_back();
+    }
+
+    m_entries.push_front(Entry{key, ctx});
+    return ctx;
+}
+
+void SwsContextCache::clear()
+{
+    for (Entry &e : m_entries)
+        sws_freeContext(e.ctx);
+    m_entries.clear();
+}
+
+size_t SwsContextCache::size() const
+{
+    return m_entries.size();
+}
+
+SwsContext *SwsContextCache::create(const Key &key)
+{
+    SwsContext *ctx = sws_getContext(
+        key.srcWidth, key.srcHeight, key.srcFormat,
+        key.dstWidth, key.dstHeight, key.dstFormat,
+        key.flags, nullptr, nullptr, nullptr);
+
+    if (!ctx) {
+        qWarning() << "SwsContextCache: sws_getContext failed for"
+                   << av_get_pix_fmt_name(key.srcFormat) << "->"
+                   << av_get_pix_fmt_name(key.dstFormat);
+        return nullptr;
+    }
+
+    // Apply the source matrix / range.  Only meaningful for YUV sources;
+    // sws_getColorspaceDetails() fails for RGB input and we keep defaults.
+    int *invTable = nullptr, *table = nullptr;
+    int srcRange = 0, dstRange = 0, brightness = 0, contrast = 0, saturation = 0;
+    if (sws_getColorspaceDetails(ctx, &invTable, &srcRange, &table, &dstRange,
+                                 &brightness, &contrast, &saturation) >= 0) {
+        const int cs = (key.colorSpace == AVCOL_SPC_UNSPECIFIED)
+                           ? SWS_CS_DEFAULT
+                           : static_cast<int>(key.colorSpace);
+        if (key.colorRange != AVCOL_RANGE_UNSPECIFIED)
+            srcRange = (key.colorRange == AVCOL_RANGE_JPEG) ? 1 : 0;
+
+        sws_setColorspaceDetails(ctx, sws_getCoefficients(cs), srcRange,
+                                 table, dstRange, brightness, contrast, saturation);
+    }
+
+    return ctx;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <list>
+#include <cstddef>
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavutil/pixfmt.h>
+#include <libswscale/swscale.h>
+}
+
+/// @brief Small LRU cache of SwsContext instances keyed by the full set of
+///        conversion parameters.
+///
+/// Mid-stream resolution / format switches (adaptive streams, concatenated
+/// files) would otherwise pay a full sws init per change — expensive with
+/// Bicubic / Lanczos.  Contexts are owned by the cache; callers must not free
+/// the returned pointer.  Not thread-safe: used from the video decode thread,
+/// cleared from the controlling thread after the decode threads are joined.
+class SwsContextCache
+{
+public:
+    struct Key {
+        int           srcWidth   = 0;
+        int           srcHeight  = 0;
+        AVPixelFormat srcFormat  = AV_PIX_FMT_NONE;
+        int           dstWidth   = 0;
+        int           dstHeight  = 0;
+        AVPixelFormat dstFormat  = AV_PIX_FMT_NONE;
+        int           flags      = 0;
+        AVColorSpace  colorSpace = AVCOL_SPC_UNSPECIFIED;
+        AVColorRange  colorRange = AVCOL_RANGE_UNSPECIFIED;
+
+        bool operator==(const Key &other) const;
+    };
+
+    explicit SwsContextCache(size_t capacity = 4);
+    ~SwsContextCache();
+
+    // Non-copyable
+    SwsContextCache(const SwsContextCache &) = delete;
+    SwsContextCache &operator=(const SwsContextCache &) = delete;
+
+    /// Return a context matching @p key, creating it on a miss and evicting
+    /// the least recently used entry when full.  @p hit (optional) reports
+    /// whether the context came from the cache.  Returns nullptr on failure.
+    SwsContext *acquire(const Key &key, bool *hit = nullptr);
+
+    /// Free all cached contexts.
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        Key         key;
+        SwsContext *ctx = nullptr;
+    };
+
+    static SwsContext *create(const Key &key);
+
+    std::list<Entry> m_entries;   ///< front = most recently used
+    size_t           m_capacity;
+};
@@ -0,0 +1,385 @@
+#include "VideoFilterGraph.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+
+extern "C" {
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+#include <libavutil/error.h>
+}
+
+namespace {
+QString ffError(int err)
+{
+    char buf[AV_ERROR_MAX_STRING_SIZE]{};
+    av_strerror(err, buf, sizeof(buf));
+    return QString::fromUtf8(buf);
+}
+}
+
+VideoFilterGraph::~VideoFilterGraph()
+{
+    teardown();
+}
+
+bool VideoFilterGraph::InputParams::operator==(const InputParams &o) const
+{
+    return width == o.width && height == o.height && format == o.format
+           && av_cmp_q(sampleAspect, o.sampleAspect) == 0
+           && av_cmp_q(timeBase, o.timeBase) == 0
+           && colorSpace == o.colorSpace && colorRange == o.colorRange;
+}
+
+// ── Description ────────────────────────────────────────────
+
+void VideoFilterGraph::setDescription(const QString &description)
+{
+    std::lock_guard lock(m_descMutex);
+    m_description = description.trimmed();
+}
+
+QString VideoFilterGraph::description() const
+{
+    std::lock_guard lock(m_descMutex);
+    return m_description;
+}
+
+void VideoFilterGraph::setDeinterlaceMode(DeinterlaceMode mode)
+{
+    m_deinterlace.store(mode);
+}
+
+DeinterlaceMode VideoFilterGraph::deinterlaceMode() const
+{
+    return m_deinterlace.load();
+}
+
+void VideoFilterGraph::newStream()
+{
+    m_interlacedSeen = false;
+}
+
+QString VideoFilterGraph::effectiveDescription(const AVFrame *frame)
+{
+    const QString user = description();
+    const DeinterlaceMode mode = m_deinterlace.load();
+
+    if (mode == DeinterlaceMode::Auto && !m_interlacedSeen
+        && (frame->flags & AV_FRAME_FLAG_INTERLACED)) {
+        m_interlacedSeen = true;
+        qDebug() << "VideoFilterGraph: interlaced video detected,"
+                 << ((frame->flags & AV_FRAME_FLAG_TOP_FIELD_FIRST) ? "TFF" : "BFF")
+                 << "- deinterlacing";
+    }
+
+    const bool deinterlace = mode == DeinterlaceMode::Force
+                             || (mode == DeinterlaceMode::Auto && m_interlacedSeen);
+    if (!deinterlace)
+        return user;
+
+    // send_field: one frame per field.  parity=auto follows the frame's
+    // top-field-first flag.  In Auto mode progressive frames pass through.
+    QString bwdif = QStringLiteral("bwdif=mode=send_field:parity=auto:deint=%1")
+                        .arg(mode == DeinterlaceMode::Force ? QStringLiteral("all")
+                                                            : QStringLiteral("interlaced"));
+    return user.isEmpty() ? bwdif : bwdif + QLatin1Char(',') + user;
+}
+
+// ── Filtering ──────────────────────────────────────────────
+
+void VideoFilterGraph::filter(AVFrame *frame, AVRational timeBase, const Output &out)
+{
+    const QString desc = effectiveDescription(frame);
+    if (desc != m_builtDescription) {
+        teardown();
+        m_builtDescription = desc;
+        if (desc.isEmpty()) {
+            std::lock_guard lock(m_statsMutex);
+            m_statsDescription.clear();
+            m_stats.clear();
+        }
+    }
+
+    if (desc.isEmpty()) {
+        out(frame, timeBase);
+        return;
+    }
+
+    const InputParams input = paramsOf(frame, timeBase);
+    if (m_stages.empty() || input != m_input) {
+        // Don't retry a known-bad description for every frame.
+        const bool knownBad = desc == m_failedDescription && input == m_failedInput;
+        if (knownBad || !rebuild(input)) {
+            m_failedDescription = desc;
+            m_failedInput       = input;
+            out(frame, timeBase);
+            return;
+        }
+    }
+
+    runStage(0, frame, out);
+}
+
+void VideoFilterGraph::flush(const Output &out)
+{
+    if (!m_stages.empty())
+        runStage(0, nullptr, out);
+    teardown();
+}
+
+void VideoFilterGraph::reset()
+{
+    teardown();
+}
+
+void VideoFilterGraph::runStage(size_t index, AVFrame *frame, const Output &out)
+{
+    Stage &stage = m_stages[index];
+    const bool last = index + 1 == m_stages.size();
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 ns = 0;
+
+    int ret = av_buffersrc_add_frame_flags(stage.src, frame, AV_BUFFERSRC_FLAG_KEEP_REF);
+    if (ret < 0) {
+        qWarning() << "VideoFilterGraph::runStage - add frame failed:" << ffError(ret);
+        return;
+    }
+
+    for (;;) {
+        ret = av_buffersink_get_frame(stage.sink, stage.out);
+        if (ret < 0) break;   // EAGAIN: needs more input, EOF: drained
+
+        // Time spent downstream (later stages, presentation) is not ours.
+        ns += timer.nsecsElapsed();
+        if (last)
+            out(stage.out, stage.outTimeBase);
+        else
+            runStage(index + 1, stage.out, out);
+        av_frame_unref(stage.out);
+        timer.restart();
+    }
+    ns += timer.nsecsElapsed();
+
+    if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+        qWarning() << "VideoFilterGraph::runStage - get frame failed:" << ffError(ret);
+
+    // End of stream: propagate once this stage has drained.
+    if (!frame && !last)
+        runStage(index + 1, nullptr, out);
+
+    if (frame) {
+        std::lock_guard lock(m_statsMutex);
+        if (index < m_stats.size()) {
+            StageStats &s = m_stats[index];
+            ++s.frames;
+            s.ns += static_cast<uint64_t>(ns);
+            s.maxNs = std::max(s.maxNs, static_cast<uint64_t>(ns));
+        }
+    }
+}
+
+// ── Graph construction ─────────────────────────────────────
+
+VideoFilterGraph::InputParams VideoFilterGraph::paramsOf(const AVFrame *frame, AVRational timeBase)
+{
+    InputParams p;
+    p.width        = frame->width;
+    p.height       = frame->height;
+    p.format       = frame->format;
+    p.sampleAspect = frame->sample_aspect_ratio;
+    p.timeBase     = timeBase;
+    p.colorSpace   = frame->colorspace;
+    p.colorRange   = frame->color_range;
+    return p;
+}
+
+QStringList VideoFilterGraph::splitChain(const QString &description)
+{
+    // Pad labels or several chains: keep the graph whole.
+    if (description.contains(QLatin1Char('[')) || description.contains(QLatin1Char(';')))
+        return {description};
+
+    QStringList stages;
+    QString current;
+    bool quoted = false;
+    for (int i = 0; i < description.size(); ++i) {
+        const QChar c = description.at(i);
+        if (c == QLatin1Char('\\') && i + 1 < description.size()) {
+            current += c;
+            current += description.at(++i);
+        } else if (c == QLatin1Char('\'')) {
+            quoted = !quoted;
+            current += c;
+        } else if (c == QLatin1Char(',') && !quoted) {
+            if (!current.trimmed().isEmpty())
+                stages << current.trimmed();
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.trimmed().isEmpty())
+        stages << current.trimmed();
+    return stages;
+}
+
+QString VideoFilterGraph::filterName(const QString &stage)
+{
+    const int eq = stage.indexOf(QLatin1Char('='));
+    return (eq < 0 ? stage : stage.left(eq)).trimmed();
+}
+
+bool VideoFilterGraph::rebuild(const InputParams &input)
+{
+    teardown();
+
+    const QStringList parts = splitChain(m_builtDescription);
+    if (parts.isEmpty())
+        return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    m_stages.resize(static_cast<size_t>(parts.size()));
+    InputParams stageInput = input;
+    for (int i = 0; i < parts.size(); ++i) {
+        Stage &stage = m_stages[static_cast<size_t>(i)];
+        if (!buildStage(stage, parts.at(i), stageInput)) {
+            qWarning() << "VideoFilterGraph: cannot build" << parts.at(i)
+                       << "- passing frames through unfiltered";
+            teardown();
+            return false;
+        }
+
+        // The next stage is fed with whatever this one produces.
+        stageInput.width        = av_buffersink_get_w(stage.sink);
+        stageInput.height       = av_buffersink_get_h(stage.sink);
+        stageInput.format       = av_buffersink_get_format(stage.sink);
+        stageInput.sampleAspect = av_buffersink_get_sample_aspect_ratio(stage.sink);
+        stageInput.timeBase     = stage.outTimeBase;
+    }
+    m_input = input;
+
+    {
+        std::lock_guard lock(m_statsMutex);
+        if (m_statsDescription != m_builtDescription) {
+            m_statsDescription = m_builtDescription;
+            m_stats.assign(static_cast<size_t>(parts.size()), StageStats{});
+            for (int i = 0; i < parts.size(); ++i)
+                m_stats[static_cast<size_t>(i)].name = filterName(parts.at(i));
+        }
+    }
+
+    qDebug() << "VideoFilterGraph: built" << parts.size() << "stage(s) for"
+             << m_builtDescription << "at" << input.width << "x" << input.height
+             << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool VideoFilterGraph::buildStage(Stage &stage, const QString &description, const InputParams &input)
+{
+    stage.graph = avfilter_graph_alloc();
+    stage.out   = av_frame_alloc();
+    if (!stage.graph || !stage.out)
+        return false;
+
+    // Slice-thread the filters that support it (0 = one per core).
+    stage.graph->nb_threads  = 0;
+    stage.graph->thread_type = AVFILTER_THREAD_SLICE;
+
+    const AVRational sar = input.sampleAspect.den > 0 ? input.sampleAspect : AVRational{0, 1};
+    char args[256];
+    std::snprintf(args, sizeof(args),
+                  "video_size=%dx%d:pix_fmt=%d:time_base=%d/%d:pixel_aspect=%d/%d",
+                  input.width, input.height, input.format,
+                  input.timeBase.num, input.timeBase.den, sar.num, sar.den);
+
+    int ret = avfilter_graph_create_filter(&stage.src, avfilter_get_by_name("buffer"),
+                                           "in", args, nullptr, stage.graph);
+    if (ret >= 0) {
+        ret = avfilter_graph_create_filter(&stage.sink, avfilter_get_by_name("buffersink"),
+                                           "out", nullptr, nullptr, stage.graph);
+    }
+    if (ret < 0) {
+        qWarning() << "VideoFilterGraph::buildStage - buffer endpoints:" << ffError(ret);
+        return false;
+    }
+
+    // The parser's open output "in" is our source, its open input "out" the sink.
+    AVFilterInOut *outputs = avfilter_inout_alloc();
+    AVFilterInOut *inputs  = avfilter_inout_alloc();
+    if (!outputs || !inputs) {
+        avfilter_inout_free(&outputs);
+        avfilter_inout_free(&inputs);
+        return false;
+    }
+    outputs->name       = av_strdup("in");
+    outputs->filter_ctx = stage.src;
+    outputs->pad_idx    = 0;
+    outputs->next       = nullptr;
+    inputs->name        = av_strdup("out");
+    inputs->filter_ctx  = stage.sink;
+    inputs->pad_idx     = 0;
+    inputs->next        = nullptr;
+
+    ret = avfilter_graph_parse_ptr(stage.graph, description.toUtf8().constData(),
+                                   &inputs, &outputs, nullptr);
+    avfilter_inout_free(&outputs);
+    avfilter_inout_free(&inputs);
+    if (ret >= 0)
+        ret = avfilter_graph_config(stage.graph, nullptr);
+    if (ret < 0) {
+        qWarning() << "VideoFilterGraph::buildStage -" << description << ":" << ffError(ret);
+        return false;
+    }
+
+    stage.outTimeBase = av_buffersink_get_time_base(stage.sink);
+    return true;
+}
+
+void VideoFilterGraph::teardown()
+{
+    for (Stage &stage : m_stages) {
+        avfilter_graph_free(&stage.graph);   // frees src / sink too
+        av_frame_free(&stage.out);
+    }
+    m_stages.clear();
+    m_input = InputParams{};
+}
+
+// ── Stats ──────────────────────────────────────────────────
+
+QVariantMap VideoFilterGraph::stats() const
+{
+    QVariantMap map;
+    std::lock_guard lock(m_statsMutex);
+    if (m_statsDescription.isEmpty() || m_stats.empty())
+        return map;
+
+    map.insert(QStringLiteral("filterGraph"), m_statsDescription);
+    map.insert(QStringLiteral("filterFrames"), QVariant::fromValue<qulonglong>(m_stats.front().frames));
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        const StageStats &s = m_stats[i];
+        const QString prefix = QStringLiteral("filter.%1.%2").arg(i).arg(s.name);
+        map.insert(prefix + QStringLiteral(".msAvg"),
+                   s.frames ? static_cast<double>(s.ns) / 1e6 / static_cast<double>(s.frames) : 0.0);
+        map.insert(prefix + QStringLiteral(".msMax"), static_cast<double>(s.maxNs) / 1e6);
+    }
+    return map;
+}
+
+void VideoFilterGraph::resetStats()
+{
+    std::lock_guard lock(m_statsMutex);
+    for (StageStats &s : m_stats) {
+        s.frames = 0;
+        s.ns     = 0;
+        s.maxNs  = 0;
+    }
+}
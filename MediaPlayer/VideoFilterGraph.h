@@ -0,0 +1,141 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "AVPlayerStatus.h"
+
+extern "C" {
+#include <libavfilter/avfilter.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include <libavutil/rational.h>
+}
+
+/// @brief Optional libavfilter post-processing stage between the video
+///        decoder and FrameHandler.
+///
+/// The description uses ffmpeg -vf syntax, e.g. "hqdn3d,unsharp=5:5:0.8".
+/// Each filter of a plain comma-separated chain gets its own small graph so
+/// its cost can be timed separately; a description with pad labels or ';'
+/// is built as a single graph.  Graphs are only rebuilt when the description
+/// or the input parameters (size, format, aspect, colour, time base) change.
+/// Slice threading is enabled on every graph.
+///
+/// Deinterlacing is a bwdif stage in front of the user's chain, emitting
+/// one frame per field (50i → 50p).  In Auto mode it is inserted once the
+/// stream flags its first interlaced frame and then only touches frames
+/// flagged interlaced, so progressive segments pass through untouched.
+///
+/// Runs on the video filter thread of AVCodecHandler.  Only setDescription(),
+/// description(), stats() and resetStats() may be called from other threads.
+class VideoFilterGraph
+{
+public:
+    /// Receives each filtered frame together with the time base of its pts.
+    /// The frame is only valid for the duration of the call.
+    using Output = std::function<void(AVFrame *frame, AVRational timeBase)>;
+
+    VideoFilterGraph() = default;
+    ~VideoFilterGraph();
+
+    // Non-copyable
+    VideoFilterGraph(const VideoFilterGraph &) = delete;
+    VideoFilterGraph &operator=(const VideoFilterGraph &) = delete;
+
+    /// Set the filter description.  Empty = pass-through.  Takes effect on
+    /// the next frame.
+    void setDescription(const QString &description);
+    QString description() const;
+
+    /// Deinterlacing policy.  Takes effect on the next frame.
+    void setDeinterlaceMode(DeinterlaceMode mode);
+    DeinterlaceMode deinterlaceMode() const;
+
+    /// Forget Auto-mode interlace detection (new file).
+    void newStream();
+
+    /// Filter @p frame (pts in @p timeBase) and hand every resulting frame to
+    /// @p out.  Without a description, or when the graph cannot be built for
+    /// it, the frame is passed through unchanged.
+    void filter(AVFrame *frame, AVRational timeBase, const Output &out);
+
+    /// Drain the frames still buffered inside the filters (end of stream).
+    void flush(const Output &out);
+
+    /// Drop all buffered state (seek, stop).  The next frame rebuilds.
+    void reset();
+
+    /// Per-filter timing: "filterGraph", "filterFrames" and, per stage,
+    /// "filter.<n>.<name>.msAvg" / ".msMax".  Empty without a description.
+    QVariantMap stats() const;
+    void resetStats();
+
+private:
+    /// Parameters a graph was configured for; a change forces a rebuild.
+    struct InputParams {
+        int           width  = 0;
+        int           height = 0;
+        int           format = AV_PIX_FMT_NONE;
+        AVRational    sampleAspect{0, 1};
+        AVRational    timeBase{0, 1};
+        AVColorSpace  colorSpace = AVCOL_SPC_UNSPECIFIED;
+        AVColorRange  colorRange = AVCOL_RANGE_UNSPECIFIED;
+
+        bool operator==(const InputParams &o) const;
+        bool operator!=(const InputParams &o) const { return !(*this == o); }
+    };
+
+    struct Stage {
+        AVFilterGraph   *graph = nullptr;
+        AVFilterContext *src   = nullptr;   ///< "buffer"
+        AVFilterContext *sink  = nullptr;   ///< "buffersink"
+        AVFrame         *out   = nullptr;   ///< reused receive frame
+        AVRational       outTimeBase{0, 1};
+    };
+
+    struct StageStats {
+        QString  name;
+        uint64_t frames = 0;
+        uint64_t ns     = 0;
+        uint64_t maxNs  = 0;
+    };
+
+    static InputParams paramsOf(const AVFrame *frame, AVRational timeBase);
+    static QStringList splitChain(const QString &description);
+    static QString filterName(const QString &stage);
+
+    /// The user's description, prefixed with bwdif when @p frame needs it.
+    QString effectiveDescription(const AVFrame *frame);
+
+    bool rebuild(const InputParams &input);
+    bool buildStage(Stage &stage, const QString &description, const InputParams &input);
+    void teardown();
+
+    /// Feed @p frame (nullptr = EOF) into stage @p index and push everything
+    /// it produces downstream.
+    void runStage(size_t index, AVFrame *frame, const Output &out);
+
+    // Description (any thread)
+    mutable std::mutex   m_descMutex;
+    QString              m_description;
+    std::atomic<DeinterlaceMode> m_deinterlace{DeinterlaceMode::Auto};
+    std::atomic<bool>    m_interlacedSeen{false};   ///< Auto mode: stream is interlaced
+
+    // Filter-thread state
+    QString              m_builtDescription;   ///< description m_stages were built from
+    QString              m_failedDescription;  ///< last description that failed to build
+    InputParams          m_failedInput;        ///< input it failed for
+    InputParams          m_input;
+    std::vector<Stage>   m_stages;
+
+    // Timing (any thread)
+    mutable std::mutex       m_statsMutex;
+    QString                  m_statsDescription;
+    std::vector<StageStats>  m_stats;
+};
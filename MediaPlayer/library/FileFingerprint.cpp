@@ -0,0 +1,24 @@
+#include "FileFingerprint.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <algorithm>
+
+namespace {
+constexpr qint64 kChunk = 64 * 1024;   // bytes hashed from each end
+} // namespace
+
+QString FileFingerprint::of(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const qint64 total = file.size();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(total));
+    hash.addData(file.read(kChunk));
+    if (total > kChunk && file.seek(std::max(kChunk, total - kChunk)))
+        hash.addData(file.read(kChunk));
+    return QString::fromLatin1(hash.result().toHex());
+}
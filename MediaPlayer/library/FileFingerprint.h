@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QString>
+
+/// @brief Identity of a file's content that survives renames and moves.
+///
+/// SHA-1 over the file size and its first and last 64 KiB: cheap enough
+/// to compute on every open, and media files that share both ends and
+/// the size are in practice the same file.  Reads the file, so call it
+/// off the GUI thread.
+namespace FileFingerprint
+{
+    /// Hex digest, or an empty string when @p path cannot be read.
+    QString of(const QString &path);
+}
@@ -0,0 +1,120 @@
+#include "LibraryIndex.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QDataStream &operator<<(QDataStream &out, const MediaEntry &entry)
+{
+    out << entry.path << entry.size << entry.mtimeMs
+        << entry.title << entry.container << entry.durationMs << entry.bitRate
+        << entry.videoCodec << qint32(entry.width) << qint32(entry.height) << entry.frameRate
+        << entry.audioCodec << qint32(entry.sampleRate) << qint32(entry.channels)
+        << entry.probeFailed;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, MediaEntry &entry)
+{
+    qint32 width = 0, height = 0, sampleRate = 0, channels = 0;
+    in >> entry.path >> entry.size >> entry.mtimeMs
+       >> entry.title >> entry.container >> entry.durationMs >> entry.bitRate
+       >> entry.videoCodec >> width >> height >> entry.frameRate
+       >> entry.audioCodec >> sampleRate >> channels
+       >> entry.probeFailed;
+    entry.width      = width;
+    entry.height     = height;
+    entry.sampleRate = sampleRate;
+    entry.channels   = channels;
+    return in;
+}
+
+QString LibraryIndex::defaultLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+           + QStringLiteral("/library.idx");
+}
+
+bool LibraryIndex::load(const QString &filePath)
+{
+    m_entries.clear();
+
+    QFile file(filePath);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "LibraryIndex::load - cannot open" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_6);
+
+    quint32 magic = 0, version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != kMagic || version != kVersion || count < 0) {
+        qWarning() << "LibraryIndex::load - unsupported index, starting empty:" << filePath;
+        return false;
+    }
+
+    m_entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        MediaEntry entry;
+        in >> entry;
+        if (in.status() == QDataStream::Ok)
+            m_entries.insert(entry.path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "LibraryIndex::load - truncated index, kept" << m_entries.size() << "entries";
+        return false;
+    }
+    return true;
+}
+
+bool LibraryIndex::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "LibraryIndex::save - cannot open" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_6);
+    out << kMagic << kVersion << qint32(m_entries.size());
+    for (const MediaEntry &entry : m_entries)
+        out << entry;
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "LibraryIndex::save - write failed:" << filePath << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+const MediaEntry *LibraryIndex::find(const QString &path) const
+{
+    auto it = m_entries.constFind(path);
+    return it == m_entries.cend() ? nullptr : &it.value();
+}
+
+void LibraryIndex::insert(const MediaEntry &entry)
+{
+    m_entries.insert(entry.path, entry);
+}
+
+void LibraryIndex::remove(const QString &path)
+{
+    m_entries.remove(path);
+}
+
+void LibraryIndex::clear()
+{
+    m_entries.clear();
+}
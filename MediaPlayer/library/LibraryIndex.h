@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+
+/// @brief Metadata of one library file, from MediaLibrary's light probe.
+struct MediaEntry
+{
+    QString path;
+    qint64  size    = 0;    ///< bytes, for change detection
+    qint64  mtimeMs = 0;    ///< last modification, ms since epoch
+
+    QString title;          ///< container "title" tag, empty when untagged
+    QString container;      ///< demuxer name, e.g. "matroska,webm"
+    qint64  durationMs = 0;
+    qint64  bitRate    = 0; ///< bits per second, 0 = unknown
+
+    QString videoCodec;
+    int     width     = 0;
+    int     height    = 0;
+    double  frameRate = 0.0;
+
+    QString audioCodec;
+    int     sampleRate = 0;
+    int     channels   = 0;
+
+    bool    probeFailed = false;   ///< unreadable; retried only when the file changes
+};
+
+QDataStream &operator<<(QDataStream &out, const MediaEntry &entry);
+QDataStream &operator>>(QDataStream &in, MediaEntry &entry);
+
+/// @brief The library's on-disk index: one MediaEntry per file, keyed by
+///        absolute path.
+///
+/// Stored as a single versioned QDataStream file, written through QSaveFile
+/// so a crash mid-write keeps the previous index.  Entries carry size and
+/// mtime so a rescan only probes files that changed.  Plain value type:
+/// MediaLibrary hands copies (implicitly shared) to its scan task.
+class LibraryIndex
+{
+public:
+    /// Index file inside the application data directory.
+    static QString defaultLocation();
+
+    /// Replace the entries with the contents of @p filePath.  A missing
+    /// file is an empty index; an unreadable one is logged and ignored.
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+
+    const MediaEntry *find(const QString &path) const;
+    void insert(const MediaEntry &entry);
+    void remove(const QString &path);
+    void clear();
+
+    int size() const { return static_cast<int>(m_entries.size()); }
+    const QHash<QString, MediaEntry> &entries() const { return m_entries; }
+
+private:
+    static constexpr quint32 kMagic   = 0x5A514C49;   // "ZQLI"
+    static constexpr quint32 kVersion = 1;
+
+    QHash<QString, MediaEntry> m_entries;
+};
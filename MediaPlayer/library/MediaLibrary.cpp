@@ -0,0 +1,528 @@
+#include "MediaLibrary.h"
+#include "SettingsStore.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QUrl>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/dict.h>
+}
+
+namespace {
+// Bytes the demuxer may read to identify the container.  Headers that hold
+// the stream parameters (moov, EBML, RIFF) sit well inside this.
+constexpr int64_t kProbeBytes = 512 * 1024;
+
+// Below this many files per task, extra probe tasks only add overhead.
+constexpr size_t kProbesPerTask = 16;
+
+const QSet<QString> &mediaSuffixes()
+{
+    static const QSet<QString> suffixes = {
+        "mp4", "m4v", "mov", "mkv", "webm", "avi", "wmv", "flv", "ts", "m2ts", "mts",
+        "mpg", "mpeg", "3gp", "ogv", "mxf",
+        "mp3", "flac", "wav", "m4a", "aac", "ogg", "opus", "wma", "ac3", "dts",
+    };
+    return suffixes;
+}
+
+QString formatDuration(qint64 ms)
+{
+    const qint64 secs = ms / 1000;
+    return QString("%1:%2:%3")
+        .arg(secs / 3600, 2, 10, QChar('0'))
+        .arg((secs % 3600) / 60, 2, 10, QChar('0'))
+        .arg(secs % 60, 2, 10, QChar('0'));
+}
+
+bool isUnder(const QString &path, const QString &dir)
+{
+    return path.startsWith(dir)
+        && (path.size() == dir.size() || path.at(dir.size()) == QLatin1Char('/'));
+}
+
+bool isUnderAny(const QString &path, const QStringList &dirs)
+{
+    return std::any_of(dirs.cbegin(), dirs.cend(),
+                       [&path](const QString &dir) { return isUnder(path, dir); });
+}
+} // namespace
+
+/// Shared between the GUI thread and the scan / probe tasks.
+struct MediaLibrary::ScanState
+{
+    QStringList  folders;
+    QStringList  roots;               ///< subtrees to rescan; empty = every folder
+    QString      indexPath;
+    bool         loadIndex = false;   ///< read the index from disk first
+    LibraryIndex previous;            ///< index the scan starts from
+
+    std::vector<MediaEntry> pending;  ///< new / changed files, probed in place
+    std::atomic<size_t>     next{0};  ///< next pending entry to probe
+
+    std::atomic<bool> cancel{false};
+    std::atomic<int>  found{0};
+    std::atomic<int>  toProbe{0};
+    std::atomic<int>  probed{0};
+    std::atomic<int>  removed{0};
+    QElapsedTimer     clock;
+};
+
+MediaLibrary::MediaLibrary(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_indexPath(LibraryIndex::defaultLocation())
+{
+    SettingsStore &settings = SettingsStore::instance();
+    m_folders = settings.value("library/folders").toStringList();
+
+    m_progressTimer.setInterval(250);
+    connect(&m_progressTimer, &QTimer::timeout, this, &MediaLibrary::updateScanStats);
+
+    m_rescanTimer.setSingleShot(true);
+    m_rescanTimer.setInterval(kRescanDelayMs);
+    connect(&m_rescanTimer, &QTimer::timeout, this, &MediaLibrary::rescanChanged);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &dir) {
+        m_changedDirs.insert(dir);
+        m_rescanTimer.start();
+    });
+
+    // Loads the index and catches up with changes made while we were not
+    // running.
+    startScan();
+}
+
+MediaLibrary::~MediaLibrary()
+{
+    if (m_scan)
+        m_scan->cancel = true;
+    m_scanTasks.wait();
+}
+
+// ── QAbstractListModel ─────────────────────────────────────
+
+int MediaLibrary::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_items.size());
+}
+
+QVariant MediaLibrary::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_items.size())
+        return {};
+
+    const MediaEntry &e = m_items.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:           return QFileInfo(e.path).fileName();
+    case PathRole:           return e.path;
+    case TitleRole:          return e.title;
+    case ContainerRole:      return e.container;
+    case DurationRole:       return e.durationMs / 1000.0;
+    case DurationTextRole:   return e.durationMs > 0 ? formatDuration(e.durationMs) : QString();
+    case ResolutionTextRole:
+        return e.width > 0 ? QString("%1×%2").arg(e.width).arg(e.height) : QString();
+    case VideoCodecRole:     return e.videoCodec;
+    case AudioCodecRole:     return e.audioCodec;
+    case SizeRole:           return e.size;
+    }
+    return {};
+}
+
+QHash<int, QByteArray> MediaLibrary::roleNames() const
+{
+    return {
+        {PathRole,           "path"},
+        {NameRole,           "name"},
+        {TitleRole,          "title"},
+        {ContainerRole,      "container"},
+        {DurationRole,       "duration"},
+        {DurationTextRole,   "durationText"},
+        {ResolutionTextRole, "resolutionText"},
+        {VideoCodecRole,     "videoCodec"},
+        {AudioCodecRole,     "audioCodec"},
+        {SizeRole,           "size"},
+    };
+}
+
+// ── Properties ─────────────────────────────────────────────
+
+QStringList MediaLibrary::folders() const
+{
+    return m_folders;
+}
+
+int MediaLibrary::count() const
+{
+    return static_cast<int>(m_items.size());
+}
+
+bool MediaLibrary::scanning() const
+{
+    return m_scan != nullptr;
+}
+
+QVariantMap MediaLibrary::scanStats() const
+{
+    return m_scanStats;
+}
+
+// ── Folders ────────────────────────────────────────────────
+
+void MediaLibrary::addFolder(const QString &folder)
+{
+    const QString path = toLocalPath(folder);
+    if (path.isEmpty() || !QFileInfo(path).isDir()) {
+        qWarning() << "MediaLibrary::addFolder - not a directory:" << folder;
+        return;
+    }
+    if (m_folders.contains(path)) return;
+
+    m_folders.append(path);
+    saveFolders();
+    emit foldersChanged();
+    rescan();
+}
+
+void MediaLibrary::removeFolder(const QString &folder)
+{
+    const QString path = toLocalPath(folder);
+    if (!m_folders.removeOne(path)) return;
+
+    saveFolders();
+    emit foldersChanged();
+
+    // Whatever the running scan finds under the removed folder is stale.
+    if (m_scan)
+        m_scan->cancel = true;
+    rescan();
+}
+
+void MediaLibrary::saveFolders() const
+{
+    SettingsStore &settings = SettingsStore::instance();
+    settings.setValue("library/folders", m_folders);
+}
+
+QString MediaLibrary::toLocalPath(const QString &folder)
+{
+    const QUrl url(folder);
+    const QString path = url.isLocalFile() ? url.toLocalFile() : folder;
+    return path.isEmpty() ? QString() : QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+bool MediaLibrary::isMediaFile(const QString &suffix)
+{
+    return mediaSuffixes().contains(suffix.toLower());
+}
+
+// ── Scanning ───────────────────────────────────────────────
+
+void MediaLibrary::rescan()
+{
+    if (m_scan) {
+        m_rescanQueued = true;
+        return;
+    }
+    startScan();
+}
+
+void MediaLibrary::rescanChanged()
+{
+    // A running scan picks the directories up when it finishes.
+    if (m_scan || m_changedDirs.isEmpty()) return;
+
+    QStringList changed(m_changedDirs.cbegin(), m_changedDirs.cend());
+    m_changedDirs.clear();
+    std::sort(changed.begin(), changed.end());
+
+    // Outermost changed directories only, and only inside a library folder:
+    // the watcher may still report a folder removed since the last scan.
+    QStringList roots;
+    for (const QString &dir : changed) {
+        if (!roots.isEmpty() && isUnder(dir, roots.last())) continue;
+        if (isUnderAny(dir, m_folders)) roots.append(dir);
+    }
+    if (!roots.isEmpty())
+        startScan(roots);
+}
+
+void MediaLibrary::startScan(const QStringList &roots)
+{
+    auto state = std::make_shared<ScanState>();
+    state->folders   = m_folders;
+    state->roots     = roots;
+    state->indexPath = m_indexPath;
+    state->loadIndex = !m_indexLoaded;
+    state->previous  = m_index;
+    state->clock.start();
+
+    m_scan = state;
+    m_rescanQueued = false;
+    if (roots.isEmpty())
+        m_changedDirs.clear();   // a full scan covers them
+    emit scanningChanged();
+    updateScanStats();
+    m_progressTimer.start();
+
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Io, [this, state] {
+        ScanResult result = runScan(state);
+        QMetaObject::invokeMethod(this, [this, state, result = std::move(result)]() mutable {
+            finishScan(state, std::move(result));
+        }, Qt::QueuedConnection);
+    }, &m_scanTasks);
+}
+
+MediaLibrary::ScanResult MediaLibrary::runScan(const std::shared_ptr<ScanState> &state)
+{
+    ScanResult result;
+
+    if (state->loadIndex)
+        state->previous.load(state->indexPath);
+
+    // ── Partial scan: entries outside the changed subtrees carry over ──
+    const bool partial = !state->roots.isEmpty();
+    if (partial) {
+        for (const MediaEntry &entry : state->previous.entries())
+            if (!isUnderAny(entry.path, state->roots))
+                result.index.insert(entry);
+    }
+    // Entries of the previous index the walk can find again.
+    const int walked = state->previous.size() - result.index.size();
+
+    // ── Walk: keep unchanged entries, collect new / changed files ──
+    int stillThere = 0;   // entries of the previous index found again
+    for (const QString &folder : partial ? state->roots : state->folders) {
+        if (partial && !QFileInfo(folder).isDir()) continue;   // removed meanwhile
+        result.directories.append(folder);
+        QDirIterator it(folder, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            if (state->cancel) return result;
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            if (info.isDir()) {
+                result.directories.append(info.absoluteFilePath());
+                continue;
+            }
+            if (!isMediaFile(info.suffix())) continue;
+
+            const QString path = info.absoluteFilePath();
+            if (result.index.find(path)) continue;   // nested library folders
+            state->found.fetch_add(1, std::memory_order_relaxed);
+
+            const qint64 size  = info.size();
+            const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+            const MediaEntry *known = state->previous.find(path);
+            if (known) ++stillThere;
+            if (known && known->size == size && known->mtimeMs == mtime) {
+                result.index.insert(*known);
+                continue;
+            }
+
+            MediaEntry entry;
+            entry.path    = path;
+            entry.size    = size;
+            entry.mtimeMs = mtime;
+            result.index.insert(entry);   // placeholder until probed
+            state->pending.push_back(std::move(entry));
+        }
+    }
+    state->toProbe.store(static_cast<int>(state->pending.size()));
+
+    // ── Probe: one task per core; this task takes part so the scan keeps
+    //    moving even when every Background worker is busy ──
+    auto drain = [state] {
+        for (;;) {
+            const size_t i = state->next.fetch_add(1);
+            if (i >= state->pending.size() || state->cancel) return;
+            probe(state->pending[i], state->cancel);
+            state->probed.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    const size_t cores   = std::max(1u, std::thread::hardware_concurrency());
+    const size_t helpers = std::min(cores - 1, state->pending.size() / kProbesPerTask);
+    PipelineExecutor::TaskGroup probes;
+    for (size_t i = 0; i < helpers; ++i)
+        PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background, drain, &probes);
+    drain();
+    probes.wait();
+
+    if (state->cancel) return result;
+
+    for (const MediaEntry &entry : state->pending)
+        result.index.insert(entry);
+
+    state->removed.store(walked - stillThere);
+    if (!state->pending.empty() || state->removed > 0)
+        result.index.save(state->indexPath);
+
+    result.items.reserve(result.index.size());
+    for (const MediaEntry &entry : result.index.entries())
+        result.items.append(entry);
+    std::sort(result.items.begin(), result.items.end(), [](const MediaEntry &a, const MediaEntry &b) {
+        return QString::compare(a.path, b.path, Qt::CaseInsensitive) < 0;
+    });
+    return result;
+}
+
+void MediaLibrary::probe(MediaEntry &entry, const std::atomic<bool> &cancel)
+{
+    AVFormatContext *fmt = avformat_alloc_context();
+    if (!fmt) {
+        entry.probeFailed = true;
+        return;
+    }
+    fmt->probesize = kProbeBytes;
+    fmt->interrupt_callback.callback = &MediaLibrary::probeInterrupt;
+    fmt->interrupt_callback.opaque   = const_cast<std::atomic<bool> *>(&cancel);
+
+    // Header only: the stream parameters the container declares are
+    // enough for the library, and no decoder is opened.
+    if (avformat_open_input(&fmt, entry.path.toUtf8().constData(), nullptr, nullptr) < 0) {
+        entry.probeFailed = true;   // avformat_open_input() freed fmt
+        return;
+    }
+
+    entry.probeFailed = false;
+    entry.container   = QString::fromUtf8(fmt->iformat->name);
+    entry.bitRate     = fmt->bit_rate > 0 ? fmt->bit_rate : 0;
+    if (fmt->duration != AV_NOPTS_VALUE && fmt->duration > 0)
+        entry.durationMs = fmt->duration / 1000;
+    if (const AVDictionaryEntry *title = av_dict_get(fmt->metadata, "title", nullptr, 0))
+        entry.title = QString::fromUtf8(title->value);
+
+    const int videoIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (videoIdx >= 0) {
+        const AVStream *st = fmt->streams[videoIdx];
+        entry.videoCodec = QString::fromUtf8(avcodec_get_name(st->codecpar->codec_id));
+        entry.width      = st->codecpar->width;
+        entry.height     = st->codecpar->height;
+        const AVRational rate = st->avg_frame_rate.num > 0 ? st->avg_frame_rate : st->r_frame_rate;
+        entry.frameRate  = rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 0.0;
+        if (entry.durationMs == 0 && st->duration != AV_NOPTS_VALUE && st->duration > 0)
+            entry.durationMs = static_cast<qint64>(st->duration * av_q2d(st->time_base) * 1000.0);
+    }
+
+    const int audioIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (audioIdx >= 0) {
+        const AVStream *st = fmt->streams[audioIdx];
+        entry.audioCodec = QString::fromUtf8(avcodec_get_name(st->codecpar->codec_id));
+        entry.sampleRate = st->codecpar->sample_rate;
+        entry.channels   = st->codecpar->ch_layout.nb_channels;
+        if (entry.durationMs == 0 && st->duration != AV_NOPTS_VALUE && st->duration > 0)
+            entry.durationMs = static_cast<qint64>(st->duration * av_q2d(st->time_base) * 1000.0);
+    }
+
+    avformat_close_input(&fmt);
+}
+
+int MediaLibrary::probeInterrupt(void *opaque)
+{
+    return static_cast<const std::atomic<bool> *>(opaque)->load() ? 1 : 0;
+}
+
+void MediaLibrary::finishScan(const std::shared_ptr<ScanState> &state, ScanResult result)
+{
+    updateScanStats();
+    m_scan.reset();
+    m_progressTimer.stop();
+
+    if (!state->cancel) {
+        m_index       = std::move(result.index);
+        m_indexLoaded = true;
+
+        const bool countChangedNow = m_items.size() != result.items.size();
+        beginResetModel();
+        m_items = std::move(result.items);
+        endResetModel();
+        if (countChangedNow)
+            emit countChanged();
+
+        if (state->roots.isEmpty()) {
+            watchDirectories(result.directories);
+        } else {
+            // Keep watching outside the rescanned subtrees.
+            QStringList directories;
+            for (const QString &dir : m_watcher.directories())
+                if (!isUnderAny(dir, state->roots)) directories.append(dir);
+            directories += result.directories;
+            watchDirectories(directories);
+        }
+    }
+
+    const double secs = state->clock.elapsed() / 1000.0;
+    qDebug().noquote() << QString("MediaLibrary - %1 files (%2 probed, %3 removed) in %4 s: "
+                                  "%5 files/s, %6 probes/s%7%8")
+                              .arg(m_scanStats.value("filesFound").toInt())
+                              .arg(m_scanStats.value("filesProbed").toInt())
+                              .arg(m_scanStats.value("filesRemoved").toInt())
+                              .arg(secs, 0, 'f', 2)
+                              .arg(m_scanStats.value("filesPerSecond").toDouble(), 0, 'f', 0)
+                              .arg(m_scanStats.value("probesPerSecond").toDouble(), 0, 'f', 0)
+                              .arg(state->roots.isEmpty()
+                                       ? QString()
+                                       : QString(" [%1 changed directories]").arg(state->roots.size()))
+                              .arg(state->cancel ? " (cancelled)" : "");
+    emit scanningChanged();
+
+    if (m_rescanQueued)
+        startScan();
+    else
+        rescanChanged();
+}
+
+void MediaLibrary::updateScanStats()
+{
+    const std::shared_ptr<ScanState> &state = m_scan;
+    if (!state) {
+        emit scanStatsChanged();
+        return;
+    }
+
+    const double secs   = std::max<qint64>(1, state->clock.elapsed()) / 1000.0;
+    const int    found  = state->found.load(std::memory_order_relaxed);
+    const int    probed = state->probed.load(std::memory_order_relaxed);
+
+    m_scanStats.insert("filesFound",      found);
+    m_scanStats.insert("filesToProbe",    state->toProbe.load(std::memory_order_relaxed));
+    m_scanStats.insert("filesProbed",     probed);
+    m_scanStats.insert("filesRemoved",    state->removed.load(std::memory_order_relaxed));
+    m_scanStats.insert("elapsedMs",       state->clock.elapsed());
+    m_scanStats.insert("filesPerSecond",  found / secs);
+    m_scanStats.insert("probesPerSecond", probed / secs);
+    emit scanStatsChanged();
+}
+
+void MediaLibrary::watchDirectories(const QStringList &directories)
+{
+    QStringList wanted = directories;
+    if (wanted.size() > kMaxWatchedDirectories) {
+        qWarning() << "MediaLibrary - watching only" << kMaxWatchedDirectories << "of"
+                   << wanted.size() << "directories; use rescan() for the rest";
+        wanted = wanted.mid(0, kMaxWatchedDirectories);
+    }
+
+    const QSet<QString> next(wanted.cbegin(), wanted.cend());
+    const QStringList current = m_watcher.directories();
+    const QSet<QString> watched(current.cbegin(), current.cend());
+
+    QStringList stale;
+    for (const QString &dir : current)
+        if (!next.contains(dir)) stale.append(dir);
+    QStringList added;
+    for (const QString &dir : wanted)
+        if (!watched.contains(dir)) added.append(dir);
+
+    if (!stale.isEmpty()) m_watcher.removePaths(stale);
+    if (!added.isEmpty()) m_watcher.addPaths(added);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+#include <QtQml/qqml.h>
+#include <atomic>
+#include <memory>
+
+#include "LibraryIndex.h"
+#include "PipelineExecutor.h"
+
+/// @brief QML list model of the media files found under the user's library
+///        folders.
+///
+/// A scan walks the folders on the executor's Io lane and compares each
+/// media file's size and mtime with the persistent LibraryIndex; only new
+/// or changed files are probed.  Probing runs on the Background lane,
+/// spread over one task per core, and only reads the container header:
+/// no find_stream_info(), no decoder.  A QFileSystemWatcher (inotify on
+/// Linux) on the scanned directories triggers a rescan a moment after the
+/// tree changes; it walks only the subtrees of the directories that
+/// changed and merges the result into the index.
+///
+/// Progress and throughput are published in scanStats and logged when a
+/// scan finishes.
+class MediaLibrary : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(QStringList folders READ folders NOTIFY foldersChanged)
+    Q_PROPERTY(int  count    READ count    NOTIFY countChanged)
+    Q_PROPERTY(bool scanning READ scanning NOTIFY scanningChanged)
+
+    /// Running or last scan: "filesFound", "filesToProbe", "filesProbed",
+    /// "filesRemoved", "elapsedMs", "filesPerSecond", "probesPerSecond".
+    Q_PROPERTY(QVariantMap scanStats READ scanStats NOTIFY scanStatsChanged)
+
+public:
+    enum Role {
+        PathRole = Qt::UserRole + 1,
+        NameRole,
+        TitleRole,
+        ContainerRole,
+        DurationRole,         ///< seconds
+        DurationTextRole,
+        ResolutionTextRole,
+        VideoCodecRole,
+        AudioCodecRole,
+        SizeRole,             ///< bytes
+    };
+
+    explicit MediaLibrary(QObject *parent = nullptr);
+    ~MediaLibrary() override;
+
+    // ── QAbstractListModel ──
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QStringList folders() const;
+    int  count() const;
+    bool scanning() const;
+    QVariantMap scanStats() const;
+
+    /// Add a library folder (local path or file:// URL) and scan it.
+    Q_INVOKABLE void addFolder(const QString &folder);
+    Q_INVOKABLE void removeFolder(const QString &folder);
+
+    /// Incremental rescan of every folder.  While a scan is running the
+    /// request is queued and runs once it has finished.
+    Q_INVOKABLE void rescan();
+
+signals:
+    void foldersChanged();
+    void countChanged();
+    void scanningChanged();
+    void scanStatsChanged();
+
+private:
+    struct ScanState;
+
+    struct ScanResult {
+        LibraryIndex       index;
+        QVector<MediaEntry> items;    ///< index sorted for the model
+        QStringList        directories;
+    };
+
+    /// Scan @p roots (subtrees of the library folders) and merge them into
+    /// the index; every folder when empty.
+    void startScan(const QStringList &roots = {});
+    /// Partial scan of the directories the watcher reported.
+    void rescanChanged();
+    void finishScan(const std::shared_ptr<ScanState> &state, ScanResult result);
+    void updateScanStats();
+    void watchDirectories(const QStringList &directories);
+    void saveFolders() const;
+
+    /// Runs on the Io lane.
+    static ScanResult runScan(const std::shared_ptr<ScanState> &state);
+    /// Header-only probe of @p entry->path; fills in the metadata fields.
+    static void probe(MediaEntry &entry, const std::atomic<bool> &cancel);
+    static int  probeInterrupt(void *opaque);
+    static bool isMediaFile(const QString &suffix);
+    static QString toLocalPath(const QString &folder);
+
+    static constexpr int kMaxWatchedDirectories = 4096;
+    static constexpr int kRescanDelayMs         = 2000;
+
+    QStringList          m_folders;
+    QString              m_indexPath;
+    bool                 m_indexLoaded = false;
+    LibraryIndex         m_index;
+    QVector<MediaEntry>  m_items;
+
+    // ── Scanning ──
+    std::shared_ptr<ScanState>  m_scan;            ///< running scan, null when idle
+    bool                        m_rescanQueued = false;
+    PipelineExecutor::TaskGroup m_scanTasks;
+    QVariantMap                 m_scanStats;
+    QTimer                      m_progressTimer;   ///< refreshes scanStats while scanning
+
+    // ── Change notification ──
+    QFileSystemWatcher   m_watcher;
+    QTimer               m_rescanTimer;             ///< coalesces watcher bursts
+    QSet<QString>        m_changedDirs;             ///< reported since the last scan
+};
@@ -0,0 +1,211 @@
+#include "ThumbnailCache.h"
+#include "ThumbnailExtractor.h"
+#include "FileFingerprint.h"
+#include "DecoderThreadingPolicy.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <thread>
+
+ThumbnailCache &ThumbnailCache::instance()
+{
+    static ThumbnailCache cache;
+    return cache;
+}
+
+ThumbnailCache::ThumbnailCache()
+    : m_diskDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                + QStringLiteral("/thumbnails"))
+{
+    // Construct the executor first so it outlives this cache at exit.
+    PipelineExecutor::instance();
+    QDir().mkpath(m_diskDir);
+    m_memory.setMaxCost(kMemoryCostKb);
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background,
+                                        [this] { trimDisk(); }, &m_jobs);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    std::deque<Request> dropped;
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+        dropped.swap(m_queue);
+    }
+    for (Request &r : dropped)
+        r.done({});
+    m_jobs.wait();
+}
+
+void ThumbnailCache::request(const QString &path, const QSize &size,
+                             std::shared_ptr<std::atomic<bool>> cancelled, Done done)
+{
+    Request r{path, size, memoryKey(path, size), std::move(cancelled), std::move(done)};
+
+    {
+        std::unique_lock lock(m_mutex);
+        if (const QImage *hit = m_memory.object(r.memoryKey)) {
+            const QImage image = *hit;
+            lock.unlock();
+            r.done(image);
+            return;
+        }
+        if (m_stopping) {
+            lock.unlock();
+            r.done({});
+            return;
+        }
+        m_queue.push_back(std::move(r));
+    }
+    schedule();
+}
+
+int ThumbnailCache::concurrencyLimit() const
+{
+    if (DecoderThreadingPolicy::playingPlayers() > 0)
+        return 1;
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+}
+
+void ThumbnailCache::schedule()
+{
+    const int limit = concurrencyLimit();
+    std::lock_guard lock(m_mutex);
+    while (!m_stopping && m_running < limit && m_running < static_cast<int>(m_queue.size())) {
+        ++m_running;
+        PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background,
+                                            [this] { runJobs(); }, &m_jobs);
+    }
+}
+
+void ThumbnailCache::runJobs()
+{
+    for (;;) {
+        Request r;
+        {
+            std::lock_guard lock(m_mutex);
+            // Playback started since this task was scheduled: leave the
+            // rest to a single task.
+            if (m_queue.empty() || m_stopping || m_running > concurrencyLimit()) {
+                --m_running;
+                return;
+            }
+            r = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        QImage image;
+        if (!(r.cancelled && r.cancelled->load()))
+            image = load(r);
+        r.done(image);
+
+        if (DecoderThreadingPolicy::playingPlayers() > 0)
+            std::this_thread::sleep_for(kPlaybackPause);
+        else
+            schedule();   // playback stopped: fan out again
+    }
+}
+
+QImage ThumbnailCache::load(const Request &request)
+{
+    const QString key = contentKey(request.path, request.size);
+    const QString file = key.isEmpty() ? QString() : m_diskDir + '/' + key + QStringLiteral(".jpg");
+
+    QImage image;
+    if (!file.isEmpty()) {
+        QFile cached(file);
+        if (cached.open(QIODevice::ReadWrite | QIODevice::ExistingOnly) && image.load(&cached, "JPG"))
+            cached.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    if (image.isNull()) {
+        image = ThumbnailExtractor::extract(request.path, request.size, request.cancelled.get());
+        if (!image.isNull() && !file.isEmpty()) {
+            QSaveFile out(file);
+            if (!out.open(QIODevice::WriteOnly) || !image.save(&out, "JPG", kJpegQuality)
+                || !out.commit()) {
+                qWarning() << "ThumbnailCache::load - cannot write" << file;
+            } else {
+                std::lock_guard lock(m_mutex);
+                if (++m_writesSinceTrim >= kTrimEveryWrites && !m_stopping) {
+                    m_writesSinceTrim = 0;
+                    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background,
+                                                        [this] { trimDisk(); }, &m_jobs);
+                }
+            }
+        }
+    }
+
+    if (!image.isNull()) {
+        const int costKb = static_cast<int>(std::max<qsizetype>(1, image.sizeInBytes() / 1024));
+        std::lock_guard lock(m_mutex);
+        m_memory.insert(request.memoryKey, new QImage(image), costKb);
+    }
+    return image;
+}
+
+void ThumbnailCache::trimDisk()
+{
+    // contentKey(): FileFingerprint (SHA-1 hex) plus the size.
+    static const QRegularExpression currentName(QStringLiteral("^[0-9a-f]{40}-\\d+x\\d+\\.jpg$"));
+
+    QFileInfoList kept;
+    qint64 total = 0;
+    int stale = 0;
+    const QFileInfoList files = QDir(m_diskDir).entryInfoList({QStringLiteral("*.jpg")}, QDir::Files);
+    for (const QFileInfo &info : files) {
+        if (!currentName.match(info.fileName()).hasMatch()) {
+            if (QFile::remove(info.absoluteFilePath()))
+                ++stale;
+            continue;
+        }
+        total += info.size();
+        kept.append(info);
+    }
+
+    int evicted = 0;
+    if (total > kDiskCapBytes) {
+        // Least recently used first; load() refreshes the mtime on a hit.
+        std::sort(kept.begin(), kept.end(), [](const QFileInfo &a, const QFileInfo &b) {
+            return a.lastModified() < b.lastModified();
+        });
+        for (const QFileInfo &info : kept) {
+            if (total <= kDiskCapBytes / 4 * 3) break;
+            if (QFile::remove(info.absoluteFilePath())) {
+                total -= info.size();
+                ++evicted;
+            }
+        }
+    }
+
+    if (stale > 0 || evicted > 0)
+        qDebug() << "ThumbnailCache::trimDisk - removed" << stale << "stale and"
+                 << evicted << "old thumbnails," << total / 1024 << "KB kept";
+}
+
+QString ThumbnailCache::memoryKey(const QString &path, const QSize &size)
+{
+    const QFileInfo info(path);
+    return QStringLiteral("%1|%2|%3|%4x%5")
+        .arg(path)
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch())
+        .arg(size.width())
+        .arg(size.height());
+}
+
+QString ThumbnailCache::contentKey(const QString &path, const QSize &size)
+{
+    const QString fingerprint = FileFingerprint::of(path);
+    if (fingerprint.isEmpty())
+        return {};
+    return QStringLiteral("%1-%2x%3").arg(fingerprint).arg(size.width()).arg(size.height());
+}
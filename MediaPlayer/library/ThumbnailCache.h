@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "PipelineExecutor.h"
+
+/// @brief Process-wide thumbnail service: in-memory LRU in front of a
+///        content-addressed disk cache in front of ThumbnailExtractor.
+///
+/// Disk entries are named after the file's FileFingerprint plus the
+/// requested size, so a moved or renamed file keeps its thumbnail and an
+/// edited one gets a new one.  A disk hit refreshes the file's mtime, and
+/// the directory is kept under kDiskCapBytes by dropping the least recently
+/// used files; files named after an older key format are removed.  The
+/// memory cache is keyed by path, size and mtime and avoids re-reading
+/// those bytes for thumbnails already shown.
+///
+/// Extraction runs on the executor's Background lane.  While any player is
+/// playing (DecoderThreadingPolicy::playingPlayers()), only one extraction
+/// runs at a time and each is followed by a short pause, so thumbnails
+/// never take more than a fraction of one core from playback.
+class ThumbnailCache
+{
+public:
+    /// Called exactly once per request, from any thread.  A null image
+    /// means there is no thumbnail (audio-only, unreadable, cancelled).
+    using Done = std::function<void(const QImage &image)>;
+
+    static ThumbnailCache &instance();
+
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache &) = delete;
+    ThumbnailCache &operator=(const ThumbnailCache &) = delete;
+
+    /// Thumbnail of @p path fitted into @p size.  Answers synchronously on
+    /// a memory hit, otherwise from a Background task.  A request whose
+    /// @p cancelled flag is set before it runs completes with a null image.
+    void request(const QString &path, const QSize &size,
+                 std::shared_ptr<std::atomic<bool>> cancelled, Done done);
+
+private:
+    ThumbnailCache();
+
+    struct Request {
+        QString path;
+        QSize   size;
+        QString memoryKey;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        Done    done;
+    };
+
+    void schedule();          ///< start jobs up to the current concurrency limit
+    void runJobs();           ///< Background task: take requests until none is left
+    QImage load(const Request &request);
+    int  concurrencyLimit() const;
+    void trimDisk();          ///< Background task: stale key formats, size cap
+
+    static QString memoryKey(const QString &path, const QSize &size);
+    static QString contentKey(const QString &path, const QSize &size);
+
+    static constexpr int  kMemoryCostKb  = 48 * 1024;     ///< decoded thumbnails kept in RAM
+    static constexpr int  kJpegQuality   = 85;
+    static constexpr auto kPlaybackPause = std::chrono::milliseconds(100);
+    static constexpr qint64 kDiskCapBytes = 256ll << 20;   ///< trimmed to 3/4 of this
+    static constexpr int  kTrimEveryWrites = 64;
+
+    const QString m_diskDir;
+
+    std::mutex              m_mutex;            ///< guards everything below
+    QCache<QString, QImage> m_memory;
+    std::deque<Request>     m_queue;
+    int                     m_running  = 0;     ///< runJobs() tasks in flight
+    int                     m_writesSinceTrim = 0;
+    bool                    m_stopping = false;
+
+    PipelineExecutor::TaskGroup m_jobs;
+};
@@ -0,0 +1,217 @@
+#include "ThumbnailExtractor.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+// Candidate positions, as fractions of the duration, in order of preference.
+constexpr double kCandidates[] = {0.10, 0.25, 0.40, 0.60, 0.80};
+
+// A keyframe is normally found within a few packets of a seek; give up on
+// a candidate after this many.
+constexpr int kMaxPacketsPerCandidate = 256;
+
+// Luma thresholds (0–255) for "shows something".
+constexpr double kMinMean   = 24.0;
+constexpr double kMaxMean   = 235.0;
+constexpr double kMinStddev = 12.0;
+} // namespace
+
+bool ThumbnailExtractor::Score::acceptable() const
+{
+    return mean >= kMinMean && mean <= kMaxMean && stddev >= kMinStddev;
+}
+
+QImage ThumbnailExtractor::extract(const QString &path, const QSize &maxSize,
+                                   const std::atomic<bool> *cancel)
+{
+    AVFormatContext *fmt = avformat_alloc_context();
+    if (!fmt) return {};
+    if (cancel) {
+        fmt->interrupt_callback.callback = &ThumbnailExtractor::interruptCallback;
+        fmt->interrupt_callback.opaque   = const_cast<std::atomic<bool> *>(cancel);
+    }
+    if (avformat_open_input(&fmt, path.toUtf8().constData(), nullptr, nullptr) < 0)
+        return {};
+
+    AVCodecContext *ctx = nullptr;
+    AVFrame *frame = av_frame_alloc();
+    QImage best;
+    Score bestScore;
+    bestScore.stddev = -1.0;
+
+    auto cleanup = [&] {
+        av_frame_free(&frame);
+        avcodec_free_context(&ctx);
+        avformat_close_input(&fmt);
+    };
+
+    int streamIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIdx >= 0 && fmt->streams[streamIdx]->codecpar->width <= 0) {
+        // Header without the picture size (e.g. MPEG-TS): probe the stream.
+        avformat_find_stream_info(fmt, nullptr);
+        streamIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+    if (streamIdx < 0 || !frame) {
+        cleanup();
+        return {};
+    }
+
+    AVStream *st = fmt->streams[streamIdx];
+    const AVCodec *codec = avcodec_find_decoder(st->codecpar->codec_id);
+    ctx = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!ctx || avcodec_parameters_to_context(ctx, st->codecpar) < 0) {
+        cleanup();
+        return {};
+    }
+    ctx->pkt_timebase     = st->time_base;
+    ctx->thread_count     = 1;                    // one core, whatever the file
+    ctx->skip_frame       = AVDISCARD_NONKEY;     // keyframes only
+    ctx->skip_loop_filter = AVDISCARD_ALL;
+    if (avcodec_open2(ctx, codec, nullptr) < 0) {
+        cleanup();
+        return {};
+    }
+
+    // Cover art: a single picture carried in the header.
+    if (st->disposition & AV_DISPOSITION_ATTACHED_PIC) {
+        if (avcodec_send_packet(ctx, &st->attached_pic) >= 0
+            && avcodec_send_packet(ctx, nullptr) >= 0
+            && avcodec_receive_frame(ctx, frame) == 0) {
+            best = scale(frame, st->sample_aspect_ratio, maxSize);
+        }
+        cleanup();
+        return best;
+    }
+
+    const int64_t duration = fmt->duration != AV_NOPTS_VALUE ? fmt->duration : 0;
+    const int candidates = duration > 0 ? static_cast<int>(std::size(kCandidates)) : 1;
+
+    for (int i = 0; i < candidates; ++i) {
+        if (cancel && cancel->load()) break;
+
+        if (duration > 0) {
+            const int64_t target = (fmt->start_time != AV_NOPTS_VALUE ? fmt->start_time : 0)
+                                   + static_cast<int64_t>(duration * kCandidates[i]);
+            if (av_seek_frame(fmt, -1, target, AVSEEK_FLAG_BACKWARD) < 0)
+                continue;
+            avcodec_flush_buffers(ctx);
+        }
+
+        if (!decodeNext(fmt, ctx, streamIdx, frame, cancel))
+            continue;
+
+        QImage image = scale(frame, frame->sample_aspect_ratio.num > 0
+                                        ? frame->sample_aspect_ratio
+                                        : st->sample_aspect_ratio, maxSize);
+        av_frame_unref(frame);
+        if (image.isNull())
+            continue;
+
+        const Score s = score(image);
+        if (s.acceptable()) {
+            best = std::move(image);
+            break;
+        }
+        if (s.stddev > bestScore.stddev) {
+            best = std::move(image);
+            bestScore = s;
+        }
+    }
+
+    cleanup();
+    return best;
+}
+
+bool ThumbnailExtractor::decodeNext(AVFormatContext *fmt, AVCodecContext *ctx, int streamIdx,
+                                    AVFrame *frame, const std::atomic<bool> *cancel)
+{
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt) return false;
+
+    bool got = false;
+    for (int n = 0; n < kMaxPacketsPerCandidate && !got; ++n) {
+        if (cancel && cancel->load()) break;
+
+        const int ret = av_read_frame(fmt, pkt);
+        if (ret < 0) {
+            // EOF: drain what the decoder still holds.
+            avcodec_send_packet(ctx, nullptr);
+            got = avcodec_receive_frame(ctx, frame) == 0;
+            break;
+        }
+        if (pkt->stream_index == streamIdx && avcodec_send_packet(ctx, pkt) >= 0)
+            got = avcodec_receive_frame(ctx, frame) == 0;
+        av_packet_unref(pkt);
+    }
+
+    av_packet_free(&pkt);
+    return got;
+}
+
+QImage ThumbnailExtractor::scale(const AVFrame *frame, AVRational sampleAspect, const QSize &maxSize)
+{
+    if (frame->width <= 0 || frame->height <= 0 || maxSize.isEmpty())
+        return {};
+
+    // Fit the display size (storage size × SAR) into maxSize.
+    double displayWidth = frame->width;
+    if (sampleAspect.num > 0 && sampleAspect.den > 0)
+        displayWidth *= av_q2d(sampleAspect);
+    const double factor = std::min({maxSize.width() / displayWidth,
+                                    maxSize.height() / static_cast<double>(frame->height),
+                                    1.0});
+    const int dstW = std::max(1, static_cast<int>(std::lround(displayWidth * factor)));
+    const int dstH = std::max(1, static_cast<int>(std::lround(frame->height * factor)));
+
+    SwsContext *sws = sws_getContext(frame->width, frame->height,
+                                     static_cast<AVPixelFormat>(frame->format),
+                                     dstW, dstH, AV_PIX_FMT_RGB0,
+                                     SWS_AREA, nullptr, nullptr, nullptr);
+    if (!sws) {
+        qWarning() << "ThumbnailExtractor::scale - no conversion from"
+                   << av_get_pix_fmt_name(static_cast<AVPixelFormat>(frame->format));
+        return {};
+    }
+
+    QImage image(dstW, dstH, QImage::Format_RGBX8888);
+    uint8_t *dst[4]    = {image.bits(), nullptr, nullptr, nullptr};
+    int dstStride[4]   = {static_cast<int>(image.bytesPerLine()), 0, 0, 0};
+    sws_scale(sws, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+    sws_freeContext(sws);
+    return image;
+}
+
+ThumbnailExtractor::Score ThumbnailExtractor::score(const QImage &image)
+{
+    // Rec.601 luma of every pixel; thumbnails are small enough.
+    double sum = 0.0, sumSq = 0.0;
+    const int w = image.width(), h = image.height();
+    for (int y = 0; y < h; ++y) {
+        const uchar *p = image.constScanLine(y);
+        for (int x = 0; x < w; ++x, p += 4) {
+            const double luma = 0.299 * p[0] + 0.587 * p[1] + 0.114 * p[2];
+            sum   += luma;
+            sumSq += luma * luma;
+        }
+    }
+
+    Score s;
+    const double n = static_cast<double>(w) * h;
+    if (n <= 0) return s;
+    s.mean   = sum / n;
+    s.stddev = std::sqrt(std::max(0.0, sumSq / n - s.mean * s.mean));
+    return s;
+}
+
+int ThumbnailExtractor::interruptCallback(void *opaque)
+{
+    return static_cast<const std::atomic<bool> *>(opaque)->load() ? 1 : 0;
+}
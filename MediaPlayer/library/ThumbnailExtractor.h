@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <atomic>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+/// @brief Decodes one representative keyframe of a media file as a small
+///        RGB image.
+///
+/// The decoder only outputs keyframes (skip_frame = NONKEY) and runs on a
+/// single thread.  Candidates are taken at fixed fractions of the
+/// duration.  The first one that is neither near-black nor flat (fades,
+/// title cards, black leaders) wins; otherwise the candidate with the
+/// most detail is used.  Embedded cover art is returned as is.  Scaling
+/// goes through libswscale (SWS_AREA), which uses its SIMD paths for the
+/// common YUV → RGB conversions.
+class ThumbnailExtractor
+{
+public:
+    /// Thumbnail of @p path fitted into @p maxSize (display aspect kept).
+    /// Null image for audio-only or unreadable files, or when @p cancel
+    /// becomes true.
+    static QImage extract(const QString &path, const QSize &maxSize,
+                          const std::atomic<bool> *cancel = nullptr);
+
+private:
+    struct Score {
+        double mean   = 0.0;   ///< luma, 0–255
+        double stddev = 0.0;
+        bool acceptable() const;
+    };
+
+    /// Read and decode until the next picture of @p streamIdx; false at
+    /// EOF, on error or after too many packets.
+    static bool decodeNext(AVFormatContext *fmt, AVCodecContext *ctx, int streamIdx,
+                           AVFrame *frame, const std::atomic<bool> *cancel);
+    static QImage scale(const AVFrame *frame, AVRational sampleAspect, const QSize &maxSize);
+    static Score  score(const QImage &image);
+    static int    interruptCallback(void *opaque);
+};
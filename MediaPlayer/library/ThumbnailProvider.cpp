@@ -0,0 +1,76 @@
+#include "ThumbnailProvider.h"
+#include "ThumbnailCache.h"
+
+#include <QUrl>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+constexpr QSize kDefaultSize(320, 180);
+
+/// Lives until finished() is emitted, which ThumbnailCache guarantees to
+/// trigger exactly once, so the completion callback may hold a raw pointer.
+class ThumbnailResponse : public QQuickImageResponse
+{
+public:
+    ThumbnailResponse(const QString &path, const QSize &size)
+        : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+        ThumbnailCache::instance().request(path, size, m_cancelled, [this](const QImage &image) {
+            bool inConstructor = false;
+            {
+                std::lock_guard lock(m_mutex);
+                m_image = image;
+                inConstructor = m_constructing;
+                m_answered = true;
+            }
+            if (!inConstructor)
+                emit finished();
+        });
+
+        // A memory hit answers synchronously, before the engine has
+        // connected to finished(): report it from the event loop instead.
+        std::lock_guard lock(m_mutex);
+        m_constructing = false;
+        if (m_answered)
+            QMetaObject::invokeMethod(this, [this] { emit finished(); }, Qt::QueuedConnection);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        std::lock_guard lock(m_mutex);
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        std::lock_guard lock(m_mutex);
+        return m_image.isNull() ? QStringLiteral("no thumbnail") : QString();
+    }
+
+    void cancel() override
+    {
+        m_cancelled->store(true);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    mutable std::mutex m_mutex;
+    QImage m_image;
+    bool   m_constructing = true;
+    bool   m_answered     = false;
+};
+
+} // namespace
+
+QQuickImageResponse *ThumbnailProvider::requestImageResponse(const QString &id,
+                                                             const QSize &requestedSize)
+{
+    const QString path = QUrl::fromPercentEncoding(id.toUtf8());
+    QSize size = kDefaultSize;
+    if (requestedSize.width() > 0 && requestedSize.height() > 0)
+        size = requestedSize;
+    return new ThumbnailResponse(path, size);
+}
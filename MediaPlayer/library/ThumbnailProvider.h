@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+
+/// @brief "image://thumbnail/<percent-encoded path>" for QML.
+///
+/// Answers through ThumbnailCache; the requested source size picks the
+/// thumbnail size (320×180 when the Image sets none).  Registered on the
+/// engine in main().
+class ThumbnailProvider : public QQuickAsyncImageProvider
+{
+public:
+    QQuickImageResponse *requestImageResponse(const QString &id,
+                                              const QSize &requestedSize) override;
+};
@@ -0,0 +1,60 @@
+#include "GLVideoFrame.h"
+
+#include <chrono>
+
+GLVideoFrame::Layout GLVideoFrame::layoutFor(AVPixelFormat fmt)
+{
+    switch (fmt) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        return Layout::Yuv420P;
+    case AV_PIX_FMT_YUV420P10LE:
+        return Layout::Yuv420P10;
+    case AV_PIX_FMT_NV12:
+        return Layout::Nv12;
+    case AV_PIX_FMT_P010LE:
+        return Layout::P010;
+    default:
+        return Layout::None;
+    }
+}
+
+GLVideoFrame GLVideoFrame::fromAVFrame(const AVFrame *src)
+{
+    GLVideoFrame out;
+    if (!src) return out;
+
+    const Layout layout = layoutFor(static_cast<AVPixelFormat>(src->format));
+    if (layout == Layout::None) return out;
+
+    AVFrame *ref = av_frame_clone(src);
+    if (!ref) return out;
+
+    out.layout     = layout;
+    out.width      = src->width;
+    out.height     = src->height;
+    out.colorSpace = src->colorspace;
+    out.colorRange = src->format == AV_PIX_FMT_YUVJ420P ? AVCOL_RANGE_JPEG : src->color_range;
+    out.colorTrc   = src->color_trc;
+    out.colorPrimaries = src->color_primaries;
+    out.frame      = std::shared_ptr<AVFrame>(ref, [](AVFrame *f) { av_frame_free(&f); });
+    return out;
+}
+
+GLVideoFrame GLVideoFrame::fromImage(const QImage &img)
+{
+    GLVideoFrame out;
+    if (img.isNull()) return out;
+
+    out.layout = Layout::Rgba;
+    out.width  = img.width();
+    out.height = img.height();
+    out.image  = img;
+    return out;
+}
+
+int64_t GLVideoFrame::steadyNowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QImage>
+#include <QMetaType>
+#include <memory>
+#include <cstdint>
+
+// FFmpeg (C library)
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+/// @brief A decoded picture on its way from FrameHandler to OpenGLVideoItem.
+///
+/// Planar YUV frames are carried as a reference to the decoder's AVFrame
+/// (av_frame_clone — no pixel copy); the renderer uploads each plane as its
+/// own texture and converts in the fragment shader.  RGBA frames (VSR output,
+/// pixel formats without a planar shader path) are carried as a QImage.
+/// Cheap to copy; safe to pass through queued connections.
+struct GLVideoFrame
+{
+    enum class Layout : uint8_t {
+        None,
+        Rgba,           ///< image holds RGBA8888
+        Yuv420P,        ///< Y, U, V planes, 8-bit          → 3 × R8
+        Yuv420P10,      ///< Y, U, V planes, 10-bit in LSBs → 3 × R16
+        Nv12,           ///< Y + interleaved UV, 8-bit      → R8 + RG8
+        P010,           ///< Y + interleaved UV, 10-bit MSB → R16 + RG16
+    };
+
+    Layout                   layout     = Layout::None;
+    int                      width      = 0;
+    int                      height     = 0;
+    AVColorSpace             colorSpace = AVCOL_SPC_UNSPECIFIED;
+    AVColorRange             colorRange = AVCOL_RANGE_UNSPECIFIED;
+    AVColorTransferCharacteristic colorTrc = AVCOL_TRC_UNSPECIFIED;
+    AVColorPrimaries         colorPrimaries = AVCOL_PRI_UNSPECIFIED;
+    float                    peakNits   = 0.0f;  ///< HDR source peak to tone map from; 0 for SDR
+    std::shared_ptr<AVFrame> frame;   ///< planar layouts only
+    QImage                   image;   ///< Layout::Rgba only
+    double                   pts         = 0.0;  ///< stream position in seconds
+    int64_t                  presentAtUs = 0;    ///< steadyNowUs() at which to show it
+
+    /// Shader layout for a decoder pixel format, or Layout::None when the
+    /// format must be converted to RGBA on the CPU first.
+    static Layout layoutFor(AVPixelFormat fmt);
+
+    /// Reference (not copy) a planar frame. Returns an invalid frame if the
+    /// pixel format has no planar layout.
+    static GLVideoFrame fromAVFrame(const AVFrame *src);
+
+    static GLVideoFrame fromImage(const QImage &img);
+
+    /// Monotonic clock shared by the producer (presentAtUs) and the item.
+    static int64_t steadyNowUs();
+
+    bool isValid() const { return layout != Layout::None; }
+    /// PQ or HLG transfer — needs tone mapping on an SDR surface.
+    bool isHdr() const { return colorTrc == AVCOL_TRC_SMPTE2084 || colorTrc == AVCOL_TRC_ARIB_STD_B67; }
+    bool isPlanar() const { return layout != Layout::None && layout != Layout::Rgba; }
+};
+
+Q_DECLARE_METATYPE(GLVideoFrame)
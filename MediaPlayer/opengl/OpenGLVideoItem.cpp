@@ -1,212 +1,959 @@
 #include "OpenGLVideoItem.h"
+#include "HdrPeakDetector.h"
+#include "VideoShaderUniforms.h"
 
-#include <QOpenGLFunctions>
-#include <QOpenGLShaderProgram>
-#include <QOpenGLTexture>
-#include <QOpenGLFramebufferObject>
+#include <QQuickWindow>
+#include <QScreen>
+#include <QSGRenderNode>
+#include <QSGRectangleNode>
+#include <QSGImageNode>
+#include <QSGTexture>
+#include <QSGRendererInterface>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QDebug>
+#include <rhi/qrhi.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
 
-class OpenGLVideoRenderer : public QQuickFramebufferObject::Renderer, protected QOpenGLFunctions
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+namespace {
+using Layout = GLVideoFrame::Layout;
+
+constexpr int kStatsWindow = 60;   ///< frames per published stats sample
+
+int planeCount(Layout layout)
+{
+    switch (layout) {
+    case Layout::Yuv420P:
+    case Layout::Yuv420P10: return 3;
+    case Layout::Nv12:
+    case Layout::P010:      return 2;
+    default:                return 0;
+    }
+}
+
+/// QRhi texture format of one plane.
+QRhiTexture::Format planeFormat(Layout layout, int plane)
+{
+    const bool chroma = plane > 0;
+    switch (layout) {
+    case Layout::Yuv420P:   return QRhiTexture::R8;
+    case Layout::Yuv420P10: return QRhiTexture::R16;
+    case Layout::Nv12:      return chroma ? QRhiTexture::RG8 : QRhiTexture::R8;
+    case Layout::P010:      return chroma ? QRhiTexture::RG16 : QRhiTexture::R16;
+    default:                return QRhiTexture::RGBA8;
+    }
+}
+
+bool is16BitLayout(Layout layout)
+{
+    return layout == Layout::Yuv420P10 || layout == Layout::P010;
+}
+
+/// YUV → RGB conversion parameters for the fragment shader:
+///   rgb = matrix * (yuv * sampleScale - offset)
+struct YuvConversion {
+    QMatrix4x4 matrix;
+    QVector3D  offset;
+    float      sampleScale = 1.0f;
+};
+
+YuvConversion yuvConversionFor(const GLVideoFrame &frame)
+{
+    // Luma coefficients (Kr, Kb) of the source matrix.  Untagged content
+    // follows the usual convention: HD and above is BT.709, SD is BT.601.
+    float kr = 0.2126f, kb = 0.0722f;
+    switch (frame.colorSpace) {
+    case AVCOL_SPC_BT709:
+        break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+        kr = 0.2627f; kb = 0.0593f;
+        break;
+    case AVCOL_SPC_BT470BG:
+    case AVCOL_SPC_SMPTE170M:
+        kr = 0.299f;  kb = 0.114f;
+        break;
+    case AVCOL_SPC_SMPTE240M:
+        kr = 0.212f;  kb = 0.087f;
+        break;
+    default:
+        if (frame.height < 720) { kr = 0.299f; kb = 0.114f; }
+        break;
+    }
+    const float kg = 1.0f - kr - kb;
+
+    // Offsets / scales in normalised code values for the source bit depth
+    const int   depth = is16BitLayout(frame.layout) ? 10 : 8;
+    const float maxCode = static_cast<float>((1 << depth) - 1);
+    const float unit    = static_cast<float>(1 << (depth - 8));
+
+    float yOff, cOff, yScale, cScale;
+    if (frame.colorRange == AVCOL_RANGE_JPEG) {
+        yOff = 0.0f;
+        cOff = static_cast<float>(1 << (depth - 1)) / maxCode;
+        yScale = cScale = 1.0f;
+    } else {
+        yOff   = 16.0f * unit / maxCode;
+        cOff   = 128.0f * unit / maxCode;
+        yScale = maxCode / (219.0f * unit);
+        cScale = maxCode / (224.0f * unit);
+    }
+
+    YuvConversion conv;
+    conv.matrix = QMatrix4x4(
+        yScale, 0.0f,                                   2.0f * (1.0f - kr) * cScale,            0.0f,
+        yScale, -2.0f * kb * (1.0f - kb) / kg * cScale, -2.0f * kr * (1.0f - kr) / kg * cScale, 0.0f,
+        yScale, 2.0f * (1.0f - kb) * cScale,            0.0f,                                   0.0f,
+        0.0f,   0.0f,                                   0.0f,                                   1.0f);
+    conv.offset = QVector3D(yOff, cOff, cOff);
+
+    // Normalised texture samples → normalised code values
+    switch (frame.layout) {
+    case Layout::P010:      conv.sampleScale = 65535.0f / (64.0f * 1023.0f); break;  // 10 bits in MSBs
+    case Layout::Yuv420P10: conv.sampleScale = 65535.0f / 1023.0f;           break;  // 10 bits in LSBs
+    default:                conv.sampleScale = 1.0f;                         break;
+    }
+    return conv;
+}
+
+/// CPU conversion to RGBA for frames the GPU path cannot take (missing
+/// texture formats, negative strides, the software scene graph).
+QImage convertToImage(const GLVideoFrame &frame, SwsContext *&sws, QImage &scratch)
+{
+    if (frame.layout == Layout::Rgba)
+        return frame.image;
+    if (!frame.frame)
+        return {};
+
+    const AVFrame *av = frame.frame.get();
+    sws = sws_getCachedContext(sws,
+                               av->width, av->height,
+                               static_cast<AVPixelFormat>(av->format),
+                               av->width, av->height, AV_PIX_FMT_RGBA,
+                               SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!sws) return {};
+
+    if (scratch.width() != av->width || scratch.height() != av->height)
+        scratch = QImage(av->width, av->height, QImage::Format_RGBA8888);
+
+    uint8_t *dstData[4]     = { scratch.bits(), nullptr, nullptr, nullptr };
+    int      dstLinesize[4] = { static_cast<int>(scratch.bytesPerLine()), 0, 0, 0 };
+    sws_scale(sws, av->data, av->linesize, 0, av->height, dstData, dstLinesize);
+    return scratch;
+}
+
+QShader loadShader(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "OpenGLVideoItem: cannot open shader" << path;
+        return {};
+    }
+    return QShader::fromSerialized(f.readAll());
+}
+
+int64_t steadyNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+}
+
+/// Scene graph node that draws the video with QRhi, so it runs on whatever
+/// backend the scene graph picked (OpenGL, Vulkan, Direct3D, Metal, or a
+/// software adapter such as WARP / llvmpipe).  Owned by the scene graph,
+/// lives on the render thread; OpenGLVideoItem feeds it from
+/// updatePaintNode().
+class VideoRenderNode : public QSGRenderNode
 {
 public:
-    OpenGLVideoRenderer()
+    explicit VideoRenderNode(QQuickWindow *window)
+        : m_window(window)
     {
-        initializeOpenGLFunctions();
-        initProgram();
     }
 
-    ~OpenGLVideoRenderer() override
+    ~VideoRenderNode() override
     {
-        delete m_texture;
-        delete m_program;
+        releaseResources();
+        if (m_fallbackSws)
+            sws_freeContext(m_fallbackSws);
     }
 
-    QOpenGLFramebufferObject *createFramebufferObject(const QSize &size) override
+    void setFrame(const GLVideoFrame &frame)
     {
-        QOpenGLFramebufferObjectFormat format;
-        format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-        format.setSamples(0);
-        return new QOpenGLFramebufferObject(size, format);
+        m_pendingFrame = frame;
+        m_hasNewFrame = true;
     }
 
-    void synchronize(QQuickFramebufferObject *item) override
+    /// @param videoRect  target rectangle in item coordinates (letterboxed)
+    void setGeometry(const QRectF &videoRect, bool flipX, bool flipY)
     {
-        auto *videoItem = static_cast<OpenGLVideoItem *>(item);
-        QImage frame;
-        bool flipX = false;
-        bool flipY = false;
-        bool preserveAspectRatio = true;
-        if (videoItem->takePendingFrame(frame)) {
-            m_pendingFrame = frame.convertToFormat(QImage::Format_RGBA8888);
-            m_hasNewFrame = true;
-        }
-        videoItem->queryRenderOptions(flipX, flipY, preserveAspectRatio);
+        if (videoRect == m_rect && flipX == m_flipX && flipY == m_flipY)
+            return;
+        m_rect  = videoRect;
         m_flipX = flipX;
         m_flipY = flipY;
-        m_preserveAspectRatio = preserveAspectRatio;
+
+        // Flip lives in the texture coordinates, aspect in the positions.
+        const float x0 = float(videoRect.left()),  x1 = float(videoRect.right());
+        const float y0 = float(videoRect.top()),   y1 = float(videoRect.bottom());
+        const float u0 = flipX ? 1.0f : 0.0f,      u1 = 1.0f - u0;
+        const float v0 = flipY ? 1.0f : 0.0f,      v1 = 1.0f - v0;
+        const float vertices[16] = {
+            x0, y0, u0, v0,
+            x0, y1, u0, v1,
+            x1, y0, u1, v0,
+            x1, y1, u1, v1,
+        };
+        std::copy(std::begin(vertices), std::end(vertices), m_vertices);
+        m_geometryDirty = true;
+    }
+
+    void setScaleFilter(SwsFilterMode mode) { m_filterMode = shaderFilterMode(mode); }
+    void setToneMapper(ToneMapper mapper) { m_toneMapper = mapper; }
+
+    /// Stats accumulated since the last call, if a window completed.
+    bool takeStats(OpenGLVideoItem::RenderStats &out)
+    {
+        if (!m_statsReady) return false;
+        out = m_publishedStats;
+        m_statsReady = false;
+        return true;
     }
 
-    void render() override
+    QRectF rect() const override { return m_rect; }
+
+    RenderingFlags flags() const override
     {
-        const QSize viewport = framebufferObject()->size();
-        glViewport(0, 0, viewport.width(), viewport.height());
-        glDisable(GL_DEPTH_TEST);
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        return BoundedRectRendering | OpaqueRendering;
+    }
 
+    StateFlags changedStates() const override
+    {
+        return ViewportState | ScissorState;
+    }
+
+    void prepare() override
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QRhi *rhi = m_window->rhi();
+        if (!rhi) return;
+        if (!m_capsKnown)
+            detectCapabilities(rhi);
+
+        QRhiResourceUpdateBatch *u = rhi->nextResourceUpdateBatch();
+
+        qint64 uploadNs = 0;
         if (m_hasNewFrame) {
-            updateTexture();
+            QElapsedTimer uploadTimer;
+            uploadTimer.start();
+            uploadFrame(rhi, u);
+            uploadNs = uploadTimer.nsecsElapsed();
             m_hasNewFrame = false;
         }
 
-        if (!m_texture || !m_program || !m_program->isLinked()) {
-            update();
+        if (m_layout == Layout::None || !ensureBuffers(rhi)) {
+            u->release();
             return;
         }
 
-        GLfloat sx = 1.0f;
-        GLfloat sy = 1.0f;
-        if (m_preserveAspectRatio && m_texWidth > 0 && m_texHeight > 0 && viewport.height() > 0) {
-            const float videoAspect = static_cast<float>(m_texWidth) / static_cast<float>(m_texHeight);
-            const float viewAspect = static_cast<float>(viewport.width()) / static_cast<float>(viewport.height());
-            if (viewAspect > videoAspect) {
-                sx = videoAspect / viewAspect;
-            } else {
-                sy = viewAspect / videoAspect;
-            }
+        if (m_geometryDirty) {
+            u->updateDynamicBuffer(m_vbuf.get(), 0, sizeof(m_vertices), m_vertices);
+            m_geometryDirty = false;
         }
 
-        const GLfloat vertices[] = {
-            -sx, -sy,
-             sx, -sy,
-            -sx,  sy,
-             sx,  sy
-        };
+        if (m_srbDirty && !rebuildBindings(rhi)) {
+            u->release();
+            return;
+        }
+        ensurePipeline(rhi);
 
-        static const GLfloat texCoords[] = {
-            0.0f, 0.0f,
-            1.0f, 0.0f,
-            0.0f, 1.0f,
-            1.0f, 1.0f
-        };
+        // Bicubic and Lanczos scale in two separable passes: horizontally
+        // into an intermediate target of (output width × source height),
+        // then vertically in render().  Without the target they fall back
+        // to the bilinear sampler.
+        const QSize outputSize = (matrix()->mapRect(m_rect).size()
+                                  * m_window->effectiveDevicePixelRatio()).toSize();
+        const bool kernelFilter = m_filterMode >= 2;
+        m_twoPass = kernelFilter
+                 && prepareScalePass(rhi, u, QSize(outputSize.width(), m_textures[0]->pixelSize().height()));
 
-        m_program->bind();
-        m_texture->bind(0);
-        m_program->setUniformValue("uTexture", 0);
-        m_program->setUniformValue("uFlipX", m_flipX ? 1 : 0);
-        m_program->setUniformValue("uFlipY", m_flipY ? 1 : 0);
+        VideoUniforms uniforms{};
+        const QMatrix4x4 mvp = *projectionMatrix() * *matrix();
+        std::memcpy(uniforms.mvp, mvp.constData(), sizeof(uniforms.mvp));
+        std::memcpy(uniforms.yuvMatrix, m_conversion.matrix.constData(), sizeof(uniforms.yuvMatrix));
+        uniforms.yuvOffset[0] = m_conversion.offset.x();
+        uniforms.yuvOffset[1] = m_conversion.offset.y();
+        uniforms.yuvOffset[2] = m_conversion.offset.z();
+        uniforms.sampleScale  = m_conversion.sampleScale;
+        uniforms.layoutMode   = m_layout == Layout::Rgba ? 0 : (planeCount(m_layout) == 3 ? 1 : 2);
+        uniforms.filterMode   = kernelFilter && !m_twoPass ? 1 : m_filterMode;
+        uniforms.transferMode = m_toneMapper == ToneMapper::Off ? 0 : m_transferMode;
+        uniforms.toneMapper   = static_cast<int32_t>(m_toneMapper);
+        uniforms.gamutMode    = m_gamutMode;
+        uniforms.srcPeak      = m_srcPeak;
+        uniforms.scalePass    = m_twoPass ? 2 : 0;
+        uniforms.dstExtent    = float(outputSize.height());
+        u->updateDynamicBuffer(m_ubuf.get(), 0, sizeof(uniforms), &uniforms);
 
-        m_program->enableAttributeArray(0);
-        m_program->enableAttributeArray(1);
-        m_program->setAttributeArray(0, GL_FLOAT, vertices, 2);
-        m_program->setAttributeArray(1, GL_FLOAT, texCoords, 2);
+        QRhiCommandBuffer *cb = commandBuffer();
+        if (m_twoPass) {
+            // Full-target quad in clip space; the vertical pass reads the
+            // result through the screen uniforms above.
+            VideoUniforms horizontal = uniforms;
+            const QMatrix4x4 clip = rhi->clipSpaceCorrMatrix();
+            std::memcpy(horizontal.mvp, clip.constData(), sizeof(horizontal.mvp));
+            horizontal.scalePass = 1;
+            horizontal.dstExtent = float(outputSize.width());
+            u->updateDynamicBuffer(m_scaleUbuf.get(), 0, sizeof(horizontal), &horizontal);
 
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            const QSize size = m_scaleTexture->pixelSize();
+            cb->beginPass(m_scaleTarget.get(), Qt::black, { 1.0f, 0 }, u);
+            cb->setGraphicsPipeline(m_scalePipeline.get());
+            cb->setViewport(QRhiViewport(0, 0, size.width(), size.height()));
+            cb->setShaderResources(m_scaleSourceSrb.get());
+            const QRhiCommandBuffer::VertexInput input(m_scaleVbuf.get(), 0);
+            cb->setVertexInput(0, 1, &input);
+            cb->draw(4);
+            cb->endPass();
+        } else {
+            cb->resourceUpdate(u);
+        }
 
-        m_program->disableAttributeArray(0);
-        m_program->disableAttributeArray(1);
-        m_texture->release();
-        m_program->release();
+        m_prepareNs = timer.nsecsElapsed();
+        m_uploadNs  = uploadNs;
+    }
 
-        update();
+    void render(const RenderState *state) override
+    {
+        // A failed rebuildBindings() leaves no SRB, or one that still
+        // references textures freed since; draw nothing until it succeeds.
+        if (!m_pipeline || !m_srb || m_srbDirty || m_rect.isEmpty())
+            return;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QRhiCommandBuffer *cb = commandBuffer();
+        cb->setGraphicsPipeline(m_pipeline.get());
+
+        const QSize size = renderTarget()->pixelSize();
+        cb->setViewport(QRhiViewport(0, 0, size.width(), size.height()));
+        if (state->scissorEnabled()) {
+            const QRect r = state->scissorRect();
+            cb->setScissor(QRhiScissor(r.x(), r.y(), r.width(), r.height()));
+        } else {
+            cb->setScissor(QRhiScissor(0, 0, size.width(), size.height()));
+        }
+
+        cb->setShaderResources(m_twoPass ? m_scaleSrb.get() : m_srb.get());
+        const QRhiCommandBuffer::VertexInput input(m_vbuf.get(), 0);
+        cb->setVertexInput(0, 1, &input);
+        cb->draw(4);
+
+        recordFrameTiming(m_prepareNs + timer.nsecsElapsed(), m_uploadNs,
+                          cb->lastCompletedGpuTime());
+    }
+
+    void releaseResources() override
+    {
+        releaseScalePass();
+        m_pipeline.reset();
+        m_srb.reset();
+        m_sampler.reset();
+        m_ubuf.reset();
+        m_vbuf.reset();
+        for (auto &tex : m_textures)
+            tex.reset();
+        m_rpDesc = nullptr;
+        m_layout = Layout::None;
+        m_geometryDirty = true;
+        m_srbDirty = true;
+        if (m_currentFrame.isValid() && !m_pendingFrame.isValid()) {
+            // Re-upload the last picture once resources come back
+            m_pendingFrame = m_currentFrame;
+            m_hasNewFrame = true;
+        }
     }
 
 private:
-    void initProgram()
+    void detectCapabilities(QRhi *rhi)
     {
-        m_program = new QOpenGLShaderProgram();
-
-        static const char *vs = R"(
-            attribute vec2 aPos;
-            attribute vec2 aTex;
-            varying vec2 vTex;
-            void main() {
-                gl_Position = vec4(aPos, 0.0, 1.0);
-                vTex = aTex;
-            }
-        )";
-
-        static const char *fs = R"(
-            varying mediump vec2 vTex;
-            uniform sampler2D uTexture;
-            uniform int uFlipX;
-            uniform int uFlipY;
-            void main() {
-                mediump vec2 uv = vTex;
-                if (uFlipX == 1) uv.x = 1.0 - uv.x;
-                if (uFlipY == 1) uv.y = 1.0 - uv.y;
-                gl_FragColor = texture2D(uTexture, uv);
+        m_planarSupported = rhi->isTextureFormatSupported(QRhiTexture::R8)
+                         && rhi->isTextureFormatSupported(QRhiTexture::RG8);
+        m_norm16Supported = m_planarSupported
+                         && rhi->isTextureFormatSupported(QRhiTexture::R16)
+                         && rhi->isTextureFormatSupported(QRhiTexture::RG16);
+        m_halfFloatTargets = rhi->isTextureFormatSupported(QRhiTexture::RGBA16F);
+        m_capsKnown = true;
+
+        qDebug() << "OpenGLVideoItem: QRhi backend" << rhi->backendName()
+                 << "| planar:" << m_planarSupported << "| 16-bit:" << m_norm16Supported
+                 << "| fp16 targets:" << m_halfFloatTargets;
+        if (!m_planarSupported)
+            qDebug() << "OpenGLVideoItem: R8/RG8 textures unavailable, converting YUV on the CPU";
+    }
+
+    /// (Re)create a texture when its size or format changes.
+    QRhiTexture *ensureTexture(QRhi *rhi, int index, QRhiTexture::Format format, const QSize &size)
+    {
+        std::unique_ptr<QRhiTexture> &tex = m_textures[index];
+        if (tex && tex->format() == format && tex->pixelSize() == size)
+            return tex.get();
+
+        // The bindings point at the old texture from here on.
+        m_srbDirty = true;
+        tex.reset(rhi->newTexture(format, size));
+        if (!tex->create()) {
+            qWarning() << "OpenGLVideoItem: texture create failed" << size;
+            tex.reset();
+            return nullptr;
+        }
+        return tex.get();
+    }
+
+    void uploadFrame(QRhi *rhi, QRhiResourceUpdateBatch *u)
+    {
+        if (!m_pendingFrame.isValid()) return;
+
+        bool positiveStrides = true;
+        if (const AVFrame *av = m_pendingFrame.frame.get()) {
+            for (int i = 0; i < planeCount(m_pendingFrame.layout); ++i)
+                positiveStrides &= av->linesize[i] > 0;
+        }
+        const bool canUploadPlanar = m_pendingFrame.isPlanar() && m_planarSupported && positiveStrides
+            && (!is16BitLayout(m_pendingFrame.layout) || m_norm16Supported);
+
+        if (canUploadPlanar)
+            uploadPlanes(rhi, u, m_pendingFrame);
+        else
+            uploadRgba(rhi, u, convertToImage(m_pendingFrame, m_fallbackSws, m_fallbackImage));
+
+        // Keep the AVFrame until the next upload: uploadPlanes() hands the
+        // batch raw-data views of its planes, read when the batch executes
+        // later in this frame.
+        m_currentFrame = std::move(m_pendingFrame);
+        m_pendingFrame = GLVideoFrame();
+    }
+
+    void uploadRgba(QRhi *rhi, QRhiResourceUpdateBatch *u, const QImage &source)
+    {
+        if (source.isNull()) return;
+
+        const QImage image = source.format() == QImage::Format_RGBA8888
+                                 ? source
+                                 : source.convertToFormat(QImage::Format_RGBA8888);
+
+        QRhiTexture *tex = ensureTexture(rhi, 0, QRhiTexture::RGBA8, image.size());
+        if (!tex) return;
+        u->uploadTexture(tex, image);
+
+        m_layout = Layout::Rgba;
+        m_transferMode = 0;
+    }
+
+    void uploadPlanes(QRhi *rhi, QRhiResourceUpdateBatch *u, const GLVideoFrame &frame)
+    {
+        const AVFrame *av = frame.frame.get();
+        const int planes = planeCount(frame.layout);
+        const QSize lumaSize(frame.width, frame.height);
+        const QSize chromaSize((frame.width + 1) / 2, (frame.height + 1) / 2);
+
+        for (int i = 0; i < planes; ++i) {
+            const QSize size = i == 0 ? lumaSize : chromaSize;
+            QRhiTexture *tex = ensureTexture(rhi, i, planeFormat(frame.layout, i), size);
+            if (!tex) {
+                m_layout = Layout::None;
+                return;
             }
-        )";
 
-        if (!m_program->addShaderFromSourceCode(QOpenGLShader::Vertex, vs)) {
-            qWarning() << "OpenGLVideoItem vertex shader compile failed:" << m_program->log();
+            // fromRawData: the batch references the decoder's plane instead
+            // of deep-copying it (the const void * constructor copies).
+            const QByteArray plane = QByteArray::fromRawData(
+                reinterpret_cast<const char *>(av->data[i]),
+                static_cast<qsizetype>(av->linesize[i]) * size.height());
+            QRhiTextureSubresourceUploadDescription sub(plane);
+            sub.setDataStride(static_cast<quint32>(av->linesize[i]));
+            u->uploadTexture(tex, QRhiTextureUploadDescription(QRhiTextureUploadEntry(0, 0, sub)));
+        }
+
+        m_layout     = frame.layout;
+        m_conversion = yuvConversionFor(frame);
+
+        // PQ / HLG are linearised, mapped to the SDR range and re-encoded in
+        // the shader; the peak comes from FrameHandler's detector.
+        m_transferMode = frame.colorTrc == AVCOL_TRC_SMPTE2084    ? 1
+                       : frame.colorTrc == AVCOL_TRC_ARIB_STD_B67 ? 2 : 0;
+        m_gamutMode    = frame.colorPrimaries == AVCOL_PRI_BT2020 ? 1 : 0;
+        m_srcPeak      = (frame.peakNits > 0.0f ? frame.peakNits : 1000.0f) / HdrPeakDetector::kSdrWhiteNits;
+    }
+
+    bool ensureBuffers(QRhi *rhi)
+    {
+        if (!m_vbuf) {
+            m_vbuf.reset(rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::VertexBuffer, sizeof(m_vertices)));
+            if (!m_vbuf->create()) { m_vbuf.reset(); return false; }
+            m_geometryDirty = true;
         }
-        if (!m_program->addShaderFromSourceCode(QOpenGLShader::Fragment, fs)) {
-            qWarning() << "OpenGLVideoItem fragment shader compile failed:" << m_program->log();
+        if (!m_ubuf) {
+            m_ubuf.reset(rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(VideoUniforms)));
+            if (!m_ubuf->create()) { m_ubuf.reset(); return false; }
         }
-        m_program->bindAttributeLocation("aPos", 0);
-        m_program->bindAttributeLocation("aTex", 1);
-        if (!m_program->link()) {
-            qWarning() << "OpenGLVideoItem shader link failed:" << m_program->log();
+        if (!m_sampler) {
+            m_sampler.reset(rhi->newSampler(QRhiSampler::Linear, QRhiSampler::Linear, QRhiSampler::None,
+                                            QRhiSampler::ClampToEdge, QRhiSampler::ClampToEdge));
+            if (!m_sampler->create()) { m_sampler.reset(); return false; }
         }
+        return true;
     }
 
-    void updateTexture()
+    /// Bindings of video.frag: @p ubuf and the three samplers.  All
+    /// results are layout-compatible, so any pipeline accepts them.
+    std::unique_ptr<QRhiShaderResourceBindings> makeBindings(QRhi *rhi, QRhiBuffer *ubuf, QRhiTexture *y,
+                                                             QRhiTexture *uTex, QRhiTexture *vTex)
     {
-        if (m_pendingFrame.isNull()) return;
-
-        if (!m_texture || m_texWidth != m_pendingFrame.width() || m_texHeight != m_pendingFrame.height()) {
-            delete m_texture;
-            m_texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
-            m_texture->create();
-            m_texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
-            m_texture->setWrapMode(QOpenGLTexture::ClampToEdge);
-            m_texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
-            m_texture->setSize(m_pendingFrame.width(), m_pendingFrame.height());
-            m_texture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
-            m_texWidth = m_pendingFrame.width();
-            m_texHeight = m_pendingFrame.height();
+        const auto stages = QRhiShaderResourceBinding::VertexStage | QRhiShaderResourceBinding::FragmentStage;
+        const auto frag   = QRhiShaderResourceBinding::FragmentStage;
+        std::unique_ptr<QRhiShaderResourceBindings> srb(rhi->newShaderResourceBindings());
+        srb->setBindings({
+            QRhiShaderResourceBinding::uniformBuffer(0, stages, ubuf),
+            QRhiShaderResourceBinding::sampledTexture(1, frag, y, m_sampler.get()),
+            QRhiShaderResourceBinding::sampledTexture(2, frag, uTex, m_sampler.get()),
+            QRhiShaderResourceBinding::sampledTexture(3, frag, vTex, m_sampler.get()),
+        });
+        if (!srb->create()) {
+            qWarning() << "OpenGLVideoItem: shader resource bindings create failed";
+            return nullptr;
         }
+        return srb;
+    }
+
+    /// Samplers the current layout does not use are bound to plane 0; the
+    /// shader never reads them but every binding must be valid.
+    bool rebuildBindings(QRhi *rhi)
+    {
+        QRhiTexture *y = m_textures[0].get();
+        if (!y) return false;
+        const int planes = planeCount(m_layout);
+        QRhiTexture *uTex = planes >= 2 && m_textures[1] ? m_textures[1].get() : y;
+        QRhiTexture *vTex = planes == 3 && m_textures[2] ? m_textures[2].get() : y;
 
-        m_texture->setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, m_pendingFrame.constBits());
+        std::unique_ptr<QRhiShaderResourceBindings> srb = makeBindings(rhi, m_ubuf.get(), y, uTex, vTex);
+        if (!srb) return false;
+        // Layout-compatible with the previous one, so the pipeline stays valid.
+        m_srb = std::move(srb);
+        m_srbDirty = false;
+        // The horizontal pass samples the same planes.
+        m_scaleSourceSrb.reset();
+        return true;
+    }
+
+    void ensurePipeline(QRhi *rhi)
+    {
+        QRhiRenderPassDescriptor *rpDesc = renderTarget()->renderPassDescriptor();
+        if (m_pipeline && m_rpDesc == rpDesc)
+            return;
+
+        if (auto ps = makePipeline(rhi, rpDesc, renderTarget()->sampleCount(), true)) {
+            m_pipeline = std::move(ps);
+            m_rpDesc = rpDesc;
+        }
+    }
+
+    std::unique_ptr<QRhiGraphicsPipeline> makePipeline(QRhi *rhi, QRhiRenderPassDescriptor *rpDesc,
+                                                       int sampleCount, bool scissor)
+    {
+        static const QShader vs = loadShader(QStringLiteral(":/shaders/video.vert.qsb"));
+        static const QShader fs = loadShader(QStringLiteral(":/shaders/video.frag.qsb"));
+        if (!vs.isValid() || !fs.isValid())
+            return nullptr;
+
+        std::unique_ptr<QRhiGraphicsPipeline> ps(rhi->newGraphicsPipeline());
+        ps->setTopology(QRhiGraphicsPipeline::TriangleStrip);
+        if (scissor)
+            ps->setFlags(QRhiGraphicsPipeline::UsesScissor);
+        ps->setSampleCount(sampleCount);
+        ps->setShaderStages({
+            { QRhiShaderStage::Vertex, vs },
+            { QRhiShaderStage::Fragment, fs },
+        });
+
+        QRhiVertexInputLayout inputLayout;
+        inputLayout.setBindings({ { 4 * sizeof(float) } });
+        inputLayout.setAttributes({
+            { 0, 0, QRhiVertexInputAttribute::Float2, 0 },
+            { 0, 1, QRhiVertexInputAttribute::Float2, 2 * sizeof(float) },
+        });
+        ps->setVertexInputLayout(inputLayout);
+        ps->setShaderResourceBindings(m_srb.get());
+        ps->setRenderPassDescriptor(rpDesc);
+
+        if (!ps->create()) {
+            qWarning() << "OpenGLVideoItem: graphics pipeline create failed";
+            return nullptr;
+        }
+        return ps;
+    }
+
+    /// Intermediate target, quad, uniforms, bindings and pipeline of the
+    /// horizontal kernel pass.  @p size is (output width × source height).
+    /// False leaves the frame to the single bilinear pass.
+    bool prepareScalePass(QRhi *rhi, QRhiResourceUpdateBatch *u, const QSize &size)
+    {
+        if (size.isEmpty())
+            return false;
+
+        if (size != m_scaleSize) {
+            // Tried once per size, so a failing backend does not warn every frame
+            m_scaleSize = size;
+            m_scalePipeline.reset();
+            m_scaleSrb.reset();
+            m_scaleTarget.reset();
+            m_scaleRpDesc.reset();
+            m_scaleTexture.reset();
+
+            // Half float keeps the unclamped kernel overshoot and HDR signal
+            // precision until the vertical pass.
+            const auto format = m_halfFloatTargets ? QRhiTexture::RGBA16F : QRhiTexture::RGBA8;
+            std::unique_ptr<QRhiTexture> tex(rhi->newTexture(format, size, 1, QRhiTexture::RenderTarget));
+            if (!tex->create()) {
+                qWarning() << "OpenGLVideoItem: scaling target create failed" << size;
+                return false;
+            }
+            std::unique_ptr<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget({ tex.get() }));
+            std::unique_ptr<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+            rt->setRenderPassDescriptor(rpDesc.get());
+            if (!rt->create()) {
+                qWarning() << "OpenGLVideoItem: scaling render target create failed" << size;
+                return false;
+            }
+            m_scaleTexture = std::move(tex);
+            m_scaleRpDesc  = std::move(rpDesc);
+            m_scaleTarget  = std::move(rt);
+        }
+        if (!m_scaleTarget)
+            return false;
+
+        if (!m_scaleVbuf) {
+            // Texture coordinates follow the framebuffer's y direction, so
+            // the vertical pass reads the target top row first everywhere.
+            const float top = rhi->isYUpInFramebuffer() ? 1.0f : 0.0f;
+            const float bottom = 1.0f - top;
+            const float quad[16] = {
+                -1.0f,  1.0f, 0.0f, top,
+                -1.0f, -1.0f, 0.0f, bottom,
+                 1.0f,  1.0f, 1.0f, top,
+                 1.0f, -1.0f, 1.0f, bottom,
+            };
+            m_scaleVbuf.reset(rhi->newBuffer(QRhiBuffer::Immutable, QRhiBuffer::VertexBuffer, sizeof(quad)));
+            if (!m_scaleVbuf->create()) { m_scaleVbuf.reset(); return false; }
+            u->uploadStaticBuffer(m_scaleVbuf.get(), quad);
+        }
+        if (!m_scaleUbuf) {
+            m_scaleUbuf.reset(rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(VideoUniforms)));
+            if (!m_scaleUbuf->create()) { m_scaleUbuf.reset(); return false; }
+        }
+
+        if (!m_scaleSourceSrb) {
+            QRhiTexture *y = m_textures[0].get();
+            const int planes = planeCount(m_layout);
+            QRhiTexture *uTex = planes >= 2 && m_textures[1] ? m_textures[1].get() : y;
+            QRhiTexture *vTex = planes == 3 && m_textures[2] ? m_textures[2].get() : y;
+            m_scaleSourceSrb = makeBindings(rhi, m_scaleUbuf.get(), y, uTex, vTex);
+            if (!m_scaleSourceSrb) return false;
+        }
+        if (!m_scaleSrb) {
+            QRhiTexture *tex = m_scaleTexture.get();
+            m_scaleSrb = makeBindings(rhi, m_ubuf.get(), tex, tex, tex);
+            if (!m_scaleSrb) return false;
+        }
+        if (!m_scalePipeline) {
+            m_scalePipeline = makePipeline(rhi, m_scaleRpDesc.get(), 1, false);
+            if (!m_scalePipeline) return false;
+        }
+        return true;
+    }
+
+    void releaseScalePass()
+    {
+        m_scalePipeline.reset();
+        m_scaleSrb.reset();
+        m_scaleSourceSrb.reset();
+        m_scaleUbuf.reset();
+        m_scaleVbuf.reset();
+        m_scaleTarget.reset();
+        m_scaleRpDesc.reset();
+        m_scaleTexture.reset();
+        m_scaleSize = QSize();
+        m_twoPass = false;
+    }
+
+    void recordFrameTiming(qint64 nodeNs, qint64 uploadNs, double gpuSeconds)
+    {
+        m_windowNodeNs += nodeNs;
+        m_windowUploadNs += uploadNs;
+        m_windowMaxNodeNs = std::max(m_windowMaxNodeNs, nodeNs);
+        m_windowGpuSeconds += gpuSeconds;
+        if (++m_windowFrames < kStatsWindow) return;
+
+        OpenGLVideoItem::RenderStats &st = m_publishedStats;
+        st.backend      = QString::fromLatin1(m_window->rhi()->backendName());
+        st.nodeMsAvg    = m_windowNodeNs / 1e6 / m_windowFrames;
+        st.nodeMsMax    = m_windowMaxNodeNs / 1e6;
+        st.uploadMsAvg  = m_windowUploadNs / 1e6 / m_windowFrames;
+        st.gpuMsAvg     = m_windowGpuSeconds * 1e3 / m_windowFrames;
+        m_statsReady    = true;
+
+        m_windowFrames = 0;
+        m_windowNodeNs = 0;
+        m_windowUploadNs = 0;
+        m_windowMaxNodeNs = 0;
+        m_windowGpuSeconds = 0.0;
     }
 
 private:
-    QOpenGLShaderProgram *m_program = nullptr;
-    QOpenGLTexture *m_texture = nullptr;
-    QImage m_pendingFrame;
+    QQuickWindow *m_window = nullptr;
+
+    std::unique_ptr<QRhiTexture> m_textures[3];    ///< RGBA in [0], or the YUV planes
+    std::unique_ptr<QRhiSampler> m_sampler;
+    std::unique_ptr<QRhiBuffer>  m_vbuf;
+    std::unique_ptr<QRhiBuffer>  m_ubuf;
+    std::unique_ptr<QRhiShaderResourceBindings> m_srb;
+    std::unique_ptr<QRhiGraphicsPipeline>       m_pipeline;
+    QRhiRenderPassDescriptor *m_rpDesc = nullptr;  ///< the pipeline was built against this
+    bool m_srbDirty = true;
+
+    // ── Two-pass kernel scaling (bicubic / Lanczos) ──
+    std::unique_ptr<QRhiTexture>                m_scaleTexture;    ///< horizontally scaled RGB
+    std::unique_ptr<QRhiRenderPassDescriptor>   m_scaleRpDesc;
+    std::unique_ptr<QRhiTextureRenderTarget>    m_scaleTarget;
+    std::unique_ptr<QRhiBuffer>                 m_scaleVbuf;       ///< full-target quad
+    std::unique_ptr<QRhiBuffer>                 m_scaleUbuf;       ///< horizontal pass uniforms
+    std::unique_ptr<QRhiShaderResourceBindings> m_scaleSourceSrb;  ///< horizontal pass: the planes
+    std::unique_ptr<QRhiShaderResourceBindings> m_scaleSrb;        ///< vertical pass: m_scaleTexture
+    std::unique_ptr<QRhiGraphicsPipeline>       m_scalePipeline;   ///< horizontal pass
+    QSize m_scaleSize;                             ///< m_scaleTexture was created (or tried) at this size
+    bool m_twoPass = false;                        ///< this frame draws through m_scaleTexture
+
+    Layout m_layout = Layout::None;                ///< layout of the uploaded textures
+    YuvConversion m_conversion;
+    GLVideoFrame m_pendingFrame;
+    GLVideoFrame m_currentFrame;
     bool m_hasNewFrame = false;
-    int m_texWidth = 0;
-    int m_texHeight = 0;
+    bool m_capsKnown = false;
+    bool m_planarSupported = false;
+    bool m_norm16Supported = false;
+    bool m_halfFloatTargets = false;
+    SwsContext *m_fallbackSws = nullptr;
+    QImage m_fallbackImage;
+
+    int32_t m_filterMode = 1;
+    ToneMapper m_toneMapper = ToneMapper::Bt2390;
+    int32_t m_transferMode = 0;
+    int32_t m_gamutMode = 0;
+    float m_srcPeak = 1.0f;
+
+    float m_vertices[16] = {};
+    bool m_geometryDirty = true;
+    QRectF m_rect;
     bool m_flipX = false;
     bool m_flipY = false;
-    bool m_preserveAspectRatio = true;
+
+    // Render-thread timing, accumulated over kStatsWindow frames
+    qint64 m_prepareNs = 0;
+    qint64 m_uploadNs = 0;
+    int m_windowFrames = 0;
+    qint64 m_windowNodeNs = 0;
+    qint64 m_windowUploadNs = 0;
+    qint64 m_windowMaxNodeNs = 0;
+    double m_windowGpuSeconds = 0.0;
+    OpenGLVideoItem::RenderStats m_publishedStats;
+    bool m_statsReady = false;
 };
 
 OpenGLVideoItem::OpenGLVideoItem(QQuickItem *parent)
-    : QQuickFramebufferObject(parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+OpenGLVideoItem::~OpenGLVideoItem()
 {
+    if (m_softwareSws)
+        sws_freeContext(m_softwareSws);
+}
+
+QSGNode *OpenGLVideoItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    // Runs on the render thread with the GUI thread blocked.
+    QQuickWindow *win = window();
+    const bool software = win->rendererInterface()->graphicsApi() == QSGRendererInterface::Software;
+
+    auto *background = static_cast<QSGRectangleNode *>(oldNode);
+    if (!background) {
+        background = win->createRectangleNode();
+        background->setColor(Qt::black);
+        if (software)
+            background->appendChildNode(win->createImageNode());
+        else
+            background->appendChildNode(new VideoRenderNode(win));
+    }
+    background->setRect(boundingRect());
+
+    GLVideoFrame frame;
+    const bool hasFrame = takePendingFrame(frame);
+    if (hasFrame)
+        m_frameSize = QSize(frame.width, frame.height);
+
+    bool flipX = false;
+    bool flipY = false;
+    bool preserveAspectRatio = true;
+    queryRenderOptions(flipX, flipY, preserveAspectRatio);
+
+    QRectF videoRect = boundingRect();
+    if (preserveAspectRatio && !m_frameSize.isEmpty()) {
+        const QSizeF fitted = QSizeF(m_frameSize).scaled(videoRect.size(), Qt::KeepAspectRatio);
+        videoRect = QRectF(QPointF(videoRect.x() + (videoRect.width() - fitted.width()) / 2.0,
+                                   videoRect.y() + (videoRect.height() - fitted.height()) / 2.0),
+                           fitted);
+    }
+
+    if (software) {
+        // The software scene graph has no QRhi: convert on the CPU and let
+        // it blit the image.
+        auto *image = static_cast<QSGImageNode *>(background->firstChild());
+        if (hasFrame) {
+            const QImage rgba = convertToImage(frame, m_softwareSws, m_softwareImage);
+            if (!rgba.isNull()) {
+                image->setTexture(win->createTextureFromImage(rgba));
+                image->setOwnsTexture(true);
+            }
+        }
+        image->setRect(image->texture() ? videoRect : QRectF());
+        image->setFiltering(scaleFilter() == SwsFilterMode::Point ? QSGTexture::Nearest
+                                                                 : QSGTexture::Linear);
+        image->setTextureCoordinatesTransform(
+            (flipX ? QSGImageNode::MirrorHorizontally : QSGImageNode::NoTransform)
+            | (flipY ? QSGImageNode::MirrorVertically : QSGImageNode::NoTransform));
+        return background;
+    }
+
+    auto *node = static_cast<VideoRenderNode *>(background->firstChild());
+    if (hasFrame)
+        node->setFrame(frame);
+    node->setGeometry(videoRect, flipX, flipY);
+    node->setScaleFilter(scaleFilter());
+    node->setToneMapper(toneMapper());
+    node->markDirty(QSGNode::DirtyMaterial);
+
+    RenderStats stats;
+    if (node->takeStats(stats))
+        setRenderStats(stats);
+
+    return background;
 }
 
-QQuickFramebufferObject::Renderer *OpenGLVideoItem::createRenderer() const
+void OpenGLVideoItem::releaseResources()
 {
-    return new OpenGLVideoRenderer();
+    // The node tree is torn down by the scene graph; nothing GUI-side to free.
+    m_frameSize = QSize();
 }
 
 void OpenGLVideoItem::setFrame(const QImage &frame)
 {
-    if (frame.isNull()) return;
+    setVideoFrame(GLVideoFrame::fromImage(frame));
+}
+
+void OpenGLVideoItem::setVideoFrame(const GLVideoFrame &frame)
+{
+    if (!frame.isValid()) return;
 
     {
         QMutexLocker locker(&m_frameMutex);
-        m_pendingFrame = frame;
-        m_dirty = true;
+        m_frameQueue.push_back(frame);
+        if (frame.presentAtUs == 0)
+            m_frameQueue.back().presentAtUs = GLVideoFrame::steadyNowUs();
+        while (m_frameQueue.size() > kMaxQueuedFrames) {
+            m_frameQueue.pop_front();
+            ++m_framesSkipped;
+        }
     }
 
     update();
 }
 
+void OpenGLVideoItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        update();
+}
+
+void OpenGLVideoItem::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemSceneChange) {
+        disconnect(m_swapConnection);
+        disconnect(m_screenConnection);
+        disconnect(m_frameBeginConnection);
+        disconnect(m_frameEndConnection);
+        if (QQuickWindow *win = value.window) {
+            // frameSwapped fires on the render thread; hop to ours.
+            m_swapConnection = connect(win, &QQuickWindow::frameSwapped,
+                                       this, &OpenGLVideoItem::onFrameSwapped,
+                                       Qt::QueuedConnection);
+            m_screenConnection = connect(win, &QWindow::screenChanged,
+                                         this, &OpenGLVideoItem::updateVsyncInterval);
+
+            // Whole scene graph frame on the render thread — the number to
+            // compare between backends.
+            m_frameBeginConnection = connect(win, &QQuickWindow::beforeFrameBegin, this, [this]() {
+                m_sgFrameStartNs.store(steadyNowNs(), std::memory_order_relaxed);
+            }, Qt::DirectConnection);
+            m_frameEndConnection = connect(win, &QQuickWindow::afterFrameEnd, this, [this]() {
+                const int64_t start = m_sgFrameStartNs.load(std::memory_order_relaxed);
+                if (start == 0) return;
+                m_sgFrameTotalNs.fetch_add(steadyNowNs() - start, std::memory_order_relaxed);
+                m_sgFrameCount.fetch_add(1, std::memory_order_relaxed);
+            }, Qt::DirectConnection);
+        }
+        updateVsyncInterval();
+    }
+    QQuickItem::itemChange(change, value);
+}
+
+void OpenGLVideoItem::onFrameSwapped()
+{
+    // Frames still waiting for their vsync keep the loop going; once the
+    // queue drains (paused, stopped) no further renders are requested.
+    bool pending = false;
+    {
+        QMutexLocker locker(&m_frameMutex);
+        pending = !m_frameQueue.empty();
+    }
+    if (pending)
+        update();
+}
+
+void OpenGLVideoItem::updateVsyncInterval()
+{
+    QQuickWindow *win = window();
+    const qreal hz = (win && win->screen()) ? win->screen()->refreshRate() : 60.0;
+
+    QMutexLocker locker(&m_frameMutex);
+    m_vsyncIntervalUs = static_cast<int64_t>(1e6 / (hz > 1.0 ? hz : 60.0));
+}
+
 bool OpenGLVideoItem::flipX() const
 {
     QMutexLocker locker(&m_frameMutex);
@@ -258,13 +1005,104 @@ void OpenGLVideoItem::setPreserveAspectRatio(bool enabled)
     update();
 }
 
-bool OpenGLVideoItem::takePendingFrame(QImage &out)
+SwsFilterMode OpenGLVideoItem::scaleFilter() const
+{
+    QMutexLocker locker(&m_frameMutex);
+    return m_scaleFilter;
+}
+
+int OpenGLVideoItem::scaleFilterInt() const
+{
+    return static_cast<int>(scaleFilter());
+}
+
+void OpenGLVideoItem::setScaleFilterInt(int mode)
+{
+    const auto filter = static_cast<SwsFilterMode>(std::clamp(mode, 0, static_cast<int>(SwsFilterMode::Lanczos)));
+    {
+        QMutexLocker locker(&m_frameMutex);
+        if (m_scaleFilter == filter) return;
+        m_scaleFilter = filter;
+    }
+    emit scaleFilterChanged();
+    update();
+}
+
+ToneMapper OpenGLVideoItem::toneMapper() const
+{
+    QMutexLocker locker(&m_frameMutex);
+    return m_toneMapper;
+}
+
+int OpenGLVideoItem::toneMapperInt() const
+{
+    return static_cast<int>(toneMapper());
+}
+
+void OpenGLVideoItem::setToneMapperInt(int mapper)
+{
+    const auto value = static_cast<ToneMapper>(std::clamp(mapper, 0, static_cast<int>(ToneMapper::Bt2390)));
+    {
+        QMutexLocker locker(&m_frameMutex);
+        if (m_toneMapper == value) return;
+        m_toneMapper = value;
+    }
+    emit toneMapperChanged();
+    update();
+}
+
+QVariantMap OpenGLVideoItem::renderStats() const
 {
+    QVariantMap map;
+    QString backend = m_renderStats.backend;
+    if (backend.isEmpty()) {
+        QQuickWindow *win = window();
+        const bool software = win && win->rendererInterface()->graphicsApi() == QSGRendererInterface::Software;
+        backend = software ? QStringLiteral("Software") : QStringLiteral("-");
+    }
+    map.insert(QStringLiteral("renderBackend"), backend);
+
+    // Scene graph frame time since the previous read
+    const uint64_t frames  = m_sgFrameCount.exchange(0, std::memory_order_relaxed);
+    const int64_t  totalNs = m_sgFrameTotalNs.exchange(0, std::memory_order_relaxed);
+    if (frames > 0)
+        m_lastSgFrameMs = totalNs / 1e6 / static_cast<double>(frames);
+    map.insert(QStringLiteral("sgFrameMsAvg"), m_lastSgFrameMs);
+
+    map.insert(QStringLiteral("videoNodeMsAvg"), m_renderStats.nodeMsAvg);
+    map.insert(QStringLiteral("videoNodeMsMax"), m_renderStats.nodeMsMax);
+    map.insert(QStringLiteral("videoUploadMsAvg"), m_renderStats.uploadMsAvg);
+    if (m_renderStats.gpuMsAvg > 0.0)
+        map.insert(QStringLiteral("videoGpuMsAvg"), m_renderStats.gpuMsAvg);
+
     QMutexLocker locker(&m_frameMutex);
-    if (!m_dirty) return false;
+    map.insert(QStringLiteral("videoFramesSkipped"), QVariant::fromValue<qulonglong>(m_framesSkipped));
+    return map;
+}
+
+void OpenGLVideoItem::setRenderStats(const RenderStats &stats)
+{
+    m_renderStats = stats;
+}
+
+bool OpenGLVideoItem::takePendingFrame(GLVideoFrame &out)
+{
+    QMutexLocker locker(&m_frameMutex);
+    if (m_frameQueue.empty()) return false;
+
+    const int64_t deadline = GLVideoFrame::steadyNowUs() + m_vsyncIntervalUs / 2;
+    size_t due = 0;
+    while (due < m_frameQueue.size()) {
+        const int64_t at = m_frameQueue[due].presentAtUs;
+        if (at > deadline && at - deadline < kMaxAheadUs)
+            break;
+        ++due;
+    }
+    if (due == 0) return false;
 
-    out = m_pendingFrame;
-    m_dirty = false;
+    out = std::move(m_frameQueue[due - 1]);
+    m_framesSkipped += due - 1;
+    m_frameQueue.erase(m_frameQueue.begin(), m_frameQueue.begin() + static_cast<std::ptrdiff_t>(due));
     return true;
 }
 
@@ -1,27 +1,58 @@
 #pragma once
 
-#include <QQuickFramebufferObject>
+#include <QQuickItem>
 #include <QtQml/qqml.h>
 #include <QImage>
 #include <QMutex>
+#include <QVariantMap>
+#include <atomic>
+#include <deque>
 
-class OpenGLVideoRenderer;
+#include "GLVideoFrame.h"
+#include "AVPlayerStatus.h"
 
-class OpenGLVideoItem : public QQuickFramebufferObject
+struct SwsContext;
+
+/// @brief Video surface for VideoRenderMode::OpenGLTexture.
+///
+/// Draws decoded frames directly in the Qt Quick scene graph through a
+/// QRhi-based QSGRenderNode — no offscreen FBO, and no dependency on the
+/// graphics API: the same node runs on OpenGL, Vulkan, Direct3D and Metal.
+/// Flip and aspect-ratio fitting are applied in the node's geometry.
+/// (The name predates the QRhi port and is kept for QML compatibility.)
+class OpenGLVideoItem : public QQuickItem
 {
     Q_OBJECT
     QML_ELEMENT
     Q_PROPERTY(bool flipX READ flipX WRITE setFlipX NOTIFY flipXChanged)
     Q_PROPERTY(bool flipY READ flipY WRITE setFlipY NOTIFY flipYChanged)
     Q_PROPERTY(bool preserveAspectRatio READ preserveAspectRatio WRITE setPreserveAspectRatio NOTIFY preserveAspectRatioChanged)
+    /// SwsFilterMode applied in the fragment shader when scaling to the item
+    Q_PROPERTY(int scaleFilter READ scaleFilterInt WRITE setScaleFilterInt NOTIFY scaleFilterChanged)
+    /// ToneMapper curve for PQ / HLG frames
+    Q_PROPERTY(int toneMapper READ toneMapperInt WRITE setToneMapperInt NOTIFY toneMapperChanged)
+    Q_PROPERTY(QVariantMap renderStats READ renderStats)
 
 public:
-    explicit OpenGLVideoItem(QQuickItem *parent = nullptr);
+    /// Render-thread timing published by the video node every few frames.
+    struct RenderStats {
+        QString backend;              ///< QRhi backend name
+        double  nodeMsAvg   = 0.0;    ///< prepare() + render() of the video node
+        double  nodeMsMax   = 0.0;
+        double  uploadMsAvg = 0.0;    ///< texture upload share of prepare()
+        double  gpuMsAvg    = 0.0;    ///< 0 unless the window enables GPU timestamps
+    };
 
-    Renderer *createRenderer() const override;
+    explicit OpenGLVideoItem(QQuickItem *parent = nullptr);
+    ~OpenGLVideoItem() override;
 
+    /// Present an RGBA image (kept for callers that only have a QImage).
     Q_INVOKABLE void setFrame(const QImage &frame);
 
+    /// Queue a decoded frame; planar YUV is converted on the GPU.  The frame
+    /// is shown on the first vsync at or after its presentAtUs.
+    Q_INVOKABLE void setVideoFrame(const GLVideoFrame &frame);
+
     bool flipX() const;
     void setFlipX(bool enabled);
 
@@ -31,19 +62,75 @@ public:
     bool preserveAspectRatio() const;
     void setPreserveAspectRatio(bool enabled);
 
-    bool takePendingFrame(QImage &out);
+    /// Scaling to display size happens here, on the GPU: Point and the
+    /// bilinear modes use the texture sampler, Bicubic (Catmull-Rom) and
+    /// Lanczos-3 run as two shader passes, horizontal into an intermediate
+    /// texture then vertical, with the kernel widened when downscaling.
+    SwsFilterMode scaleFilter() const;
+    int scaleFilterInt() const;
+    void setScaleFilterInt(int mode);
+
+    /// HDR frames are linearised (PQ / HLG), converted from BT.2020 to
+    /// BT.709 primaries and mapped to SDR in the fragment shader, from the
+    /// peak carried in GLVideoFrame::peakNits.
+    ToneMapper toneMapper() const;
+    int toneMapperInt() const;
+    void setToneMapperInt(int mapper);
+
+    /// Backend name, scene graph frame time (render thread, per frame, since
+    /// the previous read) and video node timings.
+    QVariantMap renderStats() const;
+    /// Called from updatePaintNode() (GUI thread blocked).
+    void setRenderStats(const RenderStats &stats);
+
+    /// Called from updatePaintNode(): hand out the newest frame due by the
+    /// upcoming vsync, dropping older ones that would never be seen.
+    bool takePendingFrame(GLVideoFrame &out);
     bool queryRenderOptions(bool &flipX, bool &flipY, bool &preserveAspectRatio);
 
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void releaseResources() override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
 signals:
     void flipXChanged();
     void flipYChanged();
     void preserveAspectRatioChanged();
+    void scaleFilterChanged();
+    void toneMapperChanged();
 
 private:
+    void onFrameSwapped();
+    void updateVsyncInterval();
+
+    static constexpr size_t  kMaxQueuedFrames = 4;
+    static constexpr int64_t kMaxAheadUs      = 500000;   ///< treat further-out pts as a clock jump
+
     mutable QMutex m_frameMutex;
-    QImage m_pendingFrame;
-    bool m_dirty = false;
+    std::deque<GLVideoFrame> m_frameQueue;
+    int64_t m_vsyncIntervalUs = 16667;
+    uint64_t m_framesSkipped = 0;
+    QSize m_frameSize;   ///< render thread only (updatePaintNode)
+    QMetaObject::Connection m_swapConnection;
+    QMetaObject::Connection m_screenConnection;
+    QMetaObject::Connection m_frameBeginConnection;
+    QMetaObject::Connection m_frameEndConnection;
     bool m_flipX = false;
     bool m_flipY = false;
     bool m_preserveAspectRatio = true;
+    SwsFilterMode m_scaleFilter = SwsFilterMode::Bilinear;
+    ToneMapper m_toneMapper = ToneMapper::Bt2390;
+    RenderStats m_renderStats;
+
+    // Scene graph frame timing (written on the render thread)
+    std::atomic<int64_t>  m_sgFrameStartNs{0};
+    mutable std::atomic<int64_t>  m_sgFrameTotalNs{0};
+    mutable std::atomic<uint64_t> m_sgFrameCount{0};
+    mutable double m_lastSgFrameMs = 0.0;
+
+    // Software scene graph fallback (render thread only)
+    SwsContext *m_softwareSws = nullptr;
+    QImage m_softwareImage;
 };
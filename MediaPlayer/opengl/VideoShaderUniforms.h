@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "AVPlayerStatus.h"
+
+/// Uniform block shared by video.vert / video.frag (std140).  Used by
+/// OpenGLVideoItem and by zqt_bench's GPU scaling comparison.
+struct VideoUniforms {
+    float   mvp[16];
+    float   yuvMatrix[16];     ///< 3×3 in the upper-left, column-major
+    float   yuvOffset[4];
+    float   sampleScale;
+    int32_t layoutMode;        ///< 0 = RGBA, 1 = Y/U/V planes, 2 = Y + UV
+    int32_t filterMode;        ///< 0 = point, 1 = bilinear, 2 = bicubic, 3 = Lanczos-3
+    int32_t transferMode;      ///< 0 = SDR (no tone mapping), 1 = PQ, 2 = HLG
+    int32_t toneMapper;        ///< 1 = Hable, 2 = BT.2390
+    int32_t gamutMode;         ///< 1 = BT.2020 → BT.709 primaries in linear light
+    float   srcPeak;           ///< source peak in units of SDR reference white
+    int32_t scalePass;         ///< 0 = single pass, 1 = horizontal kernel pass, 2 = vertical
+    float   dstExtent;         ///< output pixels along the axis of the kernel pass
+    float   pad[3];
+};
+static_assert(sizeof(VideoUniforms) == 192, "must match the std140 block in video.vert");
+
+/// Shader filter for the configured scaling filter.  Both bilinear modes
+/// map to the hardware sampler.
+inline int32_t shaderFilterMode(SwsFilterMode mode)
+{
+    switch (mode) {
+    case SwsFilterMode::Point:        return 0;
+    case SwsFilterMode::FastBilinear:
+    case SwsFilterMode::Bilinear:     return 1;
+    case SwsFilterMode::Bicubic:      return 2;
+    case SwsFilterMode::Lanczos:      return 3;
+    }
+    return 1;
+}
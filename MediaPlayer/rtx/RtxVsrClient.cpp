@@ -1,10 +1,18 @@
 #include "RtxVsrClient.h"
 
+#include <QCoreApplication>
 #include <QFileInfo>
+#include <algorithm>
 #include <cstring>
 
 namespace {
+#ifdef Q_OS_WIN
 const char *kDefaultBridgeDllName = "rtx_hdr_vsr_bridge.dll";
+#else
+// Only the mock bridge exists off Windows (ZQT_BUILD_RTX_MOCK_BRIDGE);
+// QLibrary adds the lib prefix and .so / .dylib suffix.
+const char *kDefaultBridgeDllName = "rtx_hdr_vsr_bridge";
+#endif
 }
 
 RtxVsrClient::RtxVsrClient() = default;
@@ -28,7 +36,16 @@ bool RtxVsrClient::load(const QString &dllPath)
 
     clearError();
 
-    const QString path = dllPath.isEmpty() ? QString::fromLatin1(kDefaultBridgeDllName) : dllPath;
+    QString path = dllPath;
+    if (path.isEmpty()) {
+#ifdef Q_OS_WIN
+        path = QString::fromLatin1(kDefaultBridgeDllName);
+#else
+        // Not on the default library search path: look next to the binary.
+        path = QCoreApplication::applicationDirPath() + QLatin1Char('/')
+               + QString::fromLatin1(kDefaultBridgeDllName);
+#endif
+    }
     m_lib.setFileName(path);
 
     if (!m_lib.load()) {
@@ -176,6 +193,8 @@ void RtxVsrClient::shutdown()
     }
     m_handle      = nullptr;
     m_initialized = false;
+    m_packBuffer.clear();
+    m_packBuffer.shrink_to_fit();
     m_inWidth     = 0;
     m_inHeight    = 0;
     m_outWidth    = 0;
@@ -237,7 +256,7 @@ bool RtxVsrClient::processFrameToBgra(const AVFrame *inFrame,
     //   UV plane (height/2 rows × inputPitch).
     // AVFrame may have separate data[0] (Y) and data[1] (UV) pointers.
     // If they are already contiguous we can pass data[0] directly;
-    // otherwise we copy into a temp buffer.
+    // otherwise we pack into m_packBuffer, which is kept across frames.
 
     const int yStride  = inFrame->linesize[0];
     const int uvStride = inFrame->linesize[1];
@@ -247,7 +266,6 @@ bool RtxVsrClient::processFrameToBgra(const AVFrame *inFrame,
 
     const uint8_t *inputPtr = nullptr;
     unsigned int inputPitch  = static_cast<unsigned int>(yStride);
-    std::vector<uint8_t> tmpBuf;
 
     const bool contiguous = (inFrame->data[1] == inFrame->data[0] + ySize)
                             && (yStride == uvStride);
@@ -255,11 +273,22 @@ bool RtxVsrClient::processFrameToBgra(const AVFrame *inFrame,
     if (contiguous) {
         inputPtr = inFrame->data[0];
     } else {
-        // Pack Y + UV into a contiguous buffer
-        tmpBuf.resize(static_cast<size_t>(ySize + uvSize));
-        std::memcpy(tmpBuf.data(), inFrame->data[0], ySize);
-        std::memcpy(tmpBuf.data() + ySize, inFrame->data[1], uvSize);
-        inputPtr  = tmpBuf.data();
+        // Pack Y + UV into a contiguous buffer.  The bridge takes one pitch
+        // for both planes, so UV rows are re-strided if their pitch differs.
+        const size_t packedSize = static_cast<size_t>(yStride) * (h + h / 2);
+        if (m_packBuffer.size() < packedSize)
+            m_packBuffer.resize(packedSize);
+        std::memcpy(m_packBuffer.data(), inFrame->data[0], static_cast<size_t>(ySize));
+        if (uvStride == yStride) {
+            std::memcpy(m_packBuffer.data() + ySize, inFrame->data[1], static_cast<size_t>(uvSize));
+        } else {
+            const size_t rowBytes = static_cast<size_t>(std::min(yStride, uvStride));
+            for (int y = 0; y < h / 2; ++y) {
+                std::memcpy(m_packBuffer.data() + ySize + static_cast<size_t>(y) * yStride,
+                            inFrame->data[1] + static_cast<size_t>(y) * uvStride, rowBytes);
+            }
+        }
+        inputPtr  = m_packBuffer.data();
         inputPitch = static_cast<unsigned int>(yStride);
     }
 
@@ -287,7 +316,7 @@ QString RtxVsrClient::lastError() const
     return m_lastError;
 }
 
-bool RtxVsrClient::supportsInputFormat(AVPixelFormat fmt)
+bool RtxVsrClient::supportsInputFormat(AVPixelFormat fmt) const
 {
     return fmt == AV_PIX_FMT_NV12 || fmt == AV_PIX_FMT_P010LE;
 }
@@ -3,22 +3,28 @@
 #include <QString>
 #include <QLibrary>
 #include <mutex>
+#include <vector>
 
-extern "C" {
-#include <libavutil/frame.h>
-#include <libavutil/pixfmt.h>
-}
+#include "VsrBackend.h"
+
+// The bridge exports use __cdecl.  The keyword only exists on Windows
+// compilers; elsewhere the platform's C convention is the same thing.
+#ifdef _WIN32
+#define RTX_VSR_CALL __cdecl
+#else
+#define RTX_VSR_CALL
+#endif
 
 // Thin runtime wrapper for rtx_hdr_vsr_bridge.dll (C ABI).
 // This class keeps all SDK symbols behind dynamic loading so the main app
 // can run even when the bridge DLL is missing.
 //
 // ABI types mirror the definitions in rtx_hdr_vsr_bridge.h exactly.
-class RtxVsrClient
+class RtxVsrClient : public VsrBackend
 {
 public:
     RtxVsrClient();
-    ~RtxVsrClient();
+    ~RtxVsrClient() override;
 
     RtxVsrClient(const RtxVsrClient &) = delete;
     RtxVsrClient &operator=(const RtxVsrClient &) = delete;
@@ -27,12 +33,15 @@ public:
     void unload();
 
     bool isLoaded() const;
-    bool isInitialized() const;
 
-    int inWidth()  const { return m_inWidth; }
-    int inHeight() const { return m_inHeight; }
-    int outWidth()  const { return m_outWidth; }
-    int outHeight() const { return m_outHeight; }
+    // ── VsrBackend ──
+    const char *name() const override { return "RTX"; }
+    bool isInitialized() const override;
+
+    int inWidth()  const override { return m_inWidth; }
+    int inHeight() const override { return m_inHeight; }
+    int outWidth()  const override { return m_outWidth; }
+    int outHeight() const override { return m_outHeight; }
 
     bool initialize(int inputWidth,
                     int inputHeight,
@@ -40,9 +49,9 @@ public:
                     int outputHeight,
                     int quality,
                     int pixelFormat = 0,
-                    int adapterIndex = -1);
+                    int adapterIndex = -1) override;
 
-    void shutdown();
+    void shutdown() override;
 
     bool setQuality(int quality);
 
@@ -52,11 +61,14 @@ public:
                             uint8_t *outBgra,
                             int outStride,
                             int outWidth,
-                            int outHeight);
+                            int outHeight) override;
+
+    QString lastError() const override;
 
-    QString lastError() const;
+    bool supportsInputFormat(AVPixelFormat fmt) const override;
 
-    static bool supportsInputFormat(AVPixelFormat fmt);
+    /// D3D11 device + NGX feature creation takes seconds.
+    bool needsWarmUp() const override { return true; }
 
 private:
     void clearError();
@@ -112,15 +124,15 @@ private:
     using Handle = void *;
 
     // Function pointer types matching the DLL exports
-    using FnCreate       = Status (__cdecl *)(const CreateParams *params, Handle *ppCtx);
-    using FnDestroy      = void   (__cdecl *)(Handle ctx);
-    using FnProcessCpu   = Status (__cdecl *)(Handle ctx,
+    using FnCreate       = Status (RTX_VSR_CALL *)(const CreateParams *params, Handle *ppCtx);
+    using FnDestroy      = void   (RTX_VSR_CALL *)(Handle ctx);
+    using FnProcessCpu   = Status (RTX_VSR_CALL *)(Handle ctx,
                                               const void *inputData, unsigned int inputPitch,
                                               void *outputBGRA, unsigned int outputPitch);
-    using FnSetQuality   = Status (__cdecl *)(Handle ctx, Quality quality);
-    using FnReset        = Status (__cdecl *)(Handle ctx, const CreateParams *params);
-    using FnStatusString = const char *(__cdecl *)(Status status);
-    using FnLastError    = const char *(__cdecl *)(void);
+    using FnSetQuality   = Status (RTX_VSR_CALL *)(Handle ctx, Quality quality);
+    using FnReset        = Status (RTX_VSR_CALL *)(Handle ctx, const CreateParams *params);
+    using FnStatusString = const char *(RTX_VSR_CALL *)(Status status);
+    using FnLastError    = const char *(RTX_VSR_CALL *)(void);
 
 private:
     QLibrary m_lib;
@@ -138,6 +150,7 @@ private:
     QString m_lastError;
 
     std::mutex m_mutex;   // guards m_handle access across threads
+    std::vector<uint8_t> m_packBuffer;   ///< Y + UV packing for non-contiguous frames, reused
 
     // Remembered dimensions for the current init
     int m_inWidth   = 0;
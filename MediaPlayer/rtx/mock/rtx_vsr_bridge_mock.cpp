@@ -0,0 +1,188 @@
+/*
+ * rtx_vsr_bridge_mock.cpp
+ *
+ * Stand-in for rtx_hdr_vsr_bridge that needs no GPU or NVIDIA SDK.  It
+ * exports the same C ABI, so RtxVsrClient and the FrameHandler VSR pipeline
+ * can be exercised on any platform (built with ZQT_BUILD_RTX_MOCK_BRIDGE).
+ *
+ * rtx_vsr_process_cpu() does a nearest-neighbour BT.709 limited-range
+ * NV12 / P010 -> RGBA conversion at the output size, in the byte order
+ * FrameHandler presents as Format_RGBA8888.  Set RTX_VSR_MOCK_DELAY_MS to
+ * add a fixed per-frame delay and simulate a slow upscaler.
+ */
+
+#include "rtx_hdr_vsr_bridge.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct RtxBridgeContext
+{
+    RtxBridgeCreateParams params;
+    std::vector<int> srcX;   // output column -> source column
+    std::vector<int> srcY;   // output row    -> source row
+    int delayMs = 0;
+};
+
+namespace {
+
+thread_local std::string t_lastError;
+
+RtxBridgeStatus fail(RtxBridgeStatus status, const char *message)
+{
+    t_lastError = message;
+    return status;
+}
+
+bool validParams(const RtxBridgeCreateParams *p)
+{
+    return p && p->inputWidth > 0 && p->inputHeight > 0
+           && p->outputWidth > 0 && p->outputHeight > 0
+           && (p->pixelFormat == RTX_PIXEL_FMT_NV12 || p->pixelFormat == RTX_PIXEL_FMT_P010);
+}
+
+void configure(RtxBridgeContext *ctx, const RtxBridgeCreateParams *p)
+{
+    ctx->params = *p;
+    ctx->srcX.resize(p->outputWidth);
+    ctx->srcY.resize(p->outputHeight);
+    for (unsigned int x = 0; x < p->outputWidth; ++x)
+        ctx->srcX[x] = static_cast<int>(static_cast<uint64_t>(x) * p->inputWidth / p->outputWidth);
+    for (unsigned int y = 0; y < p->outputHeight; ++y)
+        ctx->srcY[y] = static_cast<int>(static_cast<uint64_t>(y) * p->inputHeight / p->outputHeight);
+
+    const char *delay = std::getenv("RTX_VSR_MOCK_DELAY_MS");
+    ctx->delayMs = delay ? std::max(0, std::atoi(delay)) : 0;
+}
+
+inline uint8_t clamp8(int v)
+{
+    return static_cast<uint8_t>(std::clamp(v, 0, 255));
+}
+
+} // namespace
+
+extern "C" {
+
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_create(
+    const RtxBridgeCreateParams* params,
+    RtxBridgeContext**           ppCtx)
+{
+    if (!ppCtx || !validParams(params))
+        return fail(RTX_BRIDGE_ERR_INVALID_ARG, "mock: invalid create parameters");
+
+    auto *ctx = new (std::nothrow) RtxBridgeContext;
+    if (!ctx)
+        return fail(RTX_BRIDGE_ERR_UNKNOWN, "mock: out of memory");
+    configure(ctx, params);
+    *ppCtx = ctx;
+    return RTX_BRIDGE_OK;
+}
+
+RTX_BRIDGE_API void RTX_BRIDGE_CALL rtx_vsr_destroy(
+    RtxBridgeContext* ctx)
+{
+    delete ctx;
+}
+
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_process_cpu(
+    RtxBridgeContext*   ctx,
+    const void*         inputData,
+    unsigned int        inputPitch,
+    void*               outputBGRA,
+    unsigned int        outputPitch)
+{
+    if (!ctx)
+        return fail(RTX_BRIDGE_ERR_NOT_INITIALIZED, "mock: null context");
+    if (!inputData || !outputBGRA)
+        return fail(RTX_BRIDGE_ERR_INVALID_ARG, "mock: null buffer");
+
+    const RtxBridgeCreateParams &p = ctx->params;
+    const bool wide = p.pixelFormat == RTX_PIXEL_FMT_P010;
+    const unsigned int bpp = wide ? 2 : 1;
+    if (inputPitch == 0)  inputPitch  = p.inputWidth * bpp;
+    if (outputPitch == 0) outputPitch = p.outputWidth * 4;
+
+    const auto *src = static_cast<const uint8_t *>(inputData);
+    const uint8_t *uvPlane = src + static_cast<size_t>(inputPitch) * p.inputHeight;
+    auto *dst = static_cast<uint8_t *>(outputBGRA);
+
+    // Samples normalised to 8 bits (P010 keeps its 10 bits in the MSBs).
+    auto sample = [wide](const uint8_t *row, int index) -> int {
+        if (!wide) return row[index];
+        uint16_t v;
+        std::memcpy(&v, row + index * 2, sizeof(v));
+        return v >> 8;
+    };
+
+    for (unsigned int y = 0; y < p.outputHeight; ++y) {
+        const int sy = ctx->srcY[y];
+        const uint8_t *yRow  = src + static_cast<size_t>(sy) * inputPitch;
+        const uint8_t *uvRow = uvPlane + static_cast<size_t>(sy / 2) * inputPitch;
+        uint8_t *out = dst + static_cast<size_t>(y) * outputPitch;
+
+        for (unsigned int x = 0; x < p.outputWidth; ++x) {
+            const int sx = ctx->srcX[x];
+            const int c  = (sx / 2) * 2;
+            // BT.709 limited range, 16.16 fixed point
+            const int Y = (sample(yRow, sx) - 16) * 76309;
+            const int U = sample(uvRow, c) - 128;
+            const int V = sample(uvRow, c + 1) - 128;
+            out[x * 4 + 0] = clamp8((Y + 117489 * V + 32768) >> 16);
+            out[x * 4 + 1] = clamp8((Y - 13975 * U - 34925 * V + 32768) >> 16);
+            out[x * 4 + 2] = clamp8((Y + 138438 * U + 32768) >> 16);
+            out[x * 4 + 3] = 255;
+        }
+    }
+
+    if (ctx->delayMs > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(ctx->delayMs));
+    return RTX_BRIDGE_OK;
+}
+
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_set_quality(
+    RtxBridgeContext*   ctx,
+    RtxVsrQuality       quality)
+{
+    if (!ctx)
+        return fail(RTX_BRIDGE_ERR_NOT_INITIALIZED, "mock: null context");
+    ctx->params.initialQuality = quality;
+    return RTX_BRIDGE_OK;
+}
+
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_reset(
+    RtxBridgeContext*               ctx,
+    const RtxBridgeCreateParams*    params)
+{
+    if (!ctx)
+        return fail(RTX_BRIDGE_ERR_NOT_INITIALIZED, "mock: null context");
+    if (!validParams(params))
+        return fail(RTX_BRIDGE_ERR_INVALID_ARG, "mock: invalid reset parameters");
+    configure(ctx, params);
+    return RTX_BRIDGE_OK;
+}
+
+RTX_BRIDGE_API const char* RTX_BRIDGE_CALL rtx_vsr_status_string(
+    RtxBridgeStatus status)
+{
+    switch (status) {
+    case RTX_BRIDGE_OK:                  return "OK";
+    case RTX_BRIDGE_ERR_INVALID_ARG:     return "Invalid argument";
+    case RTX_BRIDGE_ERR_NOT_INITIALIZED: return "Not initialized";
+    default:                             return "Mock bridge error";
+    }
+}
+
+RTX_BRIDGE_API const char* RTX_BRIDGE_CALL rtx_vsr_last_error(void)
+{
+    return t_lastError.c_str();
+}
+
+} // extern "C"
@@ -15,10 +15,17 @@
 extern "C" {
 #endif
 
-#ifdef RTX_BRIDGE_EXPORTS
-#define RTX_BRIDGE_API __declspec(dllexport)
+#if defined(_WIN32)
+#  ifdef RTX_BRIDGE_EXPORTS
+#    define RTX_BRIDGE_API __declspec(dllexport)
+#  else
+#    define RTX_BRIDGE_API __declspec(dllimport)
+#  endif
+#  define RTX_BRIDGE_CALL __cdecl
 #else
-#define RTX_BRIDGE_API __declspec(dllimport)
+/* Only the mock bridge is built off Windows (ZQT_BUILD_RTX_MOCK_BRIDGE). */
+#  define RTX_BRIDGE_API __attribute__((visibility("default")))
+#  define RTX_BRIDGE_CALL
 #endif
 
 /* ------------------------------------------------------------------ */
@@ -96,7 +103,7 @@ typedef struct RtxBridgeCreateParams
  *   Create DX11 device + NGX VSR (and optionally TrueHDR) pipeline.
  *   Returns RTX_BRIDGE_OK on success; *ppCtx receives the opaque handle.
  */
-RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_create(
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_create(
     const RtxBridgeCreateParams* params,
     RtxBridgeContext**           ppCtx);
 
@@ -104,7 +111,7 @@ RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_create(
  * rtx_vsr_destroy
  *   Release all GPU resources and free the handle.
  */
-RTX_BRIDGE_API void __cdecl rtx_vsr_destroy(
+RTX_BRIDGE_API void RTX_BRIDGE_CALL rtx_vsr_destroy(
     RtxBridgeContext* ctx);
 
 /*
@@ -117,7 +124,7 @@ RTX_BRIDGE_API void __cdecl rtx_vsr_destroy(
  *   outputBGRA     : caller-allocated buffer, outputWidth * outputHeight * 4 bytes
  *   outputPitch    : row pitch of output buffer (0 = tightly packed = outWidth*4)
  */
-RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_process_cpu(
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_process_cpu(
     RtxBridgeContext*   ctx,
     const void*         inputData,
     unsigned int        inputPitch,
@@ -128,7 +135,7 @@ RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_process_cpu(
  * rtx_vsr_set_quality
  *   Change VSR quality level at runtime (takes effect on next process call).
  */
-RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_set_quality(
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_set_quality(
     RtxBridgeContext*   ctx,
     RtxVsrQuality       quality);
 
@@ -136,7 +143,7 @@ RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_set_quality(
  * rtx_vsr_reset
  *   Re-create the pipeline for a new resolution without destroying the handle.
  */
-RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_reset(
+RTX_BRIDGE_API RtxBridgeStatus RTX_BRIDGE_CALL rtx_vsr_reset(
     RtxBridgeContext*               ctx,
     const RtxBridgeCreateParams*    params);
 
@@ -144,14 +151,14 @@ RTX_BRIDGE_API RtxBridgeStatus __cdecl rtx_vsr_reset(
  * rtx_vsr_status_string
  *   Convert a RtxBridgeStatus to a human-readable string.
  */
-RTX_BRIDGE_API const char* __cdecl rtx_vsr_status_string(
+RTX_BRIDGE_API const char* RTX_BRIDGE_CALL rtx_vsr_status_string(
     RtxBridgeStatus status);
 
 /*
  * rtx_vsr_last_error
  *   Return the last detailed error message (thread-local, null-terminated).
  */
-RTX_BRIDGE_API const char* __cdecl rtx_vsr_last_error(void);
+RTX_BRIDGE_API const char* RTX_BRIDGE_CALL rtx_vsr_last_error(void);
 
 #ifdef __cplusplus
 }
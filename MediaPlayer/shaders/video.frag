@@ -0,0 +1,241 @@
+#version 440
+
+layout(location = 0) in vec2 vTexCoord;
+layout(location = 0) out vec4 fragColor;
+
+layout(std140, binding = 0) uniform buf {
+    mat4  mvp;
+    mat4  yuvMatrix;      // mat3 padded to mat4 for std140
+    vec4  yuvOffset;
+    float sampleScale;
+    int   layoutMode;     // 0 = RGBA, 1 = Y/U/V planes, 2 = Y + interleaved UV
+    int   filterMode;     // 0 = point, 1 = bilinear, 2 = bicubic, 3 = Lanczos-3
+    int   transferMode;   // 0 = SDR, 1 = PQ, 2 = HLG
+    int   toneMapper;     // 1 = Hable, 2 = BT.2390
+    int   gamutMode;      // 1 = BT.2020 -> BT.709
+    float srcPeak;        // source peak / SDR reference white
+    int   scalePass;      // 0 = single pass, 1 = horizontal kernel pass, 2 = vertical
+    float dstExtent;      // output pixels along the axis the kernel pass filters
+};
+
+layout(binding = 1) uniform sampler2D texY;   // RGBA image in layout 0
+layout(binding = 2) uniform sampler2D texU;   // U, or interleaved UV
+layout(binding = 3) uniform sampler2D texV;
+
+const float PI = 3.14159265358979;
+
+// Catmull-Rom (B = 0, C = 0.5), support [-2, 2]
+float cubicWeight(float x)
+{
+    x = abs(x);
+    if (x < 1.0)
+        return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0)
+        return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+// Lanczos, a = 3 (same window as SWS_LANCZOS), support [-3, 3]
+float lanczosWeight(float x)
+{
+    x = abs(x);
+    if (x < 1e-5)
+        return 1.0;
+    if (x >= 3.0)
+        return 0.0;
+    float px = PI * x;
+    return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+}
+
+float kernelWeight(float x)
+{
+    return filterMode == 3 ? lanczosWeight(x) : cubicWeight(x);
+}
+
+// Kernels are stretched by up to this factor when minifying; beyond it the
+// output aliases rather than run hundreds of taps per fragment.
+const float MAX_KERNEL_SCALE = 8.0;
+
+// Resample one plane along one axis (dir = (1, 0) or (0, 1)) with the
+// bicubic or Lanczos kernel.  When the plane has more texels along the axis
+// than the output has pixels, the kernel is stretched by that ratio so
+// every source texel contributes (a low-pass before decimation).  Taps sit on exact
+// texel centres along the axis; across it the hardware sampler
+// interpolates, which is a no-op for planes at the intermediate target's
+// row count and bilinear for subsampled chroma.
+vec4 sampleKernel(sampler2D tex, vec2 uv, vec2 dir)
+{
+    vec2  size   = vec2(textureSize(tex, 0));
+    float n      = dot(size, dir);
+    float pos    = dot(uv, dir) * n - 0.5;
+    float scale  = clamp(n / dstExtent, 1.0, MAX_KERNEL_SCALE);
+    float radius = (filterMode == 3 ? 3.0 : 2.0) * scale;
+    int   first  = int(floor(pos - radius)) + 1;
+    int   last   = int(floor(pos + radius));
+
+    vec4  sum  = vec4(0.0);
+    float wsum = 0.0;
+    vec2  across = uv * (1.0 - dir);
+    for (int k = first; k <= last; ++k) {
+        vec2  tc = across + dir * ((float(k) + 0.5) / n);
+        float w  = kernelWeight((float(k) - pos) / scale);
+        sum  += texture(tex, tc) * w;
+        wsum += w;
+    }
+    return sum / wsum;
+}
+
+// Sample one plane for the current pass.  The single pass covers point and
+// bilinear; bicubic and Lanczos filter horizontally here (scalePass 1) and
+// vertically over the intermediate target in main() (scalePass 2).
+vec4 samplePlane(sampler2D tex, vec2 uv)
+{
+    if (scalePass == 1)
+        return sampleKernel(tex, uv, vec2(1.0, 0.0));
+    if (filterMode == 0) {
+        vec2 size = vec2(textureSize(tex, 0));
+        return texture(tex, (floor(uv * size) + 0.5) / size);
+    }
+    return texture(tex, uv);
+}
+
+// ── HDR → SDR ──
+// Linear light is expressed relative to SDR reference white (203 nits,
+// ITU-R BT.2408), so 1.0 is the brightest value the SDR output can show.
+
+const float SDR_WHITE = 203.0;
+
+const float PQ_M1 = 0.1593017578125;
+const float PQ_M2 = 78.84375;
+const float PQ_C1 = 0.8359375;
+const float PQ_C2 = 18.8515625;
+const float PQ_C3 = 18.6875;
+
+// SMPTE ST 2084 EOTF: signal -> nits / 10000
+vec3 pqEotf(vec3 e)
+{
+    vec3 p = pow(max(e, 0.0), vec3(1.0 / PQ_M2));
+    return pow(max(p - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * p), vec3(1.0 / PQ_M1));
+}
+
+float pqEotf1(float e)
+{
+    float p = pow(max(e, 0.0), 1.0 / PQ_M2);
+    return pow(max(p - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * p), 1.0 / PQ_M1);
+}
+
+// Inverse EOTF: nits / 10000 -> signal
+float pqInverseEotf(float y)
+{
+    float p = pow(max(y, 0.0), PQ_M1);
+    return pow((PQ_C1 + PQ_C2 * p) / (1.0 + PQ_C3 * p), PQ_M2);
+}
+
+// ARIB STD-B67 inverse OETF: signal -> scene light [0, 1]
+vec3 hlgInverseOetf(vec3 e)
+{
+    const float a = 0.17883277, b = 0.28466892, c = 0.55991073;
+    vec3 lo = e * e / 3.0;
+    vec3 hi = (exp((e - c) / a) + b) / 12.0;
+    return mix(lo, hi, step(vec3(0.5), e));
+}
+
+// Hable filmic curve ("Uncharted 2")
+float hable(float x)
+{
+    const float A = 0.15, B = 0.50, C = 0.10, D = 0.20, E = 0.02, F = 0.30;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+// ITU-R BT.2390 EETF: Hermite roll-off in the PQ domain, linear below the
+// knee so mid-tones keep their source brightness.
+float bt2390(float y, float srcPeakNits, float dstPeakNits)
+{
+    float srcPq  = pqInverseEotf(srcPeakNits / 10000.0);
+    float e      = pqInverseEotf(y / 10000.0) / srcPq;
+    float maxLum = pqInverseEotf(dstPeakNits / 10000.0) / srcPq;
+    float ks     = 1.5 * maxLum - 0.5;
+    if (e > ks && ks < 1.0) {
+        float t  = (e - ks) / (1.0 - ks);
+        float t2 = t * t;
+        float t3 = t2 * t;
+        e = (2.0 * t3 - 3.0 * t2 + 1.0) * ks
+          + (t3 - 2.0 * t2 + t) * (1.0 - ks)
+          + (-2.0 * t3 + 3.0 * t2) * maxLum;
+    }
+    return pqEotf1(min(e, maxLum) * srcPq) * 10000.0;
+}
+
+vec3 toneMap(vec3 signal)
+{
+    signal = clamp(signal, 0.0, 1.0);
+
+    vec3 rgb;
+    if (transferMode == 1) {
+        rgb = pqEotf(signal) * (10000.0 / SDR_WHITE);
+    } else {
+        // HLG: scene light through the BT.2100 OOTF for a 1000-nit display
+        vec3 scene = hlgInverseOetf(signal);
+        float ys = dot(scene, vec3(0.2627, 0.6780, 0.0593));
+        rgb = scene * pow(max(ys, 1e-6), 0.2) * (1000.0 / SDR_WHITE);
+    }
+
+    if (gamutMode == 1) {
+        const mat3 bt2020To709 = mat3( 1.6605, -0.1246, -0.0182,
+                                      -0.5876,  1.1329, -0.1006,
+                                      -0.0728, -0.0083,  1.1187);
+        rgb = max(bt2020To709 * rgb, 0.0);
+    }
+
+    // Map luminance and scale RGB by the same ratio to keep hue and
+    // saturation; channels that still exceed 1.0 clip.
+    float y = dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+    float peak = max(srcPeak, 1.0);
+    float mapped;
+    if (toneMapper == 1)
+        mapped = hable(y) / hable(peak);
+    else
+        mapped = bt2390(y * SDR_WHITE, peak * SDR_WHITE, SDR_WHITE) / SDR_WHITE;
+    rgb *= mapped / max(y, 1e-6);
+
+    // Display encoding (gamma 2.2, as the desktop compositor expects)
+    return pow(clamp(rgb, 0.0, 1.0), vec3(1.0 / 2.2));
+}
+
+void main()
+{
+    if (scalePass == 2) {
+        // Vertical pass over the horizontally scaled RGB, which is still
+        // in the source transfer so tone mapping runs once per output pixel
+        vec3 rgb = sampleKernel(texY, vTexCoord, vec2(0.0, 1.0)).rgb;
+        if (transferMode != 0)
+            rgb = toneMap(rgb);
+        fragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);
+        return;
+    }
+
+    if (layoutMode == 0) {
+        vec4 c = samplePlane(texY, vTexCoord);
+        fragColor = scalePass == 1 ? c : clamp(c, 0.0, 1.0);
+        return;
+    }
+
+    vec3 yuv;
+    yuv.x = samplePlane(texY, vTexCoord).r;
+    if (layoutMode == 1) {
+        yuv.y = samplePlane(texU, vTexCoord).r;
+        yuv.z = samplePlane(texV, vTexCoord).r;
+    } else {
+        yuv.yz = samplePlane(texU, vTexCoord).rg;
+    }
+
+    vec3 rgb = mat3(yuvMatrix) * (yuv * sampleScale - yuvOffset.xyz);
+    if (scalePass == 1) {
+        // Unclamped, so the vertical pass filters the kernel's overshoot
+        fragColor = vec4(rgb, 1.0);
+        return;
+    }
+    if (transferMode != 0)
+        rgb = toneMap(rgb);
+    fragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
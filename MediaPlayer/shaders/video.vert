@@ -0,0 +1,29 @@
+#version 440
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texCoord;
+
+layout(location = 0) out vec2 vTexCoord;
+
+layout(std140, binding = 0) uniform buf {
+    mat4  mvp;
+    mat4  yuvMatrix;      // mat3 padded to mat4 for std140
+    vec4  yuvOffset;
+    float sampleScale;
+    int   layoutMode;     // 0 = RGBA, 1 = Y/U/V planes, 2 = Y + interleaved UV
+    int   filterMode;     // 0 = point, 1 = bilinear, 2 = bicubic, 3 = Lanczos-3
+    int   transferMode;   // 0 = SDR, 1 = PQ, 2 = HLG
+    int   toneMapper;     // 1 = Hable, 2 = BT.2390
+    int   gamutMode;      // 1 = BT.2020 -> BT.709
+    float srcPeak;        // source peak / SDR reference white
+    int   scalePass;      // 0 = single pass, 1 = horizontal kernel pass, 2 = vertical
+    float dstExtent;      // output pixels along the axis the kernel pass filters
+};
+
+out gl_PerVertex { vec4 gl_Position; };
+
+void main()
+{
+    vTexCoord = texCoord;
+    gl_Position = mvp * vec4(position, 0.0, 1.0);
+}
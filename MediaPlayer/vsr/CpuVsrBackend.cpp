@@ -0,0 +1,516 @@
+#include "CpuVsrBackend.h"
+#include "DecoderThreadingPolicy.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+/// Catmull-Rom (B = 0, C = 0.5), support [-2, 2]
+float cubicWeight(double x)
+{
+    x = std::abs(x);
+    if (x < 1.0)
+        return static_cast<float>((1.5 * x - 2.5) * x * x + 1.0);
+    if (x < 2.0)
+        return static_cast<float>(((-0.5 * x + 2.5) * x - 4.0) * x + 2.0);
+    return 0.0f;
+}
+
+/// AMD FidelityFX CAS on one pixel and its 4-neighbourhood.  Sharpening is
+/// scaled down where the neighbourhood already spans most of the range, so
+/// strong edges do not ring and flat areas do not amplify noise.
+inline float casPixel(float c, float n, float s, float w, float e, float peak)
+{
+    const float mn = std::min(std::min(std::min(n, s), std::min(w, e)), c);
+    const float mx = std::max(std::max(std::max(n, s), std::max(w, e)), c);
+    const float headroom = std::min(mn, 1.0f - mx) / std::max(mx, 1e-5f);
+    const float amp = std::sqrt(std::clamp(headroom, 0.0f, 1.0f));
+    const float wgt = amp * peak;
+    return std::clamp((c + wgt * (n + s + w + e)) / (1.0f + 4.0f * wgt), 0.0f, 1.0f);
+}
+
+void casRow(const float *__restrict up, const float *__restrict cur, const float *__restrict dn,
+            int width, float sharpness, float *__restrict out)
+{
+    const float peak = -1.0f / (8.0f - 3.0f * sharpness);
+    if (width == 1) {
+        out[0] = casPixel(cur[0], up[0], dn[0], cur[0], cur[0], peak);
+        return;
+    }
+    out[0] = casPixel(cur[0], up[0], dn[0], cur[0], cur[1], peak);
+    for (int x = 1; x < width - 1; ++x)
+        out[x] = casPixel(cur[x], up[x], dn[x], cur[x - 1], cur[x + 1], peak);
+    out[width - 1] = casPixel(cur[width - 1], up[width - 1], dn[width - 1],
+                              cur[width - 2], cur[width - 1], peak);
+}
+
+inline uint8_t toByte(float v)
+{
+    return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+} // namespace
+
+CpuVsrBackend::CpuVsrBackend() = default;
+
+CpuVsrBackend::~CpuVsrBackend()
+{
+    shutdown();
+    m_bandTasks.wait();   // late helpers only check their batch and return
+}
+
+bool CpuVsrBackend::isInitialized() const
+{
+    return m_initialized;
+}
+
+bool CpuVsrBackend::initialize(int inputWidth,
+                               int inputHeight,
+                               int outputWidth,
+                               int outputHeight,
+                               int quality,
+                               int /*pixelFormat*/,
+                               int /*adapterIndex*/)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastError.clear();
+
+    if (inputWidth <= 0 || inputHeight <= 0 || outputWidth <= 0 || outputHeight <= 0) {
+        m_lastError = QStringLiteral("Invalid frame dimensions for VSR init");
+        return false;
+    }
+
+    // Quality 0 is plain (anti-ringed) bicubic; higher levels add CAS.
+    static constexpr float kSharpness[] = { 0.0f, 0.3f, 0.5f, 0.7f, 0.9f };
+    m_sharpness      = kSharpness[std::clamp(quality, 0, 4)];
+    m_sharpenDropped = false;
+    m_frameMsAvg     = 0.0;
+
+    m_inWidth   = inputWidth;
+    m_inHeight  = inputHeight;
+    m_outWidth  = outputWidth;
+    m_outHeight = outputHeight;
+    buildTables();
+
+    m_initialized = true;
+    qDebug() << "CpuVsrBackend: initialized"
+             << inputWidth << "x" << inputHeight
+             << "->" << outputWidth << "x" << outputHeight
+             << "sharpness:" << m_sharpness;
+    return true;
+}
+
+void CpuVsrBackend::shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scratch.clear();
+    m_hTaps.clear();
+    m_vTaps.clear();
+    m_hChroma.clear();
+    m_vChroma.clear();
+    m_initialized = false;
+    m_inWidth   = 0;
+    m_inHeight  = 0;
+    m_outWidth  = 0;
+    m_outHeight = 0;
+}
+
+bool CpuVsrBackend::processFrameToBgra(const AVFrame *inFrame,
+                                       uint8_t *outBgra,
+                                       int outStride,
+                                       int outWidth,
+                                       int outHeight)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastError.clear();
+
+    if (!m_initialized) {
+        m_lastError = QStringLiteral("CPU VSR is not initialized");
+        return false;
+    }
+    if (!inFrame || !outBgra || outWidth != m_outWidth || outHeight != m_outHeight
+        || outStride < outWidth * 4) {
+        m_lastError = QStringLiteral("Invalid frame/buffer arguments");
+        return false;
+    }
+    if (inFrame->width != m_inWidth || inFrame->height != m_inHeight) {
+        m_lastError = QStringLiteral("Input size does not match initialize()");
+        return false;
+    }
+    if (!supportsInputFormat(static_cast<AVPixelFormat>(inFrame->format))) {
+        m_lastError = QStringLiteral("Unsupported input format for CPU VSR");
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    FrameView view = describe(inFrame);
+    view.sharpness = m_sharpenDropped ? 0.0f : m_sharpness;
+
+    const int bands = (m_outHeight + kBandRows - 1) / kBandRows;
+    const std::function<void(int, int)> job = [&](int band, int slot) {
+        processBand(view, band, m_scratch[static_cast<size_t>(slot)], outBgra, outStride);
+    };
+    runBands(bands, job);
+
+    // Keep the cost bounded: if the machine cannot sustain the full
+    // pipeline, fall back to the (much cheaper) unsharpened upscale.
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start).count();
+    m_frameMsAvg = m_frameMsAvg > 0.0 ? m_frameMsAvg * 0.9 + ms * 0.1 : ms;
+    if (!m_sharpenDropped && m_sharpness > 0.0f && m_frameMsAvg > kFrameBudgetMs) {
+        m_sharpenDropped = true;
+        qDebug() << "CpuVsrBackend: average" << m_frameMsAvg << "ms over the"
+                 << kFrameBudgetMs << "ms budget, dropping sharpening";
+    }
+    return true;
+}
+
+QString CpuVsrBackend::lastError() const
+{
+    return m_lastError;
+}
+
+bool CpuVsrBackend::supportsInputFormat(AVPixelFormat fmt) const
+{
+    switch (fmt) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+    case AV_PIX_FMT_YUV420P10LE:
+    case AV_PIX_FMT_NV12:
+    case AV_PIX_FMT_P010LE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// ── Tables ─────────────────────────────────────────────────
+
+CpuVsrBackend::Taps CpuVsrBackend::cubicTaps(double pos, int size)
+{
+    const double base = std::floor(pos);
+    const double f = pos - base;
+    Taps t{};
+    for (int k = 0; k < 4; ++k) {
+        t.index[k]  = std::clamp(static_cast<int>(base) - 1 + k, 0, size - 1);
+        t.weight[k] = cubicWeight(static_cast<double>(k - 1) - f);
+    }
+    return t;
+}
+
+CpuVsrBackend::Lerp CpuVsrBackend::lerpTaps(double pos, int size)
+{
+    pos = std::clamp(pos, 0.0, static_cast<double>(size - 1));
+    Lerp l;
+    l.index0 = static_cast<int>(pos);
+    l.index1 = std::min(l.index0 + 1, size - 1);
+    l.frac   = static_cast<float>(pos - l.index0);
+    return l;
+}
+
+void CpuVsrBackend::buildTables()
+{
+    const double sx = static_cast<double>(m_inWidth) / m_outWidth;
+    const double sy = static_cast<double>(m_inHeight) / m_outHeight;
+    const int chromaW = (m_inWidth + 1) / 2;
+    const int chromaH = (m_inHeight + 1) / 2;
+
+    m_hTaps.resize(static_cast<size_t>(m_outWidth));
+    m_hChroma.resize(static_cast<size_t>(m_outWidth));
+    for (int x = 0; x < m_outWidth; ++x) {
+        const double pos = (x + 0.5) * sx - 0.5;
+        m_hTaps[x]   = cubicTaps(pos, m_inWidth);
+        m_hChroma[x] = lerpTaps(pos * 0.5, chromaW);             // left-sited chroma
+    }
+
+    m_vTaps.resize(static_cast<size_t>(m_outHeight));
+    m_vChroma.resize(static_cast<size_t>(m_outHeight));
+    for (int y = 0; y < m_outHeight; ++y) {
+        const double pos = (y + 0.5) * sy - 0.5;
+        m_vTaps[y]   = cubicTaps(pos, m_inHeight);
+        m_vChroma[y] = lerpTaps((pos - 0.5) * 0.5, chromaH);     // centred between rows
+    }
+}
+
+CpuVsrBackend::FrameView CpuVsrBackend::describe(const AVFrame *frame)
+{
+    FrameView v;
+    v.frame = frame;
+
+    int depth = 8;
+    switch (static_cast<AVPixelFormat>(frame->format)) {
+    case AV_PIX_FMT_NV12:
+        v.interleaved = true;
+        break;
+    case AV_PIX_FMT_P010LE:
+        v.interleaved = true;
+        v.wide = true;
+        v.shift = 6;
+        depth = 10;
+        break;
+    case AV_PIX_FMT_YUV420P10LE:
+        v.wide = true;
+        depth = 10;
+        break;
+    default:
+        break;
+    }
+
+    const float maxCode = static_cast<float>((1 << depth) - 1);
+    const float unit    = static_cast<float>(1 << (depth - 8));
+    v.scale = 1.0f / maxCode;
+
+    const bool fullRange = frame->color_range == AVCOL_RANGE_JPEG
+                           || frame->format == AV_PIX_FMT_YUVJ420P;
+    v.cOffset = 128.0f * unit / maxCode;
+    if (fullRange) {
+        v.yOffset = 0.0f;
+        v.yScale = v.cScale = 1.0f;
+    } else {
+        v.yOffset = 16.0f * unit / maxCode;
+        v.yScale  = maxCode / (219.0f * unit);
+        v.cScale  = maxCode / (224.0f * unit);
+    }
+
+    // Same matrix selection as the OpenGL shader path
+    float kr = 0.2126f, kb = 0.0722f;
+    switch (frame->colorspace) {
+    case AVCOL_SPC_BT709:
+        break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+        kr = 0.2627f; kb = 0.0593f;
+        break;
+    case AVCOL_SPC_BT470BG:
+    case AVCOL_SPC_SMPTE170M:
+        kr = 0.299f;  kb = 0.114f;
+        break;
+    default:
+        if (frame->height < 720) { kr = 0.299f; kb = 0.114f; }
+        break;
+    }
+    const float kg = 1.0f - kr - kb;
+    v.rv = 2.0f * (1.0f - kr);
+    v.gu = -2.0f * kb * (1.0f - kb) / kg;
+    v.gv = -2.0f * kr * (1.0f - kr) / kg;
+    v.bu = 2.0f * (1.0f - kb);
+    return v;
+}
+
+// ── Per-band processing ────────────────────────────────────
+
+void CpuVsrBackend::loadRow(const FrameView &view, int row, float *dst) const
+{
+    const AVFrame *f = view.frame;
+    const uint8_t *src = f->data[0] + static_cast<ptrdiff_t>(row) * f->linesize[0];
+    const float scale = view.scale;
+    if (view.wide) {
+        const int shift = view.shift;
+        for (int x = 0; x < m_inWidth; ++x) {
+            uint16_t v;
+            std::memcpy(&v, src + 2 * x, sizeof(v));
+            dst[x] = static_cast<float>(v >> shift) * scale;
+        }
+    } else {
+        for (int x = 0; x < m_inWidth; ++x)
+            dst[x] = static_cast<float>(src[x]) * scale;
+    }
+}
+
+void CpuVsrBackend::loadChromaRow(const FrameView &view, int row, float *u, float *v) const
+{
+    const AVFrame *f = view.frame;
+    const int chromaW = (m_inWidth + 1) / 2;
+    const float scale = view.scale;
+    const uint8_t *p1 = f->data[1] + static_cast<ptrdiff_t>(row) * f->linesize[1];
+
+    if (view.interleaved) {
+        if (view.wide) {
+            const int shift = view.shift;
+            for (int x = 0; x < chromaW; ++x) {
+                uint16_t uv[2];
+                std::memcpy(uv, p1 + 4 * x, sizeof(uv));
+                u[x] = static_cast<float>(uv[0] >> shift) * scale;
+                v[x] = static_cast<float>(uv[1] >> shift) * scale;
+            }
+        } else {
+            for (int x = 0; x < chromaW; ++x) {
+                u[x] = static_cast<float>(p1[2 * x]) * scale;
+                v[x] = static_cast<float>(p1[2 * x + 1]) * scale;
+            }
+        }
+        return;
+    }
+
+    const uint8_t *p2 = f->data[2] + static_cast<ptrdiff_t>(row) * f->linesize[2];
+    if (view.wide) {
+        for (int x = 0; x < chromaW; ++x) {
+            uint16_t a, b;
+            std::memcpy(&a, p1 + 2 * x, sizeof(a));
+            std::memcpy(&b, p2 + 2 * x, sizeof(b));
+            u[x] = static_cast<float>(a) * scale;
+            v[x] = static_cast<float>(b) * scale;
+        }
+    } else {
+        for (int x = 0; x < chromaW; ++x) {
+            u[x] = static_cast<float>(p1[x]) * scale;
+            v[x] = static_cast<float>(p2[x]) * scale;
+        }
+    }
+}
+
+void CpuVsrBackend::processBand(const FrameView &view, int band, Scratch &s,
+                                uint8_t *out, int outStride) const
+{
+    const int width = m_outWidth;
+    const int y0 = band * kBandRows;
+    const int y1 = std::min(y0 + kBandRows, m_outHeight);
+    if (y0 >= y1) return;
+
+    // CAS needs one scaled luma row above and below the band.
+    const bool sharpen = view.sharpness > 0.0f;
+    const int ly0 = sharpen ? std::max(y0 - 1, 0) : y0;
+    const int ly1 = sharpen ? std::min(y1 + 1, m_outHeight) : y1;
+
+    // ── 1. Horizontal pass over every source row the band touches ──
+    const int sr0 = m_vTaps[ly0].index[0];
+    const int sr1 = m_vTaps[ly1 - 1].index[3];
+    const int srcRows = sr1 - sr0 + 1;
+    s.srcRow.resize(static_cast<size_t>(m_inWidth));
+    s.hRows.resize(static_cast<size_t>(srcRows) * width);
+
+    for (int r = 0; r < srcRows; ++r) {
+        loadRow(view, sr0 + r, s.srcRow.data());
+        const float *src = s.srcRow.data();
+        float *dst = s.hRows.data() + static_cast<size_t>(r) * width;
+        for (int x = 0; x < width; ++x) {
+            const Taps &t = m_hTaps[x];
+            const float a = src[t.index[1]];
+            const float b = src[t.index[2]];
+            const float v = t.weight[0] * src[t.index[0]] + t.weight[1] * a
+                          + t.weight[2] * b + t.weight[3] * src[t.index[3]];
+            // Anti-ringing: stay within the two nearest source samples
+            dst[x] = std::min(std::max(v, std::min(a, b)), std::max(a, b));
+        }
+    }
+
+    // ── 2. Vertical pass (contiguous rows, vectorisable) ──
+    s.luma.resize(static_cast<size_t>(ly1 - ly0) * width);
+    for (int y = ly0; y < ly1; ++y) {
+        const Taps &t = m_vTaps[y];
+        const float *__restrict r0 = s.hRows.data() + static_cast<size_t>(t.index[0] - sr0) * width;
+        const float *__restrict r1 = s.hRows.data() + static_cast<size_t>(t.index[1] - sr0) * width;
+        const float *__restrict r2 = s.hRows.data() + static_cast<size_t>(t.index[2] - sr0) * width;
+        const float *__restrict r3 = s.hRows.data() + static_cast<size_t>(t.index[3] - sr0) * width;
+        float *__restrict dst = s.luma.data() + static_cast<size_t>(y - ly0) * width;
+        const float w0 = t.weight[0], w1 = t.weight[1], w2 = t.weight[2], w3 = t.weight[3];
+        for (int x = 0; x < width; ++x) {
+            const float v = w0 * r0[x] + w1 * r1[x] + w2 * r2[x] + w3 * r3[x];
+            dst[x] = std::min(std::max(v, std::min(r1[x], r2[x])), std::max(r1[x], r2[x]));
+        }
+    }
+
+    // ── 3. Chroma rows for the band, as float ──
+    const int chromaW = (m_inWidth + 1) / 2;
+    const int cr0 = m_vChroma[y0].index0;
+    const int cr1 = m_vChroma[y1 - 1].index1;
+    const int chromaRows = cr1 - cr0 + 1;
+    s.chromaU.resize(static_cast<size_t>(chromaRows) * chromaW);
+    s.chromaV.resize(static_cast<size_t>(chromaRows) * chromaW);
+    for (int r = 0; r < chromaRows; ++r) {
+        loadChromaRow(view, cr0 + r,
+                      s.chromaU.data() + static_cast<size_t>(r) * chromaW,
+                      s.chromaV.data() + static_cast<size_t>(r) * chromaW);
+    }
+
+    // ── 4. Sharpen, upsample chroma, convert, store ──
+    s.sharp.resize(static_cast<size_t>(width));
+    for (int y = y0; y < y1; ++y) {
+        const float *luma = s.luma.data() + static_cast<size_t>(y - ly0) * width;
+        if (sharpen) {
+            const float *up = s.luma.data() + static_cast<size_t>(std::max(y - 1, ly0) - ly0) * width;
+            const float *dn = s.luma.data() + static_cast<size_t>(std::min(y + 1, ly1 - 1) - ly0) * width;
+            casRow(up, luma, dn, width, view.sharpness, s.sharp.data());
+            luma = s.sharp.data();
+        }
+
+        const Lerp &vy = m_vChroma[y];
+        const float *u0 = s.chromaU.data() + static_cast<size_t>(vy.index0 - cr0) * chromaW;
+        const float *u1 = s.chromaU.data() + static_cast<size_t>(vy.index1 - cr0) * chromaW;
+        const float *v0 = s.chromaV.data() + static_cast<size_t>(vy.index0 - cr0) * chromaW;
+        const float *v1 = s.chromaV.data() + static_cast<size_t>(vy.index1 - cr0) * chromaW;
+        const float fy = vy.frac;
+
+        uint8_t *dst = out + static_cast<ptrdiff_t>(y) * outStride;
+        for (int x = 0; x < width; ++x) {
+            const Lerp &hx = m_hChroma[x];
+            const float ut = u0[hx.index0] + (u0[hx.index1] - u0[hx.index0]) * hx.frac;
+            const float ub = u1[hx.index0] + (u1[hx.index1] - u1[hx.index0]) * hx.frac;
+            const float vt = v0[hx.index0] + (v0[hx.index1] - v0[hx.index0]) * hx.frac;
+            const float vb = v1[hx.index0] + (v1[hx.index1] - v1[hx.index0]) * hx.frac;
+
+            const float yy = (luma[x] - view.yOffset) * view.yScale;
+            const float cu = (ut + (ub - ut) * fy - view.cOffset) * view.cScale;
+            const float cv = (vt + (vb - vt) * fy - view.cOffset) * view.cScale;
+
+            dst[4 * x + 0] = toByte(yy + view.rv * cv);
+            dst[4 * x + 1] = toByte(yy + view.gu * cu + view.gv * cv);
+            dst[4 * x + 2] = toByte(yy + view.bu * cu);
+            dst[4 * x + 3] = 255;
+        }
+    }
+}
+
+// ── Band tasks ─────────────────────────────────────────────
+
+void CpuVsrBackend::runBands(int count, const std::function<void(int, int)> &job)
+{
+    // The decoder of this player already runs on its share of the cores;
+    // the upscale gets the same share, the calling thread included.
+    const int players = std::max(1, DecoderThreadingPolicy::activePlayers());
+    const int helpers = std::clamp(DecoderThreadingPolicy::coresPerPlayer(players) - 1,
+                                   0, std::max(0, count - 1));
+    if (m_scratch.size() < static_cast<size_t>(helpers) + 1)
+        m_scratch.resize(static_cast<size_t>(helpers) + 1);
+
+    auto batch = std::make_shared<BandBatch>();
+    batch->job   = &job;
+    batch->count = count;
+    for (int i = 0; i < helpers; ++i) {
+        PipelineExecutor::instance().submit(PipelineExecutor::Lane::Video, [batch, slot = i + 1] {
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (batch->closed) return;
+                ++batch->running;
+            }
+            drainBands(*batch, slot);
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                --batch->running;
+            }
+            batch->cv.notify_all();
+        }, &m_bandTasks);
+    }
+
+    // Never wait for a helper to start: the calling thread takes every band
+    // no helper got to, then only waits for the helpers already inside.
+    drainBands(*batch, 0);
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->closed = true;
+    batch->cv.wait(lock, [&batch] { return batch->running == 0; });
+}
+
+void CpuVsrBackend::drainBands(BandBatch &batch, int slot)
+{
+    for (int band = batch.next.fetch_add(1, std::memory_order_relaxed);
+         band < batch.count;
+         band = batch.next.fetch_add(1, std::memory_order_relaxed)) {
+        (*batch.job)(band, slot);
+    }
+}
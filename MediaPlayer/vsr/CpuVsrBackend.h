@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "PipelineExecutor.h"
+#include "VsrBackend.h"
+
+/// @brief Portable super-resolution fallback for machines without RTX VSR.
+///
+/// Luma is upscaled with a separable Catmull-Rom kernel whose output is
+/// clamped to the two nearest source samples on each axis (anti-ringing:
+/// edges stay sharp without halos), then sharpened with contrast-adaptive
+/// sharpening (CAS), which backs off where local contrast is already high.
+/// Chroma is upsampled bilinearly.  The result is converted to RGBA in the
+/// same pass.
+///
+/// All scaling coefficients are precomputed in initialize().  The inner
+/// loops run over contiguous float rows so the compiler can vectorise them.
+/// Output rows are split into bands.  The calling thread takes bands and
+/// helper tasks on the executor's Video lane take the rest; the helpers
+/// are sized from DecoderThreadingPolicy's per-player core budget, so the
+/// upscale shares the player's cores with its decoder instead of adding
+/// threads of its own.  If the average frame time goes over the budget,
+/// sharpening is dropped, which keeps the per-frame cost bounded.
+class CpuVsrBackend : public VsrBackend
+{
+public:
+    CpuVsrBackend();
+    ~CpuVsrBackend() override;
+
+    CpuVsrBackend(const CpuVsrBackend &) = delete;
+    CpuVsrBackend &operator=(const CpuVsrBackend &) = delete;
+
+    // ── VsrBackend ──
+    const char *name() const override { return "CPU"; }
+    bool isInitialized() const override;
+
+    int inWidth()  const override { return m_inWidth; }
+    int inHeight() const override { return m_inHeight; }
+    int outWidth()  const override { return m_outWidth; }
+    int outHeight() const override { return m_outHeight; }
+
+    bool initialize(int inputWidth,
+                    int inputHeight,
+                    int outputWidth,
+                    int outputHeight,
+                    int quality,
+                    int pixelFormat = 0,
+                    int adapterIndex = -1) override;
+
+    void shutdown() override;
+
+    bool processFrameToBgra(const AVFrame *inFrame,
+                            uint8_t *outBgra,
+                            int outStride,
+                            int outWidth,
+                            int outHeight) override;
+
+    QString lastError() const override;
+
+    bool supportsInputFormat(AVPixelFormat fmt) const override;
+
+private:
+    /// Four-tap filter position for one output coordinate.
+    struct Taps {
+        int   index[4];    ///< clamped source indices (base - 1 … base + 2)
+        float weight[4];
+    };
+
+    /// Two-tap bilinear position (chroma).
+    struct Lerp {
+        int   index0 = 0;
+        int   index1 = 0;
+        float frac   = 0.0f;
+    };
+
+    /// Per-thread scratch rows, reused across frames.
+    struct Scratch {
+        std::vector<float> srcRow;     ///< one source row converted to float
+        std::vector<float> hRows;      ///< horizontally scaled source rows
+        std::vector<float> luma;       ///< scaled luma rows (band ± 1 for CAS)
+        std::vector<float> sharp;      ///< one sharpened luma row
+        std::vector<float> chromaU;    ///< source chroma rows as float
+        std::vector<float> chromaV;
+    };
+
+    /// Source description for one frame, resolved on the calling thread.
+    struct FrameView {
+        const AVFrame *frame = nullptr;
+        bool  wide        = false;   ///< 16-bit samples
+        int   shift       = 0;       ///< P010: 10 bits in the MSBs
+        bool  interleaved = false;   ///< NV12 / P010 chroma
+        float scale       = 1.0f / 255.0f;
+        // YUV → RGB
+        float yOffset = 0.0f, yScale = 1.0f, cOffset = 0.5f, cScale = 1.0f;
+        float rv = 0.0f, gu = 0.0f, gv = 0.0f, bu = 0.0f;
+        float sharpness = 0.0f;      ///< CAS strength for this frame
+    };
+
+    void buildTables();
+    static Taps cubicTaps(double pos, int size);
+    static Lerp lerpTaps(double pos, int size);
+    static FrameView describe(const AVFrame *frame);
+
+    void processBand(const FrameView &view, int band, Scratch &scratch,
+                     uint8_t *out, int outStride) const;
+    void loadRow(const FrameView &view, int row, float *dst) const;
+    void loadChromaRow(const FrameView &view, int row, float *u, float *v) const;
+
+    // ── Band tasks ──
+    /// One frame's bands.  Owned jointly by the calling thread and the
+    /// helper tasks; a helper that starts after the frame was finished
+    /// sees `closed` and returns without touching the job.
+    struct BandBatch {
+        const std::function<void(int, int)> *job = nullptr;
+        int              count = 0;
+        std::atomic<int> next{0};
+        std::mutex              mutex;
+        std::condition_variable cv;
+        int  running = 0;       ///< helpers inside drainBands()
+        bool closed  = false;   ///< calling thread is done; no helper may join
+    };
+
+    /// Run job(band, scratchSlot) for every band in [0, count) and wait.
+    void runBands(int count, const std::function<void(int, int)> &job);
+    static void drainBands(BandBatch &batch, int slot);
+
+    mutable std::mutex m_mutex;   ///< serialises initialize / shutdown / process
+    QString m_lastError;
+
+    int m_inWidth   = 0;
+    int m_inHeight  = 0;
+    int m_outWidth  = 0;
+    int m_outHeight = 0;
+    bool m_initialized = false;
+
+    float m_sharpness = 0.0f;      ///< CAS strength, 0 disables the pass
+    bool  m_sharpenDropped = false;
+    double m_frameMsAvg = 0.0;
+    static constexpr double kFrameBudgetMs = 12.0;
+    static constexpr int    kBandRows      = 32;
+
+    std::vector<Taps> m_hTaps;     ///< per output column (luma)
+    std::vector<Taps> m_vTaps;     ///< per output row (luma)
+    std::vector<Lerp> m_hChroma;   ///< per output column
+    std::vector<Lerp> m_vChroma;   ///< per output row
+
+    std::vector<Scratch> m_scratch;   ///< [0] = calling thread, [i] = helper i
+    PipelineExecutor::TaskGroup m_bandTasks;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+/// @brief Video super-resolution backend used by FrameHandler.
+///
+/// A backend upscales a decoded frame to the configured output size and
+/// writes 8-bit, 4-channel pixels into a caller-supplied buffer.  The byte
+/// order is the one FrameHandler presents as Format_RGBA8888.  Calls may come
+/// from the decode thread and from a warm-up thread, so implementations
+/// serialise initialize() / shutdown() / processFrameToBgra() internally.
+class VsrBackend
+{
+public:
+    virtual ~VsrBackend() = default;
+
+    /// Short name for logs and stats ("RTX", "CPU").  Must be a string
+    /// literal: it is published through an atomic pointer.
+    virtual const char *name() const = 0;
+
+    virtual bool isInitialized() const = 0;
+
+    virtual int inWidth()  const = 0;
+    virtual int inHeight() const = 0;
+    virtual int outWidth()  const = 0;
+    virtual int outHeight() const = 0;
+
+    /// (Re-)configure for the given input / output sizes.  @p quality is
+    /// 0 (plain bicubic) … 4 (highest); @p pixelFormat uses the RTX bridge
+    /// numbering (0 = NV12, 1 = P010) and may be ignored.
+    virtual bool initialize(int inputWidth,
+                            int inputHeight,
+                            int outputWidth,
+                            int outputHeight,
+                            int quality,
+                            int pixelFormat = 0,
+                            int adapterIndex = -1) = 0;
+
+    virtual void shutdown() = 0;
+
+    /// Upscale @p inFrame into @p outBgra (outHeight rows of outStride bytes).
+    virtual bool processFrameToBgra(const AVFrame *inFrame,
+                                    uint8_t *outBgra,
+                                    int outStride,
+                                    int outWidth,
+                                    int outHeight) = 0;
+
+    virtual QString lastError() const = 0;
+
+    virtual bool supportsInputFormat(AVPixelFormat fmt) const = 0;
+
+    /// True when initialize() is slow enough (GPU / driver setup) to be worth
+    /// running ahead of the first frame on a background thread.
+    virtual bool needsWarmUp() const { return false; }
+};
@@ -0,0 +1,66 @@
+#include "VsrWorker.h"
+
+VsrWorker::~VsrWorker()
+{
+    stop();
+}
+
+void VsrWorker::submit(std::function<void()> job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_pending) {
+        if (!m_running)
+            runOne(lock);   // its task has no worker yet
+        else
+            m_cv.wait(lock);
+    }
+    m_pending = std::move(job);
+    if (m_scheduled)
+        return;   // the running task picks it up
+
+    m_scheduled = true;
+    lock.unlock();
+    PipelineExecutor::instance().submit(PipelineExecutor::Lane::Video,
+                                        [this] { runPending(); }, &m_task);
+}
+
+void VsrWorker::drain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_pending || m_running) {
+        if (m_pending && !m_running)
+            runOne(lock);
+        else
+            m_cv.wait(lock);
+    }
+}
+
+void VsrWorker::stop()
+{
+    drain();
+    m_task.wait();
+}
+
+void VsrWorker::runPending()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_pending && !m_running)
+        runOne(lock);
+    m_scheduled = false;
+    m_cv.notify_all();
+}
+
+void VsrWorker::runOne(std::unique_lock<std::mutex> &lock)
+{
+    std::function<void()> job = std::move(m_pending);
+    m_pending = nullptr;
+    m_running = true;
+    lock.unlock();
+    m_cv.notify_all();   // the slot is free again
+
+    job();
+
+    lock.lock();
+    m_running = false;
+    m_cv.notify_all();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "PipelineExecutor.h"
+
+/// @brief Single-slot job queue drained on the shared PipelineExecutor.
+///
+/// FrameHandler hands each VSR frame to it so the upscale of frame N runs
+/// while the decode stage decodes and paces frame N + 1.  At most one job
+/// runs and one waits; submit() blocks while the slot is taken, which
+/// bounds latency to a frame and applies back-pressure to the decoder.
+/// The executor caps its workers, so a waiting job may have no worker
+/// yet: submit() and drain() then run it themselves instead of waiting.
+class VsrWorker
+{
+public:
+    VsrWorker() = default;
+    ~VsrWorker();
+
+    VsrWorker(const VsrWorker &) = delete;
+    VsrWorker &operator=(const VsrWorker &) = delete;
+
+    /// Queue @p job; an executor task runs it as soon as the slot frees up.
+    void submit(std::function<void()> job);
+
+    /// Block until no job is queued or running.
+    void drain();
+
+    /// Finish the queued job and wait for the executor task to return.
+    void stop();
+
+private:
+    void runPending();
+    /// Run m_pending on this thread; @p lock is held on entry and exit.
+    void runOne(std::unique_lock<std::mutex> &lock);
+
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    std::function<void()>   m_pending;
+    bool                    m_scheduled = false;   ///< a runPending() task is queued or running
+    bool                    m_running   = false;   ///< a job is running, on any thread
+    PipelineExecutor::TaskGroup m_task;
+};
@@ -0,0 +1,271 @@
+#include "BenchCorpus.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <memory>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavfilter/avfilter.h>
+#include <libavfilter/buffersink.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+/// One encoded stream: a lavfi source graph feeding an encoder.
+struct Track {
+    AVFilterGraph   *graph  = nullptr;
+    AVFilterContext *sink   = nullptr;
+    AVCodecContext  *enc    = nullptr;
+    AVStream        *stream = nullptr;
+    int64_t          nextPts = 0;   ///< enc->time_base
+    bool             done    = false;
+
+    Track() = default;
+    Track(const Track &) = delete;
+    Track &operator=(const Track &) = delete;
+    ~Track()
+    {
+        avfilter_graph_free(&graph);
+        avcodec_free_context(&enc);
+    }
+};
+
+/// Muxer + tracks; everything is released on every exit path.
+struct Writer {
+    AVFormatContext       *oc = nullptr;
+    std::unique_ptr<Track> video;
+    std::unique_ptr<Track> audio;
+    AVFrame               *frame = av_frame_alloc();
+    AVPacket              *pkt   = av_packet_alloc();
+
+    ~Writer()
+    {
+        av_frame_free(&frame);
+        av_packet_free(&pkt);
+        video.reset();
+        audio.reset();
+        if (oc) {
+            if (oc->pb) avio_closep(&oc->pb);
+            avformat_free_context(oc);
+        }
+    }
+};
+
+bool openSource(Track &track, const QString &description, bool audio)
+{
+    track.graph = avfilter_graph_alloc();
+    if (!track.graph) return false;
+
+    const AVFilter *sink = avfilter_get_by_name(audio ? "abuffersink" : "buffersink");
+    if (avfilter_graph_create_filter(&track.sink, sink, "out", nullptr, nullptr, track.graph) < 0)
+        return false;
+
+    AVFilterInOut *inputs  = avfilter_inout_alloc();
+    AVFilterInOut *outputs = nullptr;
+    if (!inputs) return false;
+    inputs->name       = av_strdup("out");
+    inputs->filter_ctx = track.sink;
+    inputs->pad_idx    = 0;
+    inputs->next       = nullptr;
+
+    const QByteArray desc = description.toUtf8();
+    const int ret = avfilter_graph_parse_ptr(track.graph, desc.constData(), &inputs, &outputs, nullptr);
+    avfilter_inout_free(&inputs);
+    avfilter_inout_free(&outputs);
+    if (ret < 0 || avfilter_graph_config(track.graph, nullptr) < 0) {
+        qWarning() << "BenchCorpus::openSource - cannot build" << description;
+        return false;
+    }
+    return true;
+}
+
+bool openEncoder(Writer &w, Track &track, const AVCodec *codec)
+{
+    // Single-threaded so the output (slice layout included) does not
+    // depend on the core count of the machine.
+    track.enc->thread_count = 1;
+    track.enc->flags |= AV_CODEC_FLAG_BITEXACT;
+    if (w.oc->oformat->flags & AVFMT_GLOBALHEADER)
+        track.enc->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    if (avcodec_open2(track.enc, codec, nullptr) < 0) {
+        qWarning() << "BenchCorpus::openEncoder - cannot open" << codec->name;
+        return false;
+    }
+    track.stream = avformat_new_stream(w.oc, nullptr);
+    if (!track.stream) return false;
+    track.stream->time_base = track.enc->time_base;
+    return avcodec_parameters_from_context(track.stream->codecpar, track.enc) >= 0;
+}
+
+bool addVideo(Writer &w, const BenchCorpus::Clip &clip, int seconds)
+{
+    const AVCodec *codec = avcodec_find_encoder_by_name(clip.videoCodec);
+    if (!codec) {
+        qWarning() << "BenchCorpus::addVideo - encoder not available:" << clip.videoCodec;
+        return false;
+    }
+    w.video = std::make_unique<Track>();
+    Track &t = *w.video;
+    t.enc = avcodec_alloc_context3(codec);
+    if (!t.enc) return false;
+
+    t.enc->width     = clip.width;
+    t.enc->height    = clip.height;
+    t.enc->pix_fmt   = clip.pixFmt;
+    t.enc->time_base = AVRational{1, clip.fps};
+    t.enc->framerate = AVRational{clip.fps, 1};
+    t.enc->gop_size  = clip.fps;   // a keyframe per second, like typical web video
+    t.enc->bit_rate  = static_cast<int64_t>(clip.width) * clip.height * clip.fps / 5;
+    if (codec->id == AV_CODEC_ID_MPEG4 || codec->id == AV_CODEC_ID_MPEG2VIDEO)
+        t.enc->max_b_frames = 2;
+    if (!openEncoder(w, t, codec)) return false;
+
+    const QString desc = QStringLiteral("testsrc2=size=%1x%2:rate=%3:duration=%4,format=%5")
+                             .arg(clip.width).arg(clip.height).arg(clip.fps).arg(seconds)
+                             .arg(QString::fromLatin1(av_get_pix_fmt_name(clip.pixFmt)));
+    return openSource(t, desc, false);
+}
+
+bool addAudio(Writer &w, const BenchCorpus::Clip &clip, int seconds)
+{
+    const AVCodec *codec = avcodec_find_encoder_by_name(clip.audioCodec);
+    if (!codec) {
+        qWarning() << "BenchCorpus::addAudio - encoder not available:" << clip.audioCodec;
+        return false;
+    }
+    w.audio = std::make_unique<Track>();
+    Track &t = *w.audio;
+    t.enc = avcodec_alloc_context3(codec);
+    if (!t.enc) return false;
+
+    t.enc->sample_rate = kSampleRate;
+    t.enc->sample_fmt  = clip.sampleFmt;
+    t.enc->bit_rate    = 192000;
+    t.enc->time_base   = AVRational{1, kSampleRate};
+    av_channel_layout_default(&t.enc->ch_layout, 2);
+    if (!openEncoder(w, t, codec)) return false;
+
+    const QString desc = QStringLiteral("sine=frequency=440:beep_factor=4:sample_rate=%1:duration=%2,"
+                                        "aformat=sample_fmts=%3:channel_layouts=stereo")
+                             .arg(kSampleRate).arg(seconds)
+                             .arg(QString::fromLatin1(av_get_sample_fmt_name(clip.sampleFmt)));
+    if (!openSource(t, desc, true)) return false;
+    if (t.enc->frame_size > 0 && !(codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
+        av_buffersink_set_frame_size(t.sink, static_cast<unsigned>(t.enc->frame_size));
+    return true;
+}
+
+bool drainEncoder(Writer &w, Track &t)
+{
+    for (;;) {
+        const int ret = avcodec_receive_packet(t.enc, w.pkt);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) return false;
+        av_packet_rescale_ts(w.pkt, t.enc->time_base, t.stream->time_base);
+        w.pkt->stream_index = t.stream->index;
+        if (av_interleaved_write_frame(w.oc, w.pkt) < 0) return false;
+    }
+}
+
+/// Pull one frame from @p t's source and encode it; flushes the encoder
+/// at the end of the source.
+bool step(Writer &w, Track &t)
+{
+    int ret = av_buffersink_get_frame(t.sink, w.frame);
+    if (ret == AVERROR_EOF) {
+        t.done = true;
+        avcodec_send_frame(t.enc, nullptr);
+        return drainEncoder(w, t);
+    }
+    if (ret < 0) return false;
+
+    w.frame->pts = av_rescale_q(w.frame->pts, av_buffersink_get_time_base(t.sink), t.enc->time_base);
+    w.frame->pict_type = AV_PICTURE_TYPE_NONE;
+    t.nextPts = w.frame->pts;
+    ret = avcodec_send_frame(t.enc, w.frame);
+    av_frame_unref(w.frame);
+    return ret >= 0 && drainEncoder(w, t);
+}
+
+bool generate(const BenchCorpus::Clip &clip, int seconds, const QString &path)
+{
+    Writer w;
+    if (!w.frame || !w.pkt) return false;
+
+    const QByteArray file = QFile::encodeName(path);
+    if (avformat_alloc_output_context2(&w.oc, nullptr, "matroska", file.constData()) < 0)
+        return false;
+    w.oc->flags |= AVFMT_FLAG_BITEXACT;
+
+    if (!addVideo(w, clip, seconds)) return false;
+    if (clip.audioCodec && !addAudio(w, clip, seconds)) return false;
+
+    if (avio_open(&w.oc->pb, file.constData(), AVIO_FLAG_WRITE) < 0) return false;
+    if (avformat_write_header(w.oc, nullptr) < 0) return false;
+
+    // Feed whichever track is behind so the muxer gets them interleaved.
+    Track *video = w.video.get();
+    Track *audio = w.audio.get();
+    while (!video->done || (audio && !audio->done)) {
+        Track *next = video;
+        if (video->done
+            || (audio && !audio->done
+                && av_compare_ts(audio->nextPts, audio->enc->time_base,
+                                 video->nextPts, video->enc->time_base) < 0))
+            next = audio;
+        if (!step(w, *next)) return false;
+    }
+
+    return av_write_trailer(w.oc) >= 0;
+}
+
+} // namespace
+
+namespace BenchCorpus {
+
+const std::vector<Clip> &defaultClips()
+{
+    static const std::vector<Clip> clips = {
+        {"mpeg4-720p30-aac",    "mpeg4",      AV_PIX_FMT_YUV420P,     1280,  720, 30, "aac", AV_SAMPLE_FMT_FLTP},
+        {"mpeg2-1080p25-mp2",   "mpeg2video", AV_PIX_FMT_YUV420P,     1920, 1080, 25, "mp2", AV_SAMPLE_FMT_S16},
+        {"mjpeg-1080p30-422",   "mjpeg",      AV_PIX_FMT_YUVJ422P,    1920, 1080, 30, nullptr, AV_SAMPLE_FMT_NONE},
+        {"ffv1-1080p30-10bit",  "ffv1",       AV_PIX_FMT_YUV420P10LE, 1920, 1080, 30, nullptr, AV_SAMPLE_FMT_NONE},
+    };
+    return clips;
+}
+
+QString ensure(const Clip &clip, int seconds, const QString &directory)
+{
+    const QString path = QDir(directory).filePath(
+        QStringLiteral("%1-%2s.mkv").arg(QString::fromLatin1(clip.name)).arg(seconds));
+    if (QFileInfo::exists(path))
+        return path;
+
+    if (!QDir().mkpath(directory)) {
+        qWarning() << "BenchCorpus::ensure - cannot create" << directory;
+        return {};
+    }
+
+    // Generate under a temporary name: an interrupted run must not leave a
+    // truncated file behind that later runs would pick up.
+    const QString partial = path + QStringLiteral(".part");
+    QFile::remove(partial);
+    qInfo().noquote() << "generating" << QDir::toNativeSeparators(path);
+    if (!generate(clip, seconds, partial) || !QFile::rename(partial, path)) {
+        qWarning() << "BenchCorpus::ensure - failed to generate" << clip.name;
+        QFile::remove(partial);
+        return {};
+    }
+    return path;
+}
+
+} // namespace BenchCorpus
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+#include <vector>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+#include <libavutil/samplefmt.h>
+}
+
+/// @brief Synthetic media files for zqt_bench, generated with libavfilter
+///        sources (testsrc2 / sine) and FFmpeg's native encoders.
+///
+/// Nothing is read from outside the process, encoding is bit-exact and the
+/// encoders are built into every FFmpeg configuration, so the same corpus
+/// comes out on any machine.  Files are written once into the corpus
+/// directory and reused by later runs.
+namespace BenchCorpus {
+
+struct Clip {
+    const char    *name;
+    const char    *videoCodec;   ///< encoder name
+    AVPixelFormat  pixFmt;
+    int            width;
+    int            height;
+    int            fps;
+    const char    *audioCodec;   ///< encoder name, nullptr = no audio
+    AVSampleFormat sampleFmt;    ///< format the audio encoder takes
+};
+
+/// The default clip set, one per FrameHandler conversion path: yuv420p
+/// (QVideoSink fast path) with audio at 720p and 1080p, 4:2:2 (sws to
+/// RGBA) and 10-bit 4:2:0 (sws to P010).
+const std::vector<Clip> &defaultClips();
+
+/// Path of @p clip rendered at @p seconds, generating it first when the
+/// file does not exist yet.  Returns an empty string on failure.
+QString ensure(const Clip &clip, int seconds, const QString &directory);
+
+} // namespace BenchCorpus
@@ -0,0 +1,486 @@
+#include "ScaleCompare.h"
+#include "FrameHandler.h"
+#include "VideoShaderUniforms.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonObject>
+#include <QOffscreenSurface>
+#include <rhi/qrhi.h>
+#include <cmath>
+#include <memory>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+
+constexpr double kDecodeAtSeconds = 1.0;   ///< skip the fade-in of testsrc2
+constexpr double kPsnrIdentical   = 99.0;
+
+constexpr SwsFilterMode kFilters[] = {
+    SwsFilterMode::Point,
+    SwsFilterMode::Bilinear,
+    SwsFilterMode::Bicubic,
+    SwsFilterMode::Lanczos,
+};
+
+const char *filterName(SwsFilterMode mode)
+{
+    switch (mode) {
+    case SwsFilterMode::Point:        return "point";
+    case SwsFilterMode::FastBilinear: return "fast-bilinear";
+    case SwsFilterMode::Bilinear:     return "bilinear";
+    case SwsFilterMode::Bicubic:      return "bicubic";
+    case SwsFilterMode::Lanczos:      return "lanczos";
+    }
+    return "?";
+}
+
+// ── CPU side ──
+
+/// RGBA copy of @p src at @p size.  @p sws is reused across calls.
+QImage swsScale(const QImage &src, const QSize &size, int flags, SwsContext *&sws)
+{
+    sws = sws_getCachedContext(sws, src.width(), src.height(), AV_PIX_FMT_RGBA,
+                               size.width(), size.height(), AV_PIX_FMT_RGBA,
+                               flags, nullptr, nullptr, nullptr);
+    if (!sws) return {};
+
+    QImage dst(size, QImage::Format_RGBA8888);
+    const uint8_t *srcData[4] = { src.constBits(), nullptr, nullptr, nullptr };
+    const int srcLinesize[4]  = { static_cast<int>(src.bytesPerLine()), 0, 0, 0 };
+    uint8_t *dstData[4]       = { dst.bits(), nullptr, nullptr, nullptr };
+    const int dstLinesize[4]  = { static_cast<int>(dst.bytesPerLine()), 0, 0, 0 };
+    sws_scale(sws, srcData, srcLinesize, 0, src.height(), dstData, dstLinesize);
+    return dst;
+}
+
+/// First video frame at or after kDecodeAtSeconds, as RGBA.
+QImage decodeReference(const QString &path)
+{
+    AVFormatContext *fmt = nullptr;
+    const QByteArray file = QFile::encodeName(path);
+    if (avformat_open_input(&fmt, file.constData(), nullptr, nullptr) < 0)
+        return {};
+    std::unique_ptr<AVFormatContext, void (*)(AVFormatContext *)> fmtGuard(
+        fmt, [](AVFormatContext *f) { avformat_close_input(&f); });
+    if (avformat_find_stream_info(fmt, nullptr) < 0)
+        return {};
+
+    const AVCodec *codec = nullptr;
+    const int index = av_find_best_stream(fmt, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (index < 0 || !codec)
+        return {};
+    const AVStream *stream = fmt->streams[index];
+
+    AVCodecContext *dec = avcodec_alloc_context3(codec);
+    std::unique_ptr<AVCodecContext, void (*)(AVCodecContext *)> decGuard(
+        dec, [](AVCodecContext *c) { avcodec_free_context(&c); });
+    if (!dec || avcodec_parameters_to_context(dec, stream->codecpar) < 0
+        || avcodec_open2(dec, codec, nullptr) < 0)
+        return {};
+
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    const int64_t at = static_cast<int64_t>(kDecodeAtSeconds / av_q2d(stream->time_base));
+
+    QImage image;
+    bool draining = false;
+    while (image.isNull()) {
+        if (!draining) {
+            const int ret = av_read_frame(fmt, pkt);
+            if (ret < 0) {
+                draining = true;
+                avcodec_send_packet(dec, nullptr);
+            } else {
+                if (pkt->stream_index == index)
+                    avcodec_send_packet(dec, pkt);
+                av_packet_unref(pkt);
+            }
+        }
+
+        while (avcodec_receive_frame(dec, frame) >= 0) {
+            const bool due = frame->best_effort_timestamp == AV_NOPTS_VALUE
+                          || frame->best_effort_timestamp >= at;
+            if (due && image.isNull()) {
+                // Full-precision conversion: this is the reference.
+                SwsContext *sws = sws_getContext(frame->width, frame->height,
+                                                 static_cast<AVPixelFormat>(frame->format),
+                                                 frame->width, frame->height, AV_PIX_FMT_RGBA,
+                                                 SWS_BICUBIC | SWS_ACCURATE_RND | SWS_FULL_CHR_H_INT,
+                                                 nullptr, nullptr, nullptr);
+                if (sws) {
+                    image = QImage(frame->width, frame->height, QImage::Format_RGBA8888);
+                    uint8_t *dstData[4]      = { image.bits(), nullptr, nullptr, nullptr };
+                    const int dstLinesize[4] = { static_cast<int>(image.bytesPerLine()), 0, 0, 0 };
+                    sws_scale(sws, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+                    sws_freeContext(sws);
+                }
+            }
+            av_frame_unref(frame);
+        }
+        if (draining)
+            break;   // the flushed decoder has handed out everything
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    return image;
+}
+
+/// PSNR of the RGB channels of @p image against @p reference, in dB.
+double psnr(const QImage &reference, const QImage &image)
+{
+    if (image.size() != reference.size())
+        return 0.0;
+
+    double sum = 0.0;
+    for (int y = 0; y < reference.height(); ++y) {
+        const uint8_t *a = reference.constScanLine(y);
+        const uint8_t *b = image.constScanLine(y);
+        for (int x = 0; x < reference.width() * 4; x += 4) {
+            for (int c = 0; c < 3; ++c) {
+                const double d = static_cast<double>(a[x + c]) - b[x + c];
+                sum += d * d;
+            }
+        }
+    }
+    const double mse = sum / (3.0 * reference.width() * reference.height());
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : kPsnrIdentical;
+}
+
+// ── GPU side ──
+
+QShader loadShader(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "ScaleCompare - cannot open shader" << path;
+        return {};
+    }
+    return QShader::fromSerialized(f.readAll());
+}
+
+/// video.frag drawn offscreen with an RGBA source texture (layout 0), so
+/// only the scaling kernel differs from the sws side.  Bicubic and Lanczos
+/// take the player's two passes: horizontal into an intermediate texture
+/// of (target width × source height), then vertical into the target.
+class GpuScaler
+{
+public:
+    /// False when no QRhi backend can be created (no GPU / GL context).
+    bool init(const QImage &source, const QSize &target)
+    {
+#if QT_CONFIG(opengl)
+        m_surface.reset(QRhiGles2InitParams::newFallbackSurface());
+        QRhiGles2InitParams params;
+        params.fallbackSurface = m_surface.get();
+        m_rhi.reset(QRhi::create(QRhi::OpenGLES2, &params));
+#endif
+        if (!m_rhi)
+            return false;
+
+        m_vs = loadShader(QStringLiteral(":/shaders/video.vert.qsb"));
+        m_fs = loadShader(QStringLiteral(":/shaders/video.frag.qsb"));
+        if (!m_vs.isValid() || !m_fs.isValid())
+            return false;
+
+        m_targetSize = target;
+        const QSize scaleSize(target.width(), source.height());
+        const auto scaleFormat = m_rhi->isTextureFormatSupported(QRhiTexture::RGBA16F) ? QRhiTexture::RGBA16F
+                                                                                       : QRhiTexture::RGBA8;
+        m_source.reset(m_rhi->newTexture(QRhiTexture::RGBA8, source.size()));
+        m_target.reset(m_rhi->newTexture(QRhiTexture::RGBA8, target, 1,
+                                         QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+        m_scaleTexture.reset(m_rhi->newTexture(scaleFormat, scaleSize, 1, QRhiTexture::RenderTarget));
+        if (!m_source->create() || !m_target->create() || !m_scaleTexture->create())
+            return false;
+
+        m_rt.reset(m_rhi->newTextureRenderTarget({ m_target.get() }));
+        m_rpDesc.reset(m_rt->newCompatibleRenderPassDescriptor());
+        m_rt->setRenderPassDescriptor(m_rpDesc.get());
+        m_scaleRt.reset(m_rhi->newTextureRenderTarget({ m_scaleTexture.get() }));
+        m_scaleRpDesc.reset(m_scaleRt->newCompatibleRenderPassDescriptor());
+        m_scaleRt->setRenderPassDescriptor(m_scaleRpDesc.get());
+        if (!m_rt->create() || !m_scaleRt->create())
+            return false;
+
+        // Full-target quad; QRhi NDC is y-up on every backend, texture
+        // coordinates start at the top of the image.
+        static const float vertices[16] = {
+            -1.0f,  1.0f, 0.0f, 0.0f,
+            -1.0f, -1.0f, 0.0f, 1.0f,
+             1.0f,  1.0f, 1.0f, 0.0f,
+             1.0f, -1.0f, 1.0f, 1.0f,
+        };
+        // The intermediate is written in framebuffer orientation, so the
+        // vertical pass reads its top row at v = 0 like any other texture.
+        const float top = m_rhi->isYUpInFramebuffer() ? 1.0f : 0.0f;
+        const float scaleVertices[16] = {
+            -1.0f,  1.0f, 0.0f, top,
+            -1.0f, -1.0f, 0.0f, 1.0f - top,
+             1.0f,  1.0f, 1.0f, top,
+             1.0f, -1.0f, 1.0f, 1.0f - top,
+        };
+        m_vbuf.reset(m_rhi->newBuffer(QRhiBuffer::Immutable, QRhiBuffer::VertexBuffer, sizeof(vertices)));
+        m_scaleVbuf.reset(m_rhi->newBuffer(QRhiBuffer::Immutable, QRhiBuffer::VertexBuffer, sizeof(scaleVertices)));
+        m_ubuf.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(VideoUniforms)));
+        m_scaleUbuf.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(VideoUniforms)));
+        m_sampler.reset(m_rhi->newSampler(QRhiSampler::Linear, QRhiSampler::Linear, QRhiSampler::None,
+                                          QRhiSampler::ClampToEdge, QRhiSampler::ClampToEdge));
+        if (!m_vbuf->create() || !m_scaleVbuf->create() || !m_ubuf->create() || !m_scaleUbuf->create()
+            || !m_sampler->create())
+            return false;
+
+        // Single pass and horizontal pass read the source; the vertical
+        // pass reads the intermediate with the target's uniforms.
+        m_srb = makeBindings(m_ubuf.get(), m_source.get());
+        m_scaleSourceSrb = makeBindings(m_scaleUbuf.get(), m_source.get());
+        m_scaleSrb = makeBindings(m_ubuf.get(), m_scaleTexture.get());
+        if (!m_srb || !m_scaleSourceSrb || !m_scaleSrb)
+            return false;
+
+        m_pipeline = makePipeline(m_rpDesc.get());
+        m_scalePipeline = makePipeline(m_scaleRpDesc.get());
+        if (!m_pipeline || !m_scalePipeline)
+            return false;
+
+        // Upload once: the comparison is about the scaling passes.
+        QRhiCommandBuffer *cb = nullptr;
+        if (m_rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return false;
+        QRhiResourceUpdateBatch *u = m_rhi->nextResourceUpdateBatch();
+        u->uploadTexture(m_source.get(), source);
+        u->uploadStaticBuffer(m_vbuf.get(), vertices);
+        u->uploadStaticBuffer(m_scaleVbuf.get(), scaleVertices);
+        cb->resourceUpdate(u);
+        return m_rhi->endOffscreenFrame() == QRhi::FrameOpSuccess;
+    }
+
+    QString backendName() const
+    {
+        return m_rhi ? QString::fromLatin1(m_rhi->backendName()) : QString();
+    }
+
+    /// One offscreen frame scaling with @p filter; waits for the GPU.
+    /// Reads the result back into @p out when given.
+    bool draw(SwsFilterMode filter, QImage *out)
+    {
+        QRhiCommandBuffer *cb = nullptr;
+        if (m_rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return false;
+
+        VideoUniforms uniforms{};
+        uniforms.mvp[0] = uniforms.mvp[5] = uniforms.mvp[10] = uniforms.mvp[15] = 1.0f;
+        uniforms.sampleScale = 1.0f;
+        uniforms.layoutMode  = 0;
+        uniforms.filterMode  = shaderFilterMode(filter);
+        const bool twoPass = uniforms.filterMode >= 2;
+        uniforms.scalePass   = twoPass ? 2 : 0;
+        uniforms.dstExtent   = float(m_targetSize.height());
+        QRhiResourceUpdateBatch *u = m_rhi->nextResourceUpdateBatch();
+        u->updateDynamicBuffer(m_ubuf.get(), 0, sizeof(uniforms), &uniforms);
+
+        if (twoPass) {
+            VideoUniforms horizontal = uniforms;
+            horizontal.scalePass = 1;
+            horizontal.dstExtent = float(m_targetSize.width());
+            u->updateDynamicBuffer(m_scaleUbuf.get(), 0, sizeof(horizontal), &horizontal);
+
+            const QSize size = m_scaleTexture->pixelSize();
+            cb->beginPass(m_scaleRt.get(), Qt::black, { 1.0f, 0 }, u);
+            drawQuad(cb, m_scalePipeline.get(), m_scaleSourceSrb.get(), m_scaleVbuf.get(), size);
+            cb->endPass();
+            u = nullptr;
+        }
+
+        cb->beginPass(m_rt.get(), Qt::black, { 1.0f, 0 }, u);
+        drawQuad(cb, m_pipeline.get(), twoPass ? m_scaleSrb.get() : m_srb.get(), m_vbuf.get(), m_targetSize);
+
+        QRhiReadbackResult result;
+        QRhiResourceUpdateBatch *readback = nullptr;
+        if (out) {
+            readback = m_rhi->nextResourceUpdateBatch();
+            readback->readBackTexture({ m_target.get() }, &result);
+        }
+        cb->endPass(readback);
+
+        // Offscreen frames complete before endOffscreenFrame() returns.
+        if (m_rhi->endOffscreenFrame() != QRhi::FrameOpSuccess)
+            return false;
+
+        if (out) {
+            const QImage image(reinterpret_cast<const uchar *>(result.data.constData()),
+                               result.pixelSize.width(), result.pixelSize.height(),
+                               QImage::Format_RGBA8888);
+            *out = m_rhi->isYUpInFramebuffer() ? image.mirrored() : image.copy();
+        }
+        return true;
+    }
+
+private:
+    /// video.frag's bindings with @p tex on all three samplers.
+    std::unique_ptr<QRhiShaderResourceBindings> makeBindings(QRhiBuffer *ubuf, QRhiTexture *tex)
+    {
+        const auto stages = QRhiShaderResourceBinding::VertexStage | QRhiShaderResourceBinding::FragmentStage;
+        const auto frag   = QRhiShaderResourceBinding::FragmentStage;
+        std::unique_ptr<QRhiShaderResourceBindings> srb(m_rhi->newShaderResourceBindings());
+        srb->setBindings({
+            QRhiShaderResourceBinding::uniformBuffer(0, stages, ubuf),
+            QRhiShaderResourceBinding::sampledTexture(1, frag, tex, m_sampler.get()),
+            QRhiShaderResourceBinding::sampledTexture(2, frag, tex, m_sampler.get()),
+            QRhiShaderResourceBinding::sampledTexture(3, frag, tex, m_sampler.get()),
+        });
+        if (!srb->create())
+            return nullptr;
+        return srb;
+    }
+
+    std::unique_ptr<QRhiGraphicsPipeline> makePipeline(QRhiRenderPassDescriptor *rpDesc)
+    {
+        std::unique_ptr<QRhiGraphicsPipeline> ps(m_rhi->newGraphicsPipeline());
+        ps->setTopology(QRhiGraphicsPipeline::TriangleStrip);
+        ps->setShaderStages({
+            { QRhiShaderStage::Vertex, m_vs },
+            { QRhiShaderStage::Fragment, m_fs },
+        });
+        QRhiVertexInputLayout inputLayout;
+        inputLayout.setBindings({ { 4 * sizeof(float) } });
+        inputLayout.setAttributes({
+            { 0, 0, QRhiVertexInputAttribute::Float2, 0 },
+            { 0, 1, QRhiVertexInputAttribute::Float2, 2 * sizeof(float) },
+        });
+        ps->setVertexInputLayout(inputLayout);
+        ps->setShaderResourceBindings(m_srb.get());
+        ps->setRenderPassDescriptor(rpDesc);
+        if (!ps->create())
+            return nullptr;
+        return ps;
+    }
+
+    static void drawQuad(QRhiCommandBuffer *cb, QRhiGraphicsPipeline *ps, QRhiShaderResourceBindings *srb,
+                         QRhiBuffer *vbuf, const QSize &size)
+    {
+        cb->setGraphicsPipeline(ps);
+        cb->setViewport(QRhiViewport(0, 0, size.width(), size.height()));
+        cb->setShaderResources(srb);
+        const QRhiCommandBuffer::VertexInput input(vbuf, 0);
+        cb->setVertexInput(0, 1, &input);
+        cb->draw(4);
+    }
+
+    // Declaration order = reverse destruction order: resources go before
+    // the QRhi, the QRhi before its surface.
+    std::unique_ptr<QOffscreenSurface>           m_surface;
+    std::unique_ptr<QRhi>                        m_rhi;
+    QShader                                      m_vs;
+    QShader                                      m_fs;
+    std::unique_ptr<QRhiTexture>                 m_source;
+    std::unique_ptr<QRhiTexture>                 m_target;
+    std::unique_ptr<QRhiTexture>                 m_scaleTexture;   ///< horizontally scaled source
+    std::unique_ptr<QRhiTextureRenderTarget>     m_rt;
+    std::unique_ptr<QRhiRenderPassDescriptor>    m_rpDesc;
+    std::unique_ptr<QRhiTextureRenderTarget>     m_scaleRt;
+    std::unique_ptr<QRhiRenderPassDescriptor>    m_scaleRpDesc;
+    std::unique_ptr<QRhiBuffer>                  m_vbuf;
+    std::unique_ptr<QRhiBuffer>                  m_scaleVbuf;
+    std::unique_ptr<QRhiBuffer>                  m_ubuf;
+    std::unique_ptr<QRhiBuffer>                  m_scaleUbuf;
+    std::unique_ptr<QRhiSampler>                 m_sampler;
+    std::unique_ptr<QRhiShaderResourceBindings>  m_srb;
+    std::unique_ptr<QRhiShaderResourceBindings>  m_scaleSourceSrb;
+    std::unique_ptr<QRhiShaderResourceBindings>  m_scaleSrb;
+    std::unique_ptr<QRhiGraphicsPipeline>        m_pipeline;
+    std::unique_ptr<QRhiGraphicsPipeline>        m_scalePipeline;
+    QSize m_targetSize;
+};
+
+} // namespace
+
+namespace ScaleCompare {
+
+bool run(const QString &name, const QString &path, int iterations,
+         QTextStream &out, QJsonArray &json)
+{
+    const QImage reference = decodeReference(path);
+    if (reference.isNull()) {
+        qWarning() << "ScaleCompare - cannot decode a frame of" << path;
+        return false;
+    }
+
+    SwsContext *sws = nullptr;
+    const QSize half(reference.width() / 2, reference.height() / 2);
+    const QImage source = swsScale(reference, half, SWS_AREA | SWS_ACCURATE_RND, sws);
+
+    GpuScaler gpu;
+    const bool haveGpu = gpu.init(source, reference.size());
+    if (!haveGpu)
+        qWarning() << "ScaleCompare - no GPU (QRhi OpenGL) available, CPU only";
+
+    out << "\n" << name << "  " << source.width() << "x" << source.height()
+        << " -> " << reference.width() << "x" << reference.height()
+        << (haveGpu ? QStringLiteral("  GPU: ") + gpu.backendName() : QString()) << "\n";
+    out << QStringLiteral("  %1 %2 %3 %4 %5\n")
+               .arg(QStringLiteral("filter"), -10)
+               .arg(QStringLiteral("sws dB"), 9).arg(QStringLiteral("sws ms"), 9)
+               .arg(QStringLiteral("gpu dB"), 9).arg(QStringLiteral("gpu ms"), 9);
+
+    QJsonArray filters;
+    for (SwsFilterMode filter : kFilters) {
+        const int flags = FrameHandler::toSwsFlags(filter);
+
+        QImage swsOut = swsScale(source, reference.size(), flags, sws);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i)
+            swsScale(source, reference.size(), flags, sws);
+        const double swsMs = timer.nsecsElapsed() / 1e6 / iterations;
+        const double swsDb = psnr(reference, swsOut);
+
+        double gpuMs = 0.0, gpuDb = 0.0;
+        bool gpuOk = false;
+        if (haveGpu) {
+            QImage gpuOut;
+            gpuOk = gpu.draw(filter, &gpuOut);
+            timer.restart();
+            for (int i = 0; gpuOk && i < iterations; ++i)
+                gpuOk = gpu.draw(filter, nullptr);
+            gpuMs = timer.nsecsElapsed() / 1e6 / iterations;
+            gpuDb = psnr(reference, gpuOut);
+        }
+
+        out << QStringLiteral("  %1 %2 %3").arg(QString::fromLatin1(filterName(filter)), -10)
+                   .arg(swsDb, 9, 'f', 2).arg(swsMs, 9, 'f', 3);
+        if (gpuOk)
+            out << QStringLiteral(" %1 %2").arg(gpuDb, 9, 'f', 2).arg(gpuMs, 9, 'f', 3);
+        out << "\n";
+
+        QJsonObject o;
+        o["filter"]  = QString::fromLatin1(filterName(filter));
+        o["swsPsnr"] = swsDb;
+        o["swsMs"]   = swsMs;
+        if (gpuOk) {
+            o["gpuPsnr"] = gpuDb;
+            o["gpuMs"]   = gpuMs;
+        }
+        filters.append(o);
+    }
+    sws_freeContext(sws);
+
+    QJsonObject clip;
+    clip["name"]    = name;
+    clip["source"]  = QStringLiteral("%1x%2").arg(source.width()).arg(source.height());
+    clip["target"]  = QStringLiteral("%1x%2").arg(reference.width()).arg(reference.height());
+    clip["gpu"]     = haveGpu ? gpu.backendName() : QString();
+    clip["filters"] = filters;
+    json.append(clip);
+    return true;
+}
+
+} // namespace ScaleCompare
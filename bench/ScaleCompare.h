@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QString>
+#include <QTextStream>
+
+/// @brief zqt_bench --scale-compare: the OpenGLVideoItem shader scaler
+///        against sws_scale, per SwsFilterMode.
+///
+/// A frame from each clip is taken as the reference, shrunk to half size
+/// with SWS_AREA and scaled back up to the reference size by both paths.
+/// Reported per filter: PSNR against the reference (RGB) and ms per frame.
+/// sws time is one sws_scale() call; GPU time is one offscreen QRhi frame
+/// drawing the real video.frag (uniform update, draw -- two passes for
+/// bicubic and Lanczos, as in the player -- submit and wait),
+/// the source texture already uploaded, as it is for every filter in the
+/// player.  Without a usable GPU the GPU columns are left out.
+///
+/// Needs a QGuiApplication for the OpenGL context.
+namespace ScaleCompare {
+
+/// Compare on @p path; @p iterations timed calls per filter and path.
+/// Returns false when no frame could be decoded.
+bool run(const QString &name, const QString &path, int iterations,
+         QTextStream &out, QJsonArray &json);
+
+} // namespace ScaleCompare
@@ -0,0 +1,415 @@
+/*
+ * zqt_bench.cpp
+ *
+ * Headless throughput benchmark for the decode / convert pipeline.  Each
+ * clip of a generated lavfi corpus (see BenchCorpus) is played through an
+ * AVCodecHandler + FrameHandler pair with real-time pacing off, no video
+ * sink and a null audio output, so the stages run as fast as they can
+ * without a window, GPU or sound device.
+ *
+ * Reported per clip: items per second and latency percentiles for every
+ * stage (StageTimings), end-to-end video fps, C++ heap allocations made
+ * during playback (operator new, counted below; av_malloc / malloc are
+ * not included) and FrameBufferPool allocations.  The process peak RSS is
+ * a high-water mark over the whole run, so it is reported once at the end.
+ *
+ *   zqt_bench [--seconds N] [--iterations N] [--threads N] [--render-mode sink|gl]
+ *             [--clip NAME]... [--file PATH]... [--corpus DIR] [--json PATH] [--verbose]
+ *
+ * With --scale-compare the clips are not played; instead the GPU scaling
+ * of OpenGLVideoItem is compared with sws_scale (see ScaleCompare).
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "AVCodecHandler.h"
+#include "BenchCorpus.h"
+#include "FrameHandler.h"
+#include "PlayerStats.h"
+#include "ScaleCompare.h"
+#include "StageTimings.h"
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+// ── Allocation counting ────────────────────────────────────
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocatedBytes{0};
+}
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// ── Benchmark ──────────────────────────────────────────────
+
+namespace {
+
+struct Options {
+    int             seconds    = 10;
+    int             iterations = 3;
+    int             threads    = 0;   ///< 0 = DecoderThreadingPolicy table
+    VideoRenderMode renderMode = VideoRenderMode::QVideoSink;
+};
+
+struct ClipResult {
+    QString  name;
+    QString  path;
+    QString  videoCodec;
+    QSize    resolution;
+    int      runs        = 0;
+    int      failedRuns  = 0;
+    double   wallSec     = 0.0;   ///< play() → PlaybackDone, summed over runs
+    uint64_t allocations = 0;     ///< operator new calls during playback
+    uint64_t allocatedBytes = 0;
+    QVariantMap poolStats;        ///< PlayerStats snapshot after the last run
+    std::shared_ptr<StageTimings> timings = std::make_shared<StageTimings>();
+};
+
+constexpr StageTimings::Stage kStages[] = {
+    StageTimings::Stage::Demux,
+    StageTimings::Stage::VideoDecode,
+    StageTimings::Stage::VideoConvert,
+    StageTimings::Stage::AudioDecode,
+    StageTimings::Stage::AudioConvert,
+};
+
+// Stage samples reserved per second of media, on top of the video frame
+// rate: above the packet rate of AAC (~47/s), Opus (50/s) and MP3 (~38/s).
+constexpr double kReservedAudioItemsPerSec = 100.0;
+
+double toMs(int64_t ns)
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+/// Play @p path once to the end.  Returns the time from play() to
+/// PlaybackDone in seconds, or a negative value on failure.
+double runOnce(const QString &path, FrameHandler &frameHandler, const Options &options,
+               ClipResult &result)
+{
+    AVCodecHandler codec;
+    codec.setFilePath(path);
+    codec.setFrameHandler(&frameHandler);
+    codec.setDecodeThreading(options.threads, DecodeThreadType::Auto);
+    codec.setRealtimePacing(false);
+    codec.setStageTimings(result.timings);
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    done = false;
+    codec.setPlaybackDoneCallback([&] {
+        std::lock_guard lock(mutex);
+        done = true;
+        cv.notify_all();
+    });
+
+    if (!codec.open()) {
+        qWarning() << "zqt_bench - cannot open" << path;
+        return -1.0;
+    }
+    codec.registerPlayer();
+    result.videoCodec = codec.videoCodecName();
+    result.resolution = codec.videoResolution();
+
+    // Generous: even a slow CI box decodes the corpus faster than real time.
+    const auto timeout = std::chrono::seconds(std::max(60, options.seconds * 20));
+
+    // Keep StageTimings' sample vectors from growing, and being counted,
+    // during playback.
+    const double itemsPerSec = codec.videoFrameRate() + kReservedAudioItemsPerSec;
+    result.timings->reserve(static_cast<size_t>(itemsPerSec * std::max(1.0, codec.durationSeconds())));
+
+    const uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+    const uint64_t bytesBefore  = g_allocatedBytes.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    codec.play();
+
+    bool finished = false;
+    {
+        std::unique_lock lock(mutex);
+        finished = cv.wait_for(lock, timeout, [&] { return done; });
+    }
+    const auto end = std::chrono::steady_clock::now();
+    result.allocations    += g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+    result.allocatedBytes += g_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+    codec.stop();
+    codec.close();
+
+    if (!finished) {
+        qWarning() << "zqt_bench - timed out playing" << path;
+        return -1.0;
+    }
+    return std::chrono::duration<double>(end - start).count();
+}
+
+ClipResult benchClip(const QString &name, const QString &path, FrameHandler &frameHandler,
+                     const Options &options)
+{
+    ClipResult result;
+    result.name = name;
+    result.path = path;
+    frameHandler.stats().reset();
+
+    for (int i = 0; i < options.iterations; ++i) {
+        const double wall = runOnce(path, frameHandler, options, result);
+        if (wall < 0.0) {
+            ++result.failedRuns;
+            continue;
+        }
+        ++result.runs;
+        result.wallSec += wall;
+    }
+
+    result.poolStats = frameHandler.stats().snapshot();
+    return result;
+}
+
+void printClip(QTextStream &out, const ClipResult &r)
+{
+    const uint64_t frames = r.timings->summary(StageTimings::Stage::VideoConvert).count;
+    out << "\n" << r.name << "  (" << r.videoCodec << " " << r.resolution.width() << "x"
+        << r.resolution.height() << ", " << r.runs << " run(s)";
+    if (r.failedRuns > 0) out << ", " << r.failedRuns << " FAILED";
+    out << ")\n";
+    if (r.runs == 0 || r.wallSec <= 0.0) return;
+
+    out << "  stage              items    items/s   busy%    p50 ms    p90 ms    p99 ms    max ms\n";
+    for (StageTimings::Stage stage : kStages) {
+        const StageTimings::Summary s = r.timings->summary(stage);
+        if (s.count == 0) continue;
+        out << QStringLiteral("  %1 %2 %3 %4 %5 %6 %7 %8\n")
+                   .arg(QString::fromLatin1(StageTimings::stageName(stage)), -14)
+                   .arg(s.count, 9)
+                   .arg(static_cast<double>(s.count) / r.wallSec, 10, 'f', 1)
+                   .arg(toMs(s.totalNs) / (r.wallSec * 1000.0) * 100.0, 7, 'f', 1)
+                   .arg(toMs(s.p50Ns), 9, 'f', 3)
+                   .arg(toMs(s.p90Ns), 9, 'f', 3)
+                   .arg(toMs(s.p99Ns), 9, 'f', 3)
+                   .arg(toMs(s.maxNs), 9, 'f', 3);
+    }
+
+    out << "  end-to-end    " << QString::number(static_cast<double>(frames) / r.wallSec, 'f', 1)
+        << " video fps, " << QString::number(r.wallSec, 'f', 2) << " s wall\n";
+    out << "  allocations   " << r.allocations << " operator new ("
+        << QString::number(frames ? static_cast<double>(r.allocations) / frames : 0.0, 'f', 1)
+        << " per frame, " << QString::number(r.allocatedBytes / (1024.0 * 1024.0), 'f', 1) << " MB), pool "
+        << r.poolStats.value("poolAllocations").toULongLong() << " new / "
+        << r.poolStats.value("poolReuses").toULongLong() << " reused\n";
+}
+
+QJsonObject toJson(const ClipResult &r)
+{
+    QJsonObject stages;
+    for (StageTimings::Stage stage : kStages) {
+        const StageTimings::Summary s = r.timings->summary(stage);
+        if (s.count == 0) continue;
+        QJsonObject o;
+        o["count"]   = static_cast<qint64>(s.count);
+        o["perSec"]  = r.wallSec > 0.0 ? static_cast<double>(s.count) / r.wallSec : 0.0;
+        o["busyPct"] = r.wallSec > 0.0 ? toMs(s.totalNs) / (r.wallSec * 1000.0) * 100.0 : 0.0;
+        o["p50Ms"]   = toMs(s.p50Ns);
+        o["p90Ms"]   = toMs(s.p90Ns);
+        o["p99Ms"]   = toMs(s.p99Ns);
+        o["maxMs"]   = toMs(s.maxNs);
+        stages[QString::fromLatin1(StageTimings::stageName(stage))] = o;
+    }
+
+    const uint64_t frames = r.timings->summary(StageTimings::Stage::VideoConvert).count;
+    QJsonObject o;
+    o["name"]           = r.name;
+    o["path"]           = r.path;
+    o["videoCodec"]     = r.videoCodec;
+    o["width"]          = r.resolution.width();
+    o["height"]         = r.resolution.height();
+    o["runs"]           = r.runs;
+    o["failedRuns"]     = r.failedRuns;
+    o["wallSec"]        = r.wallSec;
+    o["videoFps"]       = r.wallSec > 0.0 ? static_cast<double>(frames) / r.wallSec : 0.0;
+    o["allocations"]    = static_cast<qint64>(r.allocations);
+    o["allocatedBytes"] = static_cast<qint64>(r.allocatedBytes);
+    o["allocsPerFrame"] = frames ? static_cast<double>(r.allocations) / frames : 0.0;
+    o["poolAllocations"] = r.poolStats.value("poolAllocations").toLongLong();
+    o["poolReuses"]     = r.poolStats.value("poolReuses").toLongLong();
+    o["stages"]         = stages;
+    return o;
+}
+
+constexpr int kScaleIterations = 30;   ///< timed calls per filter in --scale-compare
+
+/// --scale-compare needs a QGuiApplication for its OpenGL context; the
+/// playback benchmark stays windowless.
+bool wantsGui(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--scale-compare") == 0)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::unique_ptr<QCoreApplication> app = wantsGui(argc, argv)
+        ? std::make_unique<QGuiApplication>(argc, argv)
+        : std::make_unique<QCoreApplication>(argc, argv);
+    QCoreApplication::setApplicationName("zqt_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless decode / convert benchmark for the ZQTPlayer pipeline.");
+    parser.addHelpOption();
+    const QCommandLineOption secondsOpt("seconds", "Length of the generated clips.", "N", "10");
+    const QCommandLineOption iterOpt("iterations", "Runs per clip.", "N", "3");
+    const QCommandLineOption threadsOpt("threads", "Decoder threads, 0 = per-codec table.", "N", "0");
+    const QCommandLineOption modeOpt("render-mode", "Video conversion path: sink or gl.", "mode", "sink");
+    const QCommandLineOption clipOpt("clip", "Only run this corpus clip (repeatable).", "name");
+    const QCommandLineOption fileOpt("file", "Also run this media file (repeatable).", "path");
+    const QCommandLineOption corpusOpt("corpus", "Corpus directory.", "dir",
+                                       QDir(QDir::tempPath()).filePath("zqt_bench_corpus"));
+    const QCommandLineOption jsonOpt("json", "Write the results as JSON.", "path");
+    const QCommandLineOption verboseOpt("verbose", "Keep the pipeline's debug log.");
+    const QCommandLineOption scaleOpt("scale-compare",
+                                      "Compare GPU shader scaling with sws_scale (PSNR, ms/frame) "
+                                      "instead of playing the clips.");
+    parser.addOptions({secondsOpt, iterOpt, threadsOpt, modeOpt, clipOpt, fileOpt,
+                       corpusOpt, jsonOpt, verboseOpt, scaleOpt});
+    parser.process(*app);
+
+    if (!parser.isSet(verboseOpt))
+        QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+    Options options;
+    options.seconds    = std::max(1, parser.value(secondsOpt).toInt());
+    options.iterations = std::max(1, parser.value(iterOpt).toInt());
+    options.threads    = std::max(0, parser.value(threadsOpt).toInt());
+    if (parser.value(modeOpt) == QLatin1String("gl"))
+        options.renderMode = VideoRenderMode::OpenGLTexture;
+
+    // Clips to run: the corpus (optionally filtered), then extra files.
+    QList<QPair<QString, QString>> inputs;   // name, path
+    const QStringList only = parser.values(clipOpt);
+    for (const BenchCorpus::Clip &clip : BenchCorpus::defaultClips()) {
+        const QString name = QString::fromLatin1(clip.name);
+        if (!only.isEmpty() && !only.contains(name)) continue;
+        const QString path = BenchCorpus::ensure(clip, options.seconds, parser.value(corpusOpt));
+        if (path.isEmpty()) continue;
+        inputs.append({name, path});
+    }
+    for (const QString &file : parser.values(fileOpt))
+        inputs.append({QFileInfo(file).fileName(), file});
+
+    if (inputs.isEmpty()) {
+        qCritical() << "zqt_bench - nothing to run";
+        return 1;
+    }
+
+    if (parser.isSet(scaleOpt)) {
+        QTextStream out(stdout);
+        out << "zqt_bench --scale-compare  FFmpeg " << av_version_info() << ", "
+            << kScaleIterations << " timed calls per filter\n";
+        QJsonArray jsonClips;
+        bool anyFailed = false;
+        for (const auto &[name, path] : inputs)
+            anyFailed |= !ScaleCompare::run(name, path, kScaleIterations, out, jsonClips);
+        out.flush();
+
+        if (parser.isSet(jsonOpt)) {
+            QJsonObject root;
+            root["ffmpeg"]       = QString::fromLatin1(av_version_info());
+            root["scaleCompare"] = jsonClips;
+            QFile file(parser.value(jsonOpt));
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                qCritical() << "zqt_bench - cannot write" << file.fileName();
+                return 1;
+            }
+            file.write(QJsonDocument(root).toJson());
+        }
+        return anyFailed ? 2 : 0;
+    }
+
+    FrameHandler frameHandler;
+    frameHandler.setNullAudioOutput(true);
+    frameHandler.setVideoRenderMode(options.renderMode);
+
+    QTextStream out(stdout);
+    out << "zqt_bench  FFmpeg " << av_version_info() << ", "
+        << std::thread::hardware_concurrency() << " cores, render mode "
+        << (options.renderMode == VideoRenderMode::QVideoSink ? "sink" : "gl") << ", "
+        << options.iterations << " run(s) per clip\n";
+    out.flush();
+
+    QJsonArray jsonClips;
+    bool anyFailed = false;
+    for (const auto &[name, path] : inputs) {
+        const ClipResult result = benchClip(name, path, frameHandler, options);
+        anyFailed = anyFailed || result.failedRuns > 0;
+        printClip(out, result);
+        out.flush();
+        jsonClips.append(toJson(result));
+    }
+
+    const uint64_t peakRssBytes = PlayerStats::processPeakRssBytes();
+    out << "\npeak RSS " << QString::number(peakRssBytes / (1024.0 * 1024.0), 'f', 1)
+        << " MB (whole run)\n";
+
+    if (parser.isSet(jsonOpt)) {
+        QJsonObject root;
+        root["ffmpeg"]     = QString::fromLatin1(av_version_info());
+        root["cores"]      = static_cast<int>(std::thread::hardware_concurrency());
+        root["seconds"]    = options.seconds;
+        root["iterations"] = options.iterations;
+        root["threads"]    = options.threads;
+        root["renderMode"] = options.renderMode == VideoRenderMode::QVideoSink ? "sink" : "gl";
+        root["peakRssBytes"] = static_cast<qint64>(peakRssBytes);
+        root["clips"]      = jsonClips;
+
+        QFile file(parser.value(jsonOpt));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "zqt_bench - cannot write" << file.fileName();
+            return 1;
+        }
+        file.write(QJsonDocument(root).toJson());
+    }
+
+    return anyFailed ? 2 : 0;
+}
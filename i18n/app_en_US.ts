@@ -37,6 +37,30 @@
             <source>Drop to open</source>
             <translation>Drop to open</translation>
         </message>
+        <message>
+            <source>Library</source>
+            <translation>Library</translation>
+        </message>
+        <message>
+            <source>Add Folder</source>
+            <translation>Add Folder</translation>
+        </message>
+        <message>
+            <source>Rescan</source>
+            <translation>Rescan</translation>
+        </message>
+        <message>
+            <source>Scanning… %1 files, %2 / %3 probed</source>
+            <translation>Scanning… %1 files, %2 / %3 probed</translation>
+        </message>
+        <message>
+            <source>%1 files</source>
+            <translation>%1 files</translation>
+        </message>
+        <message>
+            <source>Add Library Folder</source>
+            <translation>Add Library Folder</translation>
+        </message>
     </context>
     <context>
         <name>Settings</name>
@@ -184,6 +208,62 @@
             <source> (Unsupported on this platform)</source>
             <translation> (Unsupported on this platform)</translation>
         </message>
+        <message>
+            <source>HDR Tone Mapping</source>
+            <translation>HDR Tone Mapping</translation>
+        </message>
+        <message>
+            <source>Off</source>
+            <translation>Off</translation>
+        </message>
+        <message>
+            <source>Hable</source>
+            <translation>Hable</translation>
+        </message>
+        <message>
+            <source>BT.2390</source>
+            <translation>BT.2390</translation>
+        </message>
+        <message>
+            <source>Video Super Resolution (RTX, CPU fallback)</source>
+            <translation>Video Super Resolution (RTX, CPU fallback)</translation>
+        </message>
+        <message>
+            <source>Video Super Resolution (CPU)</source>
+            <translation>Video Super Resolution (CPU)</translation>
+        </message>
+        <message>
+            <source>Video Filters</source>
+            <translation>Video Filters</translation>
+        </message>
+        <message>
+            <source>libavfilter chain, e.g. hqdn3d,unsharp</source>
+            <translation>libavfilter chain, e.g. hqdn3d,unsharp</translation>
+        </message>
+        <message>
+            <source>Deinterlacing</source>
+            <translation>Deinterlacing</translation>
+        </message>
+        <message>
+            <source>Auto</source>
+            <translation>Auto</translation>
+        </message>
+        <message>
+            <source>Force</source>
+            <translation>Force</translation>
+        </message>
+        <message>
+            <source>Decoder Threads</source>
+            <translation>Decoder Threads</translation>
+        </message>
+        <message>
+            <source>Frame</source>
+            <translation>Frame</translation>
+        </message>
+        <message>
+            <source>Slice</source>
+            <translation>Slice</translation>
+        </message>
     </context>
     <context>
         <name>MediaInfoDialog</name>
@@ -235,5 +315,9 @@
             <source>Channels</source>
             <translation>Channels</translation>
         </message>
+        <message>
+            <source>Performance</source>
+            <translation>Performance</translation>
+        </message>
     </context>
 </TS>
@@ -37,6 +37,30 @@
             <source>Drop to open</source>
             <translation>释放以打开</translation>
         </message>
+        <message>
+            <source>Library</source>
+            <translation>媒体库</translation>
+        </message>
+        <message>
+            <source>Add Folder</source>
+            <translation>添加文件夹</translation>
+        </message>
+        <message>
+            <source>Rescan</source>
+            <translation>重新扫描</translation>
+        </message>
+        <message>
+            <source>Scanning… %1 files, %2 / %3 probed</source>
+            <translation>正在扫描… %1 个文件，已探测 %2 / %3</translation>
+        </message>
+        <message>
+            <source>%1 files</source>
+            <translation>%1 个文件</translation>
+        </message>
+        <message>
+            <source>Add Library Folder</source>
+            <translation>添加媒体库文件夹</translation>
+        </message>
     </context>
     <context>
         <name>Settings</name>
@@ -184,6 +208,62 @@
             <source> (Unsupported on this platform)</source>
             <translation>（当前平台不支持）</translation>
         </message>
+        <message>
+            <source>HDR Tone Mapping</source>
+            <translation>HDR 色调映射</translation>
+        </message>
+        <message>
+            <source>Off</source>
+            <translation>关闭</translation>
+        </message>
+        <message>
+            <source>Hable</source>
+            <translation>Hable</translation>
+        </message>
+        <message>
+            <source>BT.2390</source>
+            <translation>BT.2390</translation>
+        </message>
+        <message>
+            <source>Video Super Resolution (RTX, CPU fallback)</source>
+            <translation>视频超分辨率（RTX，CPU 回退）</translation>
+        </message>
+        <message>
+            <source>Video Super Resolution (CPU)</source>
+            <translation>视频超分辨率（CPU）</translation>
+        </message>
+        <message>
+            <source>Video Filters</source>
+            <translation>视频滤镜</translation>
+        </message>
+        <message>
+            <source>libavfilter chain, e.g. hqdn3d,unsharp</source>
+            <translation>libavfilter 滤镜链，例如 hqdn3d,unsharp</translation>
+        </message>
+        <message>
+            <source>Deinterlacing</source>
+            <translation>去隔行</translation>
+        </message>
+        <message>
+            <source>Auto</source>
+            <translation>自动</translation>
+        </message>
+        <message>
+            <source>Force</source>
+            <translation>强制</translation>
+        </message>
+        <message>
+            <source>Decoder Threads</source>
+            <translation>解码线程</translation>
+        </message>
+        <message>
+            <source>Frame</source>
+            <translation>帧级</translation>
+        </message>
+        <message>
+            <source>Slice</source>
+            <translation>片级</translation>
+        </message>
     </context>
     <context>
         <name>MediaInfoDialog</name>
@@ -235,5 +315,9 @@
             <source>Channels</source>
             <translation>声道数</translation>
         </message>
+        <message>
+            <source>Performance</source>
+            <translation>性能</translation>
+        </message>
     </context>
 </TS>
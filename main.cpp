@@ -1,24 +1,24 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQuickStyle>
-#include <QQuickWindow>
-#include <QSGRendererInterface>
-#include <QSettings>
 #include <QDebug>
 #include "ThemeManager.h"
 #include "LanguageManager.h"
+#include "ThumbnailProvider.h"
+#include "SettingsStore.h"
 
 int main(int argc, char *argv[])
 {
-    QQuickWindow::setGraphicsApi(QSGRendererInterface::OpenGL);
+    // The scene graph picks the graphics API (D3D11 on Windows, OpenGL or
+    // Vulkan on Linux, Metal on macOS); the video item renders through
+    // QRhi on all of them.  QSG_RHI_BACKEND overrides the choice.
 
     QGuiApplication app(argc, argv);
     app.setOrganizationName("ZQT");
     app.setApplicationName("ZQTPlayer");
 
     // Restore saved style
-    QSettings settings;
-    QString style = settings.value("style", "Fusion").toString();
+    QString style = SettingsStore::instance().value("style", "Fusion").toString();
     QQuickStyle::setStyle(style);
 
     // Restore saved color scheme BEFORE QML loads
@@ -28,6 +28,7 @@ int main(int argc, char *argv[])
     LanguageManager::loadInitialTranslation();
 
     QQmlApplicationEngine engine;
+    engine.addImageProvider(QStringLiteral("thumbnail"), new ThumbnailProvider);   // engine takes ownership
     QObject::connect(
         &engine,
         &QQmlApplicationEngine::objectCreationFailed,
@@ -1,6 +1,7 @@
 import QtQuick
 import QtQuick.Controls 2.15
 import QtQuick.Layouts
+import QtQuick.Dialogs
 import ZQTPlayer 1.0
 
 ApplicationWindow {
@@ -20,6 +21,10 @@ ApplicationWindow {
         id: playerManager
     }
 
+    MediaLibrary {
+        id: library
+    }
+
     StackView {
         id: stack
         anchors.fill: parent
@@ -38,8 +43,7 @@ ApplicationWindow {
                 onDropped: function(drop) {
                     dropOverlay.visible = false;
                     if (drop.hasUrls && drop.urls.length > 0) {
-                        let path = drop.urls[0].toString();
-                        stack.push(localPlayerPage, { mediaSource: path });
+                        stack.push(localPlayerPage, { mediaSources: drop.urls });
                     }
                 }
 
@@ -83,6 +87,84 @@ ApplicationWindow {
                             onClicked: mediaInfoDialog.open()
                         }
                     }
+
+                    // ── Library ──
+                    RowLayout {
+                        spacing: 12
+                        Layout.topMargin: 12
+                        Layout.alignment: Qt.AlignHCenter
+
+                        Label {
+                            text: qsTr("Library")
+                            font.pointSize: 14
+                        }
+
+                        Button {
+                            text: qsTr("Add Folder")
+                            onClicked: folderDialog.open()
+                        }
+
+                        Button {
+                            text: qsTr("Rescan")
+                            enabled: library.folders.length > 0 && !library.scanning
+                            onClicked: library.rescan()
+                        }
+
+                        Label {
+                            opacity: 0.6
+                            text: library.scanning
+                                  ? qsTr("Scanning… %1 files, %2 / %3 probed")
+                                        .arg(library.scanStats.filesFound || 0)
+                                        .arg(library.scanStats.filesProbed || 0)
+                                        .arg(library.scanStats.filesToProbe || 0)
+                                  : qsTr("%1 files").arg(library.count)
+                        }
+                    }
+
+                    ListView {
+                        Layout.preferredWidth: Math.min(720, root.width - 48)
+                        Layout.preferredHeight: Math.min(320, contentHeight)
+                        Layout.alignment: Qt.AlignHCenter
+                        visible: library.count > 0
+                        clip: true
+                        model: library
+                        ScrollBar.vertical: ScrollBar {}
+
+                        delegate: ItemDelegate {
+                            id: entry
+                            required property string path
+                            required property string name
+                            required property string title
+                            required property string durationText
+                            required property string resolutionText
+                            required property string videoCodec
+
+                            width: ListView.view.width
+                            onClicked: stack.push(localPlayerPage, { mediaSources: [path] })
+
+                            contentItem: RowLayout {
+                                spacing: 12
+
+                                Image {
+                                    Layout.preferredWidth: 96
+                                    Layout.preferredHeight: 54
+                                    fillMode: Image.PreserveAspectFit
+                                    asynchronous: true
+                                    sourceSize: Qt.size(192, 108)
+                                    source: entry.videoCodec.length > 0
+                                            ? "image://thumbnail/" + encodeURIComponent(entry.path)
+                                            : ""
+                                }
+
+                                Label {
+                                    Layout.fillWidth: true
+                                    elide: Text.ElideRight
+                                    text: [entry.title || entry.name, entry.durationText, entry.resolutionText]
+                                          .filter(part => part.length > 0).join("  ·  ")
+                                }
+                            }
+                        }
+                    }
                 }
 
                 // ── Drop highlight overlay ──
@@ -109,6 +191,12 @@ ApplicationWindow {
                 id: mediaInfoDialog
                 manager: playerManager
             }
+
+            FolderDialog {
+                id: folderDialog
+                title: qsTr("Add Library Folder")
+                onAccepted: library.addFolder(selectedFolder.toString())
+            }
         }
     }
 
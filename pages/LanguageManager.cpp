@@ -1,6 +1,6 @@
 #include "LanguageManager.h"
+#include "SettingsStore.h"
 #include <QCoreApplication>
-#include <QSettings>
 #include <QQmlEngine>
 
 // Static translator instance – lives for the entire application
@@ -9,7 +9,7 @@ QTranslator LanguageManager::s_translator;
 // ── static: called from main.cpp BEFORE engine loads ──
 bool LanguageManager::loadInitialTranslation()
 {
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     QString locale = settings.value("language", "en_US").toString();
     if (locale.isEmpty() || locale == "en_US") {
         return true; // English is the source language – no translator needed
@@ -27,7 +27,7 @@ LanguageManager::LanguageManager(QObject *parent)
     m_langs.append(LangEntry{"English", "en_US"});
     m_langs.append(LangEntry{QString::fromUtf8("\347\256\200\344\275\223\344\270\255\346\226\207"), "zh_CN"});
 
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     QString saved = settings.value("language", "en_US").toString();
 
     m_currentIndex = 0;
@@ -71,7 +71,7 @@ void LanguageManager::setCurrentIndex(int index)
     m_currentIndex = index;
     const QString &locale = m_langs[index].locale;
 
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     settings.setValue("language", locale);
 
     // Remove current translator
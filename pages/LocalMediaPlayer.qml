@@ -11,6 +11,8 @@ Page {
 
     /// File path received from Home page via StackView push
     property string mediaSource: ""
+    /// Dropped files, played back to back as a playlist
+    property var mediaSources: []
 
     function formatTime(seconds) {
         const total = Math.max(0, Math.floor(seconds));
@@ -46,6 +48,8 @@ Page {
         flipX: playerManager.config.videoFlipX
         flipY: playerManager.config.videoFlipY
         preserveAspectRatio: playerManager.config.lockAspectRatio
+        scaleFilter: playerManager.config.swsFilter
+        toneMapper: playerManager.config.toneMapper
 
         onWidthChanged:  updateDisplaySize()
         onHeightChanged: updateDisplaySize()
@@ -66,9 +70,8 @@ Page {
         onDropped: function(drop) {
             dropOverlay.visible = false;
             if (drop.hasUrls && drop.urls.length > 0) {
-                let path = drop.urls[0].toString();
-                root.mediaSource = path;
-                playerManager.openMedia(path);
+                root.mediaSource = drop.urls[0].toString();
+                playerManager.openPlaylist(drop.urls, 0);
             }
         }
 
@@ -118,7 +121,11 @@ Page {
             }
 
             Label {
-                text: playerManager.hasMedia ? playerManager.filePath : qsTr("No media")
+                text: !playerManager.hasMedia ? qsTr("No media")
+                      : playerManager.playlist.length > 1
+                        ? playerManager.filePath + "  [" + (playerManager.playlistIndex + 1)
+                          + "/" + playerManager.playlist.length + "]"
+                        : playerManager.filePath
                 font.pointSize: 12
                 color: "white"
                 elide: Text.ElideMiddle
@@ -289,8 +296,9 @@ Page {
                     RoundButton {
                         text: "⏮"
                         font.pointSize: 14
+                        enabled: playerManager.hasPrevious
                         onClicked: {
-                            // TODO: previous / rewind
+                            playerManager.playPrevious();
                         }
                     }
 
@@ -309,8 +317,9 @@ Page {
                     RoundButton {
                         text: "⏭"
                         font.pointSize: 14
+                        enabled: playerManager.hasNext
                         onClicked: {
-                            // TODO: next / fast-forward
+                            playerManager.playNext();
                         }
                     }
                 }
@@ -362,7 +371,10 @@ Page {
 
     // ── Auto-open media when pushed with a path ──
     Component.onCompleted: {
-        if (mediaSource !== "") {
+        if (mediaSources.length > 0) {
+            mediaSource = mediaSources[0].toString();
+            playerManager.openPlaylist(mediaSources, 0);
+        } else if (mediaSource !== "") {
             playerManager.openMedia(mediaSource);
         }
     }
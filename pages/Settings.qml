@@ -294,6 +294,64 @@ Page {
                         }
                     }
 
+                    RowLayout {
+                        spacing: 12
+
+                        Label {
+                            text: qsTr("HDR Tone Mapping")
+                            Layout.alignment: Qt.AlignVCenter
+                        }
+
+                        ComboBox {
+                            model: [
+                                qsTr("Off"),
+                                qsTr("Hable"),
+                                qsTr("BT.2390")
+                            ]
+                            currentIndex: playerConfig.toneMapper
+                            onActivated: function(index) {
+                                playerConfig.toneMapper = index;
+                            }
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 12
+
+                        Label {
+                            text: qsTr("Deinterlacing")
+                            Layout.alignment: Qt.AlignVCenter
+                        }
+
+                        ComboBox {
+                            model: [
+                                qsTr("Off"),
+                                qsTr("Auto"),
+                                qsTr("Force")
+                            ]
+                            currentIndex: playerConfig.deinterlaceMode
+                            onActivated: function(index) {
+                                playerConfig.deinterlaceMode = index;
+                            }
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 12
+
+                        Label {
+                            text: qsTr("Video Filters")
+                            Layout.alignment: Qt.AlignVCenter
+                        }
+
+                        TextField {
+                            Layout.preferredWidth: 320
+                            placeholderText: qsTr("libavfilter chain, e.g. hqdn3d,unsharp")
+                            text: playerConfig.videoFilter
+                            onEditingFinished: playerConfig.videoFilter = text
+                        }
+                    }
+
                     Switch {
                         text: qsTr("Real-time seek preview")
                         checked: playerConfig.realtimeSeekPreview
@@ -337,6 +395,37 @@ Page {
                         }
                     }
 
+                    RowLayout {
+                        spacing: 12
+
+                        Label {
+                            text: qsTr("Decoder Threads")
+                            Layout.alignment: Qt.AlignVCenter
+                        }
+
+                        SpinBox {
+                            from: 0
+                            to: 64
+                            value: playerConfig.decodeThreads
+                            textFromValue: function(value) {
+                                return value === 0 ? qsTr("Auto") : value.toString();
+                            }
+                            onValueModified: playerConfig.decodeThreads = value
+                        }
+
+                        ComboBox {
+                            model: [
+                                qsTr("Auto"),
+                                qsTr("Frame"),
+                                qsTr("Slice")
+                            ]
+                            currentIndex: playerConfig.decodeThreadType
+                            onActivated: function(index) {
+                                playerConfig.decodeThreadType = index;
+                            }
+                        }
+                    }
+
                     Switch {
                         text: qsTr("Allow hardware decode fallback")
                         checked: playerConfig.allowHwFallback
@@ -362,8 +451,8 @@ Page {
                     }
 
                     Switch {
-                        visible: root.isWindows
-                        text: qsTr("RTX Video Super Resolution")
+                        text: root.isWindows ? qsTr("Video Super Resolution (RTX, CPU fallback)")
+                                             : qsTr("Video Super Resolution (CPU)")
                         checked: playerConfig.vsrEnabled
                         onToggled: playerConfig.vsrEnabled = checked
                     }
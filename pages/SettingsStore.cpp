@@ -0,0 +1,108 @@
+#include "SettingsStore.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSettings>
+
+#include "PipelineExecutor.h"
+
+SettingsStore &SettingsStore::instance()
+{
+    static SettingsStore store;
+    return store;
+}
+
+SettingsStore::SettingsStore()
+{
+    // Construct the executor first so it outlives this store at exit.
+    PipelineExecutor::instance();
+
+    QSettings settings;
+    const QStringList keys = settings.allKeys();
+    for (const QString &key : keys)
+        m_values.insert(key, settings.value(key));
+
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(kDebounceMs);
+    connect(&m_debounce, &QTimer::timeout, this, &SettingsStore::writeBehind);
+
+    if (QCoreApplication *app = QCoreApplication::instance())
+        connect(app, &QCoreApplication::aboutToQuit, this, &SettingsStore::flush);
+}
+
+SettingsStore::~SettingsStore()
+{
+    flush();
+}
+
+QVariant SettingsStore::value(const QString &key, const QVariant &defaultValue) const
+{
+    return m_values.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString &key, const QVariant &value)
+{
+    const auto it = m_values.constFind(key);
+    if (it != m_values.cend() && it.value() == value)
+        return;
+
+    m_values.insert(key, value);
+    m_pending.insert(key, value);
+    m_debounce.start();
+}
+
+void SettingsStore::writeBehind()
+{
+    if (m_pending.isEmpty()) return;
+
+    // A queue that still holds changes has a task on the way that takes
+    // these too; an empty one needs a new task.
+    bool needTask = false;
+    {
+        std::lock_guard lock(m_queue->mutex);
+        needTask = m_queue->changes.isEmpty();
+        for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it)
+            m_queue->changes.insert(it.key(), it.value());
+    }
+    m_pending.clear();
+
+    if (needTask) {
+        PipelineExecutor::instance().submit(PipelineExecutor::Lane::Background,
+                                            [queue = m_queue] { drain(*queue); });
+    }
+}
+
+void SettingsStore::flush()
+{
+    m_debounce.stop();
+
+    std::lock_guard lock(m_queue->mutex);
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it)
+        m_queue->changes.insert(it.key(), it.value());
+    m_pending.clear();
+    if (m_queue->changes.isEmpty()) return;
+
+    QVariantMap changes;
+    changes.swap(m_queue->changes);
+    write(changes);
+}
+
+void SettingsStore::drain(WriteQueue &queue)
+{
+    std::lock_guard lock(queue.mutex);
+    if (queue.changes.isEmpty()) return;   // flushed already
+
+    QVariantMap changes;
+    changes.swap(queue.changes);
+    write(changes);
+}
+
+void SettingsStore::write(const QVariantMap &changes)
+{
+    QSettings settings;
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it)
+        settings.setValue(it.key(), it.value());
+    settings.sync();
+    if (settings.status() != QSettings::NoError)
+        qWarning() << "SettingsStore::write - failed to save" << changes.size() << "settings";
+}
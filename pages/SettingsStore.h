@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariant>
+#include <QVariantMap>
+#include <memory>
+#include <mutex>
+
+/// @brief In-memory front for QSettings with write-behind.
+///
+/// All settings are read once at startup; value() never touches the disk.
+/// setValue() updates memory and (re)starts a short debounce timer; when
+/// it fires, the changed keys are written and synced by a Background task
+/// on the PipelineExecutor.  A volume slider drag is therefore a handful
+/// of map updates and a single write after the drag.  Pending changes are
+/// written synchronously on QCoreApplication::aboutToQuit and on
+/// destruction, without waiting for the executor: a batch whose task has
+/// not run yet is taken back and written on the spot.
+///
+/// GUI thread only, like the QSettings uses it replaces.
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SettingsStore &instance();
+
+    ~SettingsStore() override;
+
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    void setValue(const QString &key, const QVariant &value);
+
+    /// Write everything still pending now, on the calling thread
+    /// (shutdown).  Only waits for a write that is already running.
+    void flush();
+
+private:
+    SettingsStore();
+
+    /// Changes handed over for writing.  Shared with the write tasks, so
+    /// a task that only runs after shutdown finds nothing left to do.
+    struct WriteQueue {
+        std::mutex  mutex;     ///< held while writing: writes never overlap
+        QVariantMap changes;   ///< not yet taken by a write
+    };
+
+    void writeBehind();   ///< debounce expired: hand the pending keys to a task
+    static void drain(WriteQueue &queue);
+    static void write(const QVariantMap &changes);
+
+    static constexpr int kDebounceMs = 500;
+
+    QVariantMap m_values;     ///< every setting, as last set
+    QVariantMap m_pending;    ///< changed since the last write
+    QTimer      m_debounce;
+
+    std::shared_ptr<WriteQueue> m_queue = std::make_shared<WriteQueue>();
+};
@@ -1,13 +1,13 @@
 #include "StyleManager.h"
+#include "SettingsStore.h"
 #include <QQuickStyle>
-#include <QSettings>
 
 StyleManager::StyleManager(QObject *parent)
     : QObject(parent)
 {
     m_styles << "Fusion" << "Material";
 
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     QString saved = settings.value("style", QQuickStyle::name()).toString();
     if (saved.isEmpty()) {
         saved = "Fusion";
@@ -41,7 +41,7 @@ void StyleManager::setCurrentIndex(int index)
     }
 
     m_currentIndex = index;
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     settings.setValue("style", m_styles.at(index));
     QQuickStyle::setStyle(m_styles.at(index));
     emit currentIndexChanged();
@@ -1,12 +1,12 @@
 #include "ThemeManager.h"
+#include "SettingsStore.h"
 #include <QGuiApplication>
 #include <QStyleHints>
-#include <QSettings>
 
 ThemeManager::ThemeManager(QObject *parent)
     : QObject(parent)
 {
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     m_currentTheme = settings.value("theme", FollowSystem).toInt();
     applyTheme(m_currentTheme);
 }
@@ -23,7 +23,7 @@ void ThemeManager::setCurrentTheme(int theme)
     }
 
     m_currentTheme = theme;
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     settings.setValue("theme", theme);
     applyTheme(theme);
     emit currentThemeChanged();
@@ -31,7 +31,7 @@ void ThemeManager::setCurrentTheme(int theme)
 
 void ThemeManager::applyFromSettings()
 {
-    QSettings settings;
+    SettingsStore &settings = SettingsStore::instance();
     int theme = settings.value("theme", FollowSystem).toInt();
 
     auto *hints = QGuiApplication::styleHints();
@@ -0,0 +1,82 @@
+/*
+ * tst_gaplessplaylist.cpp
+ *
+ * Plays two BenchCorpus clips as a playlist through PlayerWindowManager.
+ * The second item is pre-opened on the standby handler and adopted at EOF
+ * with the gapless switch; the audio silence FrameHandler measures at that
+ * switch (PlayerStats::transitionGapUs, "transitionGapMs" in stats()) must
+ * stay below kMaxGapMs.
+ *
+ * The gap is measured on real audio output writes, so the test is skipped
+ * on machines without an audio output device.
+ */
+
+#include <QMediaDevices>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "BenchCorpus.h"
+#include "PlayerWindowManager.h"
+
+namespace {
+constexpr int    kClipSeconds = 3;
+constexpr double kMaxGapMs    = 50.0;   ///< well under one video frame at 20 fps
+}
+
+class tst_GaplessPlaylist : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void transitionGap();
+
+private:
+    QTemporaryDir m_corpus;
+    QStringList   m_clips;
+};
+
+void tst_GaplessPlaylist::initTestCase()
+{
+    // Keep ResumeStore / SettingsStore away from the user's files.
+    QStandardPaths::setTestModeEnabled(true);
+
+    if (QMediaDevices::audioOutputs().isEmpty())
+        QSKIP("No audio output device; the transition gap is measured on audio writes.");
+
+    QVERIFY(m_corpus.isValid());
+    // The clips with an audio track.
+    for (const BenchCorpus::Clip &clip : BenchCorpus::defaultClips()) {
+        if (!clip.audioCodec) continue;
+        const QString path = BenchCorpus::ensure(clip, kClipSeconds, m_corpus.path());
+        QVERIFY2(!path.isEmpty(), clip.name);
+        m_clips.append(path);
+    }
+    QVERIFY(m_clips.size() >= 2);
+}
+
+void tst_GaplessPlaylist::transitionGap()
+{
+    PlayerWindowManager manager;
+    manager.config()->setMuted(true);
+    manager.openPlaylist({m_clips.at(0), m_clips.at(1)});
+
+    QTRY_VERIFY_WITH_TIMEOUT(manager.isPlaying() && manager.playlistIndex() == 0, 10000);
+
+    // adoptHandler(gapless) resets the stats and arms the measurement; the
+    // first audio write of the second item fills it in.
+    QTRY_VERIFY_WITH_TIMEOUT(manager.playlistIndex() == 1
+                             && manager.stats().contains(QStringLiteral("transitionGapMs")),
+                             kClipSeconds * 1000 + 10000);
+
+    const double gapMs = manager.stats().value(QStringLiteral("transitionGapMs")).toDouble();
+    qInfo() << "transition gap" << gapMs << "ms";
+    QVERIFY2(gapMs <= kMaxGapMs,
+             qPrintable(QStringLiteral("gap %1 ms > %2 ms").arg(gapMs).arg(kMaxGapMs)));
+
+    manager.closeMedia();
+}
+
+QTEST_GUILESS_MAIN(tst_GaplessPlaylist)
+#include "tst_gaplessplaylist.moc"